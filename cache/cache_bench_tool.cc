@@ -87,6 +87,16 @@ static class std::shared_ptr<ROCKSDB_NAMESPACE::SecondaryCache> secondary_cache;
 
 DEFINE_string(cache_type, "lru_cache", "Type of block cache.");
 
+DEFINE_bool(tiny_lfu_admission, false,
+            "Use TinyLFU admission with lru_cache or clock_cache");
+DEFINE_bool(lazy_lru_updates, false,
+            "Only update the LRU list of lru_cache on eviction");
+DEFINE_uint32(scan_percent, 0,
+              "Percentage of lookup (+ insert on not found) operations that "
+              "read the next key of a per-thread scan over keys that are "
+              "never read again, like an occasional full scan. These are not "
+              "counted in the reported hit ratio.");
+
 // ## BEGIN stress_cache_key sub-tool options ##
 // See class StressCacheKey below.
 DEFINE_bool(stress_cache_key, false,
@@ -192,6 +202,9 @@ struct ThreadState {
   SharedState* shared;
   HistogramImpl latency_ns_hist;
   uint64_t duration_us = 0;
+  uint64_t lookups = 0;
+  uint64_t hits = 0;
+  uint64_t next_scan_key = 0;
 
   ThreadState(uint32_t index, SharedState* _shared)
       : tid(index), rnd(1000 + index), shared(_shared) {}
@@ -215,6 +228,10 @@ struct KeyGen {
         key -= max_key;
       }
     }
+    return Get(key);
+  }
+
+  Slice Get(uint64_t key) {
     // Variable size and alignment
     size_t off = key % 8;
     key_data[0] = char{42};
@@ -294,12 +311,17 @@ class CacheBench {
     if (FLAGS_cache_type == "clock_cache") {
       cache_ = ExperimentalNewClockCache(
           FLAGS_cache_size, FLAGS_value_bytes, FLAGS_num_shard_bits,
-          false /*strict_capacity_limit*/, kDefaultCacheMetadataChargePolicy);
+          false /*strict_capacity_limit*/, kDefaultCacheMetadataChargePolicy,
+          FLAGS_tiny_lfu_admission);
       if (!cache_) {
         fprintf(stderr, "Clock cache not supported.\n");
         exit(1);
       }
     } else if (FLAGS_cache_type == "fast_lru_cache") {
+      if (FLAGS_tiny_lfu_admission) {
+        fprintf(stderr, "TinyLFU admission not supported by fast_lru_cache.\n");
+        exit(1);
+      }
       cache_ = NewFastLRUCache(
           FLAGS_cache_size, FLAGS_value_bytes, FLAGS_num_shard_bits,
           false /*strict_capacity_limit*/, kDefaultCacheMetadataChargePolicy);
@@ -307,6 +329,8 @@ class CacheBench {
       LRUCacheOptions opts(FLAGS_cache_size, FLAGS_num_shard_bits,
                            false /* strict_capacity_limit */,
                            0.5 /* high_pri_pool_ratio */);
+      opts.use_tiny_lfu_admission = FLAGS_tiny_lfu_admission;
+      opts.use_lazy_lru_updates = FLAGS_lazy_lru_updates;
 #ifndef ROCKSDB_LITE
       if (!FLAGS_secondary_cache_uri.empty()) {
         Status s = SecondaryCache::CreateFromString(
@@ -397,6 +421,15 @@ class CacheBench {
                                         FLAGS_ops_per_thread / elapsed_secs);
     printf("Thread ops/sec = %u\n", ops_per_sec);
 
+    uint64_t lookups = 0;
+    uint64_t hits = 0;
+    for (uint32_t i = 0; i < FLAGS_threads; i++) {
+      lookups += threads[i]->lookups;
+      hits += threads[i]->hits;
+    }
+    printf("Hit ratio = %.2f%%\n",
+           lookups > 0 ? 100.0 * hits / lookups : 0.0);
+
     printf("\nOperation latency (ns):\n");
     HistogramImpl combined;
     for (uint32_t i = 0; i < FLAGS_threads; i++) {
@@ -549,9 +582,22 @@ class CacheBench {
           cache_->Release(handle);
           handle = nullptr;
         }
+        bool scan = false;
+        if (FLAGS_scan_percent > 0 &&
+            FastRange64(thread->rnd.Next(), 100) < FLAGS_scan_percent) {
+          // Scanned keys come after all regular keys, and each thread scans
+          // its own range of them.
+          scan = true;
+          key = gen.Get(max_key_ + 1 + (uint64_t{thread->tid} << 40) +
+                        thread->next_scan_key++);
+        }
         // do lookup
         handle = cache_->Lookup(key, &helper2, create_cb, Cache::Priority::LOW,
                                 true);
+        if (!scan) {
+          thread->lookups++;
+          thread->hits += handle != nullptr;
+        }
         if (handle) {
           if (!FLAGS_lean) {
             // do something with the data
@@ -581,6 +627,8 @@ class CacheBench {
         // do lookup
         handle = cache_->Lookup(key, &helper2, create_cb, Cache::Priority::LOW,
                                 true);
+        thread->lookups++;
+        thread->hits += handle != nullptr;
         if (handle) {
           if (!FLAGS_lean) {
             // do something with the data
@@ -632,6 +680,9 @@ class CacheBench {
     printf("Insert percentage   : %u%%\n", FLAGS_insert_percent);
     printf("Lookup percentage   : %u%%\n", FLAGS_lookup_percent);
     printf("Erase percentage    : %u%%\n", FLAGS_erase_percent);
+    printf("Scan percentage     : %u%%\n", FLAGS_scan_percent);
+    printf("TinyLFU admission   : %d\n", int{FLAGS_tiny_lfu_admission});
+    printf("Lazy LRU updates    : %d\n", int{FLAGS_lazy_lru_updates});
     std::ostringstream stats;
     if (FLAGS_gather_stats) {
       stats << "enabled (" << FLAGS_gather_stats_sleep_ms << "ms, "
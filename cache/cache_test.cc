@@ -416,6 +416,43 @@ TEST_P(CacheTest, HitAndMiss) {
   ASSERT_EQ(101, deleted_values_[0]);
 }
 
+TEST_P(CacheTest, LookupMany) {
+  const int kNumKeys = 40;
+  for (int i = 0; i < kNumKeys; i += 2) {
+    Insert(i, i + 1000);
+  }
+
+  // More keys than the inline buffers hold, spread over all the shards, with
+  // a duplicate
+  std::vector<std::string> encoded_keys;
+  for (int i = kNumKeys - 1; i >= 0; i--) {
+    encoded_keys.push_back(EncodeKey(i));
+  }
+  encoded_keys.push_back(EncodeKey(0));
+  std::vector<Slice> keys(encoded_keys.begin(), encoded_keys.end());
+  std::vector<Cache::Handle*> handles(keys.size());
+  cache_->LookupMany(keys.data(), keys.size(), handles.data());
+
+  for (size_t i = 0; i < keys.size(); i++) {
+    const int key = DecodeKey(keys[i]);
+    if (key % 2 == 0) {
+      ASSERT_NE(nullptr, handles[i]);
+      ASSERT_EQ(key + 1000, DecodeValue(cache_->Value(handles[i])));
+    } else {
+      ASSERT_EQ(nullptr, handles[i]);
+    }
+  }
+  // Every hit holds a reference, and the duplicate shares its entry
+  ASSERT_EQ(static_cast<size_t>(kNumKeys / 2), cache_->GetPinnedUsage());
+  for (Cache::Handle* handle : handles) {
+    if (handle != nullptr) {
+      cache_->Release(handle);
+    }
+  }
+  ASSERT_EQ(0U, cache_->GetPinnedUsage());
+  ASSERT_EQ(1000, Lookup(0));
+}
+
 TEST_P(CacheTest, InsertSameKey) {
   Insert(1, 1);
   Insert(1, 2);
@@ -750,6 +787,40 @@ TEST_P(CacheTest, SetCapacity) {
   cache->DisownData();
 }
 
+TEST_P(CacheTest, IncrementalShrink) {
+  if (GetParam() == kFast) {
+    ROCKSDB_GTEST_BYPASS("FastLRUCache shrinks all at once.");
+    return;
+  }
+  // What the first entry freed by the shrink sees
+  static Cache* shrinking_cache;
+  static size_t usage_at_first_free;
+  static size_t capacity_at_first_free;
+  auto deleter = [](const Slice& /*key*/, void* /*value*/) {
+    if (usage_at_first_free == 0) {
+      usage_at_first_free = shrinking_cache->GetUsage();
+      capacity_at_first_free = shrinking_cache->GetCapacity();
+    }
+  };
+
+  std::shared_ptr<Cache> cache = NewCache(kCacheSize, 0, false);
+  shrinking_cache = cache.get();
+  usage_at_first_free = 0;
+  const int kNumEntries = 500;
+  for (int i = 0; i < kNumEntries; i++) {
+    ASSERT_OK(cache->Insert(EncodeKey(i), EncodeValue(i), 1, deleter));
+  }
+  ASSERT_EQ(static_cast<size_t>(kNumEntries), cache->GetUsage());
+
+  // Entries are freed, and the capacity reported, long before the shrink
+  // completes
+  cache->SetCapacity(100);
+  ASSERT_GT(usage_at_first_free, 100U);
+  ASSERT_EQ(100U, capacity_at_first_free);
+  ASSERT_EQ(100U, cache->GetCapacity());
+  ASSERT_LE(cache->GetUsage(), 100U);
+}
+
 TEST_P(LRUCacheTest, SetStrictCapacityLimit) {
   auto type = GetParam();
   if (type == kFast) {
@@ -981,6 +1052,60 @@ TEST_P(CacheTest, DefaultShardBits) {
   ASSERT_EQ(6, sc->GetNumShardBits());
 }
 
+TEST_P(CacheTest, TinyLfuAdmission) {
+  std::shared_ptr<Cache> cache;
+  const int kCapacity = 100;
+  if (GetParam() == kLRU) {
+    LRUCacheOptions co;
+    co.capacity = kCapacity;
+    co.num_shard_bits = 0;
+    co.high_pri_pool_ratio = 0;
+    co.metadata_charge_policy = kDontChargeCacheMetadata;
+    co.use_tiny_lfu_admission = true;
+    cache = NewLRUCache(co);
+  } else if (GetParam() == kClock) {
+    cache = ExperimentalNewClockCache(
+        kCapacity, 1 /*estimated_value_size*/, 0 /*num_shard_bits*/,
+        false /*strict_capacity_limit*/, kDontChargeCacheMetadata,
+        true /*use_tiny_lfu_admission*/);
+  } else {
+    ROCKSDB_GTEST_BYPASS("FastLRUCache does not support TinyLFU admission");
+    return;
+  }
+
+  auto read = [&](int key) {
+    if (Lookup(cache, key) == -1) {
+      Insert(cache, key, key);
+    }
+  };
+  // A working set that fills the cache and is read repeatedly
+  for (int round = 0; round < 6; round++) {
+    for (int key = 0; key < kCapacity; key++) {
+      read(key);
+    }
+  }
+  // A scan over twice as many keys, each read once
+  for (int key = kCapacity; key < 3 * kCapacity; key++) {
+    read(key);
+  }
+
+  int num_hits = 0;
+  for (int key = 0; key < kCapacity; key++) {
+    num_hits += Lookup(cache, key) == key;
+  }
+  ASSERT_GE(num_hits, kCapacity * 9 / 10);
+
+  // A value handed out despite not being admitted stays usable until
+  // released.
+  Cache::Handle* handle = nullptr;
+  ASSERT_OK(cache->Insert(EncodeKey(10 * kCapacity), EncodeValue(42), 1,
+                          &CacheTest::Deleter, &handle));
+  ASSERT_NE(nullptr, handle);
+  ASSERT_EQ(42, DecodeValue(cache->Value(handle)));
+  cache->Release(handle);
+  ASSERT_LE(cache->GetUsage(), static_cast<size_t>(kCapacity));
+}
+
 TEST_P(CacheTest, GetChargeAndDeleter) {
   Insert(1, 2);
   Cache::Handle* h1 = cache_->Lookup(EncodeKey(1));
@@ -991,8 +1116,8 @@ TEST_P(CacheTest, GetChargeAndDeleter) {
 }
 
 std::shared_ptr<Cache> (*new_clock_cache_func)(size_t, size_t, int, bool,
-                                               CacheMetadataChargePolicy) =
-    ExperimentalNewClockCache;
+                                               CacheMetadataChargePolicy,
+                                               bool) = ExperimentalNewClockCache;
 INSTANTIATE_TEST_CASE_P(CacheTestInstance, CacheTest,
                         testing::Values(kLRU, kClock, kFast));
 INSTANTIATE_TEST_CASE_P(CacheTestInstance, LRUCacheTest,
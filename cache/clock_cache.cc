@@ -9,6 +9,7 @@
 
 #include "cache/clock_cache.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
@@ -351,19 +352,50 @@ void ClockHandleTable::ClockRun(size_t charge) {
         h->ReleaseExclusiveRef();
       }
     }
+    if (deleted.size() >= kMaxDeletedPerFree) {
+      // Free as we go, so that a large shrink releases memory and usage
+      // progressively instead of all at the end.
+      Free(&deleted);
+      deleted.clear();
+    }
   }
 
   Free(&deleted);
 }
 
+bool ClockHandleTable::PeekVictim(uint32_t* hash) {
+  // Enough to find an element with high probability at the usual load
+  // factors.
+  static constexpr uint32_t kMaxSteps = 64;
+  uint32_t clock_pointer_local = clock_pointer_;
+  for (uint32_t i = 0; i < std::min(kMaxSteps, GetTableSize()); i++) {
+    ClockHandle* h = &array_[ModTableSize(clock_pointer_local + i)];
+    if (h->TryInternalRef()) {
+      bool found = h->IsElement() && h->ExternalRefs() == 0;
+      if (found) {
+        *hash = h->hash;
+      }
+      h->ReleaseInternalRef();
+      if (found) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 ClockCacheShard::ClockCacheShard(
     size_t capacity, size_t estimated_value_size, bool strict_capacity_limit,
-    CacheMetadataChargePolicy metadata_charge_policy)
+    CacheMetadataChargePolicy metadata_charge_policy,
+    bool use_tiny_lfu_admission)
     : strict_capacity_limit_(strict_capacity_limit),
       detached_usage_(0),
       table_(capacity, CalcHashBits(capacity, estimated_value_size,
                                     metadata_charge_policy)) {
   set_metadata_charge_policy(metadata_charge_policy);
+  if (use_tiny_lfu_admission) {
+    frequency_sketch_.reset(new FrequencySketch(table_.GetOccupancyLimit()));
+  }
 }
 
 void ClockCacheShard::EraseUnRefEntries() {
@@ -478,6 +510,25 @@ Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
   // Use a local copy to minimize cache synchronization.
   size_t detached_usage = detached_usage_;
 
+  uint32_t victim_hash = 0;
+  if (frequency_sketch_ != nullptr && priority != Cache::Priority::HIGH &&
+      !(strict_capacity_limit_ && handle != nullptr) &&
+      table_.GetUsage() + detached_usage + tmp.total_charge >
+          table_.GetCapacity() &&
+      table_.PeekVictim(&victim_hash) &&
+      !frequency_sketch_->Admit(hash, victim_hash)) {
+    // Not admitted. The old value, if any, must not outlive the insertion of
+    // a new one, and the new one only lives as long as the handle of the
+    // caller, if any.
+    Erase(key, hash);
+    if (handle == nullptr) {
+      tmp.FreeData();
+    } else {
+      *handle = reinterpret_cast<Cache::Handle*>(DetachedInsert(&tmp));
+    }
+    return s;
+  }
+
   // Free space with the clock policy until enough space is freed or there are
   // no evictable elements.
   table_.ClockRun(tmp.total_charge + detached_usage);
@@ -544,9 +595,28 @@ Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
 }
 
 Cache::Handle* ClockCacheShard::Lookup(const Slice& key, uint32_t hash) {
+  if (frequency_sketch_ != nullptr) {
+    frequency_sketch_->Increment(hash);
+  }
   return reinterpret_cast<Cache::Handle*>(table_.Lookup(key, hash));
 }
 
+void ClockCacheShard::LookupMany(const Slice* keys, const uint32_t* hashes,
+                                 const size_t* indices, size_t num_indices,
+                                 const Cache::CacheItemHelper* /*helper*/,
+                                 const Cache::CreateCallback& /*create_cb*/,
+                                 Cache::Priority /*priority*/, bool /*wait*/,
+                                 Statistics* /*stats*/,
+                                 Cache::Handle** handles) {
+  for (size_t i = 0; i < num_indices; i++) {
+    table_.Prefetch(keys[indices[i]]);
+  }
+  for (size_t i = 0; i < num_indices; i++) {
+    const size_t idx = indices[i];
+    handles[idx] = Lookup(keys[idx], hashes[idx]);
+  }
+}
+
 bool ClockCacheShard::Ref(Cache::Handle* h) {
   ClockHandle* e = reinterpret_cast<ClockHandle*>(h);
   assert(e->ExternalRefs() > 0);
@@ -629,7 +699,8 @@ size_t ClockCacheShard::GetPinnedUsage() const {
 
 ClockCache::ClockCache(size_t capacity, size_t estimated_value_size,
                        int num_shard_bits, bool strict_capacity_limit,
-                       CacheMetadataChargePolicy metadata_charge_policy)
+                       CacheMetadataChargePolicy metadata_charge_policy,
+                       bool use_tiny_lfu_admission)
     : ShardedCache(capacity, num_shard_bits, strict_capacity_limit),
       num_shards_(1 << num_shard_bits) {
   assert(estimated_value_size > 0 ||
@@ -640,7 +711,7 @@ ClockCache::ClockCache(size_t capacity, size_t estimated_value_size,
   for (int i = 0; i < num_shards_; i++) {
     new (&shards_[i])
         ClockCacheShard(per_shard, estimated_value_size, strict_capacity_limit,
-                        metadata_charge_policy);
+                        metadata_charge_policy, use_tiny_lfu_admission);
   }
 }
 
@@ -706,7 +777,8 @@ std::shared_ptr<Cache> NewClockCache(
 std::shared_ptr<Cache> ExperimentalNewClockCache(
     size_t capacity, size_t estimated_value_size, int num_shard_bits,
     bool strict_capacity_limit,
-    CacheMetadataChargePolicy metadata_charge_policy) {
+    CacheMetadataChargePolicy metadata_charge_policy,
+    bool use_tiny_lfu_admission) {
   if (num_shard_bits >= 20) {
     return nullptr;  // The cache cannot be sharded into too many fine pieces.
   }
@@ -715,7 +787,7 @@ std::shared_ptr<Cache> ExperimentalNewClockCache(
   }
   return std::make_shared<clock_cache::ClockCache>(
       capacity, estimated_value_size, num_shard_bits, strict_capacity_limit,
-      metadata_charge_policy);
+      metadata_charge_policy, use_tiny_lfu_admission);
 }
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -18,6 +18,7 @@
 #include <string>
 
 #include "cache/cache_key.h"
+#include "cache/frequency_sketch.h"
 #include "cache/sharded_cache.h"
 #include "port/lang.h"
 #include "port/malloc.h"
@@ -186,6 +187,9 @@ constexpr double kStrictLoadFactor = 0.7;
 // What's the best way to bound the spinning?
 constexpr uint32_t kSpinsPerTry = 100000;
 
+// Maximum number of evicted handles ClockRun holds before freeing them.
+constexpr size_t kMaxDeletedPerFree = 64;
+
 // Arbitrary seeds.
 constexpr uint32_t kProbingSeed1 = 0xbc9f1d34;
 constexpr uint32_t kProbingSeed2 = 0x7a2bb9d5;
@@ -527,6 +531,13 @@ class ClockHandleTable {
   // internal reference is handed over.
   ClockHandle* Lookup(const Slice& key, uint32_t hash);
 
+  // Starts loading the first slot of the key's probe sequence into the CPU
+  // cache.
+  void Prefetch(const Slice& key) {
+    PREFETCH(&array_[ModTableSize(Hash(key.data(), key.size(), kProbingSeed1))],
+             0 /* rw */, 3 /* locality */);
+  }
+
   // Inserts a copy of h into the hash table. Returns a pointer to the
   // inserted handle, or nullptr if no available slot was found. Every
   // existing visible handle matching the key is already present in the
@@ -548,6 +559,11 @@ class ClockHandleTable {
   // capacity_.
   void ClockRun(size_t charge);
 
+  // Looks for the first evictable element at or after the clock pointer,
+  // which approximates the next victim of the clock algorithm. If one is
+  // found among the next few slots, returns true and its hash in *hash.
+  bool PeekVictim(uint32_t* hash);
+
   // Remove h from the hash table. Requires an exclusive ref to h.
   void Remove(ClockHandle* h, autovector<ClockHandle>* deleted);
 
@@ -701,7 +717,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShard {
  public:
   ClockCacheShard(size_t capacity, size_t estimated_value_size,
                   bool strict_capacity_limit,
-                  CacheMetadataChargePolicy metadata_charge_policy);
+                  CacheMetadataChargePolicy metadata_charge_policy,
+                  bool use_tiny_lfu_admission = false);
   ~ClockCacheShard() override = default;
 
   // Separate from constructor so caller can easily make an array of ClockCache
@@ -737,6 +754,15 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShard {
 
   Cache::Handle* Lookup(const Slice& key, uint32_t hash) override;
 
+  // Lookups take no lock, so this only overlaps the memory latencies of the
+  // first probes.
+  void LookupMany(const Slice* keys, const uint32_t* hashes,
+                  const size_t* indices, size_t num_indices,
+                  const Cache::CacheItemHelper* /*helper*/,
+                  const Cache::CreateCallback& /*create_cb*/,
+                  Cache::Priority /*priority*/, bool /*wait*/,
+                  Statistics* /*stats*/, Cache::Handle** handles) override;
+
   bool Release(Cache::Handle* handle, bool /*useful*/,
                bool erase_if_last_ref) override {
     return Release(handle, erase_if_last_ref);
@@ -788,6 +814,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShard {
   std::atomic<size_t> detached_usage_;
 
   ClockHandleTable table_;
+
+  // Recent lookup frequencies for TinyLFU admission, if enabled.
+  std::unique_ptr<FrequencySketch> frequency_sketch_;
 };  // class ClockCacheShard
 
 class ClockCache
@@ -799,7 +828,8 @@ class ClockCache
   ClockCache(size_t capacity, size_t estimated_value_size, int num_shard_bits,
              bool strict_capacity_limit,
              CacheMetadataChargePolicy metadata_charge_policy =
-                 kDontChargeCacheMetadata);
+                 kDontChargeCacheMetadata,
+             bool use_tiny_lfu_admission = false);
 
   ~ClockCache() override;
 
@@ -832,6 +862,7 @@ class ClockCache
 extern std::shared_ptr<Cache> ExperimentalNewClockCache(
     size_t capacity, size_t estimated_value_size, int num_shard_bits,
     bool strict_capacity_limit,
-    CacheMetadataChargePolicy metadata_charge_policy);
+    CacheMetadataChargePolicy metadata_charge_policy,
+    bool use_tiny_lfu_admission = false);
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -9,8 +9,10 @@
 #include <cstdint>
 #include <memory>
 
+#include "cache/cache_entry_roles.h"
 #include "memory/memory_allocator.h"
 #include "util/compression.h"
+#include "util/mutexlock.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -20,11 +22,15 @@ CompressedSecondaryCache::CompressedSecondaryCache(
     double high_pri_pool_ratio, double low_pri_pool_ratio,
     std::shared_ptr<MemoryAllocator> memory_allocator, bool use_adaptive_mutex,
     CacheMetadataChargePolicy metadata_charge_policy,
-    CompressionType compression_type, uint32_t compress_format_version)
+    CompressionType compression_type, uint32_t compress_format_version,
+    double max_compressed_size_ratio,
+    const std::map<CacheEntryRole, CompressionType>& compression_type_overrides)
     : cache_options_(capacity, num_shard_bits, strict_capacity_limit,
                      high_pri_pool_ratio, low_pri_pool_ratio, memory_allocator,
                      use_adaptive_mutex, metadata_charge_policy,
                      compression_type, compress_format_version) {
+  cache_options_.max_compressed_size_ratio = max_compressed_size_ratio;
+  cache_options_.compression_type_overrides = compression_type_overrides;
   cache_ =
       NewLRUCache(capacity, num_shard_bits, strict_capacity_limit,
                   high_pri_pool_ratio, memory_allocator, use_adaptive_mutex,
@@ -50,23 +56,28 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   }
 
   CacheAllocationPtr* ptr = reinterpret_cast<CacheAllocationPtr*>(handle_value);
+  // The first byte is the compression type of the rest of the value
+  const char* data = ptr->get() + 1;
+  const size_t data_size = cache_->GetCharge(lru_handle) - 1;
+  const CompressionType compression_type =
+      static_cast<CompressionType>(ptr->get()[0]);
 
   Status s;
   void* value{nullptr};
   size_t charge{0};
-  if (cache_options_.compression_type == kNoCompression) {
-    s = create_cb(ptr->get(), cache_->GetCharge(lru_handle), &value, &charge);
+  if (compression_type == kNoCompression) {
+    s = create_cb(data, data_size, &value, &charge);
   } else {
-    UncompressionContext uncompression_context(cache_options_.compression_type);
+    UncompressionContext uncompression_context(compression_type);
     UncompressionInfo uncompression_info(uncompression_context,
                                          UncompressionDict::GetEmptyDict(),
-                                         cache_options_.compression_type);
+                                         compression_type);
 
     size_t uncompressed_size{0};
-    CacheAllocationPtr uncompressed = UncompressData(
-        uncompression_info, (char*)ptr->get(), cache_->GetCharge(lru_handle),
-        &uncompressed_size, cache_options_.compress_format_version,
-        cache_options_.memory_allocator.get());
+    CacheAllocationPtr uncompressed =
+        UncompressData(uncompression_info, data, data_size, &uncompressed_size,
+                       cache_options_.compress_format_version,
+                       cache_options_.memory_allocator.get());
 
     if (!uncompressed) {
       cache_->Release(lru_handle, /*erase_if_last_ref=*/true);
@@ -108,25 +119,27 @@ Status CompressedSecondaryCache::Insert(const Slice& key, void* value,
     cache_->Release(lru_handle, /*erase_if_last_ref=*/false);
   }
 
+  // The value is stored after a byte holding its compression type.
   size_t size = (*helper->size_cb)(value);
   CacheAllocationPtr ptr =
-      AllocateBlock(size, cache_options_.memory_allocator.get());
+      AllocateBlock(size + 1, cache_options_.memory_allocator.get());
 
-  Status s = (*helper->saveto_cb)(value, 0, size, ptr.get());
+  Status s = (*helper->saveto_cb)(value, 0, size, ptr.get() + 1);
   if (!s.ok()) {
     return s;
   }
-  Slice val(ptr.get(), size);
+  Slice val(ptr.get() + 1, size);
 
-  std::string compressed_val;
-  if (cache_options_.compression_type != kNoCompression) {
+  CompressionType compression_type = GetCompressionType(helper->del_cb);
+  if (compression_type != kNoCompression) {
     CompressionOptions compression_opts;
-    CompressionContext compression_context(cache_options_.compression_type);
+    CompressionContext compression_context(compression_type);
     uint64_t sample_for_compression{0};
     CompressionInfo compression_info(
         compression_opts, compression_context, CompressionDict::GetEmptyDict(),
-        cache_options_.compression_type, sample_for_compression);
+        compression_type, sample_for_compression);
 
+    std::string compressed_val;
     bool success =
         CompressData(val, compression_info,
                      cache_options_.compress_format_version, &compressed_val);
@@ -135,15 +148,87 @@ Status CompressedSecondaryCache::Insert(const Slice& key, void* value,
       return Status::Corruption("Error compressing value.");
     }
 
-    val = Slice(compressed_val);
-    size = compressed_val.size();
-    ptr = AllocateBlock(size, cache_options_.memory_allocator.get());
-    memcpy(ptr.get(), compressed_val.data(), size);
+    if (compressed_val.size() >
+        static_cast<size_t>(size * cache_options_.max_compressed_size_ratio)) {
+      // Not worth decompressing on lookups
+      compression_type = kNoCompression;
+    } else {
+      size = compressed_val.size();
+      ptr = AllocateBlock(size + 1, cache_options_.memory_allocator.get());
+      memcpy(ptr.get() + 1, compressed_val.data(), size);
+    }
   }
+  ptr.get()[0] = static_cast<char>(compression_type);
 
   CacheAllocationPtr* buf = new CacheAllocationPtr(std::move(ptr));
 
-  return cache_->Insert(key, buf, size, DeletionCallback);
+  return cache_->Insert(key, buf, size + 1, DeletionCallback);
+}
+
+CompressionType CompressedSecondaryCache::GetCompressionType(
+    Cache::DeleterFn deleter) {
+  const auto& overrides = cache_options_.compression_type_overrides;
+  if (overrides.empty()) {
+    return cache_options_.compression_type;
+  }
+  CacheEntryRole role = CacheEntryRole::kMisc;
+  bool found = false;
+  if (deleter != nullptr) {
+    const size_t start =
+        static_cast<size_t>(reinterpret_cast<uintptr_t>(deleter) >> 4);
+    for (size_t i = 0; i < kNumRoleSlots; ++i) {
+      const RoleSlot& slot = role_slots_[(start + i) % kNumRoleSlots];
+      Cache::DeleterFn slot_deleter =
+          slot.deleter.load(std::memory_order_acquire);
+      if (slot_deleter == deleter) {
+        role = slot.role.load(std::memory_order_relaxed);
+        found = true;
+        break;
+      }
+      if (slot_deleter == nullptr) {
+        break;
+      }
+    }
+    if (!found) {
+      role = LookupAndCacheRole(deleter);
+    }
+  }
+  auto override_it = overrides.find(role);
+  return override_it != overrides.end() ? override_it->second
+                                        : cache_options_.compression_type;
+}
+
+CacheEntryRole CompressedSecondaryCache::LookupAndCacheRole(
+    Cache::DeleterFn deleter) {
+  MutexLock l(&role_map_mutex_);
+  auto it = role_map_.find(deleter);
+  if (it == role_map_.end()) {
+    // Deleters are registered on first use, so the copy may be stale
+    role_map_ = CopyCacheDeleterRoleMap();
+    it = role_map_.find(deleter);
+    if (it == role_map_.end()) {
+      it = role_map_.emplace(deleter, CacheEntryRole::kMisc).first;
+    }
+  }
+  const CacheEntryRole role = it->second;
+  // Another thread may have cached it since the lookup. If the table is
+  // full, later lookups of this deleter keep taking the mutex.
+  const size_t start =
+      static_cast<size_t>(reinterpret_cast<uintptr_t>(deleter) >> 4);
+  for (size_t i = 0; i < kNumRoleSlots; ++i) {
+    RoleSlot& slot = role_slots_[(start + i) % kNumRoleSlots];
+    Cache::DeleterFn slot_deleter =
+        slot.deleter.load(std::memory_order_relaxed);
+    if (slot_deleter == deleter) {
+      break;
+    }
+    if (slot_deleter == nullptr) {
+      slot.role.store(role, std::memory_order_relaxed);
+      slot.deleter.store(deleter, std::memory_order_release);
+      break;
+    }
+  }
+  return role;
 }
 
 void CompressedSecondaryCache::Erase(const Slice& key) { cache_->Erase(key); }
@@ -160,6 +245,15 @@ std::string CompressedSecondaryCache::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "    compress_format_version : %d\n",
            cache_options_.compress_format_version);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    max_compressed_size_ratio : %.3lf\n",
+           cache_options_.max_compressed_size_ratio);
+  ret.append(buffer);
+  for (const auto& role_and_type : cache_options_.compression_type_overrides) {
+    snprintf(buffer, kBufferSize, "    compression_type[%s] : %s\n",
+             GetCacheEntryRoleName(role_and_type.first).c_str(),
+             CompressionTypeToString(role_and_type.second).c_str());
+    ret.append(buffer);
+  }
   return ret;
 }
 
@@ -255,11 +349,12 @@ std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
     const CompressedSecondaryCacheOptions& opts) {
   // The secondary_cache is disabled for this LRUCache instance.
   assert(opts.secondary_cache == nullptr);
-  return NewCompressedSecondaryCache(
+  return std::make_shared<CompressedSecondaryCache>(
       opts.capacity, opts.num_shard_bits, opts.strict_capacity_limit,
       opts.high_pri_pool_ratio, opts.low_pri_pool_ratio, opts.memory_allocator,
       opts.use_adaptive_mutex, opts.metadata_charge_policy,
-      opts.compression_type, opts.compress_format_version);
+      opts.compression_type, opts.compress_format_version,
+      opts.max_compressed_size_ratio, opts.compression_type_overrides);
 }
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -6,7 +6,9 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
+#include <map>
 #include <memory>
 
 #include "cache/lru_cache.h"
@@ -15,6 +17,7 @@
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
 #include "util/compression.h"
+#include "util/hash_containers.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -76,7 +79,11 @@ class CompressedSecondaryCache : public SecondaryCache {
       CacheMetadataChargePolicy metadata_charge_policy =
           kDefaultCacheMetadataChargePolicy,
       CompressionType compression_type = CompressionType::kLZ4Compression,
-      uint32_t compress_format_version = 2);
+      uint32_t compress_format_version = 2,
+      double max_compressed_size_ratio = 0.875,
+      const std::map<CacheEntryRole, CompressionType>&
+          compression_type_overrides = {
+              {CacheEntryRole::kFilterBlock, CompressionType::kNoCompression}});
   virtual ~CompressedSecondaryCache() override;
 
   const char* Name() const override { return "CompressedSecondaryCache"; }
@@ -125,10 +132,34 @@ class CompressedSecondaryCache : public SecondaryCache {
   CacheAllocationPtr MergeChunksIntoValue(const void* chunks_head,
                                           size_t& charge);
 
+  // Returns the compression type for a block whose primary cache entry has
+  // the given deleter.
+  CompressionType GetCompressionType(Cache::DeleterFn deleter);
+
   // An implementation of Cache::DeleterFn.
   static void DeletionCallback(const Slice& /*key*/, void* obj);
   std::shared_ptr<Cache> cache_;
   CompressedSecondaryCacheOptions cache_options_;
+
+  // Returns the role registered for `deleter` in cache/cache_entry_roles.h,
+  // and caches it in role_slots_.
+  CacheEntryRole LookupAndCacheRole(Cache::DeleterFn deleter);
+
+  // The roles of the deleters seen so far, in an open addressing table read
+  // without locking. A slot is written once, under role_map_mutex_, with its
+  // role stored before its deleter is published, so a reader finding its
+  // deleter in a slot also finds the role.
+  static constexpr size_t kNumRoleSlots = 64;
+  struct RoleSlot {
+    std::atomic<Cache::DeleterFn> deleter{nullptr};
+    std::atomic<CacheEntryRole> role{CacheEntryRole::kMisc};
+  };
+  std::array<RoleSlot, kNumRoleSlots> role_slots_;
+
+  // Copy of the registrations in cache/cache_entry_roles.h, refreshed when a
+  // deleter is not found in it.
+  port::Mutex role_map_mutex_;
+  UnorderedMap<Cache::DeleterFn, CacheEntryRole> role_map_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -9,9 +9,11 @@
 #include <cstdint>
 #include <iterator>
 
+#include "cache/cache_entry_roles.h"
 #include "cache/lru_cache.h"
 #include "memory/jemalloc_nodump_allocator.h"
 #include "memory/memory_allocator.h"
+#include "port/port.h"
 #include "rocksdb/compression_type.h"
 #include "rocksdb/convenience.h"
 #include "rocksdb/secondary_cache.h"
@@ -728,6 +730,114 @@ class CompressedSecondaryCacheTest : public testing::Test {
     }
   }
 
+  void CompressionTypeByRatioAndRoleTest() {
+    if (!LZ4_Supported()) {
+      ROCKSDB_GTEST_SKIP("This test requires LZ4 support.");
+      return;
+    }
+    CompressedSecondaryCacheOptions opts;
+    opts.capacity = 100000;
+    opts.num_shard_bits = 0;
+    opts.metadata_charge_policy = kDontChargeCacheMetadata;
+    std::shared_ptr<SecondaryCache> sec_cache =
+        NewCompressedSecondaryCache(opts);
+    Cache* cache =
+        static_cast<CompressedSecondaryCache*>(sec_cache.get())->cache_.get();
+
+    Random rnd(301);
+    std::string compressible_str(1000, 'a');
+    std::string random_str = rnd.RandomString(1000);
+    TestItem compressible_item(compressible_str.data(),
+                               compressible_str.length());
+    TestItem random_item(random_str.data(), random_str.length());
+    Cache::CacheItemHelper filter_helper(
+        SizeCallback, SaveToCallback,
+        GetCacheEntryDeleterForRole<TestItem, CacheEntryRole::kFilterBlock>());
+
+    auto insert_twice = [&](const Slice& key, TestItem* item,
+                            const Cache::CacheItemHelper* helper) {
+      // The first insert only leaves a dummy entry
+      ASSERT_OK(sec_cache->Insert(key, item, helper));
+      ASSERT_OK(sec_cache->Insert(key, item, helper));
+    };
+    auto lookup = [&](const Slice& key, TestItem* item) {
+      bool is_in_sec_cache{false};
+      std::unique_ptr<SecondaryCacheResultHandle> handle =
+          sec_cache->Lookup(key, test_item_creator, true,
+                            /*advise_erase=*/false, is_in_sec_cache);
+      ASSERT_NE(handle, nullptr);
+      std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+      ASSERT_EQ(val->Size(), item->Size());
+      ASSERT_EQ(memcmp(val->Buf(), item->Buf(), item->Size()), 0);
+    };
+
+    // Compressible blocks are compressed
+    insert_twice("k1", &compressible_item, &helper_);
+    size_t usage = cache->GetUsage();
+    ASSERT_LT(usage, compressible_str.size() / 2);
+    lookup("k1", &compressible_item);
+
+    // Blocks that hardly compress are stored as they are, after a byte
+    // holding their compression type
+    insert_twice("k2", &random_item, &helper_);
+    ASSERT_EQ(cache->GetUsage(), usage + random_str.size() + 1);
+    usage = cache->GetUsage();
+    lookup("k2", &random_item);
+
+    // So are filter blocks
+    insert_twice("k3", &compressible_item, &filter_helper);
+    ASSERT_EQ(cache->GetUsage(), usage + compressible_str.size() + 1);
+    lookup("k3", &compressible_item);
+  }
+
+  void ConcurrentCompressionTypeByRoleTest() {
+    if (!LZ4_Supported()) {
+      ROCKSDB_GTEST_SKIP("This test requires LZ4 support.");
+      return;
+    }
+    CompressedSecondaryCacheOptions opts;
+    opts.capacity = 10000000;
+    opts.num_shard_bits = 2;
+    opts.metadata_charge_policy = kDontChargeCacheMetadata;
+    std::shared_ptr<SecondaryCache> sec_cache =
+        NewCompressedSecondaryCache(opts);
+    Cache* cache =
+        static_cast<CompressedSecondaryCache*>(sec_cache.get())->cache_.get();
+
+    std::string str(1000, 'a');
+    TestItem item(str.data(), str.length());
+    Cache::CacheItemHelper filter_helper(
+        SizeCallback, SaveToCallback,
+        GetCacheEntryDeleterForRole<TestItem, CacheEntryRole::kFilterBlock>());
+    // The first insert only leaves a dummy entry
+    ASSERT_OK(sec_cache->Insert("size", &item, &helper_));
+    ASSERT_OK(sec_cache->Insert("size", &item, &helper_));
+    const size_t compressed_size = cache->GetUsage();
+    ASSERT_LT(compressed_size, str.size() / 2);
+
+    // Threads inserting blocks of several roles all find their roles
+    constexpr int kNumThreads = 4;
+    constexpr int kNumKeys = 200;
+    std::vector<port::Thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back([&, t]() {
+        for (int i = 0; i < kNumKeys; ++i) {
+          const std::string key = std::to_string(t) + "_" + std::to_string(i);
+          const Cache::CacheItemHelper* helper =
+              i % 2 == 0 ? &filter_helper : &helper_;
+          ASSERT_OK(sec_cache->Insert(key, &item, helper));
+          ASSERT_OK(sec_cache->Insert(key, &item, helper));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    const size_t num_pairs = kNumThreads * kNumKeys / 2;
+    ASSERT_EQ(cache->GetUsage(),
+              compressed_size + num_pairs * (str.size() + 1 + compressed_size));
+  }
+
  private:
   bool fail_create_;
 };
@@ -848,6 +958,14 @@ TEST_F(CompressedSecondaryCacheTest,
   IntegrationFullCapacityTest(true);
 }
 
+TEST_F(CompressedSecondaryCacheTest, CompressionTypeByRatioAndRole) {
+  CompressionTypeByRatioAndRoleTest();
+}
+
+TEST_F(CompressedSecondaryCacheTest, ConcurrentCompressionTypeByRole) {
+  ConcurrentCompressionTypeByRoleTest();
+}
+
 TEST_F(CompressedSecondaryCacheTest, SplitValueIntoChunksTest) {
   SplitValueIntoChunksTest();
 }
@@ -0,0 +1,128 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A count-min sketch of 4-bit counters estimating how often each cache key
+// was accessed recently, for TinyLFU admission: when a new entry can only be
+// inserted by evicting another one, it is only admitted if it is estimated
+// to have been accessed more often than the victim. Once the number of
+// recorded accesses reaches about ten times the expected number of entries,
+// all counters are halved, so that old popularity fades away.
+//
+// Counters are updated with relaxed loads and stores, so concurrent updates
+// may be lost. That only makes the estimates a bit less accurate, and saves
+// lock-free callers from contending on atomic read-modify-write operations.
+// Resize() is not thread-safe.
+class FrequencySketch {
+ public:
+  explicit FrequencySketch(size_t expected_entries) {
+    Resize(expected_entries);
+  }
+
+  // Discards all counts and sizes the sketch for about `expected_entries`
+  // distinct keys.
+  void Resize(size_t expected_entries) {
+    size_t num_words = 8;
+    while (num_words < expected_entries) {
+      num_words <<= 1;
+    }
+    table_.reset(new std::atomic<uint64_t>[num_words]);
+    for (size_t i = 0; i < num_words; i++) {
+      table_[i].store(0, std::memory_order_relaxed);
+    }
+    table_mask_ = num_words - 1;
+    expected_entries_ = expected_entries;
+    sample_size_ = 10 * static_cast<uint64_t>(num_words);
+    additions_.store(0, std::memory_order_relaxed);
+  }
+
+  size_t GetExpectedEntries() const { return expected_entries_; }
+
+  // Records an access to the key with the given hash.
+  void Increment(uint32_t hash) {
+    bool added = false;
+    for (int i = 0; i < kNumHashes; i++) {
+      std::atomic<uint64_t>& word = table_[WordIndex(hash, i)];
+      const int shift = CounterShift(hash, i);
+      const uint64_t w = word.load(std::memory_order_relaxed);
+      if (((w >> shift) & kCounterMask) < kCounterMask) {
+        word.store(w + (uint64_t{1} << shift), std::memory_order_relaxed);
+        added = true;
+      }
+    }
+    if (added && additions_.fetch_add(1, std::memory_order_relaxed) + 1 ==
+                     sample_size_) {
+      Age();
+    }
+  }
+
+  // Returns the estimated number of recent accesses to the key with the
+  // given hash, between 0 and 15.
+  uint32_t Estimate(uint32_t hash) const {
+    uint64_t estimate = kCounterMask;
+    for (int i = 0; i < kNumHashes; i++) {
+      const uint64_t w =
+          table_[WordIndex(hash, i)].load(std::memory_order_relaxed);
+      const uint64_t count = (w >> CounterShift(hash, i)) & kCounterMask;
+      if (count < estimate) {
+        estimate = count;
+      }
+    }
+    return static_cast<uint32_t>(estimate);
+  }
+
+  // Whether an entry with hash `candidate_hash` should replace one with hash
+  // `victim_hash`.
+  bool Admit(uint32_t candidate_hash, uint32_t victim_hash) const {
+    return Estimate(candidate_hash) > Estimate(victim_hash);
+  }
+
+ private:
+  static constexpr int kNumHashes = 4;
+  static constexpr uint64_t kCounterMask = 0xf;
+
+  static uint64_t Remix(uint32_t hash, int i) {
+    static constexpr uint64_t kSeeds[kNumHashes] = {
+        0x9e3779b97f4a7c15, 0xc2b2ae3d27d4eb4f, 0x165667b19e3779f9,
+        0xd6e8feb86659fd93};
+    return (uint64_t{hash} + 1) * kSeeds[i];
+  }
+
+  size_t WordIndex(uint32_t hash, int i) const {
+    return static_cast<size_t>(Remix(hash, i) >> 32) & table_mask_;
+  }
+
+  static int CounterShift(uint32_t hash, int i) {
+    return static_cast<int>((Remix(hash, i) >> 28) & 0xf) << 2;
+  }
+
+  void Age() {
+    for (size_t i = 0; i <= table_mask_; i++) {
+      const uint64_t w = table_[i].load(std::memory_order_relaxed);
+      table_[i].store((w >> 1) & 0x7777777777777777,
+                      std::memory_order_relaxed);
+    }
+    additions_.fetch_sub(sample_size_ / 2, std::memory_order_relaxed);
+  }
+
+  // Each word holds 16 counters
+  std::unique_ptr<std::atomic<uint64_t>[]> table_;
+  size_t table_mask_ = 0;
+  size_t expected_entries_ = 0;
+  uint64_t sample_size_ = 0;
+  std::atomic<uint64_t> additions_{0};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
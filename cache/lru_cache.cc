@@ -9,15 +9,18 @@
 
 #include "cache/lru_cache.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 #include "monitoring/perf_context_imp.h"
 #include "monitoring/statistics.h"
 #include "port/lang.h"
 #include "util/distributed_mutex.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace lru_cache {
@@ -114,11 +117,15 @@ LRUCacheShard::LRUCacheShard(
     size_t capacity, bool strict_capacity_limit, double high_pri_pool_ratio,
     double low_pri_pool_ratio, bool use_adaptive_mutex,
     CacheMetadataChargePolicy metadata_charge_policy, int max_upper_hash_bits,
-    const std::shared_ptr<SecondaryCache>& secondary_cache)
+    const std::shared_ptr<SecondaryCache>& secondary_cache,
+    bool use_tiny_lfu_admission, bool use_lazy_lru_updates)
     : capacity_(0),
       high_pri_pool_usage_(0),
       low_pri_pool_usage_(0),
       strict_capacity_limit_(strict_capacity_limit),
+      // Entries looked up from the secondary cache are promoted under the
+      // assumption that referenced entries are not in the LRU list.
+      lazy_lru_updates_(use_lazy_lru_updates && secondary_cache == nullptr),
       high_pri_pool_ratio_(high_pri_pool_ratio),
       high_pri_pool_capacity_(0),
       low_pri_pool_ratio_(low_pri_pool_ratio),
@@ -134,23 +141,48 @@ LRUCacheShard::LRUCacheShard(
   lru_.prev = &lru_;
   lru_low_pri_ = &lru_;
   lru_bottom_pri_ = &lru_;
+  over_quota_lru_.next = &over_quota_lru_;
+  over_quota_lru_.prev = &over_quota_lru_;
+  if (use_tiny_lfu_admission) {
+    frequency_sketch_.reset(
+        new FrequencySketch(size_t{1} << table_.GetLengthBits()));
+  }
   SetCapacity(capacity);
 }
 
+LRUCacheShard::~LRUCacheShard() {
+  if (lazy_lru_updates_) {
+    // Drop the references of the cache, so that the table frees the entries.
+    table_.ApplyToEntriesRange([](LRUHandle* h) { h->Unref(); }, 0,
+                               uint32_t{1} << table_.GetLengthBits());
+  }
+}
+
 void LRUCacheShard::EraseUnRefEntries() {
   autovector<LRUHandle*> last_reference_list;
   {
     DMutexLock l(mutex_);
-    while (lru_.next != &lru_) {
-      LRUHandle* old = lru_.next;
-      // LRU list contains only elements which can be evicted.
-      assert(old->InCache() && !old->HasRefs());
-      LRU_Remove(old);
-      table_.Remove(old->key(), old->hash);
-      old->SetInCache(false);
-      assert(usage_ >= old->total_charge);
-      usage_ -= old->total_charge;
-      last_reference_list.push_back(old);
+    for (LRUHandle* list : {&lru_, &over_quota_lru_}) {
+      LRUHandle* old = list->next;
+      while (old != list) {
+        LRUHandle* next = old->next;
+        if (HasExternalRefs(old)) {
+          // Only with lazy LRU updates can the LRU list contain elements
+          // that can't be evicted.
+          assert(lazy_lru_updates_);
+          old = next;
+          continue;
+        }
+        LRU_Remove(old);
+        table_.Remove(old->key(), old->hash);
+        old->SetInCache(false);
+        old->refs.store(0, std::memory_order_relaxed);
+        assert(usage_ >= old->total_charge);
+        usage_ -= old->total_charge;
+        SubtractTenantUsage(old);
+        last_reference_list.push_back(old);
+        old = next;
+      }
     }
   }
 
@@ -163,6 +195,13 @@ void LRUCacheShard::ApplyToSomeEntries(
     const std::function<void(const Slice& key, void* value, size_t charge,
                              DeleterFn deleter)>& callback,
     uint32_t average_entries_per_lock, uint32_t* state) {
+  ApplyToSomeEntries(callback, average_entries_per_lock, state, kAllTenants);
+}
+
+void LRUCacheShard::ApplyToSomeEntries(
+    const std::function<void(const Slice& key, void* value, size_t charge,
+                             DeleterFn deleter)>& callback,
+    uint32_t average_entries_per_lock, uint32_t* state, uint32_t tenant) {
   // The state is essentially going to be the starting hash, which works
   // nicely even if we resize between calls because we use upper-most
   // hash bits for table indexes.
@@ -186,8 +225,11 @@ void LRUCacheShard::ApplyToSomeEntries(
   }
 
   table_.ApplyToEntriesRange(
-      [callback,
-       metadata_charge_policy = metadata_charge_policy_](LRUHandle* h) {
+      [callback, metadata_charge_policy = metadata_charge_policy_,
+       tenant](LRUHandle* h) {
+        if (tenant != kAllTenants && h->tenant != tenant) {
+          return;
+        }
         DeleterFn deleter = h->IsSecondaryCacheCompatible()
                                 ? h->info_.helper->del_cb
                                 : h->info_.deleter;
@@ -197,6 +239,18 @@ void LRUCacheShard::ApplyToSomeEntries(
       index_begin, index_end);
 }
 
+void LRUCacheShard::SetTenantShares(const std::vector<double>& shares) {
+  DMutexLock l(mutex_);
+  assert(shares.size() >= tenant_usage_.size());
+  tenant_shares_ = shares;
+  tenant_usage_.resize(shares.size(), 0);
+}
+
+size_t LRUCacheShard::GetTenantUsage(uint16_t tenant) const {
+  DMutexLock l(mutex_);
+  return tenant < tenant_usage_.size() ? tenant_usage_[tenant] : 0;
+}
+
 void LRUCacheShard::TEST_GetLRUList(LRUHandle** lru, LRUHandle** lru_low_pri,
                                     LRUHandle** lru_bottom_pri) {
   DMutexLock l(mutex_);
@@ -207,11 +261,13 @@ void LRUCacheShard::TEST_GetLRUList(LRUHandle** lru, LRUHandle** lru_low_pri,
 
 size_t LRUCacheShard::TEST_GetLRUSize() {
   DMutexLock l(mutex_);
-  LRUHandle* lru_handle = lru_.next;
   size_t lru_size = 0;
-  while (lru_handle != &lru_) {
-    lru_size++;
-    lru_handle = lru_handle->next;
+  for (LRUHandle* list : {&lru_, &over_quota_lru_}) {
+    LRUHandle* lru_handle = list->next;
+    while (lru_handle != list) {
+      lru_size++;
+      lru_handle = lru_handle->next;
+    }
   }
   return lru_size;
 }
@@ -253,7 +309,15 @@ void LRUCacheShard::LRU_Remove(LRUHandle* e) {
 void LRUCacheShard::LRU_Insert(LRUHandle* e) {
   assert(e->next == nullptr);
   assert(e->prev == nullptr);
-  if (high_pri_pool_ratio_ > 0 && (e->IsHighPri() || e->HasHit())) {
+  if (IsOverQuota(e)) {
+    // Insert "e" to head of over-quota LRU list.
+    e->next = &over_quota_lru_;
+    e->prev = over_quota_lru_.prev;
+    e->prev->next = e;
+    e->next->prev = e;
+    e->SetInHighPriPool(false);
+    e->SetInLowPriPool(false);
+  } else if (high_pri_pool_ratio_ > 0 && (e->IsHighPri() || e->HasHit())) {
     // Inset "e" to head of LRU list.
     e->next = &lru_;
     e->prev = lru_.prev;
@@ -315,19 +379,82 @@ void LRUCacheShard::MaintainPoolSize() {
   }
 }
 
+LRUHandle* LRUCacheShard::GetEvictionCandidate() {
+  LRUHandle* oldest = lru_.next;
+  if (over_quota_lru_.next != &over_quota_lru_ &&
+      (oldest == &lru_ ||
+       (oldest->tenant != kNoTenant && !IsOverQuota(oldest)))) {
+    return over_quota_lru_.next;
+  }
+  return oldest != &lru_ ? oldest : nullptr;
+}
+
+LRUHandle* LRUCacheShard::FindEvictable(size_t max_moved, size_t* moved) {
+  for (;;) {
+    LRUHandle* old = GetEvictionCandidate();
+    if (old == nullptr || !lazy_lru_updates_ ||
+        (!HasExternalRefs(old) && !old->IsRecentlyUsed())) {
+      return old;
+    }
+    if (*moved >= max_moved) {
+      return nullptr;
+    }
+    ++*moved;
+    // Catch up with the lookups of the entry, as if it had been moved when
+    // it was released. An entry with hits goes to the high-pri pool.
+    LRU_Remove(old);
+    old->SetRecentlyUsed(false);
+    LRU_Insert(old);
+  }
+}
+
 void LRUCacheShard::EvictFromLRU(size_t charge,
-                                 autovector<LRUHandle*>* deleted) {
-  while ((usage_ + charge) > capacity_ && lru_.next != &lru_) {
-    LRUHandle* old = lru_.next;
+                                 autovector<LRUHandle*>* deleted,
+                                 size_t max_evictions, size_t* moved) {
+  // Bounds the work when most entries are referenced. After moving all the
+  // entries once, the next candidate is no longer recently used.
+  const size_t max_moved = table_.GetOccupancyCount();
+  size_t num_moved = 0;
+  for (size_t evicted = 0; (usage_ + charge) > capacity_ &&
+                           evicted + num_moved < max_evictions;) {
+    LRUHandle* old = FindEvictable(
+        std::min<size_t>(max_moved, max_evictions - evicted), &num_moved);
+    if (old == nullptr) {
+      break;
+    }
     // LRU list contains only elements which can be evicted.
-    assert(old->InCache() && !old->HasRefs());
+    assert(!HasExternalRefs(old));
     LRU_Remove(old);
     table_.Remove(old->key(), old->hash);
     old->SetInCache(false);
+    old->refs.store(0, std::memory_order_relaxed);
     assert(usage_ >= old->total_charge);
     usage_ -= old->total_charge;
+    SubtractTenantUsage(old);
     deleted->push_back(old);
+    evicted++;
+  }
+  if (moved != nullptr) {
+    *moved = num_moved;
+  }
+}
+
+bool LRUCacheShard::IsAdmitted(LRUHandle* e, bool has_handle) {
+  if (frequency_sketch_ == nullptr || e->IsHighPri() ||
+      (usage_ + e->total_charge) <= capacity_ ||
+      (has_handle && strict_capacity_limit_)) {
+    return true;
+  }
+  // With lazy LRU updates, the victim is the entry that eviction would
+  // reach after moving the referenced and recently used ones to the head,
+  // which are moved now.
+  size_t moved = 0;
+  LRUHandle* victim = FindEvictable(table_.GetOccupancyCount(), &moved);
+  if (victim == nullptr || table_.Lookup(e->key(), e->hash) != nullptr) {
+    // The old value must not outlive the insertion of a new one.
+    return true;
   }
+  return frequency_sketch_->Admit(e->hash, victim->hash);
 }
 
 void LRUCacheShard::TryInsertIntoSecondaryCache(
@@ -344,16 +471,39 @@ void LRUCacheShard::TryInsertIntoSecondaryCache(
 }
 
 void LRUCacheShard::SetCapacity(size_t capacity) {
-  autovector<LRUHandle*> last_reference_list;
   {
     DMutexLock l(mutex_);
     capacity_ = capacity;
     high_pri_pool_capacity_ = capacity_ * high_pri_pool_ratio_;
     low_pri_pool_capacity_ = capacity_ * low_pri_pool_ratio_;
-    EvictFromLRU(0, &last_reference_list);
   }
 
-  TryInsertIntoSecondaryCache(last_reference_list);
+  // Shrink in bounded steps, releasing the mutex in between, so that
+  // lookups and inserts are not stalled behind a large shrink and the
+  // evicted entries are freed as it goes.
+  // With lazy LRU updates, the entries moved to the head of the LRU list
+  // count toward the step too, and the shrink stops once it moved as many
+  // entries as the shard held, like a single EvictFromLRU() call.
+  size_t max_moved;
+  {
+    DMutexLock l(mutex_);
+    max_moved = table_.GetOccupancyCount();
+  }
+  size_t total_moved = 0;
+  bool done = false;
+  while (!done) {
+    autovector<LRUHandle*> last_reference_list;
+    {
+      DMutexLock l(mutex_);
+      size_t moved = 0;
+      EvictFromLRU(0, &last_reference_list, kMaxEvictionsPerShrinkStep,
+                   &moved);
+      total_moved += moved;
+      done = last_reference_list.size() + moved < kMaxEvictionsPerShrinkStep ||
+             total_moved > max_moved;
+    }
+    TryInsertIntoSecondaryCache(last_reference_list);
+  }
 }
 
 void LRUCacheShard::SetStrictCapacityLimit(bool strict_capacity_limit) {
@@ -369,12 +519,24 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, Cache::Handle** handle,
   {
     DMutexLock l(mutex_);
 
-    // Free the space following strict LRU policy until enough space
-    // is freed or the lru list is empty.
-    EvictFromLRU(e->total_charge, &last_reference_list);
+    const bool admitted = IsAdmitted(e, handle != nullptr);
+    if (admitted) {
+      // Free the space following strict LRU policy until enough space
+      // is freed or the lru list is empty.
+      EvictFromLRU(e->total_charge, &last_reference_list);
+    }
 
-    if ((usage_ + e->total_charge) > capacity_ &&
-        (strict_capacity_limit_ || handle == nullptr)) {
+    if (!admitted && handle != nullptr) {
+      // The entry is not inserted, so it only lives as long as the handle of
+      // the caller, and is charged until then.
+      e->SetInCache(false);
+      if (!e->HasRefs()) {
+        e->Ref();
+      }
+      usage_ += e->total_charge;
+      *handle = reinterpret_cast<Cache::Handle*>(e);
+    } else if (!admitted || ((usage_ + e->total_charge) > capacity_ &&
+                             (strict_capacity_limit_ || handle == nullptr))) {
       e->SetInCache(false);
       if (handle == nullptr) {
         // Don't insert the entry but still return ok, as if the entry inserted
@@ -392,11 +554,28 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, Cache::Handle** handle,
       // capacity if not enough space was freed up.
       LRUHandle* old = table_.Insert(e);
       usage_ += e->total_charge;
+      AddTenantUsage(e);
+      if (frequency_sketch_ != nullptr &&
+          (size_t{1} << table_.GetLengthBits()) >
+              frequency_sketch_->GetExpectedEntries()) {
+        // The table has grown, so more keys compete for the counters.
+        frequency_sketch_->Resize(size_t{1} << table_.GetLengthBits());
+      }
       if (old != nullptr) {
         s = Status::OkOverwritten();
         assert(old->InCache());
         old->SetInCache(false);
-        if (!old->HasRefs()) {
+        SubtractTenantUsage(old);
+        if (lazy_lru_updates_) {
+          // old is on LRU because it's in cache, and the cache drops its
+          // reference.
+          LRU_Remove(old);
+          if (old->AtomicUnref()) {
+            assert(usage_ >= old->total_charge);
+            usage_ -= old->total_charge;
+            last_reference_list.push_back(old);
+          }
+        } else if (!old->HasRefs()) {
           // old is on LRU because it's in cache and its reference count is 0.
           LRU_Remove(old);
           assert(usage_ >= old->total_charge);
@@ -404,7 +583,15 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, Cache::Handle** handle,
           last_reference_list.push_back(old);
         }
       }
-      if (handle == nullptr) {
+      if (lazy_lru_updates_) {
+        // Take the reference of the cache, and one for the caller if needed.
+        assert(!e->HasRefs());
+        e->refs.store(handle == nullptr ? 1 : 2, std::memory_order_relaxed);
+        LRU_Insert(e);
+        if (handle != nullptr) {
+          *handle = reinterpret_cast<Cache::Handle*>(e);
+        }
+      } else if (handle == nullptr) {
         LRU_Insert(e);
       } else {
         // If caller already holds a ref, no need to take one here.
@@ -466,7 +653,7 @@ void LRUCacheShard::Promote(LRUHandle* e) {
           e->IsHighPri() ? Cache::Priority::HIGH : Cache::Priority::LOW;
       s = Insert(e->key(), e->hash, /*value=*/nullptr, 0,
                  /*deleter=*/nullptr, /*helper=*/nullptr, /*handle=*/nullptr,
-                 priority);
+                 priority, kNoTenant);
     } else {
       e->SetInCache(true);
       e->SetIsStandalone(false);
@@ -496,6 +683,31 @@ void LRUCacheShard::Promote(LRUHandle* e) {
   }
 }
 
+LRUHandle* LRUCacheShard::LookupAndRef(const Slice& key, uint32_t hash) {
+  if (frequency_sketch_ != nullptr) {
+    frequency_sketch_->Increment(hash);
+  }
+  LRUHandle* e = table_.Lookup(key, hash);
+  if (e != nullptr) {
+    assert(e->InCache());
+    if (lazy_lru_updates_) {
+      // The entry stays in place in the LRU list until it reaches the end of
+      // it. See EvictFromLRU().
+      e->AtomicRef();
+      e->SetRecentlyUsed(true);
+    } else {
+      if (!e->HasRefs()) {
+        // The entry is in LRU since it's in hash and has no external
+        // references.
+        LRU_Remove(e);
+      }
+      e->Ref();
+    }
+    e->SetHit();
+  }
+  return e;
+}
+
 Cache::Handle* LRUCacheShard::Lookup(
     const Slice& key, uint32_t hash,
     const ShardedCache::CacheItemHelper* helper,
@@ -505,17 +717,8 @@ Cache::Handle* LRUCacheShard::Lookup(
   bool found_dummy_entry{false};
   {
     DMutexLock l(mutex_);
-    e = table_.Lookup(key, hash);
+    e = LookupAndRef(key, hash);
     if (e != nullptr) {
-      assert(e->InCache());
-      if (!e->HasRefs()) {
-        // The entry is in LRU since it's in hash and has no external
-        // references.
-        LRU_Remove(e);
-      }
-      e->Ref();
-      e->SetHit();
-
       // For a dummy handle, if it was retrieved from secondary cache,
       // it may still exist in secondary cache.
       // If the handle exists in secondary cache, the value should be
@@ -564,7 +767,8 @@ Cache::Handle* LRUCacheShard::Lookup(
       e->info_.helper = helper;
       e->key_length = key.size();
       e->hash = hash;
-      e->refs = 0;
+      e->refs.store(0, std::memory_order_relaxed);
+      e->tenant = kNoTenant;
       e->next = e->prev = nullptr;
       e->SetPriority(priority);
       memcpy(e->key_data, key.data(), key.size());
@@ -607,8 +811,40 @@ Cache::Handle* LRUCacheShard::Lookup(
   return reinterpret_cast<Cache::Handle*>(e);
 }
 
+void LRUCacheShard::LookupMany(const Slice* keys, const uint32_t* hashes,
+                               const size_t* indices, size_t num_indices,
+                               const ShardedCache::CacheItemHelper* helper,
+                               const ShardedCache::CreateCallback& create_cb,
+                               Cache::Priority priority, bool wait,
+                               Statistics* stats, Cache::Handle** handles) {
+  if (secondary_cache_ != nullptr) {
+    // Misses may have to go to the secondary cache, which is done outside
+    // the mutex.
+    CacheShard::LookupMany(keys, hashes, indices, num_indices, helper,
+                           create_cb, priority, wait, stats, handles);
+    return;
+  }
+  DMutexLock l(mutex_);
+  // Issue all the bucket loads before walking any of the chains, so that
+  // their memory latencies overlap.
+  for (size_t i = 0; i < num_indices; i++) {
+    table_.Prefetch(hashes[indices[i]]);
+  }
+  for (size_t i = 0; i < num_indices; i++) {
+    const size_t idx = indices[i];
+    handles[idx] =
+        reinterpret_cast<Cache::Handle*>(LookupAndRef(keys[idx], hashes[idx]));
+  }
+}
+
 bool LRUCacheShard::Ref(Cache::Handle* h) {
   LRUHandle* e = reinterpret_cast<LRUHandle*>(h);
+  if (lazy_lru_updates_) {
+    // The reference held by the caller keeps the entry alive.
+    assert(e->HasRefs());
+    e->AtomicRef();
+    return true;
+  }
   DMutexLock l(mutex_);
   // To create another reference - entry must be already externally referenced.
   assert(e->HasRefs());
@@ -635,18 +871,45 @@ bool LRUCacheShard::Release(Cache::Handle* handle, bool erase_if_last_ref) {
     return false;
   }
   LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
+  if (lazy_lru_updates_ && !erase_if_last_ref && !e->AtomicUnref()) {
+    // Another reference, possibly the one of the cache, keeps the entry
+    // alive, and the LRU list is only updated on eviction.
+    return false;
+  }
   bool last_reference = false;
   {
     DMutexLock l(mutex_);
-    last_reference = e->Unref();
-    if (last_reference && e->InCache()) {
+    if (lazy_lru_updates_) {
+      if (!erase_if_last_ref) {
+        // The last reference was dropped above, after the entry left the
+        // cache.
+        assert(!e->InCache());
+        last_reference = true;
+      } else if (e->InCache() &&
+                 e->refs.load(std::memory_order_acquire) == 2) {
+        // Besides the caller, only the cache references the entry, and no
+        // other reference can be taken while holding the mutex.
+        LRU_Remove(e);
+        table_.Remove(e->key(), e->hash);
+        e->SetInCache(false);
+        SubtractTenantUsage(e);
+        e->refs.store(0, std::memory_order_relaxed);
+        last_reference = true;
+      } else {
+        last_reference = e->AtomicUnref();
+      }
+    } else {
+      last_reference = e->Unref();
+    }
+    if (!lazy_lru_updates_ && last_reference && e->InCache()) {
       // The item is still in cache, and nobody else holds a reference to it.
       if (usage_ > capacity_ || erase_if_last_ref) {
         // The LRU list must be empty since the cache is full.
-        assert(lru_.next == &lru_ || erase_if_last_ref);
+        assert(GetEvictionCandidate() == nullptr || erase_if_last_ref);
         // Take this opportunity and remove the item.
         table_.Remove(e->key(), e->hash);
         e->SetInCache(false);
+        SubtractTenantUsage(e);
       } else {
         // Put the item back on the LRU list, and don't free it.
         LRU_Insert(e);
@@ -675,7 +938,8 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
                              size_t charge,
                              void (*deleter)(const Slice& key, void* value),
                              const Cache::CacheItemHelper* helper,
-                             Cache::Handle** handle, Cache::Priority priority) {
+                             Cache::Handle** handle, Cache::Priority priority,
+                             uint16_t tenant) {
   // Allocate the memory here outside of the mutex.
   // If the cache is full, we'll have to release it.
   // It shouldn't happen very often though.
@@ -695,7 +959,8 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
   }
   e->key_length = key.size();
   e->hash = hash;
-  e->refs = 0;
+  e->refs.store(0, std::memory_order_relaxed);
+  e->tenant = tenant;
   e->next = e->prev = nullptr;
   e->SetInCache(true);
   e->SetPriority(priority);
@@ -714,12 +979,20 @@ void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
     if (e != nullptr) {
       assert(e->InCache());
       e->SetInCache(false);
-      if (!e->HasRefs()) {
+      SubtractTenantUsage(e);
+      if (lazy_lru_updates_) {
+        // The entry is in LRU since it's in hash, and the cache drops its
+        // reference.
+        LRU_Remove(e);
+        last_reference = e->AtomicUnref();
+      } else if (!e->HasRefs()) {
         // The entry is in LRU since it's in hash and has no external references
         LRU_Remove(e);
+        last_reference = true;
+      }
+      if (last_reference) {
         assert(usage_ >= e->total_charge);
         usage_ -= e->total_charge;
-        last_reference = true;
       }
     }
   }
@@ -751,7 +1024,20 @@ size_t LRUCacheShard::GetUsage() const {
 size_t LRUCacheShard::GetPinnedUsage() const {
   DMutexLock l(mutex_);
   assert(usage_ >= lru_usage_);
-  return usage_ - lru_usage_;
+  if (!lazy_lru_updates_) {
+    return usage_ - lru_usage_;
+  }
+  // Referenced entries stay in the LRU list.
+  size_t unpinned_usage = 0;
+  for (const LRUHandle* list : {&lru_, &over_quota_lru_}) {
+    for (const LRUHandle* h = list->next; h != list; h = h->next) {
+      if (!HasExternalRefs(h)) {
+        unpinned_usage += h->total_charge;
+      }
+    }
+  }
+  assert(usage_ >= unpinned_usage);
+  return usage_ - unpinned_usage;
 }
 
 std::string LRUCacheShard::GetPrintableOptions() const {
@@ -763,6 +1049,11 @@ std::string LRUCacheShard::GetPrintableOptions() const {
              high_pri_pool_ratio_);
     snprintf(buffer + strlen(buffer), kBufferSize - strlen(buffer),
              "    low_pri_pool_ratio: %.3lf\n", low_pri_pool_ratio_);
+    snprintf(buffer + strlen(buffer), kBufferSize - strlen(buffer),
+             "    use_tiny_lfu_admission: %d\n",
+             frequency_sketch_ != nullptr);
+    snprintf(buffer + strlen(buffer), kBufferSize - strlen(buffer),
+             "    use_lazy_lru_updates: %d\n", lazy_lru_updates_);
   }
   return std::string(buffer);
 }
@@ -773,7 +1064,8 @@ LRUCache::LRUCache(size_t capacity, int num_shard_bits,
                    std::shared_ptr<MemoryAllocator> allocator,
                    bool use_adaptive_mutex,
                    CacheMetadataChargePolicy metadata_charge_policy,
-                   const std::shared_ptr<SecondaryCache>& secondary_cache)
+                   const std::shared_ptr<SecondaryCache>& secondary_cache,
+                   bool use_tiny_lfu_admission, bool use_lazy_lru_updates)
     : ShardedCache(capacity, num_shard_bits, strict_capacity_limit,
                    std::move(allocator)) {
   num_shards_ = 1 << num_shard_bits;
@@ -784,7 +1076,8 @@ LRUCache::LRUCache(size_t capacity, int num_shard_bits,
     new (&shards_[i]) LRUCacheShard(
         per_shard, strict_capacity_limit, high_pri_pool_ratio,
         low_pri_pool_ratio, use_adaptive_mutex, metadata_charge_policy,
-        /* max_upper_hash_bits */ 32 - num_shard_bits, secondary_cache);
+        /* max_upper_hash_bits */ 32 - num_shard_bits, secondary_cache,
+        use_tiny_lfu_admission, use_lazy_lru_updates);
   }
   secondary_cache_ = secondary_cache;
 }
@@ -887,6 +1180,118 @@ void LRUCache::WaitAll(std::vector<Handle*>& handles) {
   }
 }
 
+uint16_t LRUCache::AddTenant(double weight) {
+  MutexLock l(&tenants_mutex_);
+  if (tenant_weights_.empty()) {
+    tenant_weights_.push_back(0.0);  // kNoTenant
+  }
+  if (tenant_weights_.size() > kMaxTenants) {
+    return kNoTenant;
+  }
+  uint16_t tenant = static_cast<uint16_t>(tenant_weights_.size());
+  tenant_weights_.push_back(weight);
+  UpdateTenantShares();
+  return tenant;
+}
+
+void LRUCache::RemoveTenant(uint16_t tenant) {
+  MutexLock l(&tenants_mutex_);
+  assert(tenant != kNoTenant && tenant < tenant_weights_.size());
+  tenant_weights_[tenant] = 0.0;
+  UpdateTenantShares();
+}
+
+void LRUCache::UpdateTenantShares() {
+  tenants_mutex_.AssertHeld();
+  double total_weight = 0.0;
+  for (double weight : tenant_weights_) {
+    total_weight += weight;
+  }
+  std::vector<double> shares(tenant_weights_.size(), 0.0);
+  if (total_weight > 0.0) {
+    for (size_t i = 0; i < shares.size(); i++) {
+      shares[i] = tenant_weights_[i] / total_weight;
+    }
+  }
+  for (int i = 0; i < num_shards_; i++) {
+    shards_[i].SetTenantShares(shares);
+  }
+}
+
+Status LRUCache::InsertForTenant(const Slice& key, void* value, size_t charge,
+                                 DeleterFn deleter, Handle** handle,
+                                 Priority priority, uint16_t tenant) {
+  uint32_t hash = HashSlice(key);
+  return shards_[Shard(hash)].Insert(key, hash, value, charge, deleter,
+                                     /*helper=*/nullptr, handle, priority,
+                                     tenant);
+}
+
+Status LRUCache::InsertForTenant(const Slice& key, void* value,
+                                 const CacheItemHelper* helper, size_t charge,
+                                 Handle** handle, Priority priority,
+                                 uint16_t tenant) {
+  if (!helper) {
+    return Status::InvalidArgument();
+  }
+  uint32_t hash = HashSlice(key);
+  return shards_[Shard(hash)].Insert(key, hash, value, charge,
+                                     /*deleter=*/nullptr, helper, handle,
+                                     priority, tenant);
+}
+
+void LRUCache::ApplyToAllEntriesOfTenant(
+    const std::function<void(const Slice& key, void* value, size_t charge,
+                             DeleterFn deleter)>& callback,
+    const ApplyToAllEntriesOptions& opts, uint16_t tenant) {
+  uint32_t num_shards = static_cast<uint32_t>(num_shards_);
+  // Iterate over part of each shard, rotating between shards, to
+  // minimize impact on latency of concurrent operations.
+  std::unique_ptr<uint32_t[]> states(new uint32_t[num_shards]{});
+
+  uint32_t aepl_in_32 = static_cast<uint32_t>(
+      std::min(size_t{UINT32_MAX}, opts.average_entries_per_lock));
+  aepl_in_32 = std::max(aepl_in_32, uint32_t{1});
+
+  bool remaining_work;
+  do {
+    remaining_work = false;
+    for (uint32_t s = 0; s < num_shards; s++) {
+      if (states[s] != UINT32_MAX) {
+        shards_[s].ApplyToSomeEntries(callback, aepl_in_32, &states[s],
+                                      tenant);
+        remaining_work |= states[s] != UINT32_MAX;
+      }
+    }
+  } while (remaining_work);
+}
+
+size_t LRUCache::GetTenantUsage(uint16_t tenant) const {
+  size_t usage = 0;
+  for (int i = 0; i < num_shards_; i++) {
+    usage += shards_[i].GetTenantUsage(tenant);
+  }
+  return usage;
+}
+
+size_t LRUCache::GetTenantQuota(uint16_t tenant) const {
+  double total_weight = 0.0;
+  double weight = 0.0;
+  {
+    MutexLock l(&tenants_mutex_);
+    for (double w : tenant_weights_) {
+      total_weight += w;
+    }
+    if (tenant < tenant_weights_.size()) {
+      weight = tenant_weights_[tenant];
+    }
+  }
+  if (total_weight <= 0.0) {
+    return 0;
+  }
+  return static_cast<size_t>(GetCapacity() * (weight / total_weight));
+}
+
 std::string LRUCache::GetPrintableOptions() const {
   std::string ret;
   ret.reserve(20000);
@@ -898,15 +1303,57 @@ std::string LRUCache::GetPrintableOptions() const {
   return ret;
 }
 
+LRUCacheTenant::LRUCacheTenant(std::shared_ptr<LRUCache> cache,
+                               uint16_t tenant, double weight)
+    // Share the memory allocator of the cache, and keep it alive with it
+    : Cache(std::shared_ptr<MemoryAllocator>(cache,
+                                             cache->memory_allocator())),
+      cache_(std::move(cache)),
+      tenant_(tenant),
+      weight_(weight) {
+  assert(tenant_ != kNoTenant);
+}
+
+LRUCacheTenant::~LRUCacheTenant() { cache_->RemoveTenant(tenant_); }
+
+std::string LRUCacheTenant::GetPrintableOptions() const {
+  std::string ret;
+  ret.reserve(20000);
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    tenant_weight: %.3lf\n", weight_);
+  ret.append(buffer);
+  ret.append(cache_->GetPrintableOptions());
+  return ret;
+}
+
 }  // namespace lru_cache
 
+std::shared_ptr<Cache> NewLRUCacheTenant(const std::shared_ptr<Cache>& cache,
+                                         double weight) {
+  if (cache == nullptr || std::strcmp(cache->Name(), "LRUCache") != 0) {
+    return nullptr;  // Only LRU caches can be shared by tenants.
+  }
+  if (!(weight > 0.0)) {
+    return nullptr;
+  }
+  auto lru_cache = std::static_pointer_cast<LRUCache>(cache);
+  uint16_t tenant = lru_cache->AddTenant(weight);
+  if (tenant == lru_cache::kNoTenant) {
+    return nullptr;  // Too many tenants.
+  }
+  return std::make_shared<LRUCacheTenant>(std::move(lru_cache), tenant,
+                                          weight);
+}
+
 std::shared_ptr<Cache> NewLRUCache(
     size_t capacity, int num_shard_bits, bool strict_capacity_limit,
     double high_pri_pool_ratio,
     std::shared_ptr<MemoryAllocator> memory_allocator, bool use_adaptive_mutex,
     CacheMetadataChargePolicy metadata_charge_policy,
     const std::shared_ptr<SecondaryCache>& secondary_cache,
-    double low_pri_pool_ratio) {
+    double low_pri_pool_ratio, bool use_tiny_lfu_admission,
+    bool use_lazy_lru_updates) {
   if (num_shard_bits >= 20) {
     return nullptr;  // The cache cannot be sharded into too many fine pieces.
   }
@@ -928,7 +1375,8 @@ std::shared_ptr<Cache> NewLRUCache(
   return std::make_shared<LRUCache>(
       capacity, num_shard_bits, strict_capacity_limit, high_pri_pool_ratio,
       low_pri_pool_ratio, std::move(memory_allocator), use_adaptive_mutex,
-      metadata_charge_policy, secondary_cache);
+      metadata_charge_policy, secondary_cache, use_tiny_lfu_admission,
+      use_lazy_lru_updates);
 }
 
 std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts) {
@@ -937,7 +1385,9 @@ std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts) {
                      cache_opts.high_pri_pool_ratio,
                      cache_opts.memory_allocator, cache_opts.use_adaptive_mutex,
                      cache_opts.metadata_charge_policy,
-                     cache_opts.secondary_cache, cache_opts.low_pri_pool_ratio);
+                     cache_opts.secondary_cache, cache_opts.low_pri_pool_ratio,
+                     cache_opts.use_tiny_lfu_admission,
+                     cache_opts.use_lazy_lru_updates);
 }
 
 std::shared_ptr<Cache> NewLRUCache(
@@ -948,6 +1398,8 @@ std::shared_ptr<Cache> NewLRUCache(
     double low_pri_pool_ratio) {
   return NewLRUCache(capacity, num_shard_bits, strict_capacity_limit,
                      high_pri_pool_ratio, memory_allocator, use_adaptive_mutex,
-                     metadata_charge_policy, nullptr, low_pri_pool_ratio);
+                     metadata_charge_policy, nullptr, low_pri_pool_ratio,
+                     /*use_tiny_lfu_admission=*/false,
+                     /*use_lazy_lru_updates=*/false);
 }
 }  // namespace ROCKSDB_NAMESPACE
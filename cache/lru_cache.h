@@ -8,9 +8,12 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "cache/frequency_sketch.h"
 #include "cache/sharded_cache.h"
 #include "port/lang.h"
 #include "port/malloc.h"
@@ -22,6 +25,14 @@
 namespace ROCKSDB_NAMESPACE {
 namespace lru_cache {
 
+// The tenant of the entries inserted directly into an LRUCache. Tenants
+// created with NewLRUCacheTenant() have ids from 1 to kMaxTenants.
+constexpr uint16_t kNoTenant = 0;
+constexpr uint16_t kMaxTenants = UINT16_MAX - 1;
+// Passed to LRUCacheShard::ApplyToSomeEntries to visit the entries of all
+// tenants.
+constexpr uint32_t kAllTenants = UINT32_MAX;
+
 // LRU cache implementation. This class is not thread-safe.
 
 // An entry is a variable length heap-allocated structure.
@@ -53,6 +64,13 @@ namespace lru_cache {
 // that any successful LRUCacheShard::Lookup/LRUCacheShard::Insert have a
 // matching LRUCache::Release (to move into state 2) or LRUCacheShard::Erase
 // (to move into state 3).
+//
+// With lazy LRU updates, an entry in the hash table is always in the LRU list
+// too, and the cache holds a reference of its own on it (refs >= 1 &&
+// in_cache == true in states 1 and 2). Lookups only take a reference and mark
+// the entry as recently used, and an entry is only moved in the LRU list when
+// it reaches the end of it. Releasing a reference does not need the mutex
+// unless it was the last one.
 
 struct LRUHandle {
   void* value;
@@ -74,8 +92,13 @@ struct LRUHandle {
   size_t key_length;
   // The hash of key(). Used for fast sharding and comparisons.
   uint32_t hash;
-  // The number of external refs to this entry. The cache itself is not counted.
-  uint32_t refs;
+  // The number of external refs to this entry. The cache itself is not
+  // counted, unless the shard uses lazy LRU updates. Only modified while
+  // holding the shard mutex, except with the Atomic* functions.
+  std::atomic<uint32_t> refs;
+  // The tenant that inserted this entry, or kNoTenant if it was inserted
+  // directly into the LRUCache.
+  uint16_t tenant;
 
   enum Flags : uint16_t {
     // Whether this entry is referenced by the hash table.
@@ -99,6 +122,9 @@ struct LRUHandle {
     // Whether this entry is not inserted into the cache (both hash table and
     // LRU list).
     IS_STANDALONE = (1 << 9),
+    // Whether this entry was looked up since it was last moved in the LRU
+    // list, with lazy LRU updates.
+    IS_RECENTLY_USED = (1 << 10),
   };
 
   uint16_t flags;
@@ -117,17 +143,31 @@ struct LRUHandle {
   Slice key() const { return Slice(key_data, key_length); }
 
   // Increase the reference count by 1.
-  void Ref() { refs++; }
+  void Ref() {
+    refs.store(refs.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+  }
 
   // Just reduce the reference count by 1. Return true if it was last reference.
   bool Unref() {
-    assert(refs > 0);
-    refs--;
-    return refs == 0;
+    uint32_t new_refs = refs.load(std::memory_order_relaxed);
+    assert(new_refs > 0);
+    new_refs--;
+    refs.store(new_refs, std::memory_order_relaxed);
+    return new_refs == 0;
+  }
+
+  // Like Ref() and Unref(), but safe against concurrent updates without the
+  // shard mutex.
+  void AtomicRef() { refs.fetch_add(1, std::memory_order_relaxed); }
+  bool AtomicUnref() {
+    const uint32_t old_refs = refs.fetch_sub(1, std::memory_order_acq_rel);
+    assert(old_refs > 0);
+    return old_refs == 1;
   }
 
   // Return true if there are external refs, false otherwise.
-  bool HasRefs() const { return refs > 0; }
+  bool HasRefs() const { return refs.load(std::memory_order_relaxed) > 0; }
 
   bool InCache() const { return flags & IN_CACHE; }
   bool IsHighPri() const { return flags & IS_HIGH_PRI; }
@@ -145,6 +185,7 @@ struct LRUHandle {
   bool IsPending() const { return flags & IS_PENDING; }
   bool IsInSecondaryCache() const { return flags & IS_IN_SECONDARY_CACHE; }
   bool IsStandalone() const { return flags & IS_STANDALONE; }
+  bool IsRecentlyUsed() const { return flags & IS_RECENTLY_USED; }
 
   void SetInCache(bool in_cache) {
     if (in_cache) {
@@ -185,6 +226,14 @@ struct LRUHandle {
 
   void SetHit() { flags |= HAS_HIT; }
 
+  void SetRecentlyUsed(bool recently_used) {
+    if (recently_used) {
+      flags |= IS_RECENTLY_USED;
+    } else {
+      flags &= ~IS_RECENTLY_USED;
+    }
+  }
+
   void SetSecondaryCacheCompatible(bool compat) {
     if (compat) {
       flags |= IS_SECONDARY_CACHE_COMPATIBLE;
@@ -290,6 +339,11 @@ class LRUHandleTable {
   LRUHandle* Insert(LRUHandle* h);
   LRUHandle* Remove(const Slice& key, uint32_t hash);
 
+  // Starts loading the bucket for `hash` into the CPU cache.
+  void Prefetch(uint32_t hash) const {
+    PREFETCH(&list_[hash >> (32 - length_bits_)], 0 /* rw */, 3 /* locality */);
+  }
+
   template <typename T>
   void ApplyToEntriesRange(T func, uint32_t index_begin, uint32_t index_end) {
     for (uint32_t i = index_begin; i < index_end; i++) {
@@ -305,6 +359,8 @@ class LRUHandleTable {
 
   int GetLengthBits() const { return length_bits_; }
 
+  uint32_t GetOccupancyCount() const { return elems_; }
+
  private:
   // Return a pointer to slot that points to a cache entry that
   // matches key/hash.  If there is no such cache entry, return a
@@ -336,8 +392,10 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
                 bool use_adaptive_mutex,
                 CacheMetadataChargePolicy metadata_charge_policy,
                 int max_upper_hash_bits,
-                const std::shared_ptr<SecondaryCache>& secondary_cache);
-  virtual ~LRUCacheShard() override = default;
+                const std::shared_ptr<SecondaryCache>& secondary_cache,
+                bool use_tiny_lfu_admission = false,
+                bool use_lazy_lru_updates = false);
+  virtual ~LRUCacheShard() override;
 
   // Separate from constructor so caller can easily make an array of LRUCache
   // if current usage is more than new capacity, the function will attempt to
@@ -358,14 +416,16 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
                         size_t charge, Cache::DeleterFn deleter,
                         Cache::Handle** handle,
                         Cache::Priority priority) override {
-    return Insert(key, hash, value, charge, deleter, nullptr, handle, priority);
+    return Insert(key, hash, value, charge, deleter, nullptr, handle, priority,
+                  kNoTenant);
   }
   virtual Status Insert(const Slice& key, uint32_t hash, void* value,
                         const Cache::CacheItemHelper* helper, size_t charge,
                         Cache::Handle** handle,
                         Cache::Priority priority) override {
     assert(helper);
-    return Insert(key, hash, value, charge, nullptr, helper, handle, priority);
+    return Insert(key, hash, value, charge, nullptr, helper, handle, priority,
+                  kNoTenant);
   }
   // If helper_cb is null, the values of the following arguments don't matter.
   virtual Cache::Handle* Lookup(const Slice& key, uint32_t hash,
@@ -377,6 +437,14 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
     return Lookup(key, hash, nullptr, nullptr, Cache::Priority::LOW, true,
                   nullptr);
   }
+  // Takes the mutex once for the whole batch, unless a secondary cache may
+  // have to be consulted.
+  virtual void LookupMany(const Slice* keys, const uint32_t* hashes,
+                          const size_t* indices, size_t num_indices,
+                          const ShardedCache::CacheItemHelper* helper,
+                          const ShardedCache::CreateCallback& create_cb,
+                          ShardedCache::Priority priority, bool wait,
+                          Statistics* stats, Cache::Handle** handles) override;
   virtual bool Release(Cache::Handle* handle, bool /*useful*/,
                        bool erase_if_last_ref) override {
     return Release(handle, erase_if_last_ref);
@@ -404,6 +472,21 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
 
   virtual std::string GetPrintableOptions() const override;
 
+  // Like ApplyToSomeEntries, but only visits the entries of `tenant`, unless
+  // it is kAllTenants.
+  void ApplyToSomeEntries(
+      const std::function<void(const Slice& key, void* value, size_t charge,
+                               DeleterFn deleter)>& callback,
+      uint32_t average_entries_per_lock, uint32_t* state, uint32_t tenant);
+
+  // Sets the share of the shard capacity guaranteed to each tenant, indexed
+  // by tenant id. Entries of tenants using more than their share are evicted
+  // first.
+  void SetTenantShares(const std::vector<double>& shares);
+
+  // Returns the charge of the entries of `tenant` in the shard.
+  size_t GetTenantUsage(uint16_t tenant) const;
+
   void TEST_GetLRUList(LRUHandle** lru, LRUHandle** lru_low_pri,
                        LRUHandle** lru_bottom_pri);
 
@@ -419,6 +502,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
 
  private:
   friend class LRUCache;
+  // The most entries SetCapacity() evicts per acquisition of the mutex.
+  static constexpr size_t kMaxEvictionsPerShrinkStep = 64;
+
   // Insert an item into the hash table and, if handle is null, insert into
   // the LRU list. Older items are evicted as necessary. If the cache is full
   // and free_handle_on_fail is true, the item is deleted and handle is set to
@@ -427,7 +513,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
                     bool free_handle_on_fail);
   Status Insert(const Slice& key, uint32_t hash, void* value, size_t charge,
                 DeleterFn deleter, const Cache::CacheItemHelper* helper,
-                Cache::Handle** handle, Cache::Priority priority);
+                Cache::Handle** handle, Cache::Priority priority,
+                uint16_t tenant);
   // Promote an item looked up from the secondary cache to the LRU cache.
   // The item may be still in the secondary cache.
   // It is only inserted into the hash table and not the LRU list, and only
@@ -437,6 +524,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   // The item is promoted to the high pri or low pri pool as specified by the
   // caller in Lookup.
   void Promote(LRUHandle* e);
+  // Looks up the primary cache and references the entry found, if any.
+  // REQUIRES: mutex_ held
+  LRUHandle* LookupAndRef(const Slice& key, uint32_t hash);
   void LRU_Remove(LRUHandle* e);
   void LRU_Insert(LRUHandle* e);
 
@@ -445,10 +535,63 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   void MaintainPoolSize();
 
   // Free some space following strict LRU policy until enough space
-  // to hold (usage_ + charge) is freed or the lru list is empty
+  // to hold (usage_ + charge) is freed, the lru list is empty or
+  // max_evictions entries were evicted. With lazy LRU updates, the entries
+  // that are referenced or were recently used are moved to the head of the
+  // list instead, up to the number of entries in the cache, and each move
+  // counts toward max_evictions. The number of moves is returned in `moved`
+  // if not null.
   // This function is not thread safe - it needs to be executed while
   // holding the mutex_.
-  void EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted);
+  void EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted,
+                    size_t max_evictions = SIZE_MAX, size_t* moved = nullptr);
+
+  // Returns the next entry EvictFromLRU() would evict, or nullptr if there
+  // is none. With lazy LRU updates, the referenced and recently used entries
+  // in the way are moved to the head of the LRU list first, counted in
+  // `moved`, giving up with nullptr once `moved` reaches max_moved.
+  // Requires mutex_.
+  LRUHandle* FindEvictable(size_t max_moved, size_t* moved);
+
+  // With TinyLFU admission, whether e may evict entries to be inserted. An
+  // entry that needs no eviction is always admitted. Requires mutex_.
+  bool IsAdmitted(LRUHandle* e, bool has_handle);
+
+  // Whether e, which must be in the hash table, is referenced by anyone but
+  // the cache. Requires mutex_, so that no new reference can be taken.
+  bool HasExternalRefs(const LRUHandle* e) const {
+    assert(e->InCache());
+    return e->refs.load(std::memory_order_acquire) >
+           (lazy_lru_updates_ ? 1u : 0u);
+  }
+
+  // Returns the next entry to evict, or nullptr if no entry can be evicted.
+  // That is the oldest entry of the LRU list, unless it belongs to a tenant
+  // within its quota while entries of tenants over their quota are waiting
+  // in over_quota_lru_. Requires mutex_.
+  LRUHandle* GetEvictionCandidate();
+
+  // Whether e belongs to a tenant whose entries use more than its share of
+  // the shard capacity. Requires mutex_.
+  bool IsOverQuota(const LRUHandle* e) const {
+    return e->tenant != kNoTenant &&
+           tenant_usage_[e->tenant] >
+               static_cast<size_t>(capacity_ * tenant_shares_[e->tenant]);
+  }
+
+  // Account for e entering or leaving the hash table in the usage of its
+  // tenant. Requires mutex_.
+  void AddTenantUsage(const LRUHandle* e) {
+    if (e->tenant != kNoTenant) {
+      tenant_usage_[e->tenant] += e->total_charge;
+    }
+  }
+  void SubtractTenantUsage(const LRUHandle* e) {
+    if (e->tenant != kNoTenant) {
+      assert(tenant_usage_[e->tenant] >= e->total_charge);
+      tenant_usage_[e->tenant] -= e->total_charge;
+    }
+  }
 
   // Try to insert the evicted handles into the secondary cache.
   void TryInsertIntoSecondaryCache(autovector<LRUHandle*> evicted_handles);
@@ -465,6 +608,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   // Whether to reject insertion if cache reaches its full capacity.
   bool strict_capacity_limit_;
 
+  // Whether the LRU list is only updated lazily, on eviction. See LRUHandle.
+  const bool lazy_lru_updates_;
+
   // Ratio of capacity reserved for high priority cache entries.
   double high_pri_pool_ratio_;
 
@@ -490,6 +636,14 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   // Pointer to head of bottom-pri pool in LRU list.
   LRUHandle* lru_bottom_pri_;
 
+  // Dummy head of the LRU list of the evictable entries of tenants that were
+  // over their quota when the entries were last released, regardless of
+  // their priority.
+  LRUHandle over_quota_lru_;
+
+  // Share of capacity_ guaranteed to each tenant, indexed by tenant id.
+  std::vector<double> tenant_shares_;
+
   // ------------^^^^^^^^^^^^^-----------
   // Not frequently modified data members
   // ------------------------------------
@@ -506,15 +660,23 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   // Memory size for entries residing in the cache.
   size_t usage_;
 
-  // Memory size for entries residing only in the LRU list.
+  // Memory size for entries residing in the LRU list. Without lazy LRU
+  // updates, these are the entries that are not referenced externally.
   size_t lru_usage_;
 
+  // Memory size for entries residing in the cache, per tenant id.
+  std::vector<size_t> tenant_usage_;
+
   // mutex_ protects the following state.
   // We don't count mutex_ as the cache's internal state so semantically we
   // don't mind mutex_ invoking the non-const actions.
   mutable DMutex mutex_;
 
   std::shared_ptr<SecondaryCache> secondary_cache_;
+
+  // Recent lookup frequencies for TinyLFU admission, if enabled. Protected
+  // by mutex_.
+  std::unique_ptr<FrequencySketch> frequency_sketch_;
 };
 
 class LRUCache
@@ -529,7 +691,9 @@ class LRUCache
            bool use_adaptive_mutex = kDefaultToAdaptiveMutex,
            CacheMetadataChargePolicy metadata_charge_policy =
                kDontChargeCacheMetadata,
-           const std::shared_ptr<SecondaryCache>& secondary_cache = nullptr);
+           const std::shared_ptr<SecondaryCache>& secondary_cache = nullptr,
+           bool use_tiny_lfu_admission = false,
+           bool use_lazy_lru_updates = false);
   virtual ~LRUCache();
   virtual const char* Name() const override { return "LRUCache"; }
   virtual CacheShard* GetShard(uint32_t shard) override;
@@ -547,10 +711,161 @@ class LRUCache
   // Retrieves high pri pool ratio.
   double GetHighPriPoolRatio();
 
+  // Registers a tenant whose share of the capacity is proportional to
+  // `weight`, and returns its id, or kNoTenant if there are too many tenants.
+  uint16_t AddTenant(double weight);
+  // Unregisters a tenant. Its remaining entries are over quota, so they are
+  // evicted first. Its id is not reused.
+  void RemoveTenant(uint16_t tenant);
+  // Like Insert, on behalf of `tenant`.
+  Status InsertForTenant(const Slice& key, void* value, size_t charge,
+                         DeleterFn deleter, Handle** handle, Priority priority,
+                         uint16_t tenant);
+  Status InsertForTenant(const Slice& key, void* value,
+                         const CacheItemHelper* helper, size_t charge,
+                         Handle** handle, Priority priority, uint16_t tenant);
+  // Like ApplyToAllEntries, but only visits the entries of `tenant`.
+  void ApplyToAllEntriesOfTenant(
+      const std::function<void(const Slice& key, void* value, size_t charge,
+                               DeleterFn deleter)>& callback,
+      const ApplyToAllEntriesOptions& opts, uint16_t tenant);
+  size_t GetTenantUsage(uint16_t tenant) const;
+  // Returns the capacity guaranteed to the tenant.
+  size_t GetTenantQuota(uint16_t tenant) const;
+
  private:
+  // Requires tenants_mutex_.
+  void UpdateTenantShares();
+
   LRUCacheShard* shards_ = nullptr;
   int num_shards_ = 0;
   std::shared_ptr<SecondaryCache> secondary_cache_;
+
+  mutable port::Mutex tenants_mutex_;
+  // Weight of each tenant, indexed by tenant id, or 0 if it was removed.
+  std::vector<double> tenant_weights_;
+};
+
+// A view of an LRUCache for one of the tenants sharing it, e.g. a column
+// family or a DB. The entries inserted through the view are charged to the
+// tenant, and the other calls are forwarded to the shared cache. See
+// NewLRUCacheTenant().
+class LRUCacheTenant : public Cache {
+ public:
+  LRUCacheTenant(std::shared_ptr<LRUCache> cache, uint16_t tenant,
+                 double weight);
+  ~LRUCacheTenant() override;
+
+  static const char* kClassName() { return "LRUCacheTenant"; }
+  const char* Name() const override { return kClassName(); }
+
+  Status Insert(const Slice& key, void* value, size_t charge, DeleterFn deleter,
+                Handle** handle, Priority priority) override {
+    return cache_->InsertForTenant(key, value, charge, deleter, handle,
+                                   priority, tenant_);
+  }
+  Status Insert(const Slice& key, void* value, const CacheItemHelper* helper,
+                size_t charge, Handle** handle = nullptr,
+                Priority priority = Priority::LOW) override {
+    return cache_->InsertForTenant(key, value, helper, charge, handle,
+                                   priority, tenant_);
+  }
+
+  Handle* Lookup(const Slice& key, Statistics* stats) override {
+    return cache_->Lookup(key, stats);
+  }
+  Handle* Lookup(const Slice& key, const CacheItemHelper* helper,
+                 const CreateCallback& create_cb, Priority priority, bool wait,
+                 Statistics* stats = nullptr) override {
+    return cache_->Lookup(key, helper, create_cb, priority, wait, stats);
+  }
+  void LookupMany(const Slice* keys, size_t num_keys, Handle** handles,
+                  const CacheItemHelper* helper = nullptr,
+                  const CreateCallback& create_cb = nullptr,
+                  Priority priority = Priority::LOW, bool wait = true,
+                  Statistics* stats = nullptr) override {
+    cache_->LookupMany(keys, num_keys, handles, helper, create_cb, priority,
+                       wait, stats);
+  }
+
+  bool Release(Handle* handle, bool useful,
+               bool erase_if_last_ref = false) override {
+    return cache_->Release(handle, useful, erase_if_last_ref);
+  }
+  bool Release(Handle* handle, bool erase_if_last_ref = false) override {
+    // LRUCache ignores `useful`
+    return cache_->Release(handle, /*useful=*/true, erase_if_last_ref);
+  }
+
+  void Erase(const Slice& key) override { cache_->Erase(key); }
+
+  // Like the following setters, affects all the tenants.
+  void EraseUnRefEntries() override { cache_->EraseUnRefEntries(); }
+
+  uint64_t NewId() override { return cache_->NewId(); }
+
+  void SetCapacity(size_t capacity) override { cache_->SetCapacity(capacity); }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {
+    cache_->SetStrictCapacityLimit(strict_capacity_limit);
+  }
+
+  bool HasStrictCapacityLimit() const override {
+    return cache_->HasStrictCapacityLimit();
+  }
+
+  void* Value(Handle* handle) override { return cache_->Value(handle); }
+
+  bool IsReady(Handle* handle) override { return cache_->IsReady(handle); }
+
+  void Wait(Handle* handle) override { cache_->Wait(handle); }
+
+  void WaitAll(std::vector<Handle*>& handles) override {
+    cache_->WaitAll(handles);
+  }
+
+  bool Ref(Handle* handle) override { return cache_->Ref(handle); }
+
+  // The capacity of the shared cache, which the tenant may use when the
+  // other tenants do not.
+  size_t GetCapacity() const override { return cache_->GetCapacity(); }
+
+  // The charge of the entries of this tenant.
+  size_t GetUsage() const override { return cache_->GetTenantUsage(tenant_); }
+
+  size_t GetUsage(Handle* handle) const override {
+    return cache_->GetUsage(handle);
+  }
+
+  size_t GetPinnedUsage() const override { return cache_->GetPinnedUsage(); }
+
+  size_t GetCharge(Handle* handle) const override {
+    return cache_->GetCharge(handle);
+  }
+
+  DeleterFn GetDeleter(Handle* handle) const override {
+    return cache_->GetDeleter(handle);
+  }
+
+  // Only visits the entries of this tenant.
+  void ApplyToAllEntries(
+      const std::function<void(const Slice& key, void* value, size_t charge,
+                               DeleterFn deleter)>& callback,
+      const ApplyToAllEntriesOptions& opts) override {
+    cache_->ApplyToAllEntriesOfTenant(callback, opts, tenant_);
+  }
+
+  std::string GetPrintableOptions() const override;
+
+  void DisownData() override { cache_->DisownData(); }
+
+  // The capacity guaranteed to this tenant.
+  size_t GetQuota() const { return cache_->GetTenantQuota(tenant_); }
+
+ private:
+  std::shared_ptr<LRUCache> cache_;
+  const uint16_t tenant_;
+  const double weight_;
 };
 
 }  // namespace lru_cache
@@ -558,5 +873,6 @@ class LRUCache
 using LRUCache = lru_cache::LRUCache;
 using LRUHandle = lru_cache::LRUHandle;
 using LRUCacheShard = lru_cache::LRUCacheShard;
+using LRUCacheTenant = lru_cache::LRUCacheTenant;
 
 }  // namespace ROCKSDB_NAMESPACE
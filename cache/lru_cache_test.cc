@@ -42,7 +42,8 @@ class LRUCacheTest : public testing::Test {
 
   void NewCache(size_t capacity, double high_pri_pool_ratio = 0.0,
                 double low_pri_pool_ratio = 1.0,
-                bool use_adaptive_mutex = kDefaultToAdaptiveMutex) {
+                bool use_adaptive_mutex = kDefaultToAdaptiveMutex,
+                bool use_lazy_lru_updates = false) {
     DeleteCache();
     cache_ = reinterpret_cast<LRUCacheShard*>(
         port::cacheline_aligned_alloc(sizeof(LRUCacheShard)));
@@ -50,7 +51,9 @@ class LRUCacheTest : public testing::Test {
                                high_pri_pool_ratio, low_pri_pool_ratio,
                                use_adaptive_mutex, kDontChargeCacheMetadata,
                                /*max_upper_hash_bits=*/24,
-                               /*secondary_cache=*/nullptr);
+                               /*secondary_cache=*/nullptr,
+                               /*use_tiny_lfu_admission=*/false,
+                               use_lazy_lru_updates);
   }
 
   void Insert(const std::string& key,
@@ -75,6 +78,16 @@ class LRUCacheTest : public testing::Test {
 
   bool Lookup(char key) { return Lookup(std::string(1, key)); }
 
+  Cache::Handle* LookupHandle(const std::string& key) {
+    return cache_->Lookup(key, 0 /*hash*/);
+  }
+
+  void Release(Cache::Handle* handle) { cache_->Release(handle); }
+
+  void SetCapacity(size_t capacity) { cache_->SetCapacity(capacity); }
+
+  size_t GetUsage() const { return cache_->GetUsage(); }
+
   void Erase(const std::string& key) { cache_->Erase(key, 0 /*hash*/); }
 
   void ValidateLRUList(std::vector<std::string> keys,
@@ -364,6 +377,231 @@ TEST_F(LRUCacheTest, EntriesWithPriority) {
   ValidateLRUList({"x", "y", "g", "z", "d", "m"}, 2, 2, 2);
 }
 
+TEST_F(LRUCacheTest, LazyLRUUpdates) {
+  // Allocate 2 cache entries to high-pri pool and 3 to low-pri pool.
+  NewCache(5, /* high_pri_pool_ratio */ 0.40, /* low_pri_pool_ratio */ 0.60,
+           kDefaultToAdaptiveMutex, /* use_lazy_lru_updates */ true);
+
+  Insert("a", Cache::Priority::LOW);
+  Insert("b", Cache::Priority::LOW);
+  Insert("c", Cache::Priority::LOW);
+  Insert("x", Cache::Priority::HIGH);
+  Insert("y", Cache::Priority::HIGH);
+  ValidateLRUList({"a", "b", "c", "x", "y"}, 2, 3);
+
+  // Lookups don't move the entries.
+  ASSERT_TRUE(Lookup("a"));
+  ValidateLRUList({"a", "b", "c", "x", "y"}, 2, 3);
+
+  // Eviction moves 'a' to the tail of the full list, as if the lookup had,
+  // and 'x' spills over to the low-pri pool.
+  Insert("d", Cache::Priority::LOW);
+  ValidateLRUList({"c", "x", "d", "y", "a"}, 2, 3);
+
+  Erase("d");
+  ValidateLRUList({"c", "x", "y", "a"}, 2, 2);
+  Insert("e", Cache::Priority::LOW);
+  Insert("f", Cache::Priority::LOW);
+  ValidateLRUList({"x", "e", "f", "y", "a"}, 2, 3);
+}
+
+TEST_F(LRUCacheTest, LazyLRUUpdatesWithHandles) {
+  LRUCacheOptions opts(5, /*_num_shard_bits=*/0,
+                       /*_strict_capacity_limit=*/false,
+                       /*_high_pri_pool_ratio=*/0.0,
+                       /*_memory_allocator=*/nullptr, kDefaultToAdaptiveMutex,
+                       kDontChargeCacheMetadata);
+  opts.use_lazy_lru_updates = true;
+  std::shared_ptr<Cache> cache = NewLRUCache(opts);
+
+  auto insert = [&](const std::string& key, Cache::Handle** handle) {
+    ASSERT_OK(cache->Insert(key, /*value=*/nullptr, /*charge=*/1,
+                            /*deleter=*/nullptr, handle));
+  };
+  auto in_cache = [&](const std::string& key) {
+    Cache::Handle* handle = cache->Lookup(key);
+    if (handle == nullptr) {
+      return false;
+    }
+    cache->Release(handle);
+    return true;
+  };
+
+  Cache::Handle* pinned = nullptr;
+  insert("p", &pinned);
+  Cache::Handle* handle = cache->Lookup("p");
+  ASSERT_EQ(pinned, handle);
+  ASSERT_TRUE(cache->Ref(handle));
+  ASSERT_FALSE(cache->Release(handle));
+  ASSERT_FALSE(cache->Release(handle));
+  ASSERT_EQ(1, cache->GetPinnedUsage());
+
+  // The pinned entry is in the LRU list, but is not evicted.
+  for (int i = 0; i < 10; i++) {
+    insert(std::to_string(i), /*handle=*/nullptr);
+  }
+  ASSERT_EQ(5, cache->GetUsage());
+  ASSERT_EQ(1, cache->GetPinnedUsage());
+  ASSERT_TRUE(in_cache("p"));
+  ASSERT_TRUE(in_cache("9"));
+  ASSERT_FALSE(in_cache("5"));
+
+  // An erased entry stays charged until its last reference is released.
+  cache->Erase("p");
+  ASSERT_FALSE(in_cache("p"));
+  ASSERT_EQ(5, cache->GetUsage());
+  ASSERT_EQ(1, cache->GetPinnedUsage());
+  ASSERT_TRUE(cache->Release(pinned));
+  ASSERT_EQ(4, cache->GetUsage());
+  ASSERT_EQ(0, cache->GetPinnedUsage());
+
+  // So does an entry replaced by a new value.
+  insert("9", &handle);
+  ASSERT_EQ(4, cache->GetUsage());
+  insert("9", /*handle=*/nullptr);
+  ASSERT_EQ(5, cache->GetUsage());
+  ASSERT_TRUE(cache->Release(handle));
+  ASSERT_EQ(4, cache->GetUsage());
+
+  handle = cache->Lookup("9");
+  ASSERT_TRUE(cache->Release(handle, /*erase_if_last_ref=*/true));
+  ASSERT_FALSE(in_cache("9"));
+  cache->EraseUnRefEntries();
+  ASSERT_EQ(0, cache->GetUsage());
+}
+
+TEST_F(LRUCacheTest, LazyLRUUpdatesShrink) {
+  const int kNumEntries = 500;
+  NewCache(kNumEntries, /* high_pri_pool_ratio */ 0.0,
+           /* low_pri_pool_ratio */ 0.0, kDefaultToAdaptiveMutex,
+           /* use_lazy_lru_updates */ true);
+  for (int i = 0; i < kNumEntries; i++) {
+    Insert(std::to_string(i));
+  }
+  // Every entry has to be moved before the first one is evicted.
+  for (int i = 0; i < kNumEntries; i++) {
+    ASSERT_TRUE(Lookup(std::to_string(i)));
+  }
+  SetCapacity(100);
+  ASSERT_EQ(100, GetUsage());
+  ASSERT_FALSE(Lookup("0"));
+  ASSERT_TRUE(Lookup(std::to_string(kNumEntries - 1)));
+
+  // The shrink gives up when every entry is referenced.
+  std::vector<Cache::Handle*> handles;
+  for (int i = kNumEntries - 100; i < kNumEntries; i++) {
+    handles.push_back(LookupHandle(std::to_string(i)));
+    ASSERT_NE(nullptr, handles.back());
+  }
+  SetCapacity(0);
+  ASSERT_EQ(100, GetUsage());
+  for (Cache::Handle* handle : handles) {
+    Release(handle);
+  }
+  Insert("x");
+  ASSERT_EQ(0, GetUsage());
+}
+
+TEST_F(LRUCacheTest, LazyLRUUpdatesTinyLfuVictim) {
+  LRUCacheOptions opts(2, /*_num_shard_bits=*/0,
+                       /*_strict_capacity_limit=*/false,
+                       /*_high_pri_pool_ratio=*/0.0,
+                       /*_memory_allocator=*/nullptr, kDefaultToAdaptiveMutex,
+                       kDontChargeCacheMetadata);
+  opts.use_lazy_lru_updates = true;
+  opts.use_tiny_lfu_admission = true;
+  std::shared_ptr<Cache> cache = NewLRUCache(opts);
+
+  auto miss = [&](const std::string& key, int times) {
+    for (int i = 0; i < times; i++) {
+      ASSERT_EQ(nullptr, cache->Lookup(key));
+    }
+  };
+  // The oldest entry is pinned and never looked up, the next one is
+  // frequently looked up but not recently.
+  Cache::Handle* pinned = nullptr;
+  ASSERT_OK(cache->Insert("a", /*value=*/nullptr, /*charge=*/1,
+                          /*deleter=*/nullptr, &pinned));
+  miss("b", 5);
+  ASSERT_OK(cache->Insert("b", /*value=*/nullptr, /*charge=*/1,
+                          /*deleter=*/nullptr));
+
+  // The candidate is compared with 'b', which eviction would evict, rather
+  // than with the pinned 'a'.
+  miss("c", 2);
+  ASSERT_OK(cache->Insert("c", /*value=*/nullptr, /*charge=*/1,
+                          /*deleter=*/nullptr));
+  Cache::Handle* handle = cache->Lookup("b");
+  ASSERT_NE(nullptr, handle);
+  cache->Release(handle);
+  ASSERT_EQ(nullptr, cache->Lookup("c"));
+  cache->Release(pinned);
+}
+
+TEST_F(LRUCacheTest, TenantQuotas) {
+  std::shared_ptr<Cache> cache =
+      NewLRUCache(10, /*num_shard_bits=*/0, /*strict_capacity_limit=*/false,
+                  /*high_pri_pool_ratio=*/0.0, /*memory_allocator=*/nullptr,
+                  kDefaultToAdaptiveMutex, kDontChargeCacheMetadata);
+  ASSERT_EQ(nullptr, NewLRUCacheTenant(cache, /*weight=*/0.0));
+  std::shared_ptr<Cache> tenant_a = NewLRUCacheTenant(cache);
+  std::shared_ptr<Cache> tenant_b = NewLRUCacheTenant(cache);
+  ASSERT_NE(nullptr, tenant_a);
+  ASSERT_NE(nullptr, tenant_b);
+  ASSERT_EQ(nullptr, NewLRUCacheTenant(tenant_a));
+  ASSERT_EQ(5, static_cast<LRUCacheTenant*>(tenant_a.get())->GetQuota());
+
+  auto insert = [](Cache* c, const std::string& key) {
+    ASSERT_OK(c->Insert(key, /*value=*/nullptr, /*charge=*/1,
+                        /*deleter=*/nullptr));
+  };
+  auto in_cache = [&](const std::string& key) {
+    Cache::Handle* handle = cache->Lookup(key);
+    if (handle == nullptr) {
+      return false;
+    }
+    cache->Release(handle);
+    return true;
+  };
+  auto num_entries = [](Cache* c) {
+    size_t count = 0;
+    c->ApplyToAllEntries(
+        [&count](const Slice&, void*, size_t, Cache::DeleterFn) { count++; },
+        {});
+    return count;
+  };
+
+  for (int i = 0; i < 4; i++) {
+    insert(tenant_b.get(), "b" + std::to_string(i));
+  }
+  // A scan of tenant A beyond its quota only evicts its own entries
+  for (int i = 0; i < 20; i++) {
+    insert(tenant_a.get(), "a" + std::to_string(i));
+  }
+  ASSERT_EQ(10, cache->GetUsage());
+  ASSERT_EQ(6, tenant_a->GetUsage());
+  ASSERT_EQ(4, tenant_b->GetUsage());
+  ASSERT_EQ(6, num_entries(tenant_a.get()));
+  ASSERT_EQ(4, num_entries(tenant_b.get()));
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(in_cache("b" + std::to_string(i)));
+  }
+  for (int i = 5; i < 19; i++) {
+    ASSERT_FALSE(in_cache("a" + std::to_string(i)));
+  }
+
+  // Without tenant B, tenant A may use the whole cache
+  tenant_b.reset();
+  ASSERT_EQ(10, static_cast<LRUCacheTenant*>(tenant_a.get())->GetQuota());
+  for (int i = 0; i < 10; i++) {
+    insert(tenant_a.get(), "x" + std::to_string(i));
+  }
+  ASSERT_EQ(10, tenant_a->GetUsage());
+  for (int i = 0; i < 4; i++) {
+    ASSERT_FALSE(in_cache("b" + std::to_string(i)));
+  }
+}
+
 // TODO: FastLRUCache and ClockCache use the same tests. We can probably remove
 // them from FastLRUCache after ClockCache becomes productive, and we don't plan
 // to use or maintain FastLRUCache any more.
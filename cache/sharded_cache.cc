@@ -19,14 +19,6 @@
 
 namespace ROCKSDB_NAMESPACE {
 
-namespace {
-
-inline uint32_t HashSlice(const Slice& s) {
-  return Lower32of64(GetSliceNPHash64(s));
-}
-
-}  // namespace
-
 ShardedCache::ShardedCache(size_t capacity, int num_shard_bits,
                            bool strict_capacity_limit,
                            std::shared_ptr<MemoryAllocator> allocator)
@@ -39,11 +31,16 @@ ShardedCache::ShardedCache(size_t capacity, int num_shard_bits,
 void ShardedCache::SetCapacity(size_t capacity) {
   uint32_t num_shards = GetNumShards();
   const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
-  MutexLock l(&capacity_mutex_);
+  MutexLock l(&set_capacity_mutex_);
+  {
+    // Shards may take a while to shrink, so publish the target first and do
+    // not block GetCapacity() meanwhile.
+    MutexLock capacity_lock(&capacity_mutex_);
+    capacity_ = capacity;
+  }
   for (uint32_t s = 0; s < num_shards; s++) {
     GetShard(s)->SetCapacity(per_shard);
   }
-  capacity_ = capacity;
 }
 
 void ShardedCache::SetStrictCapacityLimit(bool strict_capacity_limit) {
@@ -89,6 +86,46 @@ Cache::Handle* ShardedCache::Lookup(const Slice& key,
       ->Lookup(key, hash, helper, create_cb, priority, wait, stats);
 }
 
+void ShardedCache::LookupMany(const Slice* keys, size_t num_keys,
+                              Handle** handles, const CacheItemHelper* helper,
+                              const CreateCallback& create_cb,
+                              Priority priority, bool wait, Statistics* stats) {
+  uint32_t inline_hashes[kLookupManyInlineKeys];
+  size_t inline_indices[kLookupManyInlineKeys];
+  std::unique_ptr<uint32_t[]> heap_hashes;
+  std::unique_ptr<size_t[]> heap_indices;
+  uint32_t* hashes = inline_hashes;
+  size_t* indices = inline_indices;
+  if (num_keys > kLookupManyInlineKeys) {
+    heap_hashes.reset(new uint32_t[num_keys]);
+    heap_indices.reset(new size_t[num_keys]);
+    hashes = heap_hashes.get();
+    indices = heap_indices.get();
+  }
+  for (size_t i = 0; i < num_keys; i++) {
+    hashes[i] = HashSlice(keys[i]);
+    indices[i] = i;
+  }
+  // Group the keys by shard, keeping their relative order within a shard
+  std::sort(indices, indices + num_keys, [&](size_t a, size_t b) {
+    const uint32_t shard_a = Shard(hashes[a]);
+    const uint32_t shard_b = Shard(hashes[b]);
+    return shard_a < shard_b || (shard_a == shard_b && a < b);
+  });
+  size_t begin = 0;
+  while (begin < num_keys) {
+    const uint32_t shard = Shard(hashes[indices[begin]]);
+    size_t end = begin + 1;
+    while (end < num_keys && Shard(hashes[indices[end]]) == shard) {
+      end++;
+    }
+    GetShard(shard)->LookupMany(keys, hashes, indices + begin,
+                                end - begin, helper, create_cb, priority, wait,
+                                stats, handles);
+    begin = end;
+  }
+}
+
 bool ShardedCache::IsReady(Handle* handle) {
   uint32_t hash = GetHash(handle);
   return GetShard(Shard(hash))->IsReady(handle);
@@ -14,6 +14,7 @@
 
 #include "port/port.h"
 #include "rocksdb/cache.h"
+#include "util/hash.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -36,6 +37,20 @@ class CacheShard {
                                 const Cache::CreateCallback& create_cb,
                                 Cache::Priority priority, bool wait,
                                 Statistics* stats) = 0;
+  // Looks up keys[indices[i]] for each i < num_indices, storing the result
+  // in handles[indices[i]]. hashes[j] is the hash of keys[j].
+  virtual void LookupMany(const Slice* keys, const uint32_t* hashes,
+                          const size_t* indices, size_t num_indices,
+                          const Cache::CacheItemHelper* helper,
+                          const Cache::CreateCallback& create_cb,
+                          Cache::Priority priority, bool wait,
+                          Statistics* stats, Cache::Handle** handles) {
+    for (size_t i = 0; i < num_indices; i++) {
+      const size_t idx = indices[i];
+      handles[idx] = Lookup(keys[idx], hashes[idx], helper, create_cb,
+                            priority, wait, stats);
+    }
+  }
   virtual bool Release(Cache::Handle* handle, bool useful,
                        bool erase_if_last_ref) = 0;
   virtual bool IsReady(Cache::Handle* handle) = 0;
@@ -93,6 +108,12 @@ class ShardedCache : public Cache {
   virtual Handle* Lookup(const Slice& key, const CacheItemHelper* helper,
                          const CreateCallback& create_cb, Priority priority,
                          bool wait, Statistics* stats = nullptr) override;
+  // Hashes all the keys first, then hands each shard all of its keys at once.
+  virtual void LookupMany(const Slice* keys, size_t num_keys, Handle** handles,
+                          const CacheItemHelper* helper = nullptr,
+                          const CreateCallback& create_cb = nullptr,
+                          Priority priority = Priority::LOW, bool wait = true,
+                          Statistics* stats = nullptr) override;
   virtual bool Release(Handle* handle, bool useful,
                        bool erase_if_last_ref = false) override;
   virtual bool IsReady(Handle* handle) override;
@@ -119,8 +140,17 @@ class ShardedCache : public Cache {
  protected:
   inline uint32_t Shard(uint32_t hash) { return hash & shard_mask_; }
 
+  // Batch size up to which LookupMany() does not allocate
+  static constexpr size_t kLookupManyInlineKeys = 32;
+
+  static inline uint32_t HashSlice(const Slice& s) {
+    return Lower32of64(GetSliceNPHash64(s));
+  }
+
  private:
   const uint32_t shard_mask_;
+  // Serializes SetCapacity() calls
+  port::Mutex set_capacity_mutex_;
   mutable port::Mutex capacity_mutex_;
   size_t capacity_;
   bool strict_capacity_limit_;
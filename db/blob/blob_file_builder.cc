@@ -103,6 +103,15 @@ Status BlobFileBuilder::Add(const Slice& key, const Slice& value,
     return Status::OK();
   }
 
+  return AddRegardlessOfSize(key, value, blob_index);
+}
+
+Status BlobFileBuilder::AddRegardlessOfSize(const Slice& key,
+                                            const Slice& value,
+                                            std::string* blob_index) {
+  assert(blob_index);
+  assert(blob_index->empty());
+
   {
     const Status s = OpenBlobFileIfNeeded();
     if (!s.ok()) {
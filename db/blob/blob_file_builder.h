@@ -69,6 +69,10 @@ class BlobFileBuilder {
   ~BlobFileBuilder();
 
   Status Add(const Slice& key, const Slice& value, std::string* blob_index);
+  // Same as Add(), except that values smaller than min_blob_size are also
+  // stored in the blob file.
+  Status AddRegardlessOfSize(const Slice& key, const Slice& value,
+                             std::string* blob_index);
   Status Finish();
   void Abandon(const Status& s);
 
@@ -7,6 +7,7 @@
 #include "db/blob/blob_log_format.h"
 #include "db/db_test_util.h"
 #include "port/stack_trace.h"
+#include "rocksdb/utilities/debug.h"
 #include "test_util/sync_point.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -199,6 +200,50 @@ class SkipUntilFilter : public CompactionFilter {
 
 }  // anonymous namespace
 
+// Keeps the values of scanned key ranges inline and moves small values with
+// the "small" prefix to blob files.
+class PlacementByAccessFilter : public CompactionFilter {
+ public:
+  const char* Name() const override {
+    return "rocksdb.compaction.filter.placement.by.access";
+  }
+  BlobPlacement DecideBlobPlacement(
+      int /*level*/, const Slice& key, ValueType value_type,
+      uint64_t value_size, const ValueAccessStats& stats) const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    decisions_.emplace_back(key.ToString(), value_type, value_size, stats);
+    if (stats.num_scans_sampled > 0) {
+      return BlobPlacement::kInline;
+    }
+    if (key.starts_with("small")) {
+      return BlobPlacement::kBlobFile;
+    }
+    return BlobPlacement::kDefault;
+  }
+
+  struct Decision {
+    Decision(std::string _key, ValueType _value_type, uint64_t _value_size,
+             const ValueAccessStats& _stats)
+        : key(std::move(_key)),
+          value_type(_value_type),
+          value_size(_value_size),
+          stats(_stats) {}
+    std::string key;
+    ValueType value_type;
+    uint64_t value_size;
+    ValueAccessStats stats;
+  };
+
+  std::vector<Decision> TakeDecisions() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::move(decisions_);
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  mutable std::vector<Decision> decisions_;
+};
+
 class DBBlobBadCompactionFilterTest
     : public DBBlobCompactionTest,
       public testing::WithParamInterface<
@@ -867,6 +912,88 @@ TEST_F(DBBlobCompactionTest, CompactionReadaheadMerge) {
   Close();
 }
 
+#ifndef ROCKSDB_LITE
+TEST_F(DBBlobCompactionTest, BlobPlacementByAccessStats) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 100;
+  options.disable_auto_compactions = true;
+  std::unique_ptr<PlacementByAccessFilter> filter(
+      new PlacementByAccessFilter());
+  options.compaction_filter = filter.get();
+  Reopen(options);
+
+  const std::string large_value(200, 'l');
+  ASSERT_OK(Put("hot", large_value));
+  ASSERT_OK(Put("large", large_value));
+  ASSERT_OK(Put("small", "s"));
+  ASSERT_OK(Flush());
+
+  auto get_value_types = [&]() {
+    std::vector<KeyVersion> key_versions;
+    EXPECT_OK(GetAllKeyVersions(db_, Slice(), Slice(),
+                                std::numeric_limits<size_t>::max(),
+                                &key_versions));
+    std::map<std::string, int> types;
+    for (const auto& key_version : key_versions) {
+      types[key_version.user_key] = key_version.type;
+    }
+    return types;
+  };
+  std::map<std::string, int> types = get_value_types();
+  ASSERT_EQ(kTypeBlobIndex, types["hot"]);
+  ASSERT_EQ(kTypeBlobIndex, types["large"]);
+  ASSERT_EQ(kTypeValue, types["small"]);
+
+  // Pretend that the file has been scanned.
+  ColumnFamilyData* const cfd =
+      dbfull()->GetVersionSet()->GetColumnFamilySet()->GetDefault();
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  FileMetaData* const file =
+      cfd->current()->storage_info()->LevelFiles(0).front();
+  file->stats.num_reads_sampled = 3072;
+  file->stats.num_scans_sampled = 1024;
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+  std::vector<PlacementByAccessFilter::Decision> decisions =
+      filter->TakeDecisions();
+  ASSERT_EQ(3, decisions.size());
+  ASSERT_EQ("hot", decisions[0].key);
+  ASSERT_EQ(CompactionFilter::ValueType::kBlobIndex, decisions[0].value_type);
+  ASSERT_EQ(large_value.size(), decisions[0].value_size);
+  ASSERT_EQ(3072, decisions[0].stats.num_reads_sampled);
+  ASSERT_EQ(1024, decisions[0].stats.num_scans_sampled);
+  ASSERT_EQ(1, decisions[0].stats.num_files);
+  ASSERT_EQ(file->fd.GetFileSize(), decisions[0].stats.total_file_size);
+  ASSERT_EQ("small", decisions[2].key);
+  ASSERT_EQ(CompactionFilter::ValueType::kValue, decisions[2].value_type);
+  ASSERT_EQ(1, decisions[2].value_size);
+
+  // The hot key range is read back inline.
+  types = get_value_types();
+  ASSERT_EQ(kTypeValue, types["hot"]);
+  ASSERT_EQ(kTypeValue, types["large"]);
+  ASSERT_EQ(kTypeValue, types["small"]);
+
+  // Without reads, small values go to blob files and large ones are
+  // separated by size again.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  decisions = filter->TakeDecisions();
+  ASSERT_EQ(3, decisions.size());
+  ASSERT_EQ(0, decisions[0].stats.num_reads_sampled);
+  types = get_value_types();
+  ASSERT_EQ(kTypeBlobIndex, types["hot"]);
+  ASSERT_EQ(kTypeBlobIndex, types["large"]);
+  ASSERT_EQ(kTypeBlobIndex, types["small"]);
+
+  ASSERT_EQ(large_value, Get("hot"));
+  ASSERT_EQ(large_value, Get("large"));
+  ASSERT_EQ("s", Get("small"));
+
+  Close();
+}
+#endif  // ROCKSDB_LITE
+
 TEST_F(DBBlobCompactionTest, CompactionDoNotFillCache) {
   Options options = GetDefaultOptions();
 
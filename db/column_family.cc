@@ -168,11 +168,6 @@ Status CheckCompressionSupported(const ColumnFamilyOptions& cf_options) {
 }
 
 Status CheckConcurrentWritesSupported(const ColumnFamilyOptions& cf_options) {
-  if (cf_options.inplace_update_support) {
-    return Status::InvalidArgument(
-        "In-place memtable updates (inplace_update_support) is not compatible "
-        "with concurrent writes (allow_concurrent_memtable_write)");
-  }
   if (!cf_options.memtable_factory->IsInsertConcurrentlySupported()) {
     return Status::InvalidArgument(
         "Memtable doesn't concurrent writes (allow_concurrent_memtable_write)");
@@ -1311,6 +1306,7 @@ void ColumnFamilyData::InstallSuperVersion(
     // down is needed.
     super_version_->write_stall_condition =
         RecalculateWriteStallConditions(mutable_cf_options);
+    UpdateL0FileArrivals();
   } else {
     super_version_->write_stall_condition =
         old_superversion->write_stall_condition;
@@ -1339,6 +1335,54 @@ void ColumnFamilyData::InstallSuperVersion(
   }
 }
 
+void ColumnFamilyData::UpdateL0FileArrivals() {
+  if (current_ == nullptr) {
+    return;
+  }
+  const int num_l0_files = current_->storage_info()->l0_delay_trigger_count();
+  if (num_l0_files > last_num_l0_files_) {
+    const uint64_t now = ioptions_.clock->NowMicros();
+    if (last_l0_file_arrival_micros_ > 0 && now > last_l0_file_arrival_micros_) {
+      const uint64_t interval = std::max<uint64_t>(
+          (now - last_l0_file_arrival_micros_) /
+              static_cast<uint64_t>(num_l0_files - last_num_l0_files_),
+          1);
+      // Moving average that favors recent intervals
+      l0_file_arrival_interval_micros_ =
+          l0_file_arrival_interval_micros_ == 0
+              ? interval
+              : (l0_file_arrival_interval_micros_ + interval) / 2;
+    }
+    last_l0_file_arrival_micros_ = now;
+  }
+  last_num_l0_files_ = num_l0_files;
+}
+
+uint64_t ColumnFamilyData::GetMicrosUntilL0Stall(uint64_t now_micros) const {
+  const int slowdown_trigger = mutable_cf_options_.level0_slowdown_writes_trigger;
+  if (current_ == nullptr || mutable_cf_options_.disable_auto_compactions ||
+      slowdown_trigger < 0) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  const int num_l0_files = current_->storage_info()->l0_delay_trigger_count();
+  if (num_l0_files >= slowdown_trigger) {
+    return 0;
+  }
+  if (l0_file_arrival_interval_micros_ == 0) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  const uint64_t until_stall =
+      static_cast<uint64_t>(slowdown_trigger - num_l0_files) *
+      l0_file_arrival_interval_micros_;
+  // The time since the last arrival counts towards the next one only
+  const uint64_t since_last_arrival =
+      std::min(now_micros > last_l0_file_arrival_micros_
+                   ? now_micros - last_l0_file_arrival_micros_
+                   : 0,
+               l0_file_arrival_interval_micros_);
+  return until_stall - since_last_arrival;
+}
+
 void ColumnFamilyData::ResetThreadLocalSuperVersions() {
   autovector<void*> sv_ptrs;
   local_sv_->Scrape(&sv_ptrs, SuperVersion::kSVObsolete);
@@ -1369,6 +1413,11 @@ Status ColumnFamilyData::ValidateOptions(
     s = Status::InvalidArgument(
         "max_successive_merges > 0 is incompatible with unordered_write");
   }
+  if (s.ok() && db_options.unordered_write &&
+      cf_options.inplace_update_support) {
+    s = Status::InvalidArgument(
+        "inplace_update_support is incompatible with unordered_write");
+  }
   if (s.ok()) {
     s = CheckCFPathsSupported(db_options, cf_options);
   }
@@ -1515,6 +1564,7 @@ ColumnFamilySet::ColumnFamilySet(const std::string& dbname,
                                  const std::string& db_id,
                                  const std::string& db_session_id)
     : max_column_family_(0),
+      num_inplace_update_column_families_(0),
       file_options_(file_options),
       dummy_cfd_(new ColumnFamilyData(
           ColumnFamilyData::kDummyColumnFamilyDataId, "", nullptr, nullptr,
@@ -1600,6 +1650,9 @@ ColumnFamilyData* ColumnFamilySet::CreateColumnFamily(
   column_families_.insert({name, id});
   column_family_data_.insert({id, new_cfd});
   max_column_family_ = std::max(max_column_family_, id);
+  if (options.inplace_update_support) {
+    num_inplace_update_column_families_.fetch_add(1, std::memory_order_release);
+  }
   // add to linked list
   new_cfd->next_ = dummy_cfd_;
   auto prev = dummy_cfd_->prev_;
@@ -1618,6 +1671,10 @@ void ColumnFamilySet::RemoveColumnFamily(ColumnFamilyData* cfd) {
   assert(cfd_iter != column_family_data_.end());
   column_family_data_.erase(cfd_iter);
   column_families_.erase(cfd->GetName());
+  if (cfd->ioptions()->inplace_update_support) {
+    num_inplace_update_column_families_.fetch_sub(1,
+                                                  std::memory_order_release);
+  }
 }
 
 // under a DB mutex OR from a write thread
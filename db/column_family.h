@@ -485,6 +485,13 @@ class ColumnFamilyData {
   WriteStallCondition RecalculateWriteStallConditions(
       const MutableCFOptions& mutable_cf_options);
 
+  // Estimated time until writes are slowed down because of the number of L0
+  // files, from the average interval between the L0 files that arrived
+  // recently. 0 if they already are, and the maximum uint64_t if L0 does not
+  // grow or no estimate is available yet.
+  // REQUIRES: DB mutex held
+  uint64_t GetMicrosUntilL0Stall(uint64_t now_micros) const;
+
   void set_initialized() { initialized_.store(true); }
 
   bool initialized() const { return initialized_.load(); }
@@ -616,6 +623,12 @@ class ColumnFamilyData {
 
   uint64_t prev_compaction_needed_bytes_;
 
+  // Tracks the arrival of new L0 files for GetMicrosUntilL0Stall()
+  void UpdateL0FileArrivals();
+  int last_num_l0_files_ = 0;
+  uint64_t last_l0_file_arrival_micros_ = 0;
+  uint64_t l0_file_arrival_interval_micros_ = 0;
+
   // if the database was opened with 2pc enabled
   bool allow_2pc_;
 
@@ -651,6 +664,7 @@ class ColumnFamilyData {
 // * GetColumnFamily() -- either inside of DB mutex or from a write thread
 // * GetNextColumnFamilyID(), GetMaxColumnFamily(), UpdateMaxColumnFamily(),
 // NumberOfColumnFamilies -- inside of DB mutex
+// * NumberOfInplaceUpdateColumnFamilies() -- thread safe
 class ColumnFamilySet {
  public:
   // ColumnFamilySet supports iteration
@@ -694,6 +708,11 @@ class ColumnFamilySet {
   uint32_t GetMaxColumnFamily();
   void UpdateMaxColumnFamily(uint32_t new_max_column_family);
   size_t NumberOfColumnFamilies() const;
+  // Number of alive column families with inplace_update_support. Writes to
+  // them need extra checks before being inserted into memtables concurrently.
+  size_t NumberOfInplaceUpdateColumnFamilies() const {
+    return num_inplace_update_column_families_.load(std::memory_order_acquire);
+  }
 
   ColumnFamilyData* CreateColumnFamily(const std::string& name, uint32_t id,
                                        Version* dummy_version,
@@ -725,6 +744,7 @@ class ColumnFamilySet {
   UnorderedMap<uint32_t, ColumnFamilyData*> column_family_data_;
 
   uint32_t max_column_family_;
+  std::atomic<size_t> num_inplace_update_column_families_;
   const FileOptions file_options_;
 
   ColumnFamilyData* dummy_cfd_;
@@ -9,6 +9,7 @@
 
 #include "db/compaction/compaction.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <vector>
 
@@ -274,14 +275,7 @@ Compaction::Compaction(
   }
 #endif
 
-  // setup input_levels_
-  {
-    input_levels_.resize(num_input_levels());
-    for (size_t which = 0; which < num_input_levels(); which++) {
-      DoGenerateLevelFilesBrief(&input_levels_[which], inputs_[which].files,
-                                &arena_);
-    }
-  }
+  GenerateInputLevels();
 
   GetBoundaryKeys(vstorage, inputs_, &smallest_user_key_, &largest_user_key_);
 
@@ -290,11 +284,18 @@ Compaction::Compaction(
   output_split_key_ = nullptr;
   if (immutable_options_.compaction_style == kCompactionStyleLevel &&
       immutable_options_.compaction_pri == kRoundRobin) {
-    const InternalKey* cursor =
-        &input_vstorage_->GetCompactCursors()[output_level_];
-    if (cursor->size() != 0) {
+    std::vector<const InternalKey*> cursors{
+        &input_vstorage_->GetCompactCursors()[output_level_]};
+    for (const auto& extra_cursor :
+         input_vstorage_->GetExtraCompactCursors()[output_level_]) {
+      cursors.push_back(&extra_cursor);
+    }
+    auto ucmp = vstorage->InternalComparator()->user_comparator();
+    for (const InternalKey* cursor : cursors) {
+      if (cursor->size() == 0) {
+        continue;
+      }
       const Slice& cursor_user_key = ExtractUserKey(cursor->Encode());
-      auto ucmp = vstorage->InternalComparator()->user_comparator();
       // May split output files according to the cursor if it in the user-key
       // range
       if (ucmp->CompareWithoutTimestamp(cursor_user_key, smallest_user_key_) >
@@ -302,6 +303,7 @@ Compaction::Compaction(
           ucmp->CompareWithoutTimestamp(cursor_user_key, largest_user_key_) <=
               0) {
         output_split_key_ = cursor;
+        break;
       }
     }
   }
@@ -319,6 +321,105 @@ void Compaction::PopulatePenultimateLevelOutputRange() {
                   &penultimate_level_largest_user_key_, number_levels_ - 1);
 }
 
+void Compaction::GenerateInputLevels() {
+  input_levels_.resize(num_input_levels());
+  for (size_t which = 0; which < num_input_levels(); which++) {
+    if (reused_input_files_.empty()) {
+      DoGenerateLevelFilesBrief(&input_levels_[which], inputs_[which].files,
+                                &arena_);
+      continue;
+    }
+    std::vector<FileMetaData*> files;
+    for (FileMetaData* f : inputs_[which].files) {
+      if (!IsReusedInputFile(f)) {
+        files.push_back(f);
+      }
+    }
+    DoGenerateLevelFilesBrief(&input_levels_[which], files, &arena_);
+  }
+}
+
+bool Compaction::ShouldReuseInputFiles() const {
+  return mutable_cf_options_.level_compaction_move_non_overlapping_files &&
+         immutable_options_.compaction_style == kCompactionStyleLevel &&
+         immutable_options_.compaction_service == nullptr &&
+         (compaction_reason_ == CompactionReason::kLevelL0FilesNum ||
+          compaction_reason_ == CompactionReason::kLevelMaxLevelSize) &&
+         start_level_ != output_level_ && output_level_ != 0 &&
+         !deletion_compaction_ && !SupportsPerKeyPlacement() &&
+         immutable_options_.user_comparator->timestamp_size() == 0;
+}
+
+bool Compaction::ShouldCopyCleanDataBlocks() const {
+  return mutable_cf_options_.compaction_copy_clean_data_blocks &&
+         output_level_ != 0 && !deletion_compaction_ &&
+         !SupportsPerKeyPlacement() &&
+         immutable_options_.user_comparator->timestamp_size() == 0 &&
+         !DoesInputReferenceBlobFiles() &&
+         !(mutable_cf_options_.enable_blob_files &&
+           output_level_ >= mutable_cf_options_.blob_file_starting_level) &&
+         output_compression_opts_.max_dict_bytes == 0 &&
+         output_compression_opts_.parallel_threads <= 1;
+}
+
+bool Compaction::CanMoveInputFile(const FileMetaData* file) const {
+  // Same conditions as for the files of a trivial move
+  if (file->fd.GetPathId() != output_path_id_ ||
+      !InputCompressionMatchesOutput()) {
+    return false;
+  }
+  if (output_level_ + 1 < number_levels_) {
+    std::vector<FileMetaData*> file_grand_parents;
+    input_vstorage_->GetOverlappingInputs(output_level_ + 1, &file->smallest,
+                                          &file->largest, &file_grand_parents);
+    if (file->fd.GetFileSize() + TotalFileSize(file_grand_parents) >
+        max_compaction_bytes_) {
+      return false;
+    }
+  }
+  std::unique_ptr<SstPartitioner> partitioner = CreateSstPartitioner();
+  return partitioner == nullptr ||
+         partitioner->CanDoTrivialMove(file->smallest.user_key(),
+                                       file->largest.user_key());
+}
+
+void Compaction::SetReusedInputFiles(
+    std::vector<FileMetaData*> reused_input_files) {
+  assert(ShouldReuseInputFiles());
+  reused_input_files_ = std::move(reused_input_files);
+  const InternalKeyComparator* icmp = input_vstorage_->InternalComparator();
+  std::sort(reused_input_files_.begin(), reused_input_files_.end(),
+            [icmp](const FileMetaData* a, const FileMetaData* b) {
+              return icmp->Compare(a->smallest, b->smallest) < 0;
+            });
+  files_to_move_.clear();
+  for (FileMetaData* f : reused_input_files_) {
+    const std::vector<FileMetaData*>& start_files = inputs_[0].files;
+    if (std::find(start_files.begin(), start_files.end(), f) !=
+        start_files.end()) {
+      files_to_move_.push_back(f);
+    }
+  }
+  GenerateInputLevels();
+}
+
+bool Compaction::IsReusedInputFile(const FileMetaData* file) const {
+  return std::find(reused_input_files_.begin(), reused_input_files_.end(),
+                   file) != reused_input_files_.end();
+}
+
+void Compaction::AddMovedFiles(VersionEdit* out_edit) const {
+  for (FileMetaData* f : files_to_move_) {
+    out_edit->AddFile(output_level_, f->fd.GetNumber(), f->fd.GetPathId(),
+                      f->fd.GetFileSize(), f->smallest, f->largest,
+                      f->fd.smallest_seqno, f->fd.largest_seqno,
+                      f->marked_for_compaction, f->temperature,
+                      f->oldest_blob_file_number, f->oldest_ancester_time,
+                      f->file_creation_time, f->file_checksum,
+                      f->file_checksum_func_name, f->unique_id);
+  }
+}
+
 Compaction::~Compaction() {
   if (input_version_ != nullptr) {
     input_version_->Unref();
@@ -451,6 +552,10 @@ bool Compaction::IsTrivialMove() const {
 void Compaction::AddInputDeletions(VersionEdit* out_edit) {
   for (size_t which = 0; which < num_input_levels(); which++) {
     for (size_t i = 0; i < inputs_[which].size(); i++) {
+      if (level(which) == output_level_ &&
+          IsReusedInputFile(inputs_[which][i])) {
+        continue;
+      }
       out_edit->DeleteFile(level(which), inputs_[which][i]->fd.GetNumber());
     }
   }
@@ -494,6 +599,50 @@ bool Compaction::KeyNotExistsBeyondOutputLevel(
   return false;
 }
 
+void Compaction::GetValueAccessStats(
+    const Slice& user_key, std::vector<size_t>* file_ptrs,
+    CompactionFilter::ValueAccessStats* stats) const {
+  assert(file_ptrs != nullptr);
+  assert(stats != nullptr);
+  *stats = CompactionFilter::ValueAccessStats();
+  if (file_ptrs->empty()) {
+    file_ptrs->resize(num_input_levels(), 0);
+  }
+  const Comparator* user_cmp = cfd_->user_comparator();
+  auto add_file = [&](const FileMetaData* f) {
+    stats->num_reads_sampled +=
+        f->stats.num_reads_sampled.load(std::memory_order_relaxed);
+    stats->num_scans_sampled +=
+        f->stats.num_scans_sampled.load(std::memory_order_relaxed);
+    stats->num_files++;
+    stats->total_file_size += f->fd.GetFileSize();
+  };
+  for (size_t which = 0; which < num_input_levels(); which++) {
+    const LevelFilesBrief& files = input_levels_[which];
+    if (level(which) == 0) {
+      // L0 files may overlap each other
+      for (size_t i = 0; i < files.num_files; i++) {
+        const FileMetaData* f = files.files[i].file_metadata;
+        if (user_cmp->Compare(user_key, f->smallest.user_key()) >= 0 &&
+            user_cmp->Compare(user_key, f->largest.user_key()) <= 0) {
+          add_file(f);
+        }
+      }
+      continue;
+    }
+    size_t& i = file_ptrs->at(which);
+    for (; i < files.num_files; i++) {
+      const FileMetaData* f = files.files[i].file_metadata;
+      if (user_cmp->Compare(user_key, f->largest.user_key()) <= 0) {
+        if (user_cmp->Compare(user_key, f->smallest.user_key()) >= 0) {
+          add_file(f);
+        }
+        break;
+      }
+    }
+  }
+}
+
 // Mark (or clear) each file that is being compacted
 void Compaction::MarkFilesBeingCompacted(bool mark_as_compacted) {
   for (size_t i = 0; i < num_input_levels(); i++) {
@@ -652,6 +801,11 @@ std::unique_ptr<SstPartitioner> Compaction::CreateSstPartitioner() const {
   context.output_level = output_level_;
   context.smallest_user_key = smallest_user_key_;
   context.largest_user_key = largest_user_key_;
+  context.user_comparator = immutable_options_.user_comparator;
+  context.next_level_file_boundaries.reserve(grandparents_.size());
+  for (const FileMetaData* f : grandparents_) {
+    context.next_level_file_boundaries.push_back(f->largest.user_key());
+  }
   return immutable_options_.sst_partitioner_factory->CreatePartitioner(context);
 }
 
@@ -11,6 +11,7 @@
 #include "db/version_set.h"
 #include "memory/arena.h"
 #include "options/cf_options.h"
+#include "rocksdb/compaction_filter.h"
 #include "rocksdb/sst_partitioner.h"
 #include "util/autovector.h"
 
@@ -187,14 +188,58 @@ class Compaction {
   // If true, then the compaction can be done by simply deleting input files.
   bool deletion_compaction() const { return deletion_compaction_; }
 
-  // Add all inputs to this compaction as delete operations to *edit.
+  // Add all inputs to this compaction as delete operations to *edit, except
+  // for the output level input files that are reused as-is.
   void AddInputDeletions(VersionEdit* edit);
 
+  // Whether `level_compaction_move_non_overlapping_files` applies to this
+  // compaction, i.e. whether SetReusedInputFiles() may be called.
+  bool ShouldReuseInputFiles() const;
+
+  // Whether start level input file `file` could be moved to the output level
+  // as-is, given that no other input has keys within its range.
+  bool CanMoveInputFile(const FileMetaData* file) const;
+
+  // Reuse the given input files as-is instead of rewriting them. None of the
+  // other input files may have keys within their ranges. Must be called
+  // before the compaction input is read.
+  void SetReusedInputFiles(std::vector<FileMetaData*> reused_input_files);
+
+  // Input files reused as-is instead of being rewritten, sorted by key. Start
+  // level files among them are moved to the output level (see
+  // files_to_move()), output level files stay where they are. Output files
+  // are cut so that they do not overlap these files.
+  const std::vector<FileMetaData*>& reused_input_files() const {
+    return reused_input_files_;
+  }
+
+  // The reused input files moved from the start level to the output level.
+  const std::vector<FileMetaData*>& files_to_move() const {
+    return files_to_move_;
+  }
+
+  bool IsReusedInputFile(const FileMetaData* file) const;
+
+  // Add the files to move to the output level to *edit.
+  void AddMovedFiles(VersionEdit* edit) const;
+
+  // Whether `compaction_copy_clean_data_blocks` applies to this compaction as
+  // far as its options and inputs are concerned.
+  bool ShouldCopyCleanDataBlocks() const;
+
   // Returns true if the available information we have guarantees that
   // the input "user_key" does not exist in any level beyond "output_level()".
   bool KeyNotExistsBeyondOutputLevel(const Slice& user_key,
                                      std::vector<size_t>* level_ptrs) const;
 
+  // Sums up the sampled read statistics of the input files whose key range
+  // contains "user_key". Like with KeyNotExistsBeyondOutputLevel(), the keys
+  // passed in must be increasing, and "file_ptrs" must start out empty and
+  // be kept between calls.
+  void GetValueAccessStats(const Slice& user_key,
+                           std::vector<size_t>* file_ptrs,
+                           CompactionFilter::ValueAccessStats* stats) const;
+
   // Clear all files to indicate that they are not being compacted
   // Delete this compaction from the list of running compactions.
   //
@@ -238,6 +283,11 @@ class Compaction {
   // are non-overlapping and can be trivially moved.
   bool is_trivial_move() const { return is_trivial_move_; }
 
+  // Which round-robin cursor of the start level picked this compaction, when
+  // round_robin_cursors_per_level is greater than 1. -1 otherwise.
+  void set_round_robin_cursor(int cursor) { round_robin_cursor_ = cursor; }
+  int round_robin_cursor() const { return round_robin_cursor_; }
+
   // How many total levels are there?
   int number_levels() const { return number_levels_; }
 
@@ -391,6 +441,9 @@ class Compaction {
   //  level, it needs extra check.
   void PopulatePenultimateLevelOutputRange();
 
+  // Generate input_levels_ from inputs_, leaving out the reused input files.
+  void GenerateInputLevels();
+
   // Get the atomic file boundaries for all files in the compaction. Necessary
   // in order to avoid the scenario described in
   // https://github.com/facebook/rocksdb/pull/4432#discussion_r221072219 and
@@ -440,9 +493,14 @@ class Compaction {
   // Compaction input files organized by level. Constant after construction
   const std::vector<CompactionInputFiles> inputs_;
 
-  // A copy of inputs_, organized more closely in memory
+  // A copy of inputs_ without the reused input files, organized more closely
+  // in memory
   autovector<LevelFilesBrief, 2> input_levels_;
 
+  // See reused_input_files() and files_to_move()
+  std::vector<FileMetaData*> reused_input_files_;
+  std::vector<FileMetaData*> files_to_move_;
+
   // State used to check for number of overlapping grandparent files
   // (grandparent == "output_level_ + 1")
   std::vector<FileMetaData*> grandparents_;
@@ -463,6 +521,8 @@ class Compaction {
   // compaction
   bool is_trivial_move_;
 
+  int round_robin_cursor_ = -1;
+
   // Does input compression match the output compression?
   bool InputCompressionMatchesOutput() const;
 
@@ -62,7 +62,9 @@ CompactionIterator::CompactionIterator(
     const std::shared_ptr<Logger> info_log,
     const std::string* full_history_ts_low,
     const SequenceNumber penultimate_level_cutoff_seqno)
-    : input_(input, cmp,
+    : filter_batching_input_(CreateFilterBatchingIteratorIfNeeded(
+          input, cmp, compaction_filter, snapshot_checker, compaction.get())),
+      input_(filter_batching_input_ ? filter_batching_input_.get() : input, cmp,
              !compaction || compaction->DoesInputReferenceBlobFiles()),
       cmp_(cmp),
       merge_helper_(merge_helper),
@@ -273,6 +275,19 @@ bool CompactionIterator::InvokeFilterIfNeeded(bool* need_skip,
         value_type = CompactionFilter::ValueType::kValue;
       }
     }
+    if (kTypeValue == ikey_.type && filter_batching_input_ != nullptr &&
+        filter_batching_input_->TakeFilterDecision(&filter,
+                                                   &compaction_filter_value_)) {
+      if (filter != CompactionFilter::Decision::kKeep &&
+          filter != CompactionFilter::Decision::kRemove &&
+          filter != CompactionFilter::Decision::kChangeValue &&
+          filter != CompactionFilter::Decision::kPurge) {
+        status_ = Status::NotSupported(
+            "Unsupported decision returned by FilterBatch()");
+        validity_info_.Invalidate();
+        return false;
+      }
+    }
     if (CompactionFilter::Decision::kUndetermined == filter) {
       filter = compaction_filter_->FilterV2(
           level_, filter_key, value_type,
@@ -944,13 +959,19 @@ void CompactionIterator::NextFromInput() {
   }
 }
 
-bool CompactionIterator::ExtractLargeValueIfNeededImpl() {
-  if (!blob_file_builder_) {
+bool CompactionIterator::ExtractLargeValueIfNeededImpl(
+    CompactionFilter::BlobPlacement placement) {
+  if (!blob_file_builder_ ||
+      placement == CompactionFilter::BlobPlacement::kInline) {
     return false;
   }
 
   blob_index_.clear();
-  const Status s = blob_file_builder_->Add(user_key(), value_, &blob_index_);
+  const Status s =
+      placement == CompactionFilter::BlobPlacement::kBlobFile
+          ? blob_file_builder_->AddRegardlessOfSize(user_key(), value_,
+                                                    &blob_index_)
+          : blob_file_builder_->Add(user_key(), value_, &blob_index_);
 
   if (!s.ok()) {
     status_ = s;
@@ -968,10 +989,11 @@ bool CompactionIterator::ExtractLargeValueIfNeededImpl() {
   return true;
 }
 
-void CompactionIterator::ExtractLargeValueIfNeeded() {
+void CompactionIterator::ExtractLargeValueIfNeeded(
+    CompactionFilter::BlobPlacement placement) {
   assert(ikey_.type == kTypeValue);
 
-  if (!ExtractLargeValueIfNeededImpl()) {
+  if (!ExtractLargeValueIfNeededImpl(placement)) {
     return;
   }
 
@@ -979,15 +1001,19 @@ void CompactionIterator::ExtractLargeValueIfNeeded() {
   current_key_.UpdateInternalKey(ikey_.sequence, ikey_.type);
 }
 
-void CompactionIterator::GarbageCollectBlobIfNeeded() {
+void CompactionIterator::GarbageCollectBlobIfNeeded(
+    CompactionFilter::BlobPlacement placement) {
   assert(ikey_.type == kTypeBlobIndex);
 
   if (!compaction_) {
     return;
   }
 
+  const bool inline_blob =
+      placement == CompactionFilter::BlobPlacement::kInline;
+
   // GC for integrated BlobDB
-  if (compaction_->enable_blob_garbage_collection()) {
+  if (compaction_->enable_blob_garbage_collection() || inline_blob) {
     TEST_SYNC_POINT_CALLBACK(
         "CompactionIterator::GarbageCollectBlobIfNeeded::TamperWithBlobIndex",
         &value_);
@@ -1005,8 +1031,8 @@ void CompactionIterator::GarbageCollectBlobIfNeeded() {
       }
     }
 
-    if (blob_index.file_number() >=
-        blob_garbage_collection_cutoff_file_number_) {
+    if (!inline_blob && blob_index.file_number() >=
+                            blob_garbage_collection_cutoff_file_number_) {
       return;
     }
 
@@ -1034,12 +1060,14 @@ void CompactionIterator::GarbageCollectBlobIfNeeded() {
     ++iter_stats_.num_blobs_read;
     iter_stats_.total_blob_bytes_read += bytes_read;
 
-    ++iter_stats_.num_blobs_relocated;
-    iter_stats_.total_blob_bytes_relocated += blob_index.size();
+    if (!inline_blob) {
+      ++iter_stats_.num_blobs_relocated;
+      iter_stats_.total_blob_bytes_relocated += blob_index.size();
+    }
 
     value_ = blob_value_;
 
-    if (ExtractLargeValueIfNeededImpl()) {
+    if (ExtractLargeValueIfNeededImpl(placement)) {
       return;
     }
 
@@ -1124,12 +1152,40 @@ void CompactionIterator::DecideOutputLevel() {
   }
 }
 
+CompactionFilter::BlobPlacement CompactionIterator::DecideBlobPlacement() {
+  assert(ikey_.type == kTypeValue || ikey_.type == kTypeBlobIndex);
+
+  if (!blob_file_builder_ || !compaction_ || !compaction_filter_ ||
+      compaction_filter_->IsStackedBlobDbInternalCompactionFilter()) {
+    return CompactionFilter::BlobPlacement::kDefault;
+  }
+
+  CompactionFilter::ValueType value_type = CompactionFilter::ValueType::kValue;
+  uint64_t value_size = value_.size();
+  if (ikey_.type == kTypeBlobIndex) {
+    BlobIndex blob_index;
+    // Invalid blob references are reported by garbage collection, if at all.
+    if (!blob_index.DecodeFrom(value_).ok() || blob_index.HasTTL() ||
+        blob_index.IsInlined()) {
+      return CompactionFilter::BlobPlacement::kDefault;
+    }
+    value_type = CompactionFilter::ValueType::kBlobIndex;
+    value_size = blob_index.size();
+  }
+
+  CompactionFilter::ValueAccessStats stats;
+  compaction_->GetValueAccessStats(ikey_.user_key, &value_access_stats_ptrs_,
+                                   &stats);
+  return compaction_filter_->DecideBlobPlacement(
+      level_, ikey_.user_key, value_type, value_size, stats);
+}
+
 void CompactionIterator::PrepareOutput() {
   if (Valid()) {
     if (ikey_.type == kTypeValue) {
-      ExtractLargeValueIfNeeded();
+      ExtractLargeValueIfNeeded(DecideBlobPlacement());
     } else if (ikey_.type == kTypeBlobIndex) {
-      GarbageCollectBlobIfNeeded();
+      GarbageCollectBlobIfNeeded(DecideBlobPlacement());
     }
 
     if (compaction_ != nullptr && compaction_->SupportsPerKeyPlacement()) {
@@ -1242,6 +1298,134 @@ inline SequenceNumber CompactionIterator::findEarliestVisibleSnapshot(
   return kMaxSequenceNumber;
 }
 
+FilterBatchingIterator::FilterBatchingIterator(
+    InternalIterator* iter, const Comparator* ucmp,
+    const CompactionFilter* compaction_filter,
+    const CompactionFilter::BatchOptions& batch_options, int level)
+    : iter_(iter),
+      ucmp_(ucmp),
+      compaction_filter_(compaction_filter),
+      batch_options_(batch_options),
+      level_(level) {
+  assert(iter_);
+  assert(ucmp_);
+  assert(compaction_filter_);
+  ReadBatch();
+}
+
+void FilterBatchingIterator::Next() {
+  assert(Valid());
+  entries_.pop_front();
+  if (entries_.empty()) {
+    ReadBatch();
+  }
+}
+
+void FilterBatchingIterator::Seek(const Slice& target) {
+  // Decisions about skipped entries are dropped.
+  entries_.clear();
+  has_last_user_key_ = false;
+  iter_->Seek(target);
+  ReadBatch();
+}
+
+bool FilterBatchingIterator::TakeFilterDecision(
+    CompactionFilter::Decision* decision, std::string* new_value) {
+  assert(Valid());
+  Entry& entry = entries_.front();
+  if (!entry.has_decision) {
+    return false;
+  }
+  entry.has_decision = false;
+  *decision = entry.decision;
+  new_value->swap(entry.new_value);
+  return true;
+}
+
+void FilterBatchingIterator::ReadBatch() {
+  assert(entries_.empty());
+  batch_entries_.clear();
+  size_t num_bytes = 0;
+  while (iter_->Valid() && entries_.size() < batch_options_.max_entries &&
+         num_bytes < batch_options_.max_bytes) {
+    entries_.emplace_back();
+    Entry& entry = entries_.back();
+    const Slice key = iter_->key();
+    const Slice value = iter_->value();
+    entry.key.assign(key.data(), key.size());
+    entry.value.assign(value.data(), value.size());
+    num_bytes += key.size() + value.size();
+
+    ParsedInternalKey ikey;
+    if (!ParseInternalKey(entry.key, &ikey, /*log_err_key=*/false).ok()) {
+      // The CompactionIterator treats the next valid key as a new user key
+      // after a corrupted one.
+      has_last_user_key_ = false;
+    } else {
+      const bool new_user_key =
+          !has_last_user_key_ || !ucmp_->Equal(ikey.user_key, last_user_key_);
+      if (new_user_key) {
+        last_user_key_.assign(ikey.user_key.data(), ikey.user_key.size());
+        has_last_user_key_ = true;
+        if (ikey.type == kTypeValue) {
+          batch_entries_.push_back(&entry);
+        }
+      }
+    }
+    iter_->Next();
+  }
+  if (batch_entries_.empty()) {
+    return;
+  }
+
+  const size_t n = batch_entries_.size();
+  batch_keys_.clear();
+  batch_values_.clear();
+  for (Entry* entry : batch_entries_) {
+    batch_keys_.push_back(ExtractUserKey(entry->key));
+    batch_values_.push_back(entry->value);
+  }
+  batch_decisions_.assign(n, CompactionFilter::Decision::kUndetermined);
+  batch_new_values_.resize(n);
+  for (auto& new_value : batch_new_values_) {
+    new_value.clear();
+  }
+  compaction_filter_->FilterBatch(level_, batch_keys_, batch_values_,
+                                  &batch_decisions_, &batch_new_values_);
+  for (size_t i = 0; i < n; ++i) {
+    Entry* entry = batch_entries_[i];
+    entry->has_decision = true;
+    entry->decision = batch_decisions_[i];
+    entry->new_value.swap(batch_new_values_[i]);
+  }
+}
+
+std::unique_ptr<FilterBatchingIterator>
+CompactionIterator::CreateFilterBatchingIteratorIfNeeded(
+    InternalIterator* input, const Comparator* cmp,
+    const CompactionFilter* compaction_filter,
+    const SnapshotChecker* snapshot_checker,
+    const CompactionProxy* compaction) {
+  // With a snapshot checker, the filter applies to the first committed
+  // version of a user key, which is only known while iterating. With
+  // user-defined timestamps, versions older than full_history_ts_low may be
+  // treated as new user keys.
+  if (compaction_filter == nullptr ||
+      compaction_filter->IsStackedBlobDbInternalCompactionFilter() ||
+      snapshot_checker != nullptr || cmp == nullptr ||
+      cmp->timestamp_size() > 0) {
+    return nullptr;
+  }
+  CompactionFilter::BatchOptions batch_options;
+  if (!compaction_filter->SupportsFilterBatch(&batch_options)) {
+    return nullptr;
+  }
+  batch_options.max_entries = std::max<size_t>(batch_options.max_entries, 1);
+  return std::unique_ptr<FilterBatchingIterator>(new FilterBatchingIterator(
+      input, cmp, compaction_filter, batch_options,
+      compaction == nullptr ? 0 : compaction->level()));
+}
+
 uint64_t CompactionIterator::ComputeBlobGarbageCollectionCutoffFileNumber(
     const CompactionProxy* compaction) {
   if (!compaction) {
@@ -71,6 +71,70 @@ class SequenceIterWrapper : public InternalIterator {
   bool need_count_entries_;
 };
 
+// A wrapper of the input of a CompactionIterator whose compaction filter
+// supports FilterBatch(). It reads ahead a batch of entries, runs the filter
+// over the plain values among them that are the first version of their user
+// key, and keeps the decisions until the CompactionIterator gets to the
+// corresponding entries. Those are exactly the entries the CompactionIterator
+// would otherwise pass to FilterV2() when there is no snapshot checker and no
+// user-defined timestamp.
+class FilterBatchingIterator : public InternalIterator {
+ public:
+  // `iter` must already be positioned.
+  FilterBatchingIterator(InternalIterator* iter, const Comparator* ucmp,
+                         const CompactionFilter* compaction_filter,
+                         const CompactionFilter::BatchOptions& batch_options,
+                         int level);
+
+  bool Valid() const override { return !entries_.empty(); }
+  Status status() const override { return iter_->status(); }
+  void Next() override;
+  void Seek(const Slice& target) override;
+  Slice key() const override { return entries_.front().key; }
+  Slice value() const override { return entries_.front().value; }
+
+  // Unused InternalIterator methods
+  void SeekToFirst() override { assert(false); }
+  void Prev() override { assert(false); }
+  void SeekForPrev(const Slice& /* target */) override { assert(false); }
+  void SeekToLast() override { assert(false); }
+
+  // If the filter has decided about the current entry, returns true and
+  // stores the decision and new value.
+  bool TakeFilterDecision(CompactionFilter::Decision* decision,
+                          std::string* new_value);
+
+ private:
+  struct Entry {
+    std::string key;
+    std::string value;
+    bool has_decision = false;
+    CompactionFilter::Decision decision = CompactionFilter::Decision::kKeep;
+    std::string new_value;
+  };
+
+  // Reads the next batch of entries from `iter_` and filters them.
+  void ReadBatch();
+
+  InternalIterator* iter_;  // not owned
+  const Comparator* ucmp_;
+  const CompactionFilter* compaction_filter_;
+  const CompactionFilter::BatchOptions batch_options_;
+  const int level_;
+  // Entries of the current batch that have not been consumed yet. Elements
+  // are never moved, so key() and value() stay valid until Next().
+  std::deque<Entry> entries_;
+  // User key of the last entry read from `iter_`, if it was a valid key.
+  std::string last_user_key_;
+  bool has_last_user_key_ = false;
+  // Scratch space reused across batches.
+  std::vector<Entry*> batch_entries_;
+  std::vector<Slice> batch_keys_;
+  std::vector<Slice> batch_values_;
+  std::vector<CompactionFilter::Decision> batch_decisions_;
+  std::vector<std::string> batch_new_values_;
+};
+
 class CompactionIterator {
  public:
   // A wrapper around Compaction. Has a much smaller interface, only what
@@ -109,6 +173,10 @@ class CompactionIterator {
     virtual bool SupportsPerKeyPlacement() const = 0;
 
     virtual bool WithinPenultimateLevelOutputRange(const Slice& key) const = 0;
+
+    virtual void GetValueAccessStats(
+        const Slice& user_key, std::vector<size_t>* file_ptrs,
+        CompactionFilter::ValueAccessStats* stats) const = 0;
   };
 
   class RealCompaction : public CompactionProxy {
@@ -177,6 +245,12 @@ class CompactionIterator {
       return compaction_->WithinPenultimateLevelOutputRange(key);
     }
 
+    void GetValueAccessStats(
+        const Slice& user_key, std::vector<size_t>* file_ptrs,
+        CompactionFilter::ValueAccessStats* stats) const override {
+      compaction_->GetValueAccessStats(user_key, file_ptrs, stats);
+    }
+
    private:
     const Compaction* compaction_;
   };
@@ -259,14 +333,16 @@ class CompactionIterator {
 
   // Passes the output value to the blob file builder (if any), and replaces it
   // with the corresponding blob reference if it has been actually written to a
-  // blob file (i.e. if it passed the value size check). Returns true if the
-  // value got extracted to a blob file, false otherwise.
-  bool ExtractLargeValueIfNeededImpl();
+  // blob file (i.e. if it passed the value size check, or "placement" is
+  // kBlobFile). Returns true if the value got extracted to a blob file, false
+  // otherwise.
+  bool ExtractLargeValueIfNeededImpl(
+      CompactionFilter::BlobPlacement placement);
 
   // Extracts large values as described above, and updates the internal key's
   // type to kTypeBlobIndex if the value got extracted. Should only be called
   // for regular values (kTypeValue).
-  void ExtractLargeValueIfNeeded();
+  void ExtractLargeValueIfNeeded(CompactionFilter::BlobPlacement placement);
 
   // Relocates valid blobs residing in the oldest blob files if garbage
   // collection is enabled. Relocated blobs are written to new blob files or
@@ -274,9 +350,16 @@ class CompactionIterator {
   // enable_blob_files and min_blob_size). Should only be called for blob
   // references (kTypeBlobIndex).
   //
+  // Blobs are also read back into the LSM tree if "placement" is kInline.
+  //
   // Note: the stacked BlobDB implementation's compaction filter based GC
   // algorithm is also called from here.
-  void GarbageCollectBlobIfNeeded();
+  void GarbageCollectBlobIfNeeded(CompactionFilter::BlobPlacement placement);
+
+  // Asks the compaction filter where the output value should be stored, see
+  // CompactionFilter::DecideBlobPlacement(). Only called for plain values and
+  // blob references.
+  CompactionFilter::BlobPlacement DecideBlobPlacement();
 
   // Invoke compaction filter if needed.
   // Return true on success, false on failures (e.g.: kIOError).
@@ -317,11 +400,21 @@ class CompactionIterator {
 
   static uint64_t ComputeBlobGarbageCollectionCutoffFileNumber(
       const CompactionProxy* compaction);
+  static std::unique_ptr<FilterBatchingIterator>
+  CreateFilterBatchingIteratorIfNeeded(
+      InternalIterator* input, const Comparator* cmp,
+      const CompactionFilter* compaction_filter,
+      const SnapshotChecker* snapshot_checker,
+      const CompactionProxy* compaction);
   static std::unique_ptr<BlobFetcher> CreateBlobFetcherIfNeeded(
       const CompactionProxy* compaction);
   static std::unique_ptr<PrefetchBufferCollection>
   CreatePrefetchBufferCollectionIfNeeded(const CompactionProxy* compaction);
 
+  // Reads ahead of input_ to run the compaction filter in batches. nullptr
+  // unless the filter supports FilterBatch(). Declared before input_, which
+  // wraps it.
+  std::unique_ptr<FilterBatchingIterator> filter_batching_input_;
   SequenceIterWrapper input_;
   const Comparator* cmp_;
   MergeHelper* merge_helper_;
@@ -446,6 +539,8 @@ class CompactionIterator {
   // increasing so a later call to the function must be looking for a key that
   // is in or beyond the last file checked during the previous call
   std::vector<size_t> level_ptrs_;
+  // Same for compaction->GetValueAccessStats()
+  std::vector<size_t> value_access_stats_ptrs_;
   CompactionIterationStats iter_stats_;
 
   // Used to avoid purging uncommitted values. The application can specify
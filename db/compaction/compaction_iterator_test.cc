@@ -188,6 +188,12 @@ class FakeCompaction : public CompactionIterator::CompactionProxy {
     return (!key.starts_with("unsafe_pb"));
   }
 
+  void GetValueAccessStats(
+      const Slice& /*user_key*/, std::vector<size_t>* /*file_ptrs*/,
+      CompactionFilter::ValueAccessStats* stats) const override {
+    *stats = CompactionFilter::ValueAccessStats();
+  }
+
   bool key_not_exists_beyond_output_level = false;
 
   bool is_bottommost_level = false;
@@ -539,6 +545,103 @@ TEST_P(CompactionIteratorTest, CompactionFilterSkipUntil) {
   ASSERT_EQ(expected_actions, iter_->log);
 }
 
+TEST_P(CompactionIteratorTest, CompactionFilterBatch) {
+  class Filter : public CompactionFilter {
+   public:
+    bool SupportsFilterBatch(BatchOptions* options) const override {
+      options->max_entries = 3;
+      return true;
+    }
+
+    void FilterBatch(int level, const std::vector<Slice>& keys,
+                     const std::vector<Slice>& existing_values,
+                     std::vector<Decision>* decisions,
+                     std::vector<std::string>* new_values) const override {
+      std::vector<std::string> batch;
+      for (size_t i = 0; i < keys.size(); ++i) {
+        batch.push_back(keys[i].ToString());
+        (*decisions)[i] = Decide(level, keys[i], existing_values[i],
+                                 &(*new_values)[i]);
+      }
+      batches.push_back(batch);
+    }
+
+    Decision FilterV2(int level, const Slice& key, ValueType t,
+                      const Slice& existing_value, std::string* new_value,
+                      std::string* /*skip_until*/) const override {
+      single_keys.push_back(key.ToString());
+      if (t == ValueType::kMergeOperand) {
+        return Decision::kKeep;
+      }
+      return Decide(level, key, existing_value, new_value);
+    }
+
+    Decision Decide(int /*level*/, const Slice& key,
+                    const Slice& existing_value,
+                    std::string* new_value) const {
+      if (key == "a") {
+        return Decision::kRemove;
+      }
+      if (key == "c") {
+        *new_value = existing_value.ToString() + "-changed";
+        return Decision::kChangeValue;
+      }
+      if (key == "f") {
+        return unsupported_decision;
+      }
+      return Decision::kKeep;
+    }
+
+    const char* Name() const override {
+      return "CompactionIteratorTest.CompactionFilterBatch::Filter";
+    }
+
+    Decision unsupported_decision = Decision::kKeep;
+    mutable std::vector<std::vector<std::string>> batches;
+    mutable std::vector<std::string> single_keys;
+  };
+
+  NoMergingMergeOp merge_op;
+  Filter filter;
+  // With batches of three entries, only the first version of "a", "c" and
+  // "e" is passed to FilterBatch(), each in its own batch.
+  RunTest(
+      {test::KeyStr("a", 50, kTypeValue), test::KeyStr("a", 40, kTypeValue),
+       test::KeyStr("b", 45, kTypeDeletion), test::KeyStr("b", 30, kTypeValue),
+       test::KeyStr("c", 60, kTypeValue), test::KeyStr("d", 55, kTypeMerge),
+       test::KeyStr("e", 70, kTypeValue)},
+      {"av50", "av40", "", "bv30", "cv60", "dm55", "ev70"},
+      {test::KeyStr("a", 50, kTypeDeletion),
+       test::KeyStr("b", 45, kTypeDeletion), test::KeyStr("c", 60, kTypeValue),
+       test::KeyStr("d", 55, kTypeMerge), test::KeyStr("e", 70, kTypeValue)},
+      {"", "", "cv60-changed", "dm55", "ev70"}, kMaxSequenceNumber, &merge_op,
+      &filter);
+  if (GetParam()) {
+    // Filters are not batched with a snapshot checker.
+    ASSERT_TRUE(filter.batches.empty());
+    ASSERT_EQ(std::vector<std::string>({"a", "c", "d", "e"}),
+              filter.single_keys);
+  } else {
+    ASSERT_EQ(std::vector<std::vector<std::string>>({{"a"}, {"c"}, {"e"}}),
+              filter.batches);
+    ASSERT_EQ(std::vector<std::string>({"d"}), filter.single_keys);
+  }
+
+  if (!GetParam()) {
+    filter.unsupported_decision =
+        CompactionFilter::Decision::kRemoveAndSkipUntil;
+    InitIterators({test::KeyStr("e", 70, kTypeValue),
+                   test::KeyStr("f", 80, kTypeValue)},
+                  {"ev70", "fv80"}, {}, {}, kMaxSequenceNumber,
+                  kMaxSequenceNumber, &merge_op, &filter);
+    c_iter_->SeekToFirst();
+    ASSERT_TRUE(c_iter_->Valid());
+    c_iter_->Next();
+    ASSERT_FALSE(c_iter_->Valid());
+    ASSERT_TRUE(c_iter_->status().IsNotSupported());
+  }
+}
+
 TEST_P(CompactionIteratorTest, ShuttingDownInFilter) {
   NoMergingMergeOp merge_op;
   StallingFilter filter;
@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <cinttypes>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <set>
 #include <utility>
@@ -23,6 +24,7 @@
 #include "db/builder.h"
 #include "db/compaction/clipping_iterator.h"
 #include "db/compaction/compaction_state.h"
+#include "db/compaction/range_skipping_iterator.h"
 #include "db/db_impl/db_impl.h"
 #include "db/dbformat.h"
 #include "db/error_handler.h"
@@ -55,6 +57,7 @@
 #include "table/table_builder.h"
 #include "table/unique_id_impl.h"
 #include "test_util/sync_point.h"
+#include "util/mutexlock.h"
 #include "util/stop_watch.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -239,11 +242,29 @@ void CompactionJob::Prepare() {
   write_hint_ = cfd->CalculateSSTWriteHint(c->output_level());
   bottommost_level_ = c->bottommost_level();
 
+  if (c->ShouldReuseInputFiles()) {
+    FindReusedInputFiles();
+  }
+
   if (c->ShouldFormSubcompactions()) {
     StopWatch sw(db_options_.clock, stats_, SUBCOMPACTION_SETUP_TIME);
     GenSubcompactionBoundaries();
   }
   if (boundaries_.size() > 1) {
+    subcompaction_work_stealing_ =
+        !split_anchors_.empty() && !c->DoesInputReferenceBlobFiles() &&
+        !c->SupportsPerKeyPlacement() &&
+        cfd->user_comparator()->timestamp_size() == 0 &&
+        db_options_.compaction_service == nullptr;
+    if (subcompaction_work_stealing_) {
+      // Split sub-compactions are appended while others are running, so the
+      // vector must never reallocate.
+      max_split_subcompactions_ = 4 * (boundaries_.size() + 1);
+      compact_->sub_compact_states.reserve(boundaries_.size() + 1 +
+                                           max_split_subcompactions_);
+    } else {
+      split_anchors_.clear();
+    }
     for (size_t i = 0; i <= boundaries_.size(); i++) {
       compact_->sub_compact_states.emplace_back(
           c, (i != 0) ? std::optional<Slice>(boundaries_[i - 1]) : std::nullopt,
@@ -404,6 +425,349 @@ struct RangeWithSize {
       : range(a, b), size(s) {}
 };
 
+void CompactionJob::FindReusedInputFiles() {
+  Compaction* c = compact_->compaction;
+  ColumnFamilyData* cfd = c->column_family_data();
+  const InternalKeyComparator& icomp = cfd->internal_comparator();
+  const Comparator* ucmp = icomp.user_comparator();
+  Version* v = c->input_version();
+  std::vector<FileMetaData*> reused_files;
+  {
+    InstrumentedMutexUnlock unlock_guard(db_mutex_);
+
+    std::vector<std::pair<int, FileMetaData*>> files;
+    for (size_t which = 0; which < c->num_input_levels(); which++) {
+      for (FileMetaData* f : *c->inputs(which)) {
+        // Range tombstones may extend output files beyond the keys they
+        // contain, so their files could end up overlapping the reused ones.
+        std::shared_ptr<const TableProperties> tp;
+        Status s = v->GetTableProperties(&tp, f, nullptr);
+        if (!s.ok() || tp->num_range_deletions > 0) {
+          return;
+        }
+        files.emplace_back(c->level(which), f);
+      }
+    }
+
+    ReadOptions read_options;
+    read_options.fill_cache = false;
+    for (const auto& file : files) {
+      FileMetaData* f = file.second;
+      if (file.first != c->output_level() && !c->CanMoveInputFile(f)) {
+        continue;
+      }
+      bool overlapped = false;
+      for (const auto& other : files) {
+        FileMetaData* g = other.second;
+        if (g == f ||
+            ucmp->Compare(g->largest.user_key(), f->smallest.user_key()) < 0 ||
+            ucmp->Compare(g->smallest.user_key(), f->largest.user_key()) > 0) {
+          continue;
+        }
+        // The key ranges overlap, so look for an actual key of `g` within
+        // the range of `f`.
+        std::unique_ptr<InternalIterator> iter(cfd->table_cache()->NewIterator(
+            read_options, file_options_for_read_, icomp, *g,
+            /*range_del_agg=*/nullptr,
+            c->mutable_cf_options()->prefix_extractor,
+            /*table_reader_ptr=*/nullptr,
+            /*file_read_hist=*/nullptr, TableReaderCaller::kCompaction,
+            /*arena=*/nullptr, /*skip_filters=*/true, other.first,
+            MaxFileSizeForL0MetaPin(*c->mutable_cf_options()),
+            /*smallest_compaction_key=*/nullptr,
+            /*largest_compaction_key=*/nullptr,
+            /*allow_unprepared_value=*/true));
+        InternalKey seek_key(f->smallest.user_key(), kMaxSequenceNumber,
+                             kValueTypeForSeek);
+        iter->Seek(seek_key.Encode());
+        if (iter->Valid()) {
+          overlapped = ucmp->Compare(ExtractUserKey(iter->key()),
+                                     f->largest.user_key()) <= 0;
+        } else {
+          overlapped = !iter->status().ok();
+        }
+        if (overlapped) {
+          break;
+        }
+      }
+      if (!overlapped) {
+        reused_files.push_back(f);
+      }
+    }
+  }
+  if (!reused_files.empty()) {
+    TEST_SYNC_POINT_CALLBACK("CompactionJob::FindReusedInputFiles",
+                             &reused_files);
+    c->SetReusedInputFiles(std::move(reused_files));
+  }
+}
+
+void CompactionJob::FindCleanDataBlocks(
+    SubcompactionState* sub_compact,
+    const CompactionFilter* compaction_filter) {
+  const Compaction* c = sub_compact->compaction;
+  if (!c->ShouldCopyCleanDataBlocks() || compaction_filter != nullptr ||
+      snapshot_checker_ != nullptr) {
+    return;
+  }
+  ColumnFamilyData* cfd = c->column_family_data();
+  const InternalKeyComparator& icomp = cfd->internal_comparator();
+  const Comparator* ucmp = icomp.user_comparator();
+  Version* v = c->input_version();
+  const std::optional<Slice>& start = sub_compact->start;
+  const std::optional<Slice>& end = sub_compact->end;
+
+  std::vector<std::pair<int, const FileMetaData*>> files;
+  for (size_t which = 0; which < c->num_input_levels(); which++) {
+    const LevelFilesBrief* level_files = c->input_levels(which);
+    for (size_t i = 0; i < level_files->num_files; i++) {
+      const FileMetaData* f = level_files->files[i].file_metadata;
+      if ((start.has_value() &&
+           ucmp->Compare(f->largest.user_key(), start.value()) < 0) ||
+          (end.has_value() &&
+           ucmp->Compare(f->smallest.user_key(), end.value()) >= 0)) {
+        continue;
+      }
+      // Range tombstones may cover keys of any block.
+      std::shared_ptr<const TableProperties> tp;
+      Status s = v->GetTableProperties(&tp, f, nullptr);
+      if (!s.ok() || tp->num_range_deletions > 0) {
+        return;
+      }
+      files.emplace_back(c->level(which), f);
+    }
+  }
+
+  ReadOptions read_options;
+  read_options.verify_checksums = true;
+  read_options.fill_cache = false;
+  read_options.rate_limiter_priority = GetRateLimiterPriority();
+  read_options.total_order_seek = true;
+  // Iterators over the input files, created on first use
+  std::vector<std::unique_ptr<InternalIterator>> iters(files.size());
+  auto get_iter = [&](size_t i) {
+    if (iters[i] == nullptr) {
+      iters[i].reset(cfd->table_cache()->NewIterator(
+          read_options, file_options_for_read_, icomp, *files[i].second,
+          /*range_del_agg=*/nullptr, c->mutable_cf_options()->prefix_extractor,
+          /*table_reader_ptr=*/nullptr,
+          /*file_read_hist=*/nullptr, TableReaderCaller::kCompaction,
+          /*arena=*/nullptr, /*skip_filters=*/true, files[i].first,
+          MaxFileSizeForL0MetaPin(*c->mutable_cf_options()),
+          /*smallest_compaction_key=*/nullptr,
+          /*largest_compaction_key=*/nullptr,
+          /*allow_unprepared_value=*/false));
+    }
+    return iters[i].get();
+  };
+
+  // The compaction iterator zeroes out the sequence numbers of the keys in
+  // the earliest snapshot when compacting to the bottommost level.
+  const SequenceNumber earliest_snapshot =
+      existing_snapshots_.empty() ? kMaxSequenceNumber
+                                  : existing_snapshots_.front();
+  for (size_t fi = 0; fi < files.size(); fi++) {
+    const FileMetaData* f = files[fi].second;
+    std::vector<TableReader::DataBlock> blocks;
+    Status s = cfd->table_cache()->GetDataBlocks(read_options, icomp, *f,
+                                                 &blocks);
+    if (!s.ok()) {
+      s.PermitUncheckedError();
+      continue;
+    }
+    std::vector<SubcompactionState::CleanDataBlock> clean_blocks;
+    std::vector<size_t> clean_block_indexes;
+    for (size_t i = 0; i < blocks.size(); i++) {
+      // All user keys of the block are within [lower, upper].
+      const Slice lower =
+          i == 0 ? f->smallest.user_key() : Slice(blocks[i - 1].user_key_bound);
+      const Slice upper = i + 1 == blocks.size()
+                              ? f->largest.user_key()
+                              : Slice(blocks[i].user_key_bound);
+      if (start.has_value() && ucmp->Compare(lower, start.value()) < 0) {
+        continue;
+      }
+      if (end.has_value() && ucmp->Compare(upper, end.value()) >= 0) {
+        break;
+      }
+      bool overlapped = false;
+      for (const FileMetaData* reused : c->reused_input_files()) {
+        if (ucmp->Compare(reused->largest.user_key(), lower) >= 0 &&
+            ucmp->Compare(reused->smallest.user_key(), upper) <= 0) {
+          overlapped = true;
+          break;
+        }
+      }
+      for (size_t gi = 0; !overlapped && gi < files.size(); gi++) {
+        const FileMetaData* g = files[gi].second;
+        if (gi == fi || ucmp->Compare(g->largest.user_key(), lower) < 0 ||
+            ucmp->Compare(g->smallest.user_key(), upper) > 0) {
+          continue;
+        }
+        InternalIterator* iter = get_iter(gi);
+        InternalKey seek_key(lower, kMaxSequenceNumber, kValueTypeForSeek);
+        iter->Seek(seek_key.Encode());
+        if (iter->Valid()) {
+          overlapped = ucmp->Compare(ExtractUserKey(iter->key()), upper) <= 0;
+        } else {
+          overlapped = !iter->status().ok();
+        }
+      }
+      if (overlapped) {
+        continue;
+      }
+
+      TableReader::RawDataBlock raw_block;
+      s = cfd->table_cache()->ReadRawDataBlock(read_options, icomp, *f,
+                                               blocks[i].handle, &raw_block);
+      if (!s.ok() || raw_block.compression_type != c->output_compression()) {
+        s.PermitUncheckedError();
+        continue;
+      }
+      // The compaction iterator passes values of distinct user keys through
+      // unchanged, unless it zeroes out their sequence numbers.
+      SubcompactionState::CleanDataBlock block{f, blocks[i].handle, "", ""};
+      bool clean = true;
+      InternalIterator* block_iter = raw_block.iter.get();
+      for (block_iter->SeekToFirst(); block_iter->Valid(); block_iter->Next()) {
+        ParsedInternalKey ikey;
+        if (!ParseInternalKey(block_iter->key(), &ikey,
+                              /*log_err_key=*/false)
+                 .ok() ||
+            ikey.type != kTypeValue ||
+            (c->bottommost_level() && ikey.sequence != 0 &&
+             ikey.sequence <= earliest_snapshot) ||
+            (!block.largest.empty() &&
+             ucmp->Compare(ikey.user_key, ExtractUserKey(block.largest)) <=
+                 0)) {
+          clean = false;
+          break;
+        }
+        if (block.smallest.empty()) {
+          block.smallest = block_iter->key().ToString();
+        }
+        block.largest = block_iter->key().ToString();
+      }
+      if (!block_iter->status().ok()) {
+        block_iter->status().PermitUncheckedError();
+        clean = false;
+      }
+      if (clean && !block.smallest.empty()) {
+        clean_blocks.push_back(std::move(block));
+        clean_block_indexes.push_back(i);
+      }
+    }
+
+    // Versions of the same user key may be spread over adjacent blocks. The
+    // runs of adjacent clean blocks must contain all versions of their first
+    // and last user keys.
+    auto straddles_before = [&](const SubcompactionState::CleanDataBlock& b) {
+      InternalIterator* iter = get_iter(fi);
+      InternalKey seek_key(ExtractUserKey(b.smallest), kMaxSequenceNumber,
+                           kValueTypeForSeek);
+      iter->Seek(seek_key.Encode());
+      return !iter->Valid() || icomp.Compare(iter->key(), b.smallest) != 0;
+    };
+    auto straddles_after = [&](const SubcompactionState::CleanDataBlock& b) {
+      InternalIterator* iter = get_iter(fi);
+      iter->Seek(b.largest);
+      if (iter->Valid()) {
+        iter->Next();
+      }
+      if (!iter->Valid()) {
+        return !iter->status().ok();
+      }
+      return ucmp->Compare(ExtractUserKey(iter->key()),
+                           ExtractUserKey(b.largest)) == 0;
+    };
+    size_t run_begin = 0;
+    while (run_begin < clean_blocks.size()) {
+      size_t run_end = run_begin + 1;
+      while (run_end < clean_blocks.size() &&
+             clean_block_indexes[run_end] ==
+                 clean_block_indexes[run_end - 1] + 1 &&
+             ucmp->Compare(ExtractUserKey(clean_blocks[run_end].smallest),
+                           ExtractUserKey(clean_blocks[run_end - 1].largest)) >
+                 0) {
+        run_end++;
+      }
+      const size_t next_run_begin = run_end;
+      while (run_begin < run_end &&
+             straddles_before(clean_blocks[run_begin])) {
+        run_begin++;
+      }
+      while (run_begin < run_end &&
+             straddles_after(clean_blocks[run_end - 1])) {
+        run_end--;
+      }
+      if (run_begin < run_end) {
+        sub_compact->clean_data_block_ranges.emplace_back(
+            clean_blocks[run_begin].smallest,
+            clean_blocks[run_end - 1].largest);
+        for (size_t i = run_begin; i < run_end; i++) {
+          sub_compact->clean_data_blocks.push_back(std::move(clean_blocks[i]));
+        }
+      }
+      run_begin = next_run_begin;
+    }
+  }
+  for (auto& iter : iters) {
+    if (iter != nullptr) {
+      iter->status().PermitUncheckedError();
+    }
+  }
+
+  std::sort(sub_compact->clean_data_blocks.begin(),
+            sub_compact->clean_data_blocks.end(),
+            [&icomp](const SubcompactionState::CleanDataBlock& a,
+                     const SubcompactionState::CleanDataBlock& b) {
+              return icomp.Compare(a.smallest, b.smallest) < 0;
+            });
+  std::sort(sub_compact->clean_data_block_ranges.begin(),
+            sub_compact->clean_data_block_ranges.end(),
+            [&icomp](const std::pair<std::string, std::string>& a,
+                     const std::pair<std::string, std::string>& b) {
+              return icomp.Compare(a.first, b.first) < 0;
+            });
+}
+
+Status CompactionJob::AddCleanDataBlocks(
+    SubcompactionState* sub_compact, const Slice* next_key,
+    const CompactionFileOpenFunc& open_file_func,
+    const CompactionFileCloseFunc& close_file_func) {
+  ColumnFamilyData* cfd = sub_compact->compaction->column_family_data();
+  const InternalKeyComparator& icomp = cfd->internal_comparator();
+  ReadOptions read_options;
+  read_options.verify_checksums = true;
+  read_options.fill_cache = false;
+  read_options.rate_limiter_priority = GetRateLimiterPriority();
+
+  Status s;
+  std::vector<SubcompactionState::CleanDataBlock>& blocks =
+      sub_compact->clean_data_blocks;
+  while (s.ok() && sub_compact->next_clean_data_block < blocks.size()) {
+    const SubcompactionState::CleanDataBlock& block =
+        blocks[sub_compact->next_clean_data_block];
+    if (next_key != nullptr && icomp.Compare(block.largest, *next_key) >= 0) {
+      break;
+    }
+    sub_compact->next_clean_data_block++;
+    TableReader::RawDataBlock raw_block;
+    s = cfd->table_cache()->ReadRawDataBlock(read_options, icomp, *block.file,
+                                             block.handle, &raw_block);
+    if (!s.ok()) {
+      break;
+    }
+    if (!sub_compact->Current().IsPendingClose() &&
+        sub_compact->ShouldStopBefore(block.smallest)) {
+      sub_compact->Current().SetPendingClose();
+    }
+    s = sub_compact->AddCleanDataBlock(&raw_block, open_file_func,
+                                       close_file_func);
+  }
+  return s;
+}
+
 void CompactionJob::GenSubcompactionBoundaries() {
   // The goal is to find some boundary keys so that we can evenly partition
   // the compaction input data into max_subcompactions ranges.
@@ -538,12 +902,12 @@ void CompactionJob::GenSubcompactionBoundaries() {
   if (num_planned_subcompactions == 1) return;
 
   // Group the ranges into subcompactions
-  uint64_t target_range_size = std::max(
-      total_size / num_planned_subcompactions,
-      MaxFileSizeForLevel(
-          *(c->mutable_cf_options()), out_lvl,
-          c->immutable_options()->compaction_style, base_level,
-          c->immutable_options()->level_compaction_dynamic_level_bytes));
+  const uint64_t max_file_size = MaxFileSizeForLevel(
+      *(c->mutable_cf_options()), out_lvl,
+      c->immutable_options()->compaction_style, base_level,
+      c->immutable_options()->level_compaction_dynamic_level_bytes);
+  uint64_t target_range_size =
+      std::max(total_size / num_planned_subcompactions, max_file_size);
 
   if (target_range_size >= total_size) {
     return;
@@ -565,6 +929,13 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
   TEST_SYNC_POINT_CALLBACK("CompactionJob::GenSubcompactionBoundaries:1",
                            &num_actual_subcompactions);
+  if (db_options_.enable_subcompaction_work_stealing && !boundaries_.empty()) {
+    // Keep the anchors to split the remaining range of a running
+    // sub-compaction later. A split leaves each part at least an output
+    // file's worth of data.
+    split_anchors_ = std::move(all_anchors);
+    min_split_range_size_ = max_file_size;
+  }
   // Shrink extra subcompactions resources when extra resrouces are acquired
   ShrinkSubcompactionResources(
       std::min((int)(num_planned_subcompactions - num_actual_subcompactions),
@@ -583,21 +954,25 @@ Status CompactionJob::Run() {
   const uint64_t start_micros = db_options_.clock->NowMicros();
 
   // Launch a thread for each of subcompactions 1...num_threads-1
+  num_busy_workers_ = num_threads;
   std::vector<port::Thread> thread_pool;
   thread_pool.reserve(num_threads - 1);
-  for (size_t i = 1; i < compact_->sub_compact_states.size(); i++) {
-    thread_pool.emplace_back(&CompactionJob::ProcessKeyValueCompaction, this,
+  for (size_t i = 1; i < num_threads; i++) {
+    thread_pool.emplace_back(&CompactionJob::RunSubcompactionWorker, this,
                              &compact_->sub_compact_states[i]);
   }
 
   // Always schedule the first subcompaction (whether or not there are also
   // others) in the current thread to be efficient with resources
-  ProcessKeyValueCompaction(&compact_->sub_compact_states[0]);
+  RunSubcompactionWorker(&compact_->sub_compact_states[0]);
 
   // Wait for all other threads (if there are any) to finish execution
   for (auto& thread : thread_pool) {
     thread.join();
   }
+  if (!split_boundaries_.empty()) {
+    SortSplitSubcompactions();
+  }
 
   compaction_stats_.SetMicros(db_options_.clock->NowMicros() - start_micros);
 
@@ -994,6 +1369,113 @@ void CompactionJob::NotifyOnSubcompactionCompleted(
 #endif  // ROCKSDB_LITE
 }
 
+void CompactionJob::RunSubcompactionWorker(SubcompactionState* sub_compact) {
+  while (sub_compact != nullptr) {
+    ProcessKeyValueCompaction(sub_compact);
+    if (!subcompaction_work_stealing_) {
+      break;
+    }
+    MutexLock l(&split_mutex_);
+    assert(num_busy_workers_ > 0);
+    --num_busy_workers_;
+    num_idle_workers_.fetch_add(1, std::memory_order_relaxed);
+    while (split_subcompactions_.empty() && num_busy_workers_ > 0) {
+      split_cv_.Wait();
+    }
+    num_idle_workers_.fetch_sub(1, std::memory_order_relaxed);
+    if (split_subcompactions_.empty()) {
+      // No sub-compaction is left running that could split off more work.
+      split_cv_.SignalAll();
+      sub_compact = nullptr;
+    } else {
+      sub_compact = split_subcompactions_.front();
+      split_subcompactions_.pop_front();
+      ++num_busy_workers_;
+    }
+  }
+}
+
+bool CompactionJob::MaybeSplitSubcompaction(SubcompactionState* sub_compact,
+                                            const Slice& next_user_key) {
+  assert(subcompaction_work_stealing_);
+  const Comparator* ucmp =
+      sub_compact->compaction->column_family_data()->user_comparator();
+
+  // Estimate the size of the remaining range from the anchors after
+  // `next_user_key` and before the end of the range.
+  auto first = std::upper_bound(
+      split_anchors_.begin(), split_anchors_.end(), next_user_key,
+      [ucmp](const Slice& key, const TableReader::Anchor& anchor) {
+        return ucmp->Compare(key, anchor.user_key) < 0;
+      });
+  auto last = split_anchors_.end();
+  if (sub_compact->end.has_value()) {
+    last = std::lower_bound(
+        first, split_anchors_.end(), sub_compact->end.value(),
+        [ucmp](const TableReader::Anchor& anchor, const Slice& key) {
+          return ucmp->Compare(anchor.user_key, key) < 0;
+        });
+  }
+  uint64_t remaining_size = 0;
+  for (auto it = first; it != last; ++it) {
+    remaining_size += it->range_size;
+  }
+  if (remaining_size < 2 * min_split_range_size_) {
+    return false;
+  }
+  auto split = first;
+  uint64_t cumulative_size = 0;
+  for (; split != last; ++split) {
+    cumulative_size += split->range_size;
+    if (cumulative_size >= remaining_size / 2) {
+      break;
+    }
+  }
+  assert(split != last);
+
+  MutexLock l(&split_mutex_);
+  if (split_subcompactions_.size() >=
+          num_idle_workers_.load(std::memory_order_relaxed) ||
+      split_boundaries_.size() >= max_split_subcompactions_) {
+    return false;
+  }
+  std::vector<SubcompactionState>& states = compact_->sub_compact_states;
+  assert(states.size() < states.capacity());
+  split_boundaries_.emplace_back(split->user_key);
+  const Slice split_key = split_boundaries_.back();
+  states.emplace_back(compact_->compaction, split_key, sub_compact->end,
+                      static_cast<uint32_t>(states.size()));
+  states.back().compaction_job_stats.num_split_subcompactions = 1;
+  sub_compact->end = split_key;
+  split_subcompactions_.push_back(&states.back());
+  split_cv_.Signal();
+  TEST_SYNC_POINT_CALLBACK("CompactionJob::MaybeSplitSubcompaction:Split",
+                           &states.back());
+  return true;
+}
+
+void CompactionJob::SortSplitSubcompactions() {
+  std::vector<SubcompactionState>& states = compact_->sub_compact_states;
+  const Comparator* ucmp =
+      compact_->compaction->column_family_data()->user_comparator();
+  std::vector<size_t> order(states.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    const std::optional<Slice>& start_a = states[a].start;
+    const std::optional<Slice>& start_b = states[b].start;
+    if (!start_a.has_value() || !start_b.has_value()) {
+      return !start_a.has_value() && start_b.has_value();
+    }
+    return ucmp->Compare(start_a.value(), start_b.value()) < 0;
+  });
+  std::vector<SubcompactionState> sorted_states;
+  sorted_states.reserve(states.size());
+  for (size_t i : order) {
+    sorted_states.emplace_back(std::move(states[i]));
+  }
+  states.swap(sorted_states);
+}
+
 void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   assert(sub_compact);
   assert(sub_compact->compaction);
@@ -1011,6 +1493,7 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   }
 #endif  // !ROCKSDB_LITE
 
+  const uint64_t start_micros = db_options_.clock->NowMicros();
   uint64_t prev_cpu_micros = db_options_.clock->CPUMicros();
 
   ColumnFamilyData* cfd = sub_compact->compaction->column_family_data();
@@ -1073,6 +1556,8 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     }
   }
 
+  FindCleanDataBlocks(sub_compact, compaction_filter);
+
   // Although the v2 aggregator is what the level iterator(s) know about,
   // the AddTombstones calls will be propagated down to the v1 aggregator.
   std::unique_ptr<InternalIterator> raw_input(versions_->MakeInputIterator(
@@ -1103,6 +1588,16 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     input = clip.get();
   }
 
+  // The keys of the clean data blocks are copied as stored, so they bypass
+  // the compaction iterator.
+  std::unique_ptr<InternalIterator> clean_block_skipper;
+  if (!sub_compact->clean_data_block_ranges.empty()) {
+    clean_block_skipper = std::make_unique<RangeSkippingIterator>(
+        input, &sub_compact->clean_data_block_ranges,
+        &cfd->internal_comparator());
+    input = clean_block_skipper.get();
+  }
+
   std::unique_ptr<InternalIterator> blob_counter;
 
   if (sub_compact->compaction->DoesInputReferenceBlobFiles()) {
@@ -1200,15 +1695,6 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   // it only output to single level
   sub_compact->AssignRangeDelAggregator(std::move(range_del_agg));
 
-  if (c_iter->Valid() && sub_compact->compaction->output_level() != 0) {
-    sub_compact->FillFilesToCutForTtl();
-    // ShouldStopBefore() maintains state based on keys processed so far. The
-    // compaction loop always calls it on the "next" key, thus won't tell it the
-    // first key. So we do that here.
-    sub_compact->ShouldStopBefore(c_iter->key());
-  }
-  const auto& c_iter_stats = c_iter->iter_stats();
-
   // define the open and close functions for the compaction files, which will be
   // used open/close output files when needed.
   const CompactionFileOpenFunc open_file_func =
@@ -1223,6 +1709,30 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
       };
 
   Status status;
+  if ((c_iter->Valid() || !sub_compact->clean_data_blocks.empty()) &&
+      sub_compact->compaction->output_level() != 0) {
+    sub_compact->FillFilesToCutForTtl();
+    if (c_iter->Valid()) {
+      Slice first_key = c_iter->key();
+      status = AddCleanDataBlocks(sub_compact, &first_key, open_file_func,
+                                  close_file_func);
+    }
+    // ShouldStopBefore() maintains state based on keys processed so far. The
+    // compaction loop always calls it on the "next" key, thus won't tell it the
+    // first key. So we do that here.
+    if (status.ok() && c_iter->Valid()) {
+      sub_compact->ShouldStopBefore(c_iter->key());
+    }
+  }
+  const auto& c_iter_stats = c_iter->iter_stats();
+
+  // With work stealing, whether to split off the rest of the range is
+  // checked every kSplitCheckEvery keys. After a split, the loop stops at
+  // the new end.
+  const uint64_t kSplitCheckEvery = 1000;
+  uint64_t num_keys_since_split_check = 0;
+  bool range_split = false;
+
   while (status.ok() && !cfd->IsDropped() && c_iter->Valid()) {
     // Invariant: c_iter.status() is guaranteed to be OK if c_iter->Valid()
     // returns true.
@@ -1230,6 +1740,20 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     assert(!end.has_value() || cfd->user_comparator()->Compare(
                                    c_iter->user_key(), end.value()) < 0);
 
+    if (subcompaction_work_stealing_ &&
+        sub_compact->clean_data_blocks.empty() &&
+        ++num_keys_since_split_check == kSplitCheckEvery) {
+      num_keys_since_split_check = 0;
+      if (num_idle_workers_.load(std::memory_order_relaxed) > 0 &&
+          MaybeSplitSubcompaction(sub_compact, c_iter->user_key())) {
+        range_split = true;
+      }
+    }
+    if (range_split && cfd->user_comparator()->Compare(
+                           c_iter->user_key(), sub_compact->end.value()) >= 0) {
+      break;
+    }
+
     if (c_iter_stats.num_input_records % kRecordStatsEvery ==
         kRecordStatsEvery - 1) {
       RecordDroppedKeys(c_iter_stats, &sub_compact->compaction_job_stats);
@@ -1255,6 +1779,14 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     if (c_iter->status().IsManualCompactionPaused()) {
       break;
     }
+    if (!sub_compact->clean_data_blocks.empty() && c_iter->Valid()) {
+      Slice next_key = c_iter->key();
+      status = AddCleanDataBlocks(sub_compact, &next_key, open_file_func,
+                                  close_file_func);
+      if (!status.ok()) {
+        break;
+      }
+    }
 
     // TODO: Support earlier file cut for the penultimate level files. Maybe by
     //  moving `ShouldStopBefore()` to `CompactionOutputs` class. Currently
@@ -1267,6 +1799,12 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     }
   }
 
+  if (status.ok() && !cfd->IsDropped() && !range_split && !c_iter->Valid() &&
+      c_iter->status().ok()) {
+    status = AddCleanDataBlocks(sub_compact, /*next_key=*/nullptr,
+                                open_file_func, close_file_func);
+  }
+
   sub_compact->compaction_job_stats.num_blobs_read =
       c_iter_stats.num_blobs_read;
   sub_compact->compaction_job_stats.total_blob_bytes_read =
@@ -1337,6 +1875,10 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
 
   sub_compact->compaction_job_stats.cpu_micros =
       db_options_.clock->CPUMicros() - prev_cpu_micros;
+  const uint64_t elapsed_micros = db_options_.clock->NowMicros() - start_micros;
+  sub_compact->compaction_job_stats.num_subcompactions = 1;
+  sub_compact->compaction_job_stats.min_subcompaction_micros = elapsed_micros;
+  sub_compact->compaction_job_stats.max_subcompaction_micros = elapsed_micros;
 
   if (measure_io_stats_) {
     sub_compact->compaction_job_stats.file_write_nanos +=
@@ -1623,6 +2165,17 @@ Status CompactionJob::InstallCompactionResults(
 
   // Add compaction inputs
   compaction->AddInputDeletions(edit);
+  compaction->AddMovedFiles(edit);
+  if (!compaction->reused_input_files().empty()) {
+    ROCKS_LOG_BUFFER(log_buffer_,
+                     "[%s] [JOB %d] Reused %" ROCKSDB_PRIszt
+                     " input files, moved %" ROCKSDB_PRIszt
+                     " of them to level-%d",
+                     compaction->column_family_data()->GetName().c_str(),
+                     job_id_, compaction->reused_input_files().size(),
+                     compaction->files_to_move().size(),
+                     compaction->output_level());
+  }
 
   std::unordered_map<uint64_t, BlobGarbageMeter::BlobStats> blob_total_garbage;
 
@@ -1662,9 +2215,17 @@ Status CompactionJob::InstallCompactionResults(
     int start_level = compaction->start_level();
     if (start_level > 0) {
       auto vstorage = compaction->input_version()->storage_info();
-      edit->AddCompactCursor(start_level,
-                             vstorage->GetNextCompactCursor(
-                                 start_level, compaction->num_input_files(0)));
+      if (compaction->round_robin_cursor() < 0) {
+        edit->AddCompactCursor(
+            start_level, vstorage->GetNextCompactCursor(
+                             start_level, compaction->num_input_files(0)));
+      } else {
+        edit->AddCompactCursor(
+            start_level,
+            static_cast<uint32_t>(compaction->round_robin_cursor()),
+            vstorage->GetNextCompactCursor(start_level,
+                                           *compaction->inputs(0)));
+      }
     }
   }
 
@@ -1789,6 +2350,11 @@ Status CompactionJob::OpenCompactionOutputFile(SubcompactionState* sub_compact,
     meta.oldest_ancester_time = oldest_ancester_time;
     meta.file_creation_time = current_time;
     meta.temperature = temperature;
+    meta.time_window_compacted =
+        sub_compact->compaction->compaction_reason() ==
+            CompactionReason::kFIFOReduceNumFiles &&
+        sub_compact->compaction->mutable_cf_options()
+                ->compaction_options_fifo.time_window_seconds > 0;
     assert(!db_id_.empty());
     assert(!db_session_id_.empty());
     s = GetSstInternalUniqueId(db_id_, db_session_id_, meta.fd.GetNumber(),
@@ -1888,10 +2454,17 @@ void CompactionJob::UpdateCompactionInputStatsHelper(int* num_files,
                                                      int input_level) {
   const Compaction* compaction = compact_->compaction;
   auto num_input_files = compaction->num_input_files(input_level);
-  *num_files += static_cast<int>(num_input_files);
 
   for (size_t i = 0; i < num_input_files; ++i) {
     const auto* file_meta = compaction->input(input_level, i);
+    if (compaction->IsReusedInputFile(file_meta)) {
+      // Not read, but moved to the output level or left in place
+      if (compaction->level(input_level) != compaction->output_level()) {
+        compaction_stats_.stats.bytes_moved += file_meta->fd.GetFileSize();
+      }
+      continue;
+    }
+    ++*num_files;
     *bytes_read += file_meta->fd.GetFileSize();
     compaction_stats_.stats.num_input_records +=
         static_cast<uint64_t>(file_meta->num_entries);
@@ -1912,6 +2485,8 @@ void CompactionJob::UpdateCompactionJobStats(
       stats.num_input_files_in_output_level;
   compaction_job_stats_->num_input_files_at_output_level =
       stats.num_input_files_in_output_level;
+  compaction_job_stats_->total_input_bytes_at_output_level =
+      stats.bytes_read_output_level;
 
   // output information
   compaction_job_stats_->total_output_bytes = stats.bytes_written;
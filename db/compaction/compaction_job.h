@@ -42,6 +42,7 @@
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/transaction_log.h"
 #include "table/scoped_arena_iterator.h"
+#include "table/table_reader.h"
 #include "util/autovector.h"
 #include "util/stop_watch.h"
 #include "util/thread_local.h"
@@ -227,6 +228,42 @@ class CompactionJob {
   // consecutive groups such that each group has a similar size.
   void GenSubcompactionBoundaries();
 
+  // Finds the input files that no other input file has keys within the range
+  // of, and lets the compaction reuse them as-is if
+  // `level_compaction_move_non_overlapping_files` is set.
+  void FindReusedInputFiles();
+
+  // Finds the data blocks of the input files within the key-range of
+  // `sub_compact` that the compaction would not change, so that they can be
+  // copied to the output as stored if `compaction_copy_clean_data_blocks` is
+  // set.
+  void FindCleanDataBlocks(SubcompactionState* sub_compact,
+                           const CompactionFilter* compaction_filter);
+
+  // Adds the clean data blocks of `sub_compact` that end before `next_key`,
+  // or all remaining ones if `next_key` is nullptr, to its output.
+  Status AddCleanDataBlocks(SubcompactionState* sub_compact,
+                            const Slice* next_key,
+                            const CompactionFileOpenFunc& open_file_func,
+                            const CompactionFileCloseFunc& close_file_func);
+
+  // Runs `sub_compact` on the current thread. With work stealing, then keeps
+  // running the sub-compactions that other threads split off for it until
+  // all sub-compactions of the job are done.
+  void RunSubcompactionWorker(SubcompactionState* sub_compact);
+
+  // Called with work stealing by the thread running `sub_compact`, which is
+  // about to output `next_user_key`. If a worker is idle and enough of the
+  // sub-compaction's key-range remains, moves the second half of the
+  // remaining range to a new sub-compaction for the idle worker and returns
+  // true. `sub_compact->end` is then the new, smaller end.
+  bool MaybeSplitSubcompaction(SubcompactionState* sub_compact,
+                               const Slice& next_user_key);
+
+  // Restores key-range order of the sub-compactions after some of them were
+  // split.
+  void SortSplitSubcompactions();
+
   // Get the number of planned subcompactions based on max_subcompactions and
   // extra reserved resources
   uint64_t GetSubcompactionsLimit();
@@ -315,6 +352,21 @@ class CompactionJob {
   bool measure_io_stats_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<std::string> boundaries_;
+
+  // Work stealing between sub-compactions, see RunSubcompactionWorker().
+  // split_anchors_ are the sorted anchors of the compaction input used to
+  // pick split keys, and split_boundaries_ stores the picked keys. The
+  // members below split_mutex_ are protected by it.
+  bool subcompaction_work_stealing_ = false;
+  std::vector<TableReader::Anchor> split_anchors_;
+  uint64_t min_split_range_size_ = 0;
+  size_t max_split_subcompactions_ = 0;
+  std::atomic<size_t> num_idle_workers_{0};
+  port::Mutex split_mutex_;
+  port::CondVar split_cv_{&split_mutex_};
+  size_t num_busy_workers_ = 0;
+  std::deque<SubcompactionState*> split_subcompactions_;
+  std::deque<std::string> split_boundaries_;
   Env::Priority thread_pri_;
   std::string full_history_ts_low_;
   std::string trim_ts_;
@@ -11,6 +11,7 @@
 #include "db/compaction/compaction_outputs.h"
 
 #include "db/builder.h"
+#include "test_util/sync_point.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -151,6 +152,89 @@ Status CompactionOutputs::AddToOutput(
   return s;
 }
 
+Status CompactionOutputs::AddCleanDataBlock(
+    TableReader::RawDataBlock* block,
+    const CompactionFileOpenFunc& open_file_func,
+    const CompactionFileCloseFunc& close_file_func) {
+  InternalIterator* iter = block->iter.get();
+  iter->SeekToFirst();
+  if (!iter->Valid()) {
+    return iter->status().ok() ? Status::Corruption("Empty data block")
+                               : iter->status();
+  }
+  Status s;
+  const Slice first_key = iter->key();
+
+  if (!pending_close_ && partitioner_ && HasBuilder() &&
+      partitioner_->ShouldPartition(
+          PartitionerRequest(last_key_for_partitioner_,
+                             ExtractUserKey(first_key),
+                             current_output_file_size_)) == kRequired) {
+    pending_close_ = true;
+  }
+
+  if (pending_close_) {
+    s = close_file_func(*this, Status::OK(), first_key);
+    pending_close_ = false;
+  }
+  if (!s.ok()) {
+    return s;
+  }
+
+  // Open output file if necessary
+  if (!HasBuilder()) {
+    s = open_file_func(*this);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+
+  Output& curr = current_output();
+  assert(builder_ != nullptr);
+  s = builder_->AddRawDataBlock(block->contents.data, block->compression_type,
+                                block->format_version,
+                                block->uncompressed.data);
+  bool copied = s.ok();
+  if (s.IsNotSupported()) {
+    s = Status::OK();
+  }
+  for (; s.ok() && iter->Valid(); iter->Next()) {
+    const Slice key = iter->key();
+    const Slice value = iter->value();
+    s = curr.validator.Add(key, value);
+    if (!s.ok()) {
+      break;
+    }
+    if (!copied) {
+      builder_->Add(key, value);
+    }
+    stats_.num_output_records++;
+    ParsedInternalKey ikey;
+    s = ParseInternalKey(key, &ikey, /*log_err_key=*/false);
+    if (s.ok()) {
+      s = curr.meta.UpdateBoundaries(key, value, ikey.sequence, ikey.type);
+    }
+    if (s.ok() && partitioner_) {
+      last_key_for_partitioner_.assign(ikey.user_key.data_,
+                                       ikey.user_key.size_);
+    }
+  }
+  if (s.ok()) {
+    s = iter->status();
+  }
+  if (!s.ok()) {
+    return s;
+  }
+  TEST_SYNC_POINT_CALLBACK("CompactionOutputs::AddCleanDataBlock", &copied);
+
+  current_output_file_size_ = builder_->EstimatedFileSize();
+  if (compaction_->output_level() != 0 &&
+      current_output_file_size_ >= compaction_->max_output_file_size()) {
+    pending_close_ = true;
+  }
+  return s;
+}
+
 Status CompactionOutputs::AddRangeDels(
     const Slice* comp_start, const Slice* comp_end,
     CompactionIterationStats& range_del_out_stats, bool bottommost_level,
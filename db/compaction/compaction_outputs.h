@@ -15,6 +15,7 @@
 #include "db/compaction/compaction_iterator.h"
 #include "db/internal_stats.h"
 #include "db/output_validator.h"
+#include "table/table_reader.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -211,6 +212,13 @@ class CompactionOutputs {
                      const CompactionFileOpenFunc& open_file_func,
                      const CompactionFileCloseFunc& close_file_func);
 
+  // Add a data block of an input file that the compaction iterator would
+  // pass through unchanged. The block is copied as stored if the table
+  // builder supports it, and its entries are added one by one otherwise.
+  Status AddCleanDataBlock(TableReader::RawDataBlock* block,
+                           const CompactionFileOpenFunc& open_file_func,
+                           const CompactionFileCloseFunc& close_file_func);
+
   // Close the current output. `open_file_func` is needed for creating new file
   // for range-dels only output file.
   Status CloseOutput(const Status& curr_status,
@@ -11,6 +11,7 @@
 #ifndef ROCKSDB_LITE
 
 #include <cinttypes>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -28,6 +29,19 @@ uint64_t GetTotalFilesSize(const std::vector<FileMetaData*>& files) {
   }
   return total_size;
 }
+
+constexpr uint64_t kUnknownTimeWindow = std::numeric_limits<uint64_t>::max();
+
+// Returns the time window of `f` by the age of its oldest data, or
+// kUnknownTimeWindow if that age is unknown.
+uint64_t GetTimeWindow(FileMetaData* f, uint64_t time_window_seconds) {
+  assert(time_window_seconds > 0);
+  const uint64_t oldest_ancester_time = f->TryGetOldestAncesterTime();
+  if (oldest_ancester_time == kUnknownOldestAncesterTime) {
+    return kUnknownTimeWindow;
+  }
+  return oldest_ancester_time / time_window_seconds;
+}
 }  // anonymous namespace
 
 bool FIFOCompactionPicker::NeedsCompaction(
@@ -70,12 +84,26 @@ Compaction* FIFOCompactionPicker::PickTTLCompaction(
   inputs.emplace_back();
   inputs[0].level = 0;
 
+  const uint64_t time_window_seconds =
+      mutable_cf_options.compaction_options_fifo.time_window_seconds;
+
   // avoid underflow
   if (current_time > mutable_cf_options.ttl) {
     for (auto ritr = level_files.rbegin(); ritr != level_files.rend(); ++ritr) {
       FileMetaData* f = *ritr;
       assert(f);
-      if (f->fd.table_reader && f->fd.table_reader->GetTableProperties()) {
+      if (time_window_seconds > 0) {
+        // All files of a time window expire together, once the end of the
+        // window is older than ttl. The windows are assigned by the oldest
+        // ancestor time, so expire by it too.
+        const uint64_t window = GetTimeWindow(f, time_window_seconds);
+        if (window == kUnknownTimeWindow ||
+            (window + 1) * time_window_seconds >=
+                current_time - mutable_cf_options.ttl) {
+          break;
+        }
+      } else if (f->fd.table_reader &&
+                 f->fd.table_reader->GetTableProperties()) {
         uint64_t creation_time =
             f->fd.table_reader->GetTableProperties()->creation_time;
         if (creation_time == 0 ||
@@ -133,8 +161,15 @@ Compaction* FIFOCompactionPicker::PickSizeCompaction(
           mutable_cf_options.compaction_options_fifo.max_table_files_size ||
       level_files.size() == 0) {
     // total size not exceeded
-    if (mutable_cf_options.compaction_options_fifo.allow_compaction &&
-        level_files.size() > 0) {
+    if (mutable_cf_options.compaction_options_fifo.time_window_seconds > 0) {
+      Compaction* c =
+          PickTimeWindowCompaction(cf_name, mutable_cf_options,
+                                   mutable_db_options, vstorage, log_buffer);
+      if (c != nullptr) {
+        return c;
+      }
+    } else if (mutable_cf_options.compaction_options_fifo.allow_compaction &&
+               level_files.size() > 0) {
       CompactionInputFiles comp_inputs;
       // try to prevent same files from being compacted multiple times, which
       // could produce large files that may never TTL-expire. Achieve this by
@@ -216,6 +251,109 @@ Compaction* FIFOCompactionPicker::PickSizeCompaction(
   return c;
 }
 
+Compaction* FIFOCompactionPicker::PickTimeWindowCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
+    LogBuffer* log_buffer) {
+  const uint64_t time_window_seconds =
+      mutable_cf_options.compaction_options_fifo.time_window_seconds;
+  assert(time_window_seconds > 0);
+
+  const int kLevel0 = 0;
+  const std::vector<FileMetaData*>& level_files = vstorage->LevelFiles(kLevel0);
+
+  int64_t _current_time;
+  auto status = ioptions_.clock->GetCurrentTime(&_current_time);
+  if (!status.ok()) {
+    ROCKS_LOG_BUFFER(log_buffer,
+                     "[%s] FIFO compaction: Couldn't get current time: %s. "
+                     "Not doing compactions based on time windows. ",
+                     cf_name.c_str(), status.ToString().c_str());
+    return nullptr;
+  }
+  const uint64_t current_window =
+      static_cast<uint64_t>(_current_time) / time_window_seconds;
+
+  // L0 files are sorted from the newest to the oldest, so the files of a time
+  // window are next to each other. Go from the oldest window to the newest
+  // and compact the files of the first window that needs it. The outputs are
+  // marked time_window_compacted and are not compacted again while their
+  // window is current, so a flushed byte is rewritten at most once there
+  // however many times the window reaches the trigger.
+  // - The current window compacts its newest files that are not outputs yet,
+  //   once there are level0_file_num_compaction_trigger of them.
+  // - An ended window compacts its files from the oldest one that is not an
+  //   output yet. A window whose files are all outputs is done.
+  // The inputs are bounded by max_compaction_bytes, taking the oldest files
+  // first, and the outputs by target_file_size_base.
+  size_t end = level_files.size();
+  while (end > 0) {
+    const uint64_t window = GetTimeWindow(level_files[end - 1],
+                                          time_window_seconds);
+    size_t begin = end - 1;
+    while (begin > 0 && GetTimeWindow(level_files[begin - 1],
+                                      time_window_seconds) == window) {
+      --begin;
+    }
+    // Candidates are level_files[begin, last).
+    size_t last = begin;
+    size_t min_files_to_compact = 2;
+    if (window >= current_window) {
+      while (last < end && !level_files[last]->time_window_compacted) {
+        ++last;
+      }
+      min_files_to_compact = std::max(
+          min_files_to_compact,
+          static_cast<size_t>(
+              mutable_cf_options.level0_file_num_compaction_trigger));
+    } else {
+      last = end;
+      while (last > begin && level_files[last - 1]->time_window_compacted) {
+        --last;
+      }
+    }
+    if (window != kUnknownTimeWindow && last - begin >= min_files_to_compact) {
+      size_t first = last - 1;
+      uint64_t compaction_size = level_files[first]->fd.file_size;
+      while (first > begin &&
+             compaction_size + level_files[first - 1]->fd.file_size <=
+                 mutable_cf_options.max_compaction_bytes) {
+        --first;
+        compaction_size += level_files[first]->fd.file_size;
+      }
+      CompactionInputFiles comp_inputs;
+      comp_inputs.level = kLevel0;
+      for (size_t i = first; i < last; ++i) {
+        FileMetaData* f = level_files[i];
+        if (f->being_compacted) {
+          comp_inputs.files.clear();
+          break;
+        }
+        comp_inputs.files.push_back(f);
+      }
+      if (comp_inputs.size() >= min_files_to_compact) {
+        ROCKS_LOG_BUFFER(log_buffer,
+                         "[%s] FIFO compaction: picking %" ROCKSDB_PRIszt
+                         " files of time window %" PRIu64 " to compact",
+                         cf_name.c_str(), comp_inputs.size(), window);
+        return new Compaction(
+            vstorage, ioptions_, mutable_cf_options, mutable_db_options,
+            {comp_inputs}, 0, mutable_cf_options.target_file_size_base,
+            mutable_cf_options.max_compaction_bytes, 0 /* output path ID */,
+            mutable_cf_options.compression,
+            mutable_cf_options.compression_opts, Temperature::kUnknown,
+            0 /* max_subcompactions */, {}, /* is manual */ false,
+            /* trim_ts */ "", vstorage->CompactionScore(0),
+            /* is deletion compaction */ false,
+            /* l0_files_might_overlap */ true,
+            CompactionReason::kFIFOReduceNumFiles);
+      }
+    }
+    end = begin;
+  }
+  return nullptr;
+}
+
 Compaction* FIFOCompactionPicker::PickCompactionToWarm(
     const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
     const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
@@ -94,6 +94,13 @@ class LevelCompactionBuilder {
   // function will return false.
   bool PickFileToCompact();
 
+  // Round-robin picking with round_robin_cursors_per_level > 1. The files of
+  // the level are split into as many consecutive lanes of about the same
+  // number of files as there are cursors, and each cursor moves through its
+  // own lane, so that compactions of different lanes can run concurrently.
+  // Lanes holding more bytes are tried first.
+  bool PickFileWithRoundRobinCursors();
+
   // Return true if a L0 trivial move is picked up.
   bool TryPickL0TrivialMove();
 
@@ -129,6 +136,11 @@ class LevelCompactionBuilder {
   int output_level_ = -1;
   int parent_index_ = -1;
   int base_index_ = -1;
+  // The cursor and the lane [start, end) of the start level files picked by
+  // PickFileWithRoundRobinCursors(), if it was used
+  int round_robin_cursor_ = -1;
+  int round_robin_start_index_ = -1;
+  int round_robin_end_index_ = -1;
   double start_level_score_ = 0;
   bool is_manual_ = false;
   bool is_l0_trivial_move_ = false;
@@ -327,7 +339,15 @@ void LevelCompactionBuilder::SetupOtherFilesWithRoundRobinExpansion() {
                                      vstorage_->MaxBytesForLevel(start_level_);
   }
 
-  size_t start_index = vstorage_->FilesByCompactionPri(start_level_)[0];
+  size_t start_index;
+  size_t end_index = level_files.size();
+  if (round_robin_start_index_ >= 0) {
+    // Stay within the lane of the cursor
+    start_index = static_cast<size_t>(base_index_);
+    end_index = static_cast<size_t>(round_robin_end_index_);
+  } else {
+    start_index = vstorage_->FilesByCompactionPri(start_level_)[0];
+  }
   InternalKey smallest, largest;
   // Constraint 4 (No need to check again later)
   compaction_picker_->GetRange(start_level_inputs_, &smallest, &largest);
@@ -347,9 +367,8 @@ void LevelCompactionBuilder::SetupOtherFilesWithRoundRobinExpansion() {
   }
   CompactionInputFiles tmp_start_level_inputs;
   tmp_start_level_inputs = start_level_inputs_;
-  // TODO (zichen): Future parallel round-robin may also need to update this
-  // Constraint 1b (only expand till the end)
-  for (size_t i = start_index + 1; i < level_files.size(); i++) {
+  // Constraint 1b (only expand till the end, or the end of the lane)
+  for (size_t i = start_index + 1; i < end_index; i++) {
     auto* f = level_files[i];
     if (f->being_compacted) {
       // Constraint 1a
@@ -494,6 +513,7 @@ Compaction* LevelCompactionBuilder::GetCompaction() {
       /* trim_ts */ "", start_level_score_, false /* deletion_compaction */,
       /* l0_files_might_overlap */ start_level_ == 0 && !is_l0_trivial_move_,
       compaction_reason_);
+  c->set_round_robin_cursor(round_robin_cursor_);
 
   // If it's level 0 compaction, make sure we don't execute any other level 0
   // compactions in parallel
@@ -699,6 +719,11 @@ bool LevelCompactionBuilder::PickFileToCompact() {
     return true;
   }
 
+  if (ioptions_.compaction_pri == kRoundRobin && start_level_ > 0 &&
+      mutable_cf_options_.round_robin_cursors_per_level > 1) {
+    return PickFileWithRoundRobinCursors();
+  }
+
   const std::vector<FileMetaData*>& level_files =
       vstorage_->LevelFiles(start_level_);
 
@@ -780,6 +805,95 @@ bool LevelCompactionBuilder::PickFileToCompact() {
   return start_level_inputs_.size() > 0;
 }
 
+bool LevelCompactionBuilder::PickFileWithRoundRobinCursors() {
+  const std::vector<FileMetaData*>& level_files =
+      vstorage_->LevelFiles(start_level_);
+  const size_t num_files = level_files.size();
+  const size_t num_lanes =
+      std::min(num_files, static_cast<size_t>(
+                              mutable_cf_options_.round_robin_cursors_per_level));
+  const InternalKeyComparator* icmp = compaction_picker_->icmp();
+
+  std::vector<std::pair<uint64_t, size_t>> lanes_by_size;
+  for (size_t lane = 0; lane < num_lanes; lane++) {
+    uint64_t lane_bytes = 0;
+    for (size_t i = lane * num_files / num_lanes;
+         i < (lane + 1) * num_files / num_lanes; i++) {
+      if (!level_files[i]->being_compacted) {
+        lane_bytes += level_files[i]->compensated_file_size;
+      }
+    }
+    lanes_by_size.emplace_back(lane_bytes, lane);
+  }
+  std::stable_sort(lanes_by_size.begin(), lanes_by_size.end(),
+                   [](const std::pair<uint64_t, size_t>& a,
+                      const std::pair<uint64_t, size_t>& b) {
+                     return a.first > b.first;
+                   });
+
+  for (const auto& lane_and_size : lanes_by_size) {
+    const size_t lane = lane_and_size.second;
+    const size_t lane_start = lane * num_files / num_lanes;
+    const size_t lane_end = (lane + 1) * num_files / num_lanes;
+    assert(lane_start < lane_end);
+
+    // Start from the first file at or after the cursor. A cursor that was
+    // never set or that is out of the lane, because files were added or
+    // removed since it was advanced, restarts from the start of the lane.
+    size_t index = lane_start;
+    const InternalKey cursor = vstorage_->GetCompactCursor(
+        start_level_, static_cast<uint32_t>(lane));
+    if (cursor.size() != 0) {
+      auto it = std::lower_bound(
+          level_files.begin() + lane_start, level_files.begin() + lane_end,
+          cursor, [&](const FileMetaData* f, const InternalKey& c) -> bool {
+            return icmp->Compare(c, f->smallest) > 0;
+          });
+      if (it != level_files.begin() + lane_end) {
+        index = static_cast<size_t>(it - level_files.begin());
+      }
+    }
+
+    FileMetaData* f = level_files[index];
+    if (f->being_compacted) {
+      // As with a single cursor, the cursor must not skip the file. Try the
+      // other lanes instead.
+      continue;
+    }
+    start_level_inputs_.files.push_back(f);
+    if (!compaction_picker_->ExpandInputsToCleanCut(cf_name_, vstorage_,
+                                                    &start_level_inputs_) ||
+        compaction_picker_->FilesRangeOverlapWithCompaction(
+            {start_level_inputs_}, output_level_)) {
+      start_level_inputs_.clear();
+      continue;
+    }
+
+    InternalKey smallest, largest;
+    compaction_picker_->GetRange(start_level_inputs_, &smallest, &largest);
+    CompactionInputFiles output_level_inputs;
+    output_level_inputs.level = output_level_;
+    vstorage_->GetOverlappingInputs(output_level_, &smallest, &largest,
+                                    &output_level_inputs.files);
+    if (!output_level_inputs.empty() &&
+        !compaction_picker_->ExpandInputsToCleanCut(cf_name_, vstorage_,
+                                                    &output_level_inputs)) {
+      start_level_inputs_.clear();
+      continue;
+    }
+
+    base_index_ = static_cast<int>(index);
+    round_robin_cursor_ = static_cast<int>(lane);
+    round_robin_start_index_ = static_cast<int>(lane_start);
+    round_robin_end_index_ = static_cast<int>(lane_end);
+    TEST_SYNC_POINT_CALLBACK(
+        "LevelCompactionBuilder::PickFileWithRoundRobinCursors:Picked",
+        &round_robin_cursor_);
+    return true;
+  }
+  return false;
+}
+
 bool LevelCompactionBuilder::PickIntraL0Compaction() {
   start_level_inputs_.clear();
   const std::vector<FileMetaData*>& level_files =
@@ -3,6 +3,7 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 
+#include <algorithm>
 #include <limits>
 #include <string>
 #include <utility>
@@ -708,6 +709,62 @@ TEST_F(CompactionPickerTest, UniversalPeriodicCompaction6) {
   ASSERT_EQ(4, compaction->output_level());
 }
 
+TEST_F(CompactionPickerTest, UniversalIncrementalPeriodicCompaction) {
+  // With incremental universal compaction, periodic compaction rewrites
+  // marked files of the last sorted run in place, up to max_compaction_bytes.
+  const uint64_t kFileSize = 100000;
+
+  mutable_cf_options_.periodic_compaction_seconds = 1000;
+  mutable_cf_options_.max_compaction_bytes = 250000;
+  mutable_cf_options_.compaction_options_universal.incremental = true;
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(5, kCompactionStyleUniversal);
+
+  Add(0, 1U, "150", "200", kFileSize, 0, 500, 550);
+  Add(3, 2U, "010", "080", kFileSize, 0, 200, 251);
+  Add(4, 3U, "301", "350", kFileSize, 0, 101, 150);
+  Add(4, 4U, "401", "450", kFileSize, 0, 101, 150);
+  Add(4, 5U, "501", "550", kFileSize, 0, 101, 150);
+  Add(4, 6U, "601", "650", kFileSize, 0, 101, 150);
+  Add(4, 7U, "701", "750", kFileSize, 0, 101, 150);
+  UpdateVersionStorageInfo();
+  vstorage_->TEST_AddFileMarkedForPeriodicCompaction(4, file_map_[4].first);
+  vstorage_->TEST_AddFileMarkedForPeriodicCompaction(4, file_map_[5].first);
+  vstorage_->TEST_AddFileMarkedForPeriodicCompaction(4, file_map_[6].first);
+
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+          &log_buffer_));
+  ASSERT_TRUE(compaction);
+  ASSERT_EQ(CompactionReason::kPeriodicCompaction,
+            compaction->compaction_reason());
+  ASSERT_EQ(4, compaction->start_level());
+  ASSERT_EQ(4, compaction->output_level());
+  ASSERT_EQ(1U, compaction->num_input_levels());
+  ASSERT_EQ(2U, compaction->num_input_files(0));
+  ASSERT_EQ(4U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(5U, compaction->input(0, 1)->fd.GetNumber());
+  universal_compaction_picker.ReleaseCompactionFiles(compaction.get(),
+                                                     Status::OK());
+  // Normally cleared by Compaction::ReleaseCompactionFiles()
+  for (FileMetaData* f : *compaction->inputs(0)) {
+    f->being_compacted = false;
+  }
+
+  // A marked file outside of the last sorted run requires a full compaction.
+  vstorage_->TEST_AddFileMarkedForPeriodicCompaction(3, file_map_[2].first);
+  compaction.reset(universal_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction);
+  ASSERT_EQ(0, compaction->start_level());
+  ASSERT_EQ(4, compaction->output_level());
+  ASSERT_EQ(5U, compaction->num_input_files(compaction->num_input_levels() -
+                                            1));
+}
+
 TEST_F(CompactionPickerTest, UniversalIncrementalSpace1) {
   const uint64_t kFileSize = 100000;
 
@@ -950,6 +1007,295 @@ TEST_F(CompactionPickerTest, NeedsCompactionFIFO) {
   }
 }
 
+TEST_F(CompactionPickerTest, FIFOTimeWindowCompaction) {
+  NewVersionStorage(1, kCompactionStyleFIFO);
+  const uint64_t kFileSize = 100000;
+  const uint64_t kWindowSeconds = 1000;
+
+  fifo_options_.max_table_files_size = kFileSize * 100000;
+  fifo_options_.time_window_seconds = kWindowSeconds;
+  mutable_cf_options_.compaction_options_fifo = fifo_options_;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 4;
+  mutable_cf_options_.max_compaction_bytes = kFileSize * 100;
+  FIFOCompactionPicker fifo_compaction_picker(ioptions_, &icmp_);
+
+  int64_t current_time = 0;
+  ASSERT_OK(Env::Default()->GetCurrentTime(&current_time));
+  const uint64_t current_window_start =
+      static_cast<uint64_t>(current_time) / kWindowSeconds * kWindowSeconds;
+  auto window_start = [&](uint64_t windows_ago) {
+    return current_window_start - windows_ago * kWindowSeconds;
+  };
+  // Two files in the current window, which is below the trigger, and two
+  // ended windows with two files each.
+  Add(0, 7U, "100", "200", kFileSize, 0, 700, 750, 0, false,
+      Temperature::kUnknown, window_start(0) + 20);
+  Add(0, 6U, "100", "200", kFileSize, 0, 600, 650, 0, false,
+      Temperature::kUnknown, window_start(0) + 10);
+  Add(0, 5U, "100", "200", kFileSize, 0, 500, 550, 0, false,
+      Temperature::kUnknown, window_start(1) + 20);
+  Add(0, 4U, "100", "200", kFileSize, 0, 400, 450, 0, false,
+      Temperature::kUnknown, window_start(1) + 10);
+  Add(0, 3U, "100", "200", kFileSize, 0, 300, 350, 0, false,
+      Temperature::kUnknown, window_start(2) + 10);
+  Add(0, 2U, "100", "200", kFileSize, 0, 200, 250, 0, false,
+      Temperature::kUnknown, window_start(3) + 20);
+  Add(0, 1U, "100", "200", kFileSize, 0, 100, 150, 0, false,
+      Temperature::kUnknown, window_start(3) + 10);
+  UpdateVersionStorageInfo();
+
+  // The oldest window is compacted first.
+  std::unique_ptr<Compaction> compaction(fifo_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(CompactionReason::kFIFOReduceNumFiles,
+            compaction->compaction_reason());
+  ASSERT_EQ(2U, compaction->num_input_files(0));
+  ASSERT_EQ(2U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(1U, compaction->input(0, 1)->fd.GetNumber());
+
+  // Files of different windows are never compacted together.
+  std::unique_ptr<Compaction> compaction2(
+      fifo_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                            mutable_db_options_,
+                                            vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction2.get() != nullptr);
+  ASSERT_EQ(2U, compaction2->num_input_files(0));
+  ASSERT_EQ(5U, compaction2->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(4U, compaction2->input(0, 1)->fd.GetNumber());
+
+  std::unique_ptr<Compaction> compaction3(
+      fifo_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                            mutable_db_options_,
+                                            vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction3.get() == nullptr);
+}
+
+TEST_F(CompactionPickerTest, FIFOTimeWindowCompactionEndedWindow) {
+  NewVersionStorage(1, kCompactionStyleFIFO);
+  const uint64_t kFileSize = 10 << 20;
+  const uint64_t kWindowSeconds = 1000;
+
+  fifo_options_.max_table_files_size = kFileSize * 100000;
+  fifo_options_.time_window_seconds = kWindowSeconds;
+  mutable_cf_options_.compaction_options_fifo = fifo_options_;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 4;
+  mutable_cf_options_.max_compaction_bytes = 2 * kFileSize;
+  mutable_cf_options_.target_file_size_base = kFileSize;
+  FIFOCompactionPicker fifo_compaction_picker(ioptions_, &icmp_);
+
+  int64_t current_time = 0;
+  ASSERT_OK(Env::Default()->GetCurrentTime(&current_time));
+  const uint64_t current_window_start =
+      static_cast<uint64_t>(current_time) / kWindowSeconds * kWindowSeconds;
+  auto window_start = [&](uint64_t windows_ago) {
+    return current_window_start - windows_ago * kWindowSeconds;
+  };
+  // An ended window of four files that were not compacted yet, and an older
+  // ended window whose files are all outputs of time-window compactions.
+  Add(0, 6U, "100", "200", kFileSize, 0, 600, 650, 0, false,
+      Temperature::kUnknown, window_start(1) + 40);
+  Add(0, 5U, "100", "200", kFileSize, 0, 500, 550, 0, false,
+      Temperature::kUnknown, window_start(1) + 30);
+  Add(0, 4U, "100", "200", kFileSize, 0, 400, 450, 0, false,
+      Temperature::kUnknown, window_start(1) + 20);
+  Add(0, 3U, "100", "200", kFileSize, 0, 300, 350, 0, false,
+      Temperature::kUnknown, window_start(1) + 10);
+  Add(0, 2U, "100", "200", kFileSize, 0, 200, 250, 0, false,
+      Temperature::kUnknown, window_start(2) + 20);
+  Add(0, 1U, "100", "200", kFileSize, 0, 100, 150, 0, false,
+      Temperature::kUnknown, window_start(2) + 10);
+  file_map_[1U].first->time_window_compacted = true;
+  file_map_[2U].first->time_window_compacted = true;
+  UpdateVersionStorageInfo();
+
+  // The compacted window is skipped. The other one is compacted from its
+  // oldest file, bounded by max_compaction_bytes and target_file_size_base.
+  std::unique_ptr<Compaction> compaction(fifo_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(2U, compaction->num_input_files(0));
+  ASSERT_EQ(4U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(3U, compaction->input(0, 1)->fd.GetNumber());
+  ASSERT_EQ(kFileSize, compaction->max_output_file_size());
+  ASSERT_EQ(2 * kFileSize, compaction->max_compaction_bytes());
+
+  // Once the window has only one file that was not compacted yet, it is
+  // not compacted again.
+  NewVersionStorage(1, kCompactionStyleFIFO);
+  Add(0, 8U, "100", "200", kFileSize, 0, 600, 650, 0, false,
+      Temperature::kUnknown, window_start(1) + 40);
+  Add(0, 7U, "100", "200", kFileSize, 0, 300, 550, 0, false,
+      Temperature::kUnknown, window_start(1) + 10);
+  Add(0, 2U, "100", "200", kFileSize, 0, 200, 250, 0, false,
+      Temperature::kUnknown, window_start(2) + 20);
+  Add(0, 1U, "100", "200", kFileSize, 0, 100, 150, 0, false,
+      Temperature::kUnknown, window_start(2) + 10);
+  file_map_[1U].first->time_window_compacted = true;
+  file_map_[2U].first->time_window_compacted = true;
+  file_map_[7U].first->time_window_compacted = true;
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction2(
+      fifo_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                            mutable_db_options_,
+                                            vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction2.get() == nullptr);
+}
+
+TEST_F(CompactionPickerTest, FIFOTimeWindowCompactionWriteAmp) {
+  const uint64_t kFileSize = 100000;
+  const uint64_t kWindowSeconds = 100000;
+  const int kTrigger = 4;
+  const uint64_t kNumFlushes = 40;
+
+  fifo_options_.max_table_files_size = kFileSize * 100000;
+  fifo_options_.time_window_seconds = kWindowSeconds;
+  mutable_cf_options_.compaction_options_fifo = fifo_options_;
+  mutable_cf_options_.level0_file_num_compaction_trigger = kTrigger;
+  mutable_cf_options_.max_compaction_bytes = kFileSize * 100000;
+  mutable_cf_options_.target_file_size_base = kFileSize * 100000;
+  FIFOCompactionPicker fifo_compaction_picker(ioptions_, &icmp_);
+
+  int64_t current_time = 0;
+  ASSERT_OK(Env::Default()->GetCurrentTime(&current_time));
+  const uint64_t current_window_start =
+      static_cast<uint64_t>(current_time) / kWindowSeconds * kWindowSeconds;
+
+  struct TestFile {
+    uint32_t number;
+    uint64_t size;
+    SequenceNumber smallest_seqno;
+    SequenceNumber largest_seqno;
+    bool time_window_compacted;
+  };
+  // From the newest to the oldest, like L0.
+  std::vector<TestFile> files;
+  uint32_t next_file_number = 1;
+  uint64_t bytes_rewritten = 0;
+  int num_compactions = 0;
+  // Flush into the current window and apply every compaction picked, for
+  // several trigger cycles.
+  for (uint64_t i = 0; i < kNumFlushes; ++i) {
+    files.insert(files.begin(),
+                 {next_file_number++, kFileSize, 100 * (i + 1),
+                  100 * (i + 1) + 50, false});
+    NewVersionStorage(1, kCompactionStyleFIFO);
+    for (const TestFile& f : files) {
+      Add(0, f.number, "100", "200", f.size, 0, f.smallest_seqno,
+          f.largest_seqno, 0, false, Temperature::kUnknown,
+          current_window_start + 1);
+      file_map_[f.number].first->time_window_compacted =
+          f.time_window_compacted;
+    }
+    UpdateVersionStorageInfo();
+
+    std::unique_ptr<Compaction> compaction(
+        fifo_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                              mutable_db_options_,
+                                              vstorage_.get(), &log_buffer_));
+    if (compaction == nullptr) {
+      continue;
+    }
+    ++num_compactions;
+    TestFile output{next_file_number++, 0, kMaxSequenceNumber, 0, true};
+    for (size_t j = 0; j < compaction->num_input_files(0); ++j) {
+      const FileMetaData* input = compaction->input(0, j);
+      auto it = std::find_if(files.begin(), files.end(),
+                             [&](const TestFile& f) {
+                               return f.number == input->fd.GetNumber();
+                             });
+      ASSERT_TRUE(it != files.end());
+      output.size += it->size;
+      output.smallest_seqno = std::min(output.smallest_seqno,
+                                       it->smallest_seqno);
+      output.largest_seqno = std::max(output.largest_seqno, it->largest_seqno);
+      files.erase(it);
+    }
+    bytes_rewritten += output.size;
+    auto pos = std::find_if(files.begin(), files.end(), [&](const TestFile& f) {
+      return f.largest_seqno < output.largest_seqno;
+    });
+    files.insert(pos, output);
+    fifo_compaction_picker.ReleaseCompactionFiles(compaction.get(), Status::OK());
+  }
+
+  // Every flushed byte is rewritten at most once while its window is
+  // current, rather than once every kTrigger - 1 flushes.
+  ASSERT_EQ(static_cast<int>(kNumFlushes / kTrigger), num_compactions);
+  ASSERT_LE(bytes_rewritten, kNumFlushes * kFileSize);
+}
+
+TEST_F(CompactionPickerTest, FIFOTimeWindowTtl) {
+  NewVersionStorage(1, kCompactionStyleFIFO);
+  const uint64_t kFileSize = 100000;
+  const uint64_t kWindowSeconds = 1000;
+
+  fifo_options_.max_table_files_size = kFileSize * 100000;
+  fifo_options_.time_window_seconds = kWindowSeconds;
+  mutable_cf_options_.compaction_options_fifo = fifo_options_;
+  mutable_cf_options_.ttl = 2500;
+  FIFOCompactionPicker fifo_compaction_picker(ioptions_, &icmp_);
+
+  int64_t current_time = 0;
+  ASSERT_OK(Env::Default()->GetCurrentTime(&current_time));
+  const uint64_t current_window_start =
+      static_cast<uint64_t>(current_time) / kWindowSeconds * kWindowSeconds;
+  auto window_start = [&](uint64_t windows_ago) {
+    return current_window_start - windows_ago * kWindowSeconds;
+  };
+  // Only the window that ended more than ttl ago expires. The files have no
+  // table properties, the windows are told by the oldest ancestor time.
+  Add(0, 3U, "100", "200", kFileSize, 0, 300, 350, 0, false,
+      Temperature::kUnknown, window_start(2) + 10);
+  Add(0, 2U, "100", "200", kFileSize, 0, 200, 250, 0, false,
+      Temperature::kUnknown, window_start(4) + 20);
+  Add(0, 1U, "100", "200", kFileSize, 0, 100, 150, 0, false,
+      Temperature::kUnknown, window_start(4) + 10);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(fifo_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(CompactionReason::kFIFOTtl, compaction->compaction_reason());
+  ASSERT_EQ(2U, compaction->num_input_files(0));
+  ASSERT_EQ(1U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(2U, compaction->input(0, 1)->fd.GetNumber());
+}
+
+TEST_F(CompactionPickerTest, FIFOTimeWindowTtlScore) {
+  NewVersionStorage(1, kCompactionStyleFIFO);
+  const uint64_t kFileSize = 100000;
+  const uint64_t kWindowSeconds = 1000;
+
+  fifo_options_.max_table_files_size = kFileSize * 100000;
+  fifo_options_.time_window_seconds = kWindowSeconds;
+  mutable_cf_options_.compaction_options_fifo = fifo_options_;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 4;
+  // The data of the file is older than ttl, but the end of its window is not.
+  mutable_cf_options_.ttl = 2 * kWindowSeconds - 1;
+  FIFOCompactionPicker fifo_compaction_picker(ioptions_, &icmp_);
+
+  int64_t current_time = 0;
+  ASSERT_OK(Env::Default()->GetCurrentTime(&current_time));
+  const uint64_t current_window_start =
+      static_cast<uint64_t>(current_time) / kWindowSeconds * kWindowSeconds;
+  Add(0, 1U, "100", "200", kFileSize, 0, 100, 150, 0, false,
+      Temperature::kUnknown, current_window_start - 2 * kWindowSeconds);
+  UpdateVersionStorageInfo();
+
+  // The score agrees with the picker, which does not expire the window yet.
+  ASSERT_LT(vstorage_->CompactionScore(0), 1);
+  ASSERT_FALSE(fifo_compaction_picker.NeedsCompaction(vstorage_.get()));
+  std::unique_ptr<Compaction> compaction(fifo_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() == nullptr);
+}
+
 TEST_F(CompactionPickerTest, FIFOToWarm1) {
   NewVersionStorage(1, kCompactionStyleFIFO);
   const uint64_t kFileSize = 100000;
@@ -1477,6 +1823,66 @@ TEST_F(CompactionPickerTest, CompactionPriMultipleFilesRoundRobin3) {
   DeleteVersionStorage();
 }
 
+TEST_F(CompactionPickerTest, CompactionPriRoundRobinMultipleCursors) {
+  ioptions_.compaction_pri = kRoundRobin;
+  mutable_cf_options_.round_robin_cursors_per_level = 2;
+  mutable_cf_options_.max_compaction_bytes = 1000000u;
+  mutable_cf_options_.max_bytes_for_level_base = 120;
+  mutable_cf_options_.max_bytes_for_level_multiplier = 10;
+  for (bool first_lane_busy : {false, true}) {
+    NewVersionStorage(6, kCompactionStyleLevel);
+    vstorage_->ResizeCompactCursors(6);
+    // Cursor 0 points at 8U. Cursor 1 has never been set.
+    vstorage_->AddCursorForOneLevel(2, 0, InternalKey("300", 100, kTypeValue));
+    // Lane of cursor 0
+    Add(2, 6U, "100", "149", 800U);
+    Add(2, 7U, "200", "249", 800U);
+    Add(2, 8U, "300", "349", 800U);
+    Add(2, 9U, "400", "449", 800U);
+    // Lane of cursor 1
+    Add(2, 10U, "500", "549", 500U);
+    Add(2, 11U, "600", "649", 500U);
+    Add(2, 12U, "700", "749", 500U);
+    Add(2, 13U, "800", "849", 500U);
+
+    Add(3, 26U, "110", "120", 600U);
+    Add(3, 27U, "210", "220", 600U);
+    Add(3, 28U, "310", "320", 600U);
+    Add(3, 29U, "410", "420", 600U);
+    Add(3, 30U, "510", "520", 600U);
+    Add(3, 31U, "610", "620", 600U);
+    Add(3, 32U, "710", "720", 600U);
+    Add(3, 33U, "810", "820", 600U);
+    if (first_lane_busy) {
+      file_map_[8U].first->being_compacted = true;
+    }
+    UpdateVersionStorageInfo();
+    LevelCompactionPicker local_level_compaction_picker =
+        LevelCompactionPicker(ioptions_, &icmp_);
+    std::unique_ptr<Compaction> compaction(
+        local_level_compaction_picker.PickCompaction(
+            cf_name_, mutable_cf_options_, mutable_db_options_,
+            vstorage_.get(), &log_buffer_));
+    ASSERT_TRUE(compaction.get() != nullptr);
+
+    if (!first_lane_busy) {
+      // The lane holding more bytes goes first, starting at its cursor, and
+      // the inputs are not expanded past the end of the lane.
+      ASSERT_EQ(0, compaction->round_robin_cursor());
+      ASSERT_EQ(2U, compaction->num_input_files(0));
+      ASSERT_EQ(8U, compaction->input(0, 0)->fd.GetNumber());
+      ASSERT_EQ(9U, compaction->input(0, 1)->fd.GetNumber());
+    } else {
+      // The other lane starts from its beginning.
+      ASSERT_EQ(1, compaction->round_robin_cursor());
+      ASSERT_EQ(4U, compaction->num_input_files(0));
+      ASSERT_EQ(10U, compaction->input(0, 0)->fd.GetNumber());
+      ASSERT_EQ(13U, compaction->input(0, 3)->fd.GetNumber());
+    }
+    DeleteVersionStorage();
+  }
+}
+
 TEST_F(CompactionPickerTest, CompactionPriMinOverlappingManyFiles) {
   NewVersionStorage(6, kCompactionStyleLevel);
   ioptions_.compaction_pri = kMinOverlappingRatio;
@@ -115,6 +115,12 @@ class UniversalCompactionBuilder {
   // because some files are being compacted.
   Compaction* PickPeriodicCompaction();
 
+  // Try to pick a periodic compaction that only rewrites a key-range of the
+  // last sorted run, bounded by max_compaction_bytes, when all files marked
+  // for periodic compaction are in that sorted run and it is not L0.
+  // Returns null if no such compaction can be formed.
+  Compaction* PickIncrementalPeriodicCompaction();
+
   // Used in universal compaction when the allow_trivial_move
   // option is set. Checks whether there are any overlapping files
   // in the input. Returns true if the input files are non
@@ -397,7 +403,8 @@ Compaction* UniversalCompactionBuilder::PickCompaction() {
   // Periodic compaction has higher priority than other type of compaction
   // because it's a hard requirement.
   if (!vstorage_->FilesMarkedForPeriodicCompaction().empty()) {
-    // Always need to do a full compaction for periodic compaction.
+    // Periodic compaction needs a full compaction, unless `incremental`
+    // allows rewriting part of the last sorted run.
     c = PickPeriodicCompaction();
   }
 
@@ -1346,6 +1353,15 @@ Compaction* UniversalCompactionBuilder::PickPeriodicCompaction() {
   // Get some information from marked files to check whether a file is
   // included in the compaction.
 
+  if (mutable_cf_options_.compaction_options_universal.incremental) {
+    Compaction* c = PickIncrementalPeriodicCompaction();
+    if (c != nullptr) {
+      TEST_SYNC_POINT_CALLBACK(
+          "UniversalCompactionPicker::PickPeriodicCompaction:Return", c);
+      return c;
+    }
+  }
+
   size_t start_index = sorted_runs_.size();
   while (start_index > 0 && !sorted_runs_[start_index - 1].being_compacted) {
     start_index--;
@@ -1397,6 +1413,88 @@ Compaction* UniversalCompactionBuilder::PickPeriodicCompaction() {
   return c;
 }
 
+Compaction* UniversalCompactionBuilder::PickIncrementalPeriodicCompaction() {
+  const SortedRun& last_sr = sorted_runs_.back();
+  const int level = last_sr.level;
+  // Data in the last level may be moved to the penultimate level or be
+  // reserved for ingest behind, so rewriting it in place is not an option.
+  if (level == 0 || last_sr.being_compacted ||
+      ioptions_.preclude_last_level_data_seconds > 0 ||
+      ioptions_.allow_ingest_behind) {
+    return nullptr;
+  }
+  for (const auto& level_file : vstorage_->FilesMarkedForPeriodicCompaction()) {
+    if (level_file.first != level) {
+      // Newer sorted runs need a compaction into the last one anyway.
+      return nullptr;
+    }
+  }
+
+  // Take the first marked file of the level together with the marked files
+  // following it, as long as they fit into max_compaction_bytes. Files of the
+  // last sorted run don't overlap with each other, so they can be rewritten
+  // in place without touching the rest of the run.
+  const std::vector<FileMetaData*>& files = vstorage_->LevelFiles(level);
+  auto is_marked = [&](const FileMetaData* f) {
+    for (const auto& level_file :
+         vstorage_->FilesMarkedForPeriodicCompaction()) {
+      if (level_file.second == f) {
+        return true;
+      }
+    }
+    return false;
+  };
+  CompactionInputFiles inputs;
+  inputs.level = level;
+  uint64_t total_size = 0;
+  for (FileMetaData* f : files) {
+    if (!is_marked(f)) {
+      if (inputs.empty()) {
+        continue;
+      }
+      break;
+    }
+    if (!inputs.empty() &&
+        total_size + f->fd.GetFileSize() >
+            mutable_cf_options_.max_compaction_bytes) {
+      break;
+    }
+    inputs.files.push_back(f);
+    total_size += f->fd.GetFileSize();
+  }
+  if (inputs.empty() ||
+      !picker_->ExpandInputsToCleanCut(cf_name_, vstorage_, &inputs,
+                                       /*next_smallest=*/nullptr)) {
+    return nullptr;
+  }
+
+  char file_num_buf[256];
+  last_sr.DumpSizeInfo(file_num_buf, sizeof(file_num_buf),
+                       sorted_runs_.size() - 1);
+  ROCKS_LOG_BUFFER(log_buffer_,
+                   "[%s] Universal: incremental periodic compaction picking "
+                   "%" ROCKSDB_PRIszt " files of %s",
+                   cf_name_.c_str(), inputs.size(), file_num_buf);
+
+  std::vector<CompactionInputFiles> compaction_inputs;
+  compaction_inputs.push_back(std::move(inputs));
+  uint32_t path_id = GetPathId(ioptions_, mutable_cf_options_, last_sr.size);
+  return new Compaction(
+      vstorage_, ioptions_, mutable_cf_options_, mutable_db_options_,
+      std::move(compaction_inputs), level,
+      MaxFileSizeForLevel(mutable_cf_options_, level,
+                          kCompactionStyleUniversal),
+      GetMaxOverlappingBytes(), path_id,
+      GetCompressionType(vstorage_, mutable_cf_options_, level, 1,
+                         true /* enable_compression */),
+      GetCompressionOptions(mutable_cf_options_, vstorage_, level,
+                            true /* enable_compression */),
+      Temperature::kUnknown,
+      /* max_subcompactions */ 0, /* grandparents */ {}, /* is manual */ false,
+      /* trim_ts */ "", score_, false /* deletion_compaction */,
+      /* l0_files_might_overlap */ true, CompactionReason::kPeriodicCompaction);
+}
+
 uint64_t UniversalCompactionBuilder::GetMaxOverlappingBytes() const {
   if (!mutable_cf_options_.compaction_options_universal.incremental) {
     return std::numeric_limits<uint64_t>::max();
@@ -553,6 +553,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct CompactionJobStats, total_input_bytes),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"total_input_bytes_at_output_level",
+         {offsetof(struct CompactionJobStats,
+                   total_input_bytes_at_output_level),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"total_blob_bytes_read",
          {offsetof(struct CompactionJobStats, total_blob_bytes_read),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -621,6 +626,22 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct CompactionJobStats, num_single_del_mismatch),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"num_subcompactions",
+         {offsetof(struct CompactionJobStats, num_subcompactions),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"num_split_subcompactions",
+         {offsetof(struct CompactionJobStats, num_split_subcompactions),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"min_subcompaction_micros",
+         {offsetof(struct CompactionJobStats, min_subcompaction_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"max_subcompaction_micros",
+         {offsetof(struct CompactionJobStats, max_subcompaction_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 namespace {
@@ -0,0 +1,156 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rocksdb/comparator.h"
+#include "table/internal_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// An internal iterator that wraps another one and skips the keys within a set
+// of key ranges [first, second], which must be sorted and must not overlap.
+// Each range is skipped with a single Seek() of the underlying iterator. Only
+// forward iteration is supported.
+class RangeSkippingIterator : public InternalIterator {
+ public:
+  RangeSkippingIterator(
+      InternalIterator* iter,
+      const std::vector<std::pair<std::string, std::string>>* ranges,
+      const CompareInterface* cmp)
+      : iter_(iter), ranges_(ranges), cmp_(cmp) {
+    assert(iter_);
+    assert(ranges_);
+    assert(cmp_);
+  }
+
+  bool Valid() const override { return status_.ok() && iter_->Valid(); }
+
+  void SeekToFirst() override {
+    next_range_ = 0;
+    iter_->SeekToFirst();
+    SkipRanges();
+  }
+
+  void SeekToLast() override { BackwardIterationNotSupported(); }
+
+  void Seek(const Slice& target) override {
+    // The first range that may contain keys at or after `target`
+    next_range_ = static_cast<size_t>(
+        std::lower_bound(ranges_->begin(), ranges_->end(), target,
+                         [this](const std::pair<std::string, std::string>& r,
+                                const Slice& t) {
+                           return cmp_->Compare(r.second, t) < 0;
+                         }) -
+        ranges_->begin());
+    iter_->Seek(target);
+    SkipRanges();
+  }
+
+  void SeekForPrev(const Slice& /*target*/) override {
+    BackwardIterationNotSupported();
+  }
+
+  void Next() override {
+    assert(Valid());
+    iter_->Next();
+    SkipRanges();
+  }
+
+  void Prev() override { BackwardIterationNotSupported(); }
+
+  Slice key() const override {
+    assert(Valid());
+    return iter_->key();
+  }
+
+  Slice user_key() const override {
+    assert(Valid());
+    return iter_->user_key();
+  }
+
+  Slice value() const override {
+    assert(Valid());
+    return iter_->value();
+  }
+
+  Status status() const override {
+    return status_.ok() ? iter_->status() : status_;
+  }
+
+  bool PrepareValue() override {
+    assert(Valid());
+    return iter_->PrepareValue();
+  }
+
+  bool MayBeOutOfLowerBound() override {
+    assert(Valid());
+    return iter_->MayBeOutOfLowerBound();
+  }
+
+  IterBoundCheck UpperBoundCheckResult() override {
+    assert(Valid());
+    return iter_->UpperBoundCheckResult();
+  }
+
+  void SetPinnedItersMgr(PinnedIteratorsManager* pinned_iters_mgr) override {
+    iter_->SetPinnedItersMgr(pinned_iters_mgr);
+  }
+
+  bool IsKeyPinned() const override {
+    assert(Valid());
+    return iter_->IsKeyPinned();
+  }
+
+  bool IsValuePinned() const override {
+    assert(Valid());
+    return iter_->IsValuePinned();
+  }
+
+  Status GetProperty(std::string prop_name, std::string* prop) override {
+    return iter_->GetProperty(prop_name, prop);
+  }
+
+ private:
+  void SkipRanges() {
+    while (iter_->Valid() && next_range_ < ranges_->size()) {
+      const auto& range = (*ranges_)[next_range_];
+      if (cmp_->Compare(iter_->key(), range.second) > 0) {
+        ++next_range_;
+        continue;
+      }
+      if (cmp_->Compare(iter_->key(), range.first) < 0) {
+        break;
+      }
+      iter_->Seek(range.second);
+      if (iter_->Valid() && cmp_->Compare(iter_->key(), range.second) == 0) {
+        iter_->Next();
+      }
+      ++next_range_;
+    }
+  }
+
+  void BackwardIterationNotSupported() {
+    assert(false);
+    status_ = Status::NotSupported(
+        "RangeSkippingIterator does not support backward iteration");
+  }
+
+  InternalIterator* iter_;
+  const std::vector<std::pair<std::string, std::string>>* ranges_;
+  const CompareInterface* cmp_;
+  // Index of the first range that may be ahead of the current key
+  size_t next_range_ = 0;
+  Status status_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -58,6 +58,94 @@ std::shared_ptr<SstPartitionerFactory> NewSstPartitionerFixedPrefixFactory(
   return std::make_shared<SstPartitionerFixedPrefixFactory>(prefix_len);
 }
 
+static std::unordered_map<std::string, OptionTypeInfo>
+    sst_next_level_aligned_min_type_info = {
+#ifndef ROCKSDB_LITE
+        {"min_file_size",
+         {0, OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+#endif  // ROCKSDB_LITE
+};
+
+static std::unordered_map<std::string, OptionTypeInfo>
+    sst_next_level_aligned_max_type_info = {
+#ifndef ROCKSDB_LITE
+        {"max_file_size",
+         {0, OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+#endif  // ROCKSDB_LITE
+};
+
+SstPartitionerNextLevelAligned::SstPartitionerNextLevelAligned(
+    uint64_t min_file_size, uint64_t max_file_size,
+    const SstPartitioner::Context& context)
+    : min_file_size_(min_file_size),
+      max_file_size_(max_file_size),
+      ucmp_(context.user_comparator),
+      boundaries_(context.next_level_file_boundaries) {}
+
+PartitionerResult SstPartitionerNextLevelAligned::ShouldPartition(
+    const PartitionerRequest& request) {
+  if (max_file_size_ > 0 &&
+      request.current_output_file_size >= max_file_size_) {
+    return kRequired;
+  }
+  if (ucmp_ == nullptr) {
+    return kNotRequired;
+  }
+  // Keys come in ascending order, so boundaries only need to be passed once.
+  // The current key passed a boundary if the previous key did not.
+  bool passed_boundary = false;
+  while (next_boundary_ < boundaries_.size() &&
+         ucmp_->Compare(boundaries_[next_boundary_],
+                        *request.current_user_key) < 0) {
+    if (ucmp_->Compare(boundaries_[next_boundary_], *request.prev_user_key) >=
+        0) {
+      passed_boundary = true;
+    }
+    next_boundary_++;
+  }
+  return passed_boundary && request.current_output_file_size >= min_file_size_
+             ? kRequired
+             : kNotRequired;
+}
+
+bool SstPartitionerNextLevelAligned::CanDoTrivialMove(
+    const Slice& smallest_user_key, const Slice& largest_user_key) {
+  if (ucmp_ == nullptr) {
+    return true;
+  }
+  // Not if the file would be cut at a boundary within it
+  auto it = std::lower_bound(boundaries_.begin(), boundaries_.end(),
+                             smallest_user_key,
+                             [this](const Slice& boundary, const Slice& key) {
+                               return ucmp_->Compare(boundary, key) < 0;
+                             });
+  return it == boundaries_.end() || ucmp_->Compare(*it, largest_user_key) >= 0;
+}
+
+SstPartitionerNextLevelAlignedFactory::SstPartitionerNextLevelAlignedFactory(
+    uint64_t min_file_size, uint64_t max_file_size)
+    : min_file_size_(min_file_size), max_file_size_(max_file_size) {
+  RegisterOptions("MinFileSize", &min_file_size_,
+                  &sst_next_level_aligned_min_type_info);
+  RegisterOptions("MaxFileSize", &max_file_size_,
+                  &sst_next_level_aligned_max_type_info);
+}
+
+std::unique_ptr<SstPartitioner>
+SstPartitionerNextLevelAlignedFactory::CreatePartitioner(
+    const SstPartitioner::Context& context) const {
+  return std::unique_ptr<SstPartitioner>(new SstPartitionerNextLevelAligned(
+      min_file_size_, max_file_size_, context));
+}
+
+std::shared_ptr<SstPartitionerFactory> NewSstPartitionerNextLevelAlignedFactory(
+    uint64_t min_file_size, uint64_t max_file_size) {
+  return std::make_shared<SstPartitionerNextLevelAlignedFactory>(
+      min_file_size, max_file_size);
+}
+
 #ifndef ROCKSDB_LITE
 namespace {
 static int RegisterSstPartitionerFactories(ObjectLibrary& library,
@@ -70,7 +158,15 @@ static int RegisterSstPartitionerFactories(ObjectLibrary& library,
         guard->reset(new SstPartitionerFixedPrefixFactory(0));
         return guard->get();
       });
-  return 1;
+  library.AddFactory<SstPartitionerFactory>(
+      SstPartitionerNextLevelAlignedFactory::kClassName(),
+      [](const std::string& /*uri*/,
+         std::unique_ptr<SstPartitionerFactory>* guard,
+         std::string* /* errmsg */) {
+        guard->reset(new SstPartitionerNextLevelAlignedFactory(0, 0));
+        return guard->get();
+      });
+  return 2;
 }
 }  // namespace
 #endif  // ROCKSDB_LITE
@@ -161,6 +161,25 @@ bool SubcompactionState::ShouldStopBefore(const Slice& internal_key) {
   }
   seen_key_ = true;
 
+  // The outputs must not overlap the input files that are reused as-is, so
+  // cut the current output if it would span one of those.
+  const std::vector<FileMetaData*>& reused_files =
+      compaction->reused_input_files();
+  const FileMetaData* passed_reused_file = nullptr;
+  while (reused_input_file_index_ < reused_files.size() &&
+         icmp->Compare(internal_key,
+                       reused_files[reused_input_file_index_]
+                           ->largest.Encode()) > 0) {
+    passed_reused_file = reused_files[reused_input_file_index_];
+    reused_input_file_index_++;
+  }
+  if (passed_reused_file != nullptr && Current().HasBuilder() &&
+      icmp->Compare(Current().current_output().meta.largest.Encode(),
+                    passed_reused_file->smallest.Encode()) < 0) {
+    overlapped_bytes_ = 0;
+    return true;
+  }
+
   if (grandparant_file_switched &&
       overlapped_bytes_ + curr_file_size > compaction->max_compaction_bytes()) {
     // Too much overlap for current output; start new output
@@ -220,4 +239,15 @@ Status SubcompactionState::AddToOutput(
   return Current().AddToOutput(iter, open_file_func, close_file_func);
 }
 
+Status SubcompactionState::AddCleanDataBlock(
+    TableReader::RawDataBlock* block,
+    const CompactionFileOpenFunc& open_file_func,
+    const CompactionFileCloseFunc& close_file_func) {
+  assert(!compaction->SupportsPerKeyPlacement());
+  is_current_penultimate_level_ = false;
+  current_outputs_ = &compaction_outputs_;
+
+  return Current().AddCleanDataBlock(block, open_file_func, close_file_func);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
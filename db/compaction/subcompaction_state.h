@@ -53,8 +53,11 @@ class SubcompactionState {
 
   // The boundaries of the key-range this compaction is interested in. No two
   // sub-compactions may have overlapping key-ranges.
-  // 'start' is inclusive, 'end' is exclusive, and nullptr means unbounded
-  const std::optional<Slice> start, end;
+  // 'start' is inclusive, 'end' is exclusive, and nullptr means unbounded.
+  // 'end' is only changed by the thread running the sub-compaction, when it
+  // hands the rest of its key-range over to a new sub-compaction.
+  const std::optional<Slice> start;
+  std::optional<Slice> end;
 
   // The return status of this sub-compaction
   Status status;
@@ -73,6 +76,25 @@ class SubcompactionState {
   // within the same compaction job.
   const uint32_t sub_job_id;
 
+  // A data block of an input file that the compaction would not change, so
+  // it is copied to the output as stored instead of going through the
+  // compaction iterator (see `compaction_copy_clean_data_blocks`).
+  struct CleanDataBlock {
+    const FileMetaData* file;
+    BlockHandle handle;
+    // The first and the last internal key of the block
+    std::string smallest;
+    std::string largest;
+  };
+
+  // The clean data blocks within the key-range of this sub-compaction in key
+  // order, and the key ranges of the runs of adjacent clean blocks in the
+  // same file, which the compaction input skips.
+  std::vector<CleanDataBlock> clean_data_blocks;
+  std::vector<std::pair<std::string, std::string>> clean_data_block_ranges;
+  // Index of the first clean data block not added to the output yet
+  size_t next_clean_data_block = 0;
+
   Slice SmallestUserKey() const;
 
   Slice LargestUserKey() const;
@@ -155,9 +177,13 @@ class SubcompactionState {
             state.notify_on_subcompaction_completion),
         compaction_job_stats(std::move(state.compaction_job_stats)),
         sub_job_id(state.sub_job_id),
+        clean_data_blocks(std::move(state.clean_data_blocks)),
+        clean_data_block_ranges(std::move(state.clean_data_block_ranges)),
+        next_clean_data_block(state.next_clean_data_block),
         files_to_cut_for_ttl_(std::move(state.files_to_cut_for_ttl_)),
         cur_files_to_cut_for_ttl_(state.cur_files_to_cut_for_ttl_),
         next_files_to_cut_for_ttl_(state.next_files_to_cut_for_ttl_),
+        reused_input_file_index_(state.reused_input_file_index_),
         grandparent_index_(state.grandparent_index_),
         overlapped_bytes_(state.overlapped_bytes_),
         seen_key_(state.seen_key_),
@@ -210,6 +236,12 @@ class SubcompactionState {
                      const CompactionFileOpenFunc& open_file_func,
                      const CompactionFileCloseFunc& close_file_func);
 
+  // Add a clean data block, read with TableReader::ReadRawDataBlock(), to
+  // the normal outputs.
+  Status AddCleanDataBlock(TableReader::RawDataBlock* block,
+                           const CompactionFileOpenFunc& open_file_func,
+                           const CompactionFileCloseFunc& close_file_func);
+
   // Close all compaction output files, both output_to_penultimate_level outputs
   // and normal outputs.
   Status CloseCompactionFiles(const Status& curr_status,
@@ -231,6 +263,11 @@ class SubcompactionState {
   int cur_files_to_cut_for_ttl_ = -1;
   int next_files_to_cut_for_ttl_ = 0;
 
+  // Index of the first reused input file (see
+  // Compaction::reused_input_files()) the keys have not passed yet, used to
+  // keep output files from spanning a reused file.
+  size_t reused_input_file_index_ = 0;
+
   // An index that used to speed up ShouldStopBefore().
   size_t grandparent_index_ = 0;
   // The number of bytes overlapping between the current output and
@@ -544,6 +544,57 @@ TEST_F(DBBlockCacheTest, IndexAndFilterBlocksOfNewTableAddedToCache) {
             TestGetTickerCount(options, BLOCK_CACHE_INDEX_HIT));
 }
 
+TEST_F(DBBlockCacheTest, MetadataBlockCache) {
+  std::shared_ptr<Cache> cache = NewLRUCache(1 << 25);
+  std::shared_ptr<Cache> metadata_cache = NewLRUCache(1 << 25);
+
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  // If this wakes up, it could interfere with test
+  options.stats_dump_period_sec = 0;
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = cache;
+  table_options.metadata_block_cache = metadata_cache;
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(20));
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("foo", "value"));
+  ASSERT_OK(Put("bar", "value"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("value", Get("foo"));
+
+  // Index and filter blocks only went to the metadata cache
+  std::map<std::string, std::string> values;
+  ASSERT_TRUE(db_->GetMapProperty(DB::Properties::kMetadataBlockCacheEntryStats,
+                                  &values));
+  EXPECT_EQ("1", values[BlockCacheEntryStatsMapKeys::EntryCount(
+                     CacheEntryRole::kIndexBlock)]);
+  EXPECT_EQ("1", values[BlockCacheEntryStatsMapKeys::EntryCount(
+                     CacheEntryRole::kFilterBlock)]);
+  EXPECT_EQ("0", values[BlockCacheEntryStatsMapKeys::EntryCount(
+                     CacheEntryRole::kDataBlock)]);
+
+  // and data blocks only to the block cache
+  values.clear();
+  ASSERT_TRUE(
+      db_->GetMapProperty(DB::Properties::kBlockCacheEntryStats, &values));
+  EXPECT_EQ("0", values[BlockCacheEntryStatsMapKeys::EntryCount(
+                     CacheEntryRole::kIndexBlock)]);
+  EXPECT_EQ("0", values[BlockCacheEntryStatsMapKeys::EntryCount(
+                     CacheEntryRole::kFilterBlock)]);
+  EXPECT_EQ("1", values[BlockCacheEntryStatsMapKeys::EntryCount(
+                     CacheEntryRole::kDataBlock)]);
+
+  // Without a separate metadata cache, the property is not available
+  table_options.metadata_block_cache = nullptr;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  ASSERT_FALSE(db_->GetMapProperty(
+      DB::Properties::kMetadataBlockCacheEntryStats, &values));
+}
+
 // With fill_cache = false, fills up the cache, then iterates over the entire
 // db, verify dummy entries inserted in `BlockBasedTable::NewDataBlockIterator`
 // does not cause heap-use-after-free errors in COMPILE_WITH_ASAN=1 runs
@@ -1524,6 +1575,78 @@ TEST_F(DBBlockCacheTest, CacheEntryRoleStats) {
   }
 }
 
+TEST_F(DBBlockCacheTest, DumpAndRestoreBlockCacheOnReopen) {
+  const std::string dump_file = dbname_ + "_block_cache_dump";
+  env_->DeleteFile(dump_file).PermitUncheckedError();
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.block_cache_dump_file = dump_file;
+  BlockBasedTableOptions table_options;
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  table_options.block_size = 1024;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 200;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), std::string(100, 'a' + (i % 26))));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(std::string(100, 'a' + (i % 26)), Get(Key(i)));
+  }
+
+  size_t num_restored = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::RestoreBlockCacheFromFile:Done",
+      [&](void* arg) { num_restored = *static_cast<size_t*>(arg); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Reopen with an empty block cache, as after a restart
+  Close();
+  ASSERT_OK(env_->FileExists(dump_file));
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  Reopen(options);
+  ASSERT_GT(num_restored, 0);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(std::string(100, 'a' + (i % 26)), Get(Key(i)));
+  }
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+  ASSERT_GT(TestGetTickerCount(options, BLOCK_CACHE_DATA_HIT), 0);
+
+  // Rewrite the table file while the dump is not updated, so that the dump
+  // only has blocks of a file that is no longer live
+  Close();
+  options.block_cache_dump_file = "";
+  Reopen(options);
+  // Overwrite every key so that the compaction cannot just move the old file
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), std::string(100, 'a' + (i % 26))));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  Close();
+  num_restored = 0;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.block_cache_dump_file = dump_file;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  Reopen(options);
+  ASSERT_EQ(0, num_restored);
+  ASSERT_EQ(std::string(100, 'a'), Get(Key(0)));
+  ASSERT_EQ(1, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  Close();
+  ASSERT_OK(env_->DeleteFile(dump_file));
+}
+
 #endif  // ROCKSDB_LITE
 
 class DBBlockCacheKeyTest
@@ -1740,6 +1863,50 @@ TEST_P(DBBlockCacheKeyTest, StableCacheKeys) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
 }
 
+#ifndef ROCKSDB_LITE
+TEST_F(DBBlockCacheTest, SharedCacheKeysForCheckpoint) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 10;
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), "abc"));
+  }
+  ASSERT_OK(Flush());
+
+  const std::string checkpoint_dir = dbname_ + "-checkpoint";
+  Checkpoint* checkpoint;
+  ASSERT_OK(Checkpoint::Create(db_, &checkpoint));
+  ASSERT_OK(checkpoint->CreateCheckpoint(checkpoint_dir));
+  delete checkpoint;
+
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_EQ("abc", Get(Key(i)));
+  }
+  const uint64_t data_adds = TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD);
+  ASSERT_GT(data_adds, 0U);
+
+  // Another DB instance reading the same table file finds its blocks in the
+  // cache, as the cache keys come from the table properties
+  DB* checkpoint_db = nullptr;
+  ASSERT_OK(DB::Open(options, checkpoint_dir, &checkpoint_db));
+  for (int i = 0; i < kNumKeys; ++i) {
+    std::string value;
+    ASSERT_OK(checkpoint_db->Get(ReadOptions(), Key(i), &value));
+    ASSERT_EQ("abc", value);
+  }
+  ASSERT_EQ(data_adds, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+  delete checkpoint_db;
+
+  ASSERT_OK(DestroyDB(checkpoint_dir, options));
+}
+#endif  // !ROCKSDB_LITE
+
 class CacheKeyTest : public testing::Test {
  public:
   CacheKey GetBaseCacheKey() {
@@ -1056,6 +1056,76 @@ TEST_F(DBCompactionTest, CompactionSstPartitionerNonTrivial) {
   ASSERT_EQ("B", Get("bbbb1"));
 }
 
+TEST_F(DBCompactionTest, CompactionSstPartitionerNextLevelAligned) {
+  class LastJobStatsCollector : public EventListener {
+   public:
+    void OnCompactionCompleted(DB* /*db*/,
+                               const CompactionJobInfo& ci) override {
+      InstrumentedMutexLock l(&mutex_);
+      stats_ = ci.stats;
+    }
+
+    CompactionJobStats GetStats() {
+      InstrumentedMutexLock l(&mutex_);
+      return stats_;
+    }
+
+   private:
+    InstrumentedMutex mutex_;
+    CompactionJobStats stats_;
+  };
+
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.num_levels = 4;
+  options.compression = kNoCompression;
+  options.sst_partitioner_factory =
+      NewSstPartitionerNextLevelAlignedFactory(/*min_file_size=*/0);
+  auto* collector = new LastJobStatsCollector();
+  options.listeners.emplace_back(collector);
+  DestroyAndReopen(options);
+
+  // Four L3 files with 25 keys each
+  const int kNumKeys = 100;
+  for (int i = 0; i < kNumKeys; i += 25) {
+    for (int j = i; j < i + 25; j++) {
+      ASSERT_OK(Put(Key(j), "old"));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(3);
+  }
+  ASSERT_EQ("0,0,0,4", FilesPerLevel());
+
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), "new"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ("1,0,0,4", FilesPerLevel());
+
+  // The L0 file is cut right after the largest key of each L3 file, the
+  // first non-empty level after the output level.
+  ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+  ASSERT_EQ("0,4,0,4", FilesPerLevel());
+  std::vector<std::vector<FileMetaData>> files;
+  dbfull()->TEST_GetFilesMetaData(db_->DefaultColumnFamily(), &files);
+  for (size_t i = 0; i < files[1].size(); i++) {
+    ASSERT_EQ(Key(static_cast<int>(i) * 25), files[1][i].smallest.user_key());
+    ASSERT_EQ(Key(static_cast<int>(i) * 25 + 24),
+              files[1][i].largest.user_key());
+  }
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ("new", Get(Key(i)));
+  }
+
+  const CompactionJobStats stats = collector->GetStats();
+  ASSERT_EQ(4U, stats.num_output_files);
+  ASSERT_EQ(0U, stats.total_input_bytes_at_output_level);
+  ASSERT_GT(stats.WriteAmplification(), 0.0);
+  ASSERT_EQ(static_cast<double>(stats.total_output_bytes) /
+                static_cast<double>(stats.total_input_bytes),
+            stats.WriteAmplification());
+}
+
 TEST_F(DBCompactionTest, ZeroSeqIdCompaction) {
   Options options = CurrentOptions();
   options.compaction_style = kCompactionStyleLevel;
@@ -1386,6 +1456,148 @@ TEST_P(DBCompactionTestWithParam, TrivialMoveTargetLevel) {
   }
 }
 
+TEST_P(DBCompactionTestWithParam, MoveNonOverlappingInputFiles) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.level0_file_num_compaction_trigger = 2;
+  options.max_subcompactions = max_subcompactions_;
+  options.level_compaction_move_non_overlapping_files = true;
+  DestroyAndReopen(options);
+
+  auto get_files = [&](int level) {
+    ColumnFamilyMetaData cf_meta;
+    db_->GetColumnFamilyMetaData(&cf_meta);
+    std::set<std::string> names;
+    for (const auto& file : cf_meta.levels[level].files) {
+      names.insert(file.name);
+    }
+    return names;
+  };
+
+  // L1: [0 => 9], [30 => 39], [60 => 69]
+  for (int start : {0, 30, 60}) {
+    for (int i = start; i < start + 10; i++) {
+      ASSERT_OK(Put(Key(i), "old"));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+  }
+  ASSERT_EQ("0,3", FilesPerLevel(0));
+  std::set<std::string> old_l1_files = get_files(1);
+
+  // L0: [5, 65], [50 => 59]
+  ASSERT_OK(Put(Key(5), "new"));
+  ASSERT_OK(Put(Key(65), "new"));
+  ASSERT_OK(Flush());
+  for (int i = 50; i < 60; i++) {
+    ASSERT_OK(Put(Key(i), "new"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ("2,3", FilesPerLevel(0));
+  std::set<std::string> old_files = get_files(0);
+  old_files.insert(old_l1_files.begin(), old_l1_files.end());
+
+  ASSERT_OK(db_->SetOptions({{"disable_auto_compactions", "false"}}));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+
+  // [30 => 39] stays in L1 and [50 => 59] is moved there, while the files
+  // around them are rewritten.
+  std::set<std::string> new_l1_files = get_files(1);
+  std::vector<std::string> reused_files;
+  std::set_intersection(new_l1_files.begin(), new_l1_files.end(),
+                        old_files.begin(), old_files.end(),
+                        std::back_inserter(reused_files));
+  ASSERT_EQ(2U, reused_files.size());
+  ASSERT_EQ(1U, old_l1_files.count(reused_files[0]) +
+                    old_l1_files.count(reused_files[1]));
+  if (max_subcompactions_ == 1) {
+    ASSERT_EQ("0,4", FilesPerLevel(0));
+  }
+
+  for (int i = 0; i < 70; i++) {
+    std::string expected = "NOT_FOUND";
+    if (i == 5 || i == 65 || (i >= 50 && i < 60)) {
+      expected = "new";
+    } else if (i < 10 || (i >= 30 && i < 40) || i >= 60) {
+      expected = "old";
+    }
+    ASSERT_EQ(expected, Get(Key(i)));
+  }
+}
+
+TEST_P(DBCompactionTestWithParam, CopyCleanDataBlocks) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.level0_file_num_compaction_trigger = 1;
+  options.max_subcompactions = max_subcompactions_;
+  options.compaction_copy_clean_data_blocks = true;
+  options.compression = kNoCompression;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // L2: [0, 999], so that the compaction into L1 is not bottommost and
+  // keeps the sequence numbers.
+  ASSERT_OK(Put(Key(0), "bottom"));
+  ASSERT_OK(Put(Key(999), "bottom"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  // L1: [0 => 199], with about ten keys per data block
+  const std::string padding(80, 'x');
+  for (int i = 0; i < 200; i++) {
+    ASSERT_OK(Put(Key(i), "old" + padding));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  // L0: [5, 150]
+  ASSERT_OK(Put(Key(5), "new"));
+  ASSERT_OK(Put(Key(150), "new"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("1,1,1", FilesPerLevel(0));
+
+  int num_copied_blocks = 0;
+  int num_rewritten_blocks = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionOutputs::AddCleanDataBlock", [&](void* arg) {
+        if (*static_cast<bool*>(arg)) {
+          num_copied_blocks++;
+        } else {
+          num_rewritten_blocks++;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(db_->SetOptions({{"disable_auto_compactions", "false"}}));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ("0,1,1", FilesPerLevel(0));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // Only the blocks around the two new keys are rewritten.
+  ASSERT_GE(num_copied_blocks, 10);
+  ASSERT_EQ(0, num_rewritten_blocks);
+
+  for (int i = 0; i < 200; i++) {
+    ASSERT_EQ(i == 5 || i == 150 ? "new" : "old" + padding, Get(Key(i)));
+  }
+  ASSERT_EQ("bottom", Get(Key(999)));
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    count++;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(201, count);
+
+  // The copied blocks are recompacted like any other.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  for (int i = 0; i < 200; i++) {
+    ASSERT_EQ(i == 5 || i == 150 ? "new" : "old" + padding, Get(Key(i)));
+  }
+}
+
 TEST_P(DBCompactionTestWithParam, PartialOverlappingL0) {
   class SubCompactionEventListener : public EventListener {
    public:
@@ -4895,6 +5107,107 @@ TEST_F(DBCompactionTest, SubcompactionEvent) {
   ASSERT_GT(listener->GetTotalSubcompactionCount(), 0);
 }
 
+TEST_F(DBCompactionTest, SubcompactionWorkStealing) {
+  class JobStatsCollector : public EventListener {
+   public:
+    void OnCompactionCompleted(DB* /*db*/,
+                               const CompactionJobInfo& ci) override {
+      InstrumentedMutexLock l(&mutex_);
+      stats_.push_back(ci.stats);
+    }
+
+    std::vector<CompactionJobStats> GetStats() {
+      InstrumentedMutexLock l(&mutex_);
+      return stats_;
+    }
+
+   private:
+    InstrumentedMutex mutex_;
+    std::vector<CompactionJobStats> stats_;
+  };
+
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.compression = kNoCompression;
+  options.write_buffer_size = 16 << 20;
+  options.target_file_size_base = 16 << 10;
+  // Two sub-compaction boundaries, as a single one does not form
+  // sub-compactions
+  options.max_subcompactions = 3;
+  options.enable_subcompaction_work_stealing = true;
+  auto* collector = new JobStatsCollector();
+  options.listeners.emplace_back(collector);
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 20000;
+  Random rnd(301);
+  for (int i = 0; i < 2; i++) {
+    for (int j = i; j < kNumKeys; j += 2) {
+      ASSERT_OK(Put(Key(j), rnd.RandomString(100)));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ("2", FilesPerLevel());
+
+  // Slow down whichever sub-compaction starts first until it has handed part
+  // of its range over to an idle one.
+  std::atomic<bool> split{false};
+  std::mutex slow_thread_mutex;
+  std::thread::id slow_thread;
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::Run():Inprogress", [&](void* /*arg*/) {
+        std::lock_guard<std::mutex> l(slow_thread_mutex);
+        if (slow_thread == std::thread::id()) {
+          slow_thread = std::this_thread::get_id();
+        }
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::Run():PausingManualCompaction:2", [&](void* /*arg*/) {
+        if (split.load()) {
+          return;
+        }
+        bool is_slow_thread;
+        {
+          std::lock_guard<std::mutex> l(slow_thread_mutex);
+          is_slow_thread = slow_thread == std::this_thread::get_id();
+        }
+        if (is_slow_thread) {
+          env_->SleepForMicroseconds(100);
+        }
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::MaybeSplitSubcompaction:Split",
+      [&](void* /*arg*/) { split.store(true); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_TRUE(split.load());
+  std::vector<CompactionJobStats> stats = collector->GetStats();
+  ASSERT_EQ(1U, stats.size());
+  ASSERT_GE(stats[0].num_split_subcompactions, 1U);
+  ASSERT_EQ(3U + stats[0].num_split_subcompactions,
+            stats[0].num_subcompactions);
+  ASSERT_LE(stats[0].min_subcompaction_micros,
+            stats[0].max_subcompaction_micros);
+  ASSERT_EQ(static_cast<uint64_t>(kNumKeys), stats[0].num_output_records);
+
+  // Output files of the split sub-compactions must not overlap, which the
+  // version's consistency checks verify, and must hold every key once.
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  int num_keys = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_EQ(Key(num_keys), iter->key().ToString());
+    num_keys++;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(kNumKeys, num_keys);
+}
+
 TEST_F(DBCompactionTest, CompactFilesOutputRangeConflict) {
   // LSM setup:
   // L1:      [ba bz]
@@ -5331,6 +5644,146 @@ TEST_F(DBCompactionTest, PersistRoundRobinCompactCursor) {
   }
 }
 
+TEST_F(DBCompactionTest, PersistMultipleRoundRobinCompactCursors) {
+  Options options = CurrentOptions();
+  options.write_buffer_size = 16 * 1024;
+  options.max_bytes_for_level_base = 128 * 1024;
+  options.target_file_size_base = 16 * 1024;
+  options.level0_file_num_compaction_trigger = 4;
+  options.compaction_pri = CompactionPri::kRoundRobin;
+  options.round_robin_cursors_per_level = 4;
+  options.max_background_compactions = 4;
+  options.max_bytes_for_level_multiplier = 4;
+  options.num_levels = 3;
+  options.compression = kNoCompression;
+
+  DestroyAndReopen(options);
+
+  std::atomic<int> num_picks_by_other_cursors{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelCompactionBuilder::PickFileWithRoundRobinCursors:Picked",
+      [&](void* arg) {
+        if (*static_cast<int*>(arg) > 0) {
+          num_picks_by_other_cursors++;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  for (int i = 0; i < 30; i++) {
+    for (int j = 0; j < 16; j++) {
+      ASSERT_OK(Put(rnd.RandomString(24), rnd.RandomString(1000)));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_GT(num_picks_by_other_cursors.load(), 0);
+
+  const std::vector<std::vector<InternalKey>> extra_cursors =
+      dbfull()
+          ->GetVersionSet()
+          ->GetColumnFamilySet()
+          ->GetDefault()
+          ->current()
+          ->storage_info()
+          ->GetExtraCompactCursors();
+  ASSERT_FALSE(extra_cursors[1].empty());
+
+  // Reopen twice so that the cursors are both replayed from the edits and
+  // written as part of a new MANIFEST.
+  Reopen(options);
+  Reopen(options);
+
+  const VersionStorageInfo* const reopened_storage_info =
+      dbfull()
+          ->GetVersionSet()
+          ->GetColumnFamilySet()
+          ->GetDefault()
+          ->current()
+          ->storage_info();
+  const auto icmp = reopened_storage_info->InternalComparator();
+  for (int level = 0; level < static_cast<int>(extra_cursors.size());
+       level++) {
+    for (size_t i = 0; i < extra_cursors[level].size(); i++) {
+      const InternalKey reopened = reopened_storage_info->GetCompactCursor(
+          level, static_cast<uint32_t>(i + 1));
+      if (extra_cursors[level][i].Valid()) {
+        ASSERT_EQ(0, icmp->Compare(extra_cursors[level][i], reopened));
+      } else {
+        ASSERT_FALSE(reopened.Valid());
+      }
+    }
+  }
+}
+
+TEST_F(DBCompactionTest, PreemptBottommostCompactionForStallingColumnFamily) {
+  Options options = CurrentOptions();
+  options.max_background_compactions = 1;
+  options.max_background_flushes = 1;
+  options.level0_file_num_compaction_trigger = 2;
+  options.level0_slowdown_writes_trigger = 2;
+  options.level0_stop_writes_trigger = 20;
+  options.compaction_scheduling_by_stall_deadline = true;
+  options.bottommost_compaction_preemption_micros = 60 * 1000 * 1000;
+  Options pikachu_options = options;
+  pikachu_options.disable_auto_compactions = true;
+  pikachu_options.max_bytes_for_level_base = 1024;
+  pikachu_options.num_levels = 3;
+  CreateAndReopenWithCF({"pikachu"}, options);
+  ReopenWithColumnFamilies({"default", "pikachu"},
+                           std::vector<Options>{options, pikachu_options});
+
+  // Give "pikachu" an oversized L1, whose compaction into L2 is a bottommost
+  // compaction that does not relieve L0.
+  for (int level = 2; level >= 1; level--) {
+    for (int i = 0; i < 10; i++) {
+      ASSERT_OK(Put(1, Key(i), std::string(1024, 'v')));
+    }
+    ASSERT_OK(Flush(1));
+    MoveFilesToLevel(level, 1);
+  }
+  ASSERT_EQ("0,1,1", FilesPerLevel(1));
+
+  std::vector<std::string> compacted_cfs;
+  std::atomic<int> num_preempted{0};
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"DBImpl::MaybePreemptCompactionForStall:Preempt",
+        "CompactionJob::Run():PausingManualCompaction:1"}});
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::MaybePreemptCompactionForStall:Preempt",
+      [&](void* /*arg*/) { num_preempted++; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:AfterCompaction", [&](void* arg) {
+        compacted_cfs.push_back(static_cast<ColumnFamilyData*>(arg)->GetName());
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // The compaction of "pikachu" takes the only compaction thread and waits
+  // until it is canceled in favor of the default column family, which
+  // reaches level0_slowdown_writes_trigger.
+  ASSERT_OK(dbfull()->SetOptions(handles_[1],
+                                 {{"disable_auto_compactions", "false"}}));
+  for (int i = 0; i < 2; i++) {
+    ASSERT_OK(Put(0, "key", "value" + std::to_string(i)));
+    ASSERT_OK(Flush(0));
+  }
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(1, num_preempted.load());
+  ASSERT_EQ(std::vector<std::string>({"pikachu", "default", "pikachu"}),
+            compacted_cfs);
+  ASSERT_EQ(0, NumTableFilesAtLevel(0, 0));
+  ASSERT_EQ(0, NumTableFilesAtLevel(1, 1));
+  ASSERT_EQ("value1", Get(0, "key"));
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(std::string(1024, 'v'), Get(1, Key(i)));
+  }
+}
+
 TEST_P(RoundRobinSubcompactionsAgainstPressureToken, PressureTokenTest) {
   const int kKeysPerBuffer = 100;
   Options options = CurrentOptions();
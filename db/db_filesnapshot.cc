@@ -407,8 +407,8 @@ Status DBImpl::GetLiveFilesStorageInfo(
   ROCKS_LOG_INFO(immutable_db_options_.info_log,
                  "Number of log files %" ROCKSDB_PRIszt, live_wal_files.size());
 
-  // Link WAL files. Copy exact size of last one because it is the only one
-  // that has changes after the last flush.
+  // Link WAL files. Copy exact size of last one, or of the logs of the streams
+  // of the current WAL, because only they have changes after the last flush.
   auto wal_dir = immutable_db_options_.GetWalDir();
   for (size_t i = 0; s.ok() && i < wal_size; ++i) {
     if ((live_wal_files[i]->Type() == kAliveLogFile) &&
@@ -423,7 +423,9 @@ Status DBImpl::GetLiveFilesStorageInfo(
       info.file_type = kWalFile;
       info.size = live_wal_files[i]->SizeFileBytes();
       // Only last should need to be trimmed
-      info.trim_to_size = (i + 1 == wal_size);
+      info.trim_to_size =
+          i + static_cast<size_t>(immutable_db_options_.num_wal_streams) >=
+          wal_size;
       if (opts.include_checksum_info) {
         info.file_checksum_func_name = kUnknownFileChecksumFuncName;
         info.file_checksum = kUnknownFileChecksum;
@@ -25,6 +25,7 @@
 #include <utility>
 #include <vector>
 
+#include "cache/cache_key.h"
 #include "db/arena_wrapped_db_iter.h"
 #include "db/builder.h"
 #include "db/compaction/compaction_job.h"
@@ -106,6 +107,7 @@
 #include "util/mutexlock.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
+#include "utilities/cache_dump_load_impl.h"
 #include "utilities/trace/replayer_impl.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -242,7 +244,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       atomic_flush_install_cv_(&mutex_),
       blob_callback_(immutable_db_options_.sst_file_manager.get(), &mutex_,
                      &error_handler_, &event_logger_,
-                     immutable_db_options_.listeners, dbname_) {
+                     immutable_db_options_.listeners, dbname_),
+      key_write_tracker_(nullptr) {
   // !batch_per_trx_ implies seq_per_batch_ because it is only unset for
   // WriteUnprepared, which should use seq_per_batch_.
   assert(batch_per_txn_ || seq_per_batch_);
@@ -593,6 +596,12 @@ Status DBImpl::CloseHelper() {
   }
   TEST_SYNC_POINT_CALLBACK("DBImpl::CloseHelper:PendingPurgeFinished",
                            &files_grabbed_for_purge_);
+#ifndef ROCKSDB_LITE
+  if (opened_successfully_ &&
+      !immutable_db_options_.block_cache_dump_file.empty()) {
+    DumpBlockCacheToFile();
+  }
+#endif  // !ROCKSDB_LITE
   EraseThreadStatusDbInfo();
   flush_scheduler_.Clear();
   trim_history_scheduler_.Clear();
@@ -737,6 +746,135 @@ Status DBImpl::CloseHelper() {
 
 Status DBImpl::CloseImpl() { return CloseHelper(); }
 
+#ifndef ROCKSDB_LITE
+void DBImpl::GetBlockCacheDumpTargets(
+    std::unordered_map<std::string, CacheDumpRestoreTarget>* targets) {
+  mutex_.AssertHeld();
+  assert(targets != nullptr);
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || !cfd->initialized()) {
+      continue;
+    }
+    const BlockBasedTableOptions* table_options =
+        cfd->ioptions()->table_factory->GetOptions<BlockBasedTableOptions>();
+    if (table_options == nullptr || table_options->no_block_cache ||
+        table_options->block_cache == nullptr) {
+      continue;
+    }
+    const VersionStorageInfo* vstorage = cfd->current()->storage_info();
+    for (int level = 0; level < vstorage->num_levels(); ++level) {
+      for (const FileMetaData* f : vstorage->LevelFiles(level)) {
+        UniqueId64x2 unique_id = f->unique_id;
+        if (unique_id == kNullUniqueId64x2) {
+          continue;
+        }
+        // The same base cache key as the table reader derives from the table
+        // properties, see BlockBasedTable::SetupBaseCacheKey()
+        OffsetableCacheKey base_cache_key =
+            OffsetableCacheKey::FromInternalUniqueId(&unique_id);
+        (*targets)[base_cache_key.CommonPrefixSlice().ToString()] =
+            CacheDumpRestoreTarget{table_options->block_cache.get(),
+                                   table_options};
+      }
+    }
+  }
+}
+
+void DBImpl::DumpBlockCacheToFile() {
+  mutex_.AssertHeld();
+  std::unordered_map<std::string, CacheDumpRestoreTarget> targets;
+  GetBlockCacheDumpTargets(&targets);
+  if (targets.empty()) {
+    return;
+  }
+  // Background work is over and the column families, which keep the block
+  // caches alive, are only destroyed later on, so the mutex can be released.
+  mutex_.Unlock();
+  std::set<std::string> prefixes;
+  std::vector<Cache*> caches;
+  for (const auto& target : targets) {
+    prefixes.insert(target.first);
+    if (std::find(caches.begin(), caches.end(), target.second.cache) ==
+        caches.end()) {
+      caches.push_back(target.second.cache);
+    }
+  }
+
+  // Write to a temporary file first so that a dump cut short never replaces
+  // a complete one
+  const std::string& dump_file = immutable_db_options_.block_cache_dump_file;
+  const std::string tmp_file = dump_file + ".tmp";
+  std::unique_ptr<CacheDumpWriter> writer;
+  IOStatus io_s = NewToFileCacheDumpWriter(immutable_db_options_.fs,
+                                           file_options_, tmp_file, &writer);
+  if (io_s.ok()) {
+    CacheDumpOptions dump_options;
+    dump_options.clock = immutable_db_options_.clock;
+    CacheDumperImpl dumper(dump_options, /*cache=*/nullptr, std::move(writer));
+    dumper.SetPrefixFilter(std::move(prefixes));
+    io_s = dumper.DumpCachesToWriter(caches);
+  }
+  if (io_s.ok()) {
+    io_s = immutable_db_options_.fs->RenameFile(tmp_file, dump_file,
+                                                IOOptions(), nullptr);
+  }
+  if (io_s.ok()) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Dumped block cache to %s", dump_file.c_str());
+  } else {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Failed to dump block cache to %s: %s", dump_file.c_str(),
+                   io_s.ToString().c_str());
+  }
+  TEST_SYNC_POINT("DBImpl::DumpBlockCacheToFile:Done");
+  mutex_.Lock();
+}
+
+void DBImpl::RestoreBlockCacheFromFile() {
+  const std::string& dump_file = immutable_db_options_.block_cache_dump_file;
+  if (!immutable_db_options_.fs->FileExists(dump_file, IOOptions(), nullptr)
+           .ok()) {
+    return;
+  }
+  std::unordered_map<std::string, CacheDumpRestoreTarget> targets;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    GetBlockCacheDumpTargets(&targets);
+  }
+  if (targets.empty()) {
+    return;
+  }
+
+  std::unique_ptr<CacheDumpReader> reader;
+  IOStatus io_s = NewFromFileCacheDumpReader(immutable_db_options_.fs,
+                                             file_options_, dump_file, &reader);
+  size_t num_restored = 0;
+  if (io_s.ok()) {
+    CacheDumpOptions dump_options;
+    dump_options.clock = immutable_db_options_.clock;
+    // Only used when restoring to a secondary cache
+    BlockBasedTableOptions unused_table_options;
+    CacheDumpedLoaderImpl loader(dump_options, unused_table_options,
+                                 /*secondary_cache=*/nullptr,
+                                 std::move(reader));
+    io_s = loader.RestoreCacheEntriesToPrimaryCache(
+        targets, immutable_db_options_.max_file_opening_threads,
+        &num_restored);
+  }
+  if (io_s.ok()) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Restored %" ROCKSDB_PRIszt " blocks to block cache from %s",
+                   num_restored, dump_file.c_str());
+  } else {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Failed to restore block cache from %s: %s",
+                   dump_file.c_str(), io_s.ToString().c_str());
+  }
+  TEST_SYNC_POINT_CALLBACK("DBImpl::RestoreBlockCacheFromFile:Done",
+                           &num_restored);
+}
+#endif  // !ROCKSDB_LITE
+
 DBImpl::~DBImpl() {
   // TODO: remove this.
   init_logger_creation_s_.PermitUncheckedError();
@@ -1458,8 +1596,9 @@ Status DBImpl::SyncWAL() {
     InstrumentedMutexLock l(&log_write_mutex_);
     assert(!logs_.empty());
 
-    // This SyncWAL() call only cares about logs up to this number.
-    current_log_number = logfile_number_;
+    // This SyncWAL() call only cares about logs up to this number, the last
+    // stream of the current WAL.
+    current_log_number = logs_.back().number;
 
     while (logs_.front().number <= current_log_number &&
            logs_.front().IsSyncing()) {
@@ -1565,14 +1704,14 @@ Status DBImpl::UnlockWAL() {
 void DBImpl::MarkLogsSynced(uint64_t up_to, bool synced_dir,
                             VersionEdit* synced_wals) {
   log_write_mutex_.AssertHeld();
-  if (synced_dir && logfile_number_ == up_to) {
+  if (synced_dir && logs_.back().number == up_to) {
     log_dir_synced_ = true;
   }
   for (auto it = logs_.begin(); it != logs_.end() && it->number <= up_to;) {
     auto& wal = *it;
     assert(wal.IsSyncing());
 
-    if (wal.number < logs_.back().number) {
+    if (wal.number < logfile_number_) {
       // Inactive WAL
       if (immutable_db_options_.track_and_verify_wals_in_manifest &&
           wal.GetPreSyncSize() > 0) {
@@ -1588,8 +1727,8 @@ void DBImpl::MarkLogsSynced(uint64_t up_to, bool synced_dir,
         ++it;
       }
     } else {
-      assert(wal.number == logs_.back().number);
-      // Active WAL
+      assert(wal.number >= logfile_number_);
+      // Active WAL, or one of its streams
       wal.FinishSync();
       ++it;
     }
@@ -1615,6 +1754,25 @@ void DBImpl::SetLastPublishedSequence(SequenceNumber seq) {
   versions_->SetLastPublishedSequence(seq);
 }
 
+KeyWriteTracker* DBImpl::GetOrCreateKeyWriteTracker() {
+  KeyWriteTracker* tracker = key_write_tracker();
+  if (tracker != nullptr) {
+    return tracker;
+  }
+  InstrumentedMutexLock l(&mutex_);
+  if (owned_key_write_tracker_ == nullptr) {
+    owned_key_write_tracker_.reset(new KeyWriteTracker());
+    // Writes that were sequenced before the tracker existed may not be
+    // recorded per key, so treat all keys as written at the last allocated
+    // sequence number.
+    owned_key_write_tracker_->RecordWriteToAllKeys(
+        versions_->LastAllocatedSequence());
+    key_write_tracker_.store(owned_key_write_tracker_.get(),
+                             std::memory_order_release);
+  }
+  return owned_key_write_tracker_.get();
+}
+
 Status DBImpl::GetFullHistoryTsLow(ColumnFamilyHandle* column_family,
                                    std::string* ts_low) {
   if (ts_low == nullptr) {
@@ -4122,6 +4280,10 @@ Status DBImpl::GetUpdatesSince(
         "This API is not yet compatible with write-prepared/write-unprepared "
         "transactions");
   }
+  if (immutable_db_options_.num_wal_streams > 1) {
+    return Status::NotSupported(
+        "This API is not yet compatible with num_wal_streams > 1");
+  }
   if (seq > versions_->LastSequence()) {
     return Status::NotFound("Requested sequence not yet written in the db");
   }
@@ -4210,6 +4372,12 @@ Status DBImpl::DeleteFile(std::string name) {
     status = versions_->LogAndApply(cfd, *cfd->GetLatestMutableCFOptions(),
                                     &edit, &mutex_, directories_.GetDbDir());
     if (status.ok()) {
+      KeyWriteTracker* tracker = key_write_tracker();
+      if (tracker != nullptr) {
+        // Deleting files consumes no sequence number, but may drop values
+        // written at up to the last sequence number.
+        tracker->RecordWriteToAllKeys(versions_->LastSequence() + 1);
+      }
       InstallSuperVersionAndScheduleWork(cfd,
                                          &job_context.superversion_contexts[0],
                                          *cfd->GetLatestMutableCFOptions());
@@ -4297,6 +4465,12 @@ Status DBImpl::DeleteFilesInRanges(ColumnFamilyHandle* column_family,
     status = versions_->LogAndApply(cfd, *cfd->GetLatestMutableCFOptions(),
                                     &edit, &mutex_, directories_.GetDbDir());
     if (status.ok()) {
+      KeyWriteTracker* tracker = key_write_tracker();
+      if (tracker != nullptr) {
+        // Deleting files consumes no sequence number, but may drop values
+        // written at up to the last sequence number.
+        tracker->RecordWriteToAllKeys(versions_->LastSequence() + 1);
+      }
       InstallSuperVersionAndScheduleWork(cfd,
                                          &job_context.superversion_contexts[0],
                                          *cfd->GetLatestMutableCFOptions());
@@ -5322,6 +5496,11 @@ Status DBImpl::IngestExternalFiles(
         versions_->SetLastPublishedSequence(last_seqno + consumed_seqno_count);
         versions_->SetLastSequence(last_seqno + consumed_seqno_count);
       }
+      KeyWriteTracker* tracker = key_write_tracker();
+      if (status.ok() && tracker != nullptr) {
+        // Ingested keys are not tracked individually.
+        tracker->RecordWriteToAllKeys(versions_->LastSequence());
+      }
     }
 
     if (status.ok()) {
@@ -29,6 +29,7 @@
 #include "db/flush_scheduler.h"
 #include "db/import_column_family_job.h"
 #include "db/internal_stats.h"
+#include "db/key_write_tracker.h"
 #include "db/log_writer.h"
 #include "db/logs_with_prep_tracker.h"
 #include "db/memtable_list.h"
@@ -43,6 +44,7 @@
 #include "db/trim_history_scheduler.h"
 #include "db/version_edit.h"
 #include "db/wal_manager.h"
+#include "db/write_batch_internal.h"
 #include "db/write_controller.h"
 #include "db/write_thread.h"
 #include "logging/event_logger.h"
@@ -82,6 +84,7 @@ class Version;
 class VersionEdit;
 class VersionSet;
 class WriteCallback;
+struct CacheDumpRestoreTarget;
 struct JobContext;
 struct ExternalSstFileInfo;
 struct MemTableInfo;
@@ -1240,6 +1243,13 @@ class DBImpl : public DB {
 
   bool seq_per_batch() const { return seq_per_batch_; }
 
+  // Tracker of the latest write per key used by read-your-writes sessions.
+  // nullptr until GetOrCreateKeyWriteTracker() is first called.
+  KeyWriteTracker* key_write_tracker() const {
+    return key_write_tracker_.load(std::memory_order_acquire);
+  }
+  KeyWriteTracker* GetOrCreateKeyWriteTracker();
+
  protected:
   const std::string dbname_;
   // TODO(peterd): unify with VersionSet::db_id_
@@ -1267,6 +1277,16 @@ class DBImpl : public DB {
   // constant false canceled flag, used when the compaction is not manual
   const std::atomic<bool> kManualCompactionCanceledFalse_{false};
 
+  // A running automatic compaction into the bottommost level that
+  // MaybePreemptCompactionForStall() may cancel through `preempted`, which is
+  // used as the canceled flag of its CompactionJob.
+  struct PreemptibleCompaction {
+    std::atomic<bool> preempted{false};
+    uint64_t start_micros = 0;
+  };
+  // Protected by mutex_
+  std::vector<PreemptibleCompaction*> preemptible_compactions_;
+
   // State below is protected by mutex_
   // With two_write_queues enabled, some of the variables that accessed during
   // WriteToWAL need different synchronization: log_empty_, alive_log_files_,
@@ -1395,6 +1415,23 @@ class DBImpl : public DB {
       ColumnFamilyData* cfd, const ExternalSstFileIngestionJob& ingestion_job);
 
   virtual Status FlushForGetLiveFiles();
+
+  // Maps the cache key common prefix of each live table file with a unique id
+  // to the block cache and table options of its column family, for the
+  // column families using block-based tables with a block cache.
+  // REQUIRES: mutex_ held
+  void GetBlockCacheDumpTargets(
+      std::unordered_map<std::string, CacheDumpRestoreTarget>* targets);
+
+  // Writes the blocks of live table files in the block cache to
+  // DBOptions::block_cache_dump_file.
+  // REQUIRES: mutex_ held, it is released while writing
+  void DumpBlockCacheToFile();
+
+  // Inserts the blocks written by DumpBlockCacheToFile() back into the block
+  // cache, skipping those of files that are no longer live.
+  // REQUIRES: mutex_ not held
+  void RestoreBlockCacheFromFile();
 #endif  // !ROCKSDB_LITE
 
   void NewThreadStatusCfInfo(ColumnFamilyData* cfd) const;
@@ -1542,6 +1579,7 @@ class DBImpl : public DB {
   friend class WriteBatchWithIndex;
   friend class WriteUnpreparedTxnDB;
   friend class WriteUnpreparedTxn;
+  friend class ReadYourWritesSessionImpl;
 
 #ifndef ROCKSDB_LITE
   friend class ForwardIterator;
@@ -1647,6 +1685,9 @@ class DBImpl : public DB {
     bool need_log_dir_sync = false;
     log::Writer* writer = nullptr;
     LogFileNumberSize* log_file_number_size = nullptr;
+    // Writers and files of the streams of the current WAL, in stream order,
+    // when DBOptions::num_wal_streams > 1
+    autovector<std::pair<log::Writer*, LogFileNumberSize*>> streams;
   };
 
   // PurgeFileInfo is a structure to hold information of files to be deleted in
@@ -1975,10 +2016,13 @@ class DBImpl : public DB {
   // rate_limiter_priority is used to charge `DBOptions::rate_limiter`
   // for automatic WAL flush (`Options::manual_wal_flush` == false)
   // associated with this WriteToWAL
+  // If `compressed_log_entry` is not null, it holds the contents of
+  // `merged_batch` already compressed for `log_writer`.
   IOStatus WriteToWAL(const WriteBatch& merged_batch, log::Writer* log_writer,
                       uint64_t* log_used, uint64_t* log_size,
                       Env::IOPriority rate_limiter_priority,
-                      LogFileNumberSize& log_file_number_size);
+                      LogFileNumberSize& log_file_number_size,
+                      const std::string* compressed_log_entry = nullptr);
 
   IOStatus WriteToWAL(const WriteThread::WriteGroup& write_group,
                       log::Writer* log_writer, uint64_t* log_used,
@@ -1986,6 +2030,41 @@ class DBImpl : public DB {
                       SequenceNumber sequence,
                       LogFileNumberSize& log_file_number_size);
 
+  // Like WriteToWAL(write_group, ...), for a WAL written as several streams
+  // (DBOptions::num_wal_streams > 1). Consecutive batches to the same stream
+  // are written as one record of it. A batch to several streams is written to
+  // the first one, and an empty batch with the same sequence number to each
+  // of the others, so that recovery can tell whether it was lost.
+  IOStatus WriteToWALStreams(const WriteThread::WriteGroup& write_group,
+                             const LogContext& log_context, uint64_t* log_used,
+                             SequenceNumber sequence);
+
+  // Syncs the live WALs, and the WAL directory if `need_log_dir_sync`, after
+  // the write group leader has written to the WAL.
+  IOStatus SyncWALsOfWriteGroup(bool need_log_dir_sync);
+
+  // With WAL compression, compresses the contents of a large enough batch
+  // into w->compressed_wal_frame on the writing thread, before it joins a
+  // write group, so that the group leader only has to copy the frame into
+  // the WAL record. Skipped when the write queue is empty, as the writer will
+  // then most likely lead its group and compress its batch with the header.
+  void MaybeCompressWALFrame(WriteThread::Writer* w);
+
+  // With column families with inplace_update_support, whose in-place updates
+  // must be applied in sequence order, checks whether the batches of
+  // `write_group` can be inserted into memtables concurrently. The writers of
+  // the batches that write a key of such a column family that another batch
+  // of the group writes too are marked insert_by_leader, to be inserted
+  // serially by InsertByLeader() before the parallel memtable writers are
+  // launched. Returns false if the whole group must be inserted serially.
+  // Called by the leader of the group.
+  bool CheckInplaceUpdateConflicts(WriteThread::WriteGroup& write_group);
+
+  // Inserts the batches of the writers of `write_group` marked
+  // insert_by_leader into memtables, in sequence order.
+  void InsertByLeader(WriteThread::WriteGroup& write_group,
+                      const WriteOptions& write_options);
+
   IOStatus ConcurrentWriteToWAL(const WriteThread::WriteGroup& write_group,
                                 uint64_t* log_used,
                                 SequenceNumber* last_sequence, size_t seq_inc);
@@ -2101,6 +2180,16 @@ class DBImpl : public DB {
   ColumnFamilyData* PickCompactionFromQueue(
       std::unique_ptr<TaskLimiterToken>* token, LogBuffer* log_buffer);
 
+  // With DBOptions::compaction_scheduling_by_stall_deadline, orders
+  // compaction_queue_ by the estimated time until each column family stalls
+  // writes, earliest first.
+  void SortCompactionQueueByStallDeadline();
+
+  // Cancels a running bottommost compaction if a column family waiting in
+  // compaction_queue_ is about to stall writes. See
+  // DBOptions::bottommost_compaction_preemption_micros.
+  void MaybePreemptCompactionForStall();
+
   // helper function to call after some of the logs_ were synced
   void MarkLogsSynced(uint64_t up_to, bool synced_dir, VersionEdit* edit);
   Status ApplyWALToManifest(VersionEdit* edit);
@@ -2179,6 +2268,19 @@ class DBImpl : public DB {
   IOStatus CreateWAL(uint64_t log_file_num, uint64_t recycle_log_number,
                      size_t preallocate_block_size, log::Writer** new_log);
 
+  // Creates the logs of a new WAL, one per stream (DBOptions::num_wal_streams)
+  // numbered from `log_file_num`, and appends them to `*new_logs`. Creates no
+  // log on error. `first_sequence` is the sequence number expected for the
+  // first batch written to the WAL.
+  IOStatus CreateWALs(uint64_t log_file_num, uint64_t recycle_log_number,
+                      size_t preallocate_block_size,
+                      SequenceNumber first_sequence,
+                      autovector<log::Writer*>* new_logs);
+
+  // Upper bound of DBOptions::num_wal_streams, as the streams a batch writes
+  // to are kept as a 64-bit mask
+  static constexpr int kMaxWalStreams = 64;
+
   // Validate self-consistency of DB options
   static Status ValidateOptions(const DBOptions& db_options);
   // Validate self-consistency of DB options and its consistency with cf options
@@ -2305,7 +2407,15 @@ class DBImpl : public DB {
   // must be under either mutex_ or log_write_mutex_. Since after ::Open,
   // logfile_number_ is currently updated only in write_thread_, it can be read
   // from the same write_thread_ without any locks.
+  // With DBOptions::num_wal_streams > 1, the number of the first stream of the
+  // current WAL, whose other streams have the next numbers.
   uint64_t logfile_number_;
+  // With DBOptions::num_wal_streams > 1, the sequence number that follows the
+  // batches written to the current WAL. A batch with another one is preceded
+  // by a gap record, so that recovery can tell the sequence numbers consumed
+  // without being logged from lost batches. Only accessed by the write thread
+  // leader, or while the current WAL is switched.
+  SequenceNumber wal_streams_next_sequence_ = 0;
   // Log files that we can recycle. Must be protected by db mutex_.
   std::deque<uint64_t> log_recycle_files_;
   // Protected by log_write_mutex_.
@@ -2440,6 +2550,9 @@ class DBImpl : public DB {
 
   WriteThread write_thread_;
   WriteBatch tmp_batch_;
+  // Keys of the write group checked by CheckInplaceUpdateConflicts(), only
+  // kept to reuse their storage across groups
+  std::vector<WriteBatchInternal::InplaceUpdateKey> inplace_update_keys_;
   // The write thread when the writers have no memtable write. This will be used
   // in 2PC to batch the prepares separately from the serial commit.
   WriteThread nonmem_write_thread_;
@@ -2669,6 +2782,12 @@ class DBImpl : public DB {
   // seqno_time_mapping_ stores the sequence number to time mapping, it's not
   // thread safe, both read and write need db mutex hold.
   SeqnoToTimeMapping seqno_time_mapping_;
+
+  // Created under mutex_ by GetOrCreateKeyWriteTracker() and never changed
+  // afterwards. key_write_tracker_ is the lock-free view of
+  // owned_key_write_tracker_.
+  std::unique_ptr<KeyWriteTracker> owned_key_write_tracker_;
+  std::atomic<KeyWriteTracker*> key_write_tracker_;
 };
 
 class GetWithTimestampReadCallback : public ReadCallback {
@@ -2533,6 +2533,70 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
                    &DBImpl::UnscheduleCompactionCallback);
   }
+
+  if (unscheduled_compactions_ > 0 &&
+      immutable_db_options_.compaction_scheduling_by_stall_deadline &&
+      immutable_db_options_.bottommost_compaction_preemption_micros > 0) {
+    MaybePreemptCompactionForStall();
+  }
+}
+
+void DBImpl::SortCompactionQueueByStallDeadline() {
+  mutex_.AssertHeld();
+  if (compaction_queue_.size() < 2) {
+    return;
+  }
+  const uint64_t now = immutable_db_options_.clock->NowMicros();
+  std::vector<std::pair<uint64_t, ColumnFamilyData*>> by_deadline;
+  by_deadline.reserve(compaction_queue_.size());
+  for (ColumnFamilyData* cfd : compaction_queue_) {
+    by_deadline.emplace_back(cfd->GetMicrosUntilL0Stall(now), cfd);
+  }
+  // Column families without a deadline keep their order of arrival
+  std::stable_sort(by_deadline.begin(), by_deadline.end(),
+                   [](const std::pair<uint64_t, ColumnFamilyData*>& a,
+                      const std::pair<uint64_t, ColumnFamilyData*>& b) {
+                     return a.first < b.first;
+                   });
+  for (size_t i = 0; i < by_deadline.size(); i++) {
+    compaction_queue_[i] = by_deadline[i].second;
+  }
+}
+
+void DBImpl::MaybePreemptCompactionForStall() {
+  mutex_.AssertHeld();
+  if (preemptible_compactions_.empty()) {
+    return;
+  }
+  PreemptibleCompaction* latest = nullptr;
+  for (PreemptibleCompaction* pc : preemptible_compactions_) {
+    if (pc->preempted.load(std::memory_order_relaxed)) {
+      // Wait for that one to give up its thread first
+      return;
+    }
+    if (latest == nullptr || pc->start_micros > latest->start_micros) {
+      latest = pc;
+    }
+  }
+  const uint64_t now = immutable_db_options_.clock->NowMicros();
+  ColumnFamilyData* stalling_cfd = nullptr;
+  for (ColumnFamilyData* cfd : compaction_queue_) {
+    if (cfd->GetMicrosUntilL0Stall(now) <
+        immutable_db_options_.bottommost_compaction_preemption_micros) {
+      stalling_cfd = cfd;
+      break;
+    }
+  }
+  if (stalling_cfd == nullptr) {
+    return;
+  }
+  // Cancel the one that started last, as it loses the least work
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "[%s] Canceling a bottommost compaction to free a thread for "
+                 "the compaction of a column family about to stall writes",
+                 stalling_cfd->GetName().c_str());
+  latest->preempted.store(true, std::memory_order_release);
+  TEST_SYNC_POINT("DBImpl::MaybePreemptCompactionForStall:Preempt");
 }
 
 DBImpl::BGJobLimits DBImpl::GetBGJobLimits() const {
@@ -2605,6 +2669,9 @@ ColumnFamilyData* DBImpl::PickCompactionFromQueue(
     std::unique_ptr<TaskLimiterToken>* token, LogBuffer* log_buffer) {
   assert(!compaction_queue_.empty());
   assert(*token == nullptr);
+  if (immutable_db_options_.compaction_scheduling_by_stall_deadline) {
+    SortCompactionQueueByStallDeadline();
+  }
   autovector<ColumnFamilyData*> throttled_candidates;
   ColumnFamilyData* cfd = nullptr;
   while (!compaction_queue_.empty()) {
@@ -2975,11 +3042,15 @@ void DBImpl::BackgroundCallCompaction(PrepickedCompaction* prepicked_compaction,
       immutable_db_options_.clock->SleepForMicroseconds(1000000);
       mutex_.Lock();
     } else if (s.IsManualCompactionPaused()) {
-      assert(prepicked_compaction);
-      ManualCompactionState* m = prepicked_compaction->manual_compaction_state;
-      assert(m);
-      ROCKS_LOG_BUFFER(&log_buffer, "[%s] [JOB %d] Manual compaction paused",
-                       m->cfd->GetName().c_str(), job_context.job_id);
+      // An automatic compaction preempted by MaybePreemptCompactionForStall()
+      // has no manual compaction state, and has been queued again already.
+      if (prepicked_compaction != nullptr &&
+          prepicked_compaction->manual_compaction_state != nullptr) {
+        ManualCompactionState* m =
+            prepicked_compaction->manual_compaction_state;
+        ROCKS_LOG_BUFFER(&log_buffer, "[%s] [JOB %d] Manual compaction paused",
+                         m->cfd->GetName().c_str(), job_context.job_id);
+      }
     }
 
     ReleaseFileNumberFromPendingOutputs(pending_outputs_inserted_elem);
@@ -3065,6 +3136,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
   TEST_SYNC_POINT("DBImpl::BackgroundCompaction:Start");
 
   bool is_manual = (manual_compaction != nullptr);
+  bool compaction_preempted = false;
   std::unique_ptr<Compaction> c;
   if (prepicked_compaction != nullptr &&
       prepicked_compaction->compaction != nullptr) {
@@ -3336,9 +3408,15 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
       int start_level = c->start_level();
       if (start_level > 0) {
         auto vstorage = c->input_version()->storage_info();
-        c->edit()->AddCompactCursor(
-            start_level,
-            vstorage->GetNextCompactCursor(start_level, c->num_input_files(0)));
+        if (c->round_robin_cursor() < 0) {
+          c->edit()->AddCompactCursor(
+              start_level, vstorage->GetNextCompactCursor(
+                               start_level, c->num_input_files(0)));
+        } else {
+          c->edit()->AddCompactCursor(
+              start_level, static_cast<uint32_t>(c->round_robin_cursor()),
+              vstorage->GetNextCompactCursor(start_level, *c->inputs(0)));
+        }
       }
     }
     status = versions_->LogAndApply(c->column_family_data(),
@@ -3409,6 +3487,17 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
                        &earliest_write_conflict_snapshot, &snapshot_checker);
     assert(is_snapshot_supported_ || snapshots_.empty());
 
+    PreemptibleCompaction preemptible;
+    const bool is_preemptible =
+        !is_manual && thread_pri == Env::Priority::LOW &&
+        c->bottommost_level() && c->start_level() > 0 &&
+        immutable_db_options_.compaction_scheduling_by_stall_deadline &&
+        immutable_db_options_.bottommost_compaction_preemption_micros > 0;
+    if (is_preemptible) {
+      preemptible.start_micros = immutable_db_options_.clock->NowMicros();
+      preemptible_compactions_.push_back(&preemptible);
+    }
+
     CompactionJob compaction_job(
         job_context->job_id, c.get(), immutable_db_options_,
         mutable_db_options_, file_options_for_compaction_, versions_.get(),
@@ -3421,7 +3510,8 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
         c->mutable_cf_options()->report_bg_io_stats, dbname_,
         &compaction_job_stats, thread_pri, io_tracer_,
         is_manual ? manual_compaction->canceled
-                  : kManualCompactionCanceledFalse_,
+        : is_preemptible ? preemptible.preempted
+                         : kManualCompactionCanceledFalse_,
         db_id_, db_session_id_, c->column_family_data()->GetFullHistoryTsLow(),
         c->trim_ts(), &blob_callback_, &bg_compaction_scheduled_,
         &bg_bottom_compaction_scheduled_);
@@ -3437,6 +3527,14 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     TEST_SYNC_POINT("DBImpl::BackgroundCompaction:NonTrivial:AfterRun");
     mutex_.Lock();
 
+    if (is_preemptible) {
+      preemptible_compactions_.erase(
+          std::find(preemptible_compactions_.begin(),
+                    preemptible_compactions_.end(), &preemptible));
+      compaction_preempted =
+          preemptible.preempted.load(std::memory_order_acquire);
+    }
+
     status = compaction_job.Install(*c->mutable_cf_options());
     io_s = compaction_job.io_status();
     if (status.ok()) {
@@ -3470,6 +3568,16 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
 
     NotifyOnCompactionCompleted(c->column_family_data(), c.get(), status,
                                 compaction_job_stats, job_context->job_id);
+
+    if (compaction_preempted && status.IsManualCompactionPaused()) {
+      // The column family still needs the compaction
+      ColumnFamilyData* cfd = c->column_family_data();
+      cfd->current()->storage_info()->ComputeCompactionScore(
+          *(c->immutable_options()), *(c->mutable_cf_options()));
+      if (!cfd->IsDropped()) {
+        SchedulePendingCompaction(cfd);
+      }
+    }
   }
 
   if (status.ok() || status.IsCompactionTooLarge() ||
@@ -93,7 +93,8 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src,
     }
   }
 
-  if (result.WAL_ttl_seconds > 0 || result.WAL_size_limit_MB > 0) {
+  if (result.WAL_ttl_seconds > 0 || result.WAL_size_limit_MB > 0 ||
+      result.num_wal_streams > 1) {
     result.recycle_log_file_num = false;
   }
 
@@ -292,6 +293,21 @@ Status DBImpl::ValidateOptions(const DBOptions& db_options) {
         "writes in direct IO require writable_file_max_buffer_size > 0");
   }
 
+  if (db_options.num_wal_streams < 1 ||
+      db_options.num_wal_streams > kMaxWalStreams) {
+    return Status::InvalidArgument("num_wal_streams must be in [1, 64]");
+  }
+
+  if (db_options.num_wal_streams > 1 &&
+      (db_options.two_write_queues || db_options.unordered_write ||
+       db_options.enable_pipelined_write || db_options.manual_wal_flush ||
+       db_options.allow_2pc)) {
+    return Status::InvalidArgument(
+        "num_wal_streams > 1 is incompatible with two_write_queues, "
+        "unordered_write, enable_pipelined_write, manual_wal_flush and "
+        "allow_2pc");
+  }
+
   return Status::OK();
 }
 
@@ -953,26 +969,193 @@ bool DBImpl::InvokeWalFilterIfNeededOnWalRecord(uint64_t wal_number,
 #endif  // ROCKSDB_LITE
 }
 
+namespace {
+struct LogReporter : public log::Reader::Reporter {
+  Env* env;
+  Logger* info_log;
+  std::string fname;
+  Status* status;  // nullptr if immutable_db_options_.paranoid_checks==false
+  void Corruption(size_t bytes, const Status& s) override {
+    ROCKS_LOG_WARN(info_log, "%s%s: dropping %d bytes; %s",
+                   (status == nullptr ? "(ignoring error) " : ""),
+                   fname.c_str(), static_cast<int>(bytes),
+                   s.ToString().c_str());
+    if (status != nullptr && status->ok()) {
+      *status = s;
+    }
+  }
+};
+
+// Reads the records of a WAL written as several streams
+// (DBOptions::num_wal_streams) in sequence number order, as if it had been
+// written as one. The streams are known from the stream record of the first
+// log read. The logs of the other streams have the next numbers, and a
+// missing one is read as empty. A WAL written as one stream is read as is.
+// A batch lost from one stream, e.g. with the unsynced tail of its log, while
+// later ones of other streams remain, is reported as a corruption, as the
+// sequence numbers of the batches read must follow each other.
+class WalStreamsReader {
+ public:
+  // Opens the log of a stream into `*reader`. NotFound if there is none.
+  using LogOpener =
+      std::function<IOStatus(uint64_t, std::unique_ptr<log::Reader>*)>;
+
+  WalStreamsReader(std::unique_ptr<log::Reader>&& reader,
+                   log::Reader::Reporter* reporter, LogOpener open_log)
+      : reporter_(reporter), open_log_(std::move(open_log)) {
+    streams_.emplace_back();
+    streams_.back().reader = std::move(reader);
+    last_log_number_ = streams_.back().reader->GetLogNumber();
+  }
+
+  bool ReadRecord(Slice* record, WALRecoveryMode wal_recovery_mode,
+                  uint64_t* record_checksum) {
+    if (!status_.ok()) {
+      return false;
+    }
+    if (!started_) {
+      started_ = true;
+      checksum_ = record_checksum != nullptr;
+      if (!Start(wal_recovery_mode)) {
+        return false;
+      }
+    } else if (last_stream_ < streams_.size()) {
+      ReadStreamRecord(&streams_[last_stream_], wal_recovery_mode);
+    }
+    while (true) {
+      // Next record in (sequence number, stream) order
+      last_stream_ = streams_.size();
+      SequenceNumber sequence = kMaxSequenceNumber;
+      for (size_t i = 0; i < streams_.size(); ++i) {
+        if (streams_[i].has_record &&
+            (last_stream_ == streams_.size() ||
+             Sequence(streams_[i].record) < sequence)) {
+          last_stream_ = i;
+          sequence = Sequence(streams_[i].record);
+        }
+      }
+      if (last_stream_ == streams_.size()) {
+        return false;
+      }
+      Stream& stream = streams_[last_stream_];
+      if (stream.reader->GetWalStream() > 0 &&
+          stream.record.size() >= WriteBatchInternal::kHeader &&
+          DecodeFixed32(stream.record.data() + 8) == 0) {
+        // An empty batch outside of the first stream marks a batch written
+        // to an earlier stream, which must have just been read.
+        if (sequence != last_sequence_) {
+          reporter_->Corruption(
+              stream.record.size(),
+              Status::Corruption("missing batch of several WAL streams"));
+        }
+        ReadStreamRecord(&stream, wal_recovery_mode);
+        continue;
+      }
+      if (streams_[0].reader->GetNumWalStreams() > 1 &&
+          stream.record.size() >= WriteBatchInternal::kHeader) {
+        // Batches are logged in sequence number order, except across a gap
+        // record, which tells where the batches before it ended
+        uint64_t gap_next_sequence = 0;
+        if (stream.reader->ConsumeWalStreamGap(&gap_next_sequence)) {
+          if (gap_next_sequence != next_sequence_) {
+            reporter_->Corruption(
+                stream.record.size(),
+                Status::Corruption("missing batch of several WAL streams"));
+          }
+        } else if (sequence != next_sequence_) {
+          reporter_->Corruption(
+              stream.record.size(),
+              Status::Corruption("missing batch of several WAL streams"));
+        }
+        next_sequence_ =
+            sequence + DecodeFixed32(stream.record.data() + 8 /* count */);
+      }
+      last_sequence_ = sequence;
+      *record = stream.record;
+      if (record_checksum != nullptr) {
+        *record_checksum = stream.record_checksum;
+      }
+      return true;
+    }
+  }
+
+  // Number of the last log of the streams of the WAL. Valid once ReadRecord()
+  // has been called.
+  uint64_t LastLogNumber() const { return last_log_number_; }
+
+  // Error opening the log of a stream
+  const IOStatus& status() const { return status_; }
+
+ private:
+  struct Stream {
+    std::unique_ptr<log::Reader> reader;
+    std::string scratch;
+    Slice record;
+    uint64_t record_checksum = 0;
+    bool has_record = false;
+  };
+
+  // Reads the first record of the first log, then opens the logs of the
+  // other streams. Returns false on error.
+  bool Start(WALRecoveryMode wal_recovery_mode) {
+    ReadStreamRecord(&streams_[0], wal_recovery_mode);
+    const log::Reader& first = *streams_[0].reader;
+    last_log_number_ = first.GetLogNumber() - first.GetWalStream() +
+                       first.GetNumWalStreams() - 1;
+    next_sequence_ = first.GetWalStreamFirstSequence();
+    for (uint64_t number = first.GetLogNumber() + 1;
+         number <= last_log_number_; ++number) {
+      std::unique_ptr<log::Reader> reader;
+      IOStatus io_s = open_log_(number, &reader);
+      if (io_s.IsNotFound() || io_s.IsPathNotFound()) {
+        // Nothing was written to this stream
+        continue;
+      }
+      if (!io_s.ok()) {
+        status_ = io_s;
+        return false;
+      }
+      streams_.emplace_back();
+      streams_.back().reader = std::move(reader);
+      ReadStreamRecord(&streams_.back(), wal_recovery_mode);
+    }
+    return true;
+  }
+
+  void ReadStreamRecord(Stream* stream, WALRecoveryMode wal_recovery_mode) {
+    stream->has_record = stream->reader->ReadRecord(
+        &stream->record, &stream->scratch, wal_recovery_mode,
+        checksum_ ? &stream->record_checksum : nullptr);
+  }
+
+  // Records too small for a batch come first, to be reported by the caller
+  static SequenceNumber Sequence(const Slice& record) {
+    return record.size() < WriteBatchInternal::kHeader
+               ? 0
+               : DecodeFixed64(record.data());
+  }
+
+  log::Reader::Reporter* const reporter_;
+  const LogOpener open_log_;
+  std::vector<Stream> streams_;
+  bool started_ = false;
+  bool checksum_ = false;
+  uint64_t last_log_number_;
+  // Stream of the last record returned
+  size_t last_stream_ = 0;
+  // Sequence number of the last record returned
+  SequenceNumber last_sequence_ = kMaxSequenceNumber;
+  // Sequence number of the batch expected next, unless it follows a gap record
+  SequenceNumber next_sequence_ = 0;
+  IOStatus status_;
+};
+}  // namespace
+
 // REQUIRES: wal_numbers are sorted in ascending order
 Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
                                SequenceNumber* next_sequence, bool read_only,
                                bool* corrupted_wal_found,
                                RecoveryContext* recovery_ctx) {
-  struct LogReporter : public log::Reader::Reporter {
-    Env* env;
-    Logger* info_log;
-    const char* fname;
-    Status* status;  // nullptr if immutable_db_options_.paranoid_checks==false
-    void Corruption(size_t bytes, const Status& s) override {
-      ROCKS_LOG_WARN(info_log, "%s%s: dropping %d bytes; %s",
-                     (status == nullptr ? "(ignoring error) " : ""), fname,
-                     static_cast<int>(bytes), s.ToString().c_str());
-      if (status != nullptr && status->ok()) {
-        *status = s;
-      }
-    }
-  };
-
   mutex_.AssertHeld();
   Status status;
   std::unordered_map<int, VersionEdit> version_edits;
@@ -1008,7 +1191,13 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     min_wal_number =
         std::max(min_wal_number, versions_->MinLogNumberWithUnflushedData());
   }
+  // Last log of the streams of the WAL read last
+  uint64_t last_stream_wal_number = 0;
   for (auto wal_number : wal_numbers) {
+    if (wal_number <= last_stream_wal_number) {
+      // Already read as a stream of a previous log
+      continue;
+    }
     if (wal_number < min_wal_number) {
       ROCKS_LOG_INFO(immutable_db_options_.info_log,
                      "Skipping log #%" PRIu64
@@ -1065,7 +1254,7 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     LogReporter reporter;
     reporter.env = env_;
     reporter.info_log = immutable_db_options_.info_log.get();
-    reporter.fname = fname.c_str();
+    reporter.fname = fname;
     if (!immutable_db_options_.paranoid_checks ||
         immutable_db_options_.wal_recovery_mode ==
             WALRecoveryMode::kSkipAnyCorruptedRecords) {
@@ -1073,24 +1262,51 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     } else {
       reporter.status = &status;
     }
+    // Reporters of the logs of the other streams, if the WAL has several
+    std::deque<LogReporter> stream_reporters;
+    auto open_stream_log =
+        [&](uint64_t stream_wal_number,
+            std::unique_ptr<log::Reader>* stream_reader) -> IOStatus {
+      std::string stream_fname =
+          LogFileName(immutable_db_options_.GetWalDir(), stream_wal_number);
+      std::unique_ptr<FSSequentialFile> file;
+      IOStatus io_s = fs_->NewSequentialFile(
+          stream_fname, fs_->OptimizeForLogRead(file_options_), &file,
+          nullptr);
+      if (!io_s.ok()) {
+        return io_s;
+      }
+      versions_->MarkFileNumberUsed(stream_wal_number);
+      stream_reporters.push_back(reporter);
+      stream_reporters.back().fname = stream_fname;
+      stream_reader->reset(new log::ReadaheadReader(
+          immutable_db_options_.info_log,
+          std::unique_ptr<SequentialFileReader>(new SequentialFileReader(
+              std::move(file), stream_fname,
+              immutable_db_options_.log_readahead_size, io_tracer_)),
+          &stream_reporters.back(), true /*checksum*/, stream_wal_number));
+      return io_s;
+    };
     // We intentially make log::Reader do checksumming even if
     // paranoid_checks==false so that corruptions cause entire commits
     // to be skipped instead of propagating bad information (like overly
-    // large sequence numbers).
-    log::Reader reader(immutable_db_options_.info_log, std::move(file_reader),
-                       &reporter, true /*checksum*/, wal_number);
+    // large sequence numbers). Records of a compressed WAL are decompressed
+    // ahead on another thread while the previous ones are being inserted.
+    WalStreamsReader reader(
+        std::unique_ptr<log::Reader>(new log::ReadaheadReader(
+            immutable_db_options_.info_log, std::move(file_reader), &reporter,
+            true /*checksum*/, wal_number)),
+        &reporter, open_stream_log);
 
     // Determine if we should tolerate incomplete records at the tail end of the
     // Read all the records and add to a memtable
-    std::string scratch;
     Slice record;
 
     TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:BeforeReadWal",
                              /*arg=*/nullptr);
     uint64_t record_checksum;
     while (!stop_replay_by_wal_filter &&
-           reader.ReadRecord(&record, &scratch,
-                             immutable_db_options_.wal_recovery_mode,
+           reader.ReadRecord(&record, immutable_db_options_.wal_recovery_mode,
                              &record_checksum) &&
            status.ok()) {
       if (record.size() < WriteBatchInternal::kHeader) {
@@ -1189,6 +1405,12 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       }
     }
 
+    last_stream_wal_number = reader.LastLogNumber();
+    if (status.ok()) {
+      // Failure to open the log of a stream
+      status = reader.status();
+    }
+
     if (!status.ok()) {
       if (status.IsNotSupported()) {
         // We should not treat NotSupported as corruption. It is rather a clear
@@ -1753,6 +1975,35 @@ IOStatus DBImpl::CreateWAL(uint64_t log_file_num, uint64_t recycle_log_number,
   return io_s;
 }
 
+IOStatus DBImpl::CreateWALs(uint64_t log_file_num, uint64_t recycle_log_number,
+                            size_t preallocate_block_size,
+                            SequenceNumber first_sequence,
+                            autovector<log::Writer*>* new_logs) {
+  assert(new_logs != nullptr && new_logs->empty());
+  const uint32_t num_streams =
+      static_cast<uint32_t>(immutable_db_options_.num_wal_streams);
+  assert(num_streams == 1 || recycle_log_number == 0);
+  IOStatus io_s;
+  for (uint32_t stream = 0; stream < num_streams && io_s.ok(); ++stream) {
+    log::Writer* new_log = nullptr;
+    io_s = CreateWAL(log_file_num + stream, recycle_log_number,
+                     preallocate_block_size, &new_log);
+    if (new_log != nullptr) {
+      new_logs->push_back(new_log);
+    }
+    if (io_s.ok() && num_streams > 1) {
+      io_s = new_log->AddWalStreamRecord(stream, num_streams, first_sequence);
+    }
+  }
+  if (!io_s.ok()) {
+    for (log::Writer* new_log : *new_logs) {
+      delete new_log;
+    }
+    new_logs->clear();
+  }
+  return io_s;
+}
+
 Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
                     const std::vector<ColumnFamilyDescriptor>& column_families,
                     std::vector<ColumnFamilyHandle*>* handles, DB** dbptr,
@@ -1826,23 +2077,35 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
   s = impl->Recover(column_families, false, false, false, &recovered_seq,
                     &recovery_ctx);
   if (s.ok()) {
-    uint64_t new_log_number = impl->versions_->NewFileNumber();
-    log::Writer* new_log = nullptr;
+    uint64_t new_log_number = impl->versions_->FetchAddFileNumber(
+        impl->immutable_db_options_.num_wal_streams);
+    autovector<log::Writer*> new_logs;
     const size_t preallocate_block_size =
         impl->GetWalPreallocateBlockSize(max_write_buffer_size);
-    s = impl->CreateWAL(new_log_number, 0 /*recycle_log_number*/,
-                        preallocate_block_size, &new_log);
+    // The dummy entry written below comes first
+    const SequenceNumber wal_first_sequence =
+        recovered_seq != kMaxSequenceNumber
+            ? recovered_seq
+            : impl->versions_->LastSequence() + 1;
+    s = impl->CreateWALs(new_log_number, 0 /*recycle_log_number*/,
+                         preallocate_block_size, wal_first_sequence,
+                         &new_logs);
     if (s.ok()) {
       InstrumentedMutexLock wl(&impl->log_write_mutex_);
       impl->logfile_number_ = new_log_number;
-      assert(new_log != nullptr);
+      impl->wal_streams_next_sequence_ = wal_first_sequence;
+      assert(!new_logs.empty());
       assert(impl->logs_.empty());
-      impl->logs_.emplace_back(new_log_number, new_log);
+      for (log::Writer* new_log : new_logs) {
+        impl->logs_.emplace_back(new_log->get_log_number(), new_log);
+      }
     }
 
     if (s.ok()) {
-      impl->alive_log_files_.push_back(
-          DBImpl::LogFileNumberSize(impl->logfile_number_));
+      for (const auto& log : impl->logs_) {
+        impl->alive_log_files_.push_back(
+            DBImpl::LogFileNumberSize(log.number));
+      }
       // In WritePrepared there could be gap in sequence numbers. This breaks
       // the trick we use in kPointInTimeRecovery which assumes the first seq in
       // the log right after the corrupted log is one larger than the last seq
@@ -1857,8 +2120,11 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
         WriteBatchInternal::SetSequence(&empty_batch, recovered_seq);
         WriteOptions write_options;
         uint64_t log_used, log_size;
-        log::Writer* log_writer = impl->logs_.back().writer;
-        LogFileNumberSize& log_file_number_size = impl->alive_log_files_.back();
+        // With several WAL streams, the entry goes to the first one
+        log::Writer* log_writer = impl->logs_.front().writer;
+        LogFileNumberSize& log_file_number_size =
+            impl->alive_log_files_[impl->alive_log_files_.size() -
+                                   impl->logs_.size()];
 
         assert(log_writer->get_log_number() == log_file_number_size.number);
         impl->mutex_.AssertHeld();
@@ -1975,6 +2241,10 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
   impl->mutex_.Unlock();
 
 #ifndef ROCKSDB_LITE
+  if (s.ok() && !impl->immutable_db_options_.block_cache_dump_file.empty()) {
+    impl->RestoreBlockCacheFromFile();
+  }
+
   auto sfm = static_cast<SstFileManagerImpl*>(
       impl->immutable_db_options_.sst_file_manager.get());
   if (s.ok() && sfm) {
@@ -6,6 +6,7 @@
 // Copyright (c) 2011 The LevelDB Authors. All rights reserved.
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
+#include <algorithm>
 #include <cinttypes>
 
 #include "db/db_impl/db_impl.h"
@@ -16,6 +17,7 @@
 #include "options/options_helper.h"
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
+#include "util/math.h"
 
 namespace ROCKSDB_NAMESPACE {
 // Convenience methods
@@ -290,11 +292,16 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
                         post_memtable_callback);
   StopWatch write_sw(immutable_db_options_.clock, stats_, DB_WRITE);
 
+  if (immutable_db_options_.num_wal_streams > 1 && !w.disable_wal) {
+    w.wal_streams = WriteBatchInternal::GetWalStreams(
+        my_batch, static_cast<uint32_t>(immutable_db_options_.num_wal_streams));
+  }
+  MaybeCompressWALFrame(&w);
   write_thread_.JoinBatchGroup(&w);
   if (w.state == WriteThread::STATE_PARALLEL_MEMTABLE_WRITER) {
     // we are a non-leader in a parallel group
 
-    if (w.ShouldWriteToMemtable()) {
+    if (w.ShouldWriteToMemtable() && !w.insert_by_leader) {
       PERF_TIMER_STOP(write_pre_and_post_process_time);
       PERF_TIMER_GUARD(write_memtable_time);
 
@@ -398,15 +405,17 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     }
     // Rules for when we can update the memtable concurrently
     // 1. supported by memtable
-    // 2. Puts are not okay if inplace_update_support
+    // 2. Keys of column families with inplace_update_support written by more
+    //    than one batch of the group are updated in sequence order
     // 3. Merges are not okay
     //
-    // Rules 1..2 are enforced by checking the options
-    // during startup (CheckConcurrentWritesSupported), so if
-    // options.allow_concurrent_memtable_write is true then they can be
-    // assumed to be true.  Rule 3 is checked for each batch.  We could
-    // relax rules 2 if we could prevent write batches from referring
-    // more than once to a particular key.
+    // Rule 1 is enforced by checking the options during startup
+    // (CheckConcurrentWritesSupported), so if
+    // options.allow_concurrent_memtable_write is true then it can be assumed
+    // to be true.  Rule 3 is checked for each batch.  Rule 2 is enforced by
+    // CheckInplaceUpdateConflicts(), as in-place updates rewrite the newest
+    // entry of a key: the batches sharing such a key are inserted serially by
+    // the leader, before the others are inserted concurrently.
     bool parallel = immutable_db_options_.allow_concurrent_memtable_write &&
                     write_group.size > 1;
     size_t total_count = 0;
@@ -428,6 +437,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         }
       }
     }
+    if (parallel) {
+      parallel = CheckInplaceUpdateConflicts(write_group);
+    }
     // Note about seq_per_batch_: either disableWAL is set for the entire write
     // group or not. In either case we inc seq for each write batch with no
     // failed callback. This means that there could be a batch with
@@ -471,10 +483,15 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         LogFileNumberSize& log_file_number_size =
             *(log_context.log_file_number_size);
         PERF_TIMER_GUARD(write_wal_time);
-        io_s =
-            WriteToWAL(write_group, log_context.writer, log_used,
-                       log_context.need_log_sync, log_context.need_log_dir_sync,
-                       last_sequence + 1, log_file_number_size);
+        if (immutable_db_options_.num_wal_streams > 1) {
+          io_s = WriteToWALStreams(write_group, log_context, log_used,
+                                   last_sequence + 1);
+        } else {
+          io_s = WriteToWAL(write_group, log_context.writer, log_used,
+                            log_context.need_log_sync,
+                            log_context.need_log_dir_sync, last_sequence + 1,
+                            log_file_number_size);
+        }
       }
     } else {
       if (status.ok() && !write_options.disableWAL) {
@@ -537,12 +554,13 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
             batch_per_txn_);
       } else {
         write_group.last_sequence = last_sequence;
+        InsertByLeader(write_group, write_options);
         write_thread_.LaunchParallelMemTableWriters(&write_group);
         in_parallel_group = true;
 
         // Each parallel follower is doing each own writes. The leader should
         // also do its own.
-        if (w.ShouldWriteToMemtable()) {
+        if (w.ShouldWriteToMemtable() && !w.insert_by_leader) {
           ColumnFamilyMemTablesImpl column_family_memtables(
               versions_->GetColumnFamilySet());
           assert(w.sequence == current_sequence);
@@ -580,10 +598,10 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     VersionEdit synced_wals;
     log_write_mutex_.Lock();
     if (status.ok()) {
-      MarkLogsSynced(logfile_number_, log_context.need_log_dir_sync,
+      MarkLogsSynced(logs_.back().number, log_context.need_log_dir_sync,
                      &synced_wals);
     } else {
-      MarkLogsNotSynced(logfile_number_);
+      MarkLogsNotSynced(logs_.back().number);
     }
     log_write_mutex_.Unlock();
     if (status.ok() && synced_wals.IsWalAddition()) {
@@ -646,6 +664,7 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
   WriteThread::Writer w(write_options, my_batch, callback, log_ref,
                         disable_memtable, /*_batch_cnt=*/0,
                         /*_pre_release_callback=*/nullptr);
+  MaybeCompressWALFrame(&w);
   write_thread_.JoinBatchGroup(&w);
   TEST_SYNC_POINT("DBImplWrite::PipelinedWriteImpl:AfterJoinBatchGroup");
   if (w.state == WriteThread::STATE_GROUP_LEADER) {
@@ -764,8 +783,12 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     PERF_TIMER_GUARD(write_memtable_time);
     assert(w.ShouldWriteToMemtable());
     write_thread_.EnterAsMemTableWriter(&w, &memtable_write_group);
-    if (memtable_write_group.size > 1 &&
-        immutable_db_options_.allow_concurrent_memtable_write) {
+    const bool parallel =
+        memtable_write_group.size > 1 &&
+        immutable_db_options_.allow_concurrent_memtable_write &&
+        CheckInplaceUpdateConflicts(memtable_write_group);
+    if (parallel) {
+      InsertByLeader(memtable_write_group, write_options);
       write_thread_.LaunchParallelMemTableWriters(&memtable_write_group);
     } else {
       memtable_write_group.status = WriteBatchInternal::InsertInto(
@@ -783,15 +806,18 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
   }
 
   if (w.state == WriteThread::STATE_PARALLEL_MEMTABLE_WRITER) {
-    assert(w.ShouldWriteToMemtable());
-    ColumnFamilyMemTablesImpl column_family_memtables(
-        versions_->GetColumnFamilySet());
-    w.status = WriteBatchInternal::InsertInto(
-        &w, w.sequence, &column_family_memtables, &flush_scheduler_,
-        &trim_history_scheduler_, write_options.ignore_missing_column_families,
-        0 /*log_number*/, this, true /*concurrent_memtable_writes*/,
-        false /*seq_per_batch*/, 0 /*batch_cnt*/, true /*batch_per_txn*/,
-        write_options.memtable_insert_hint_per_batch);
+    if (!w.insert_by_leader) {
+      assert(w.ShouldWriteToMemtable());
+      ColumnFamilyMemTablesImpl column_family_memtables(
+          versions_->GetColumnFamilySet());
+      w.status = WriteBatchInternal::InsertInto(
+          &w, w.sequence, &column_family_memtables, &flush_scheduler_,
+          &trim_history_scheduler_,
+          write_options.ignore_missing_column_families, 0 /*log_number*/, this,
+          true /*concurrent_memtable_writes*/, false /*seq_per_batch*/,
+          0 /*batch_cnt*/, true /*batch_per_txn*/,
+          write_options.memtable_insert_hint_per_batch);
+    }
     if (write_thread_.CompleteParallelMemTableWriter(&w)) {
       MemTableInsertStatusCheck(w.status);
       versions_->SetLastSequence(w.write_group->last_sequence);
@@ -1090,8 +1116,12 @@ void DBImpl::IOStatusCheck(const IOStatus& io_status) {
     error_handler_.SetBGError(io_status, BackgroundErrorReason::kWriteCallback);
     mutex_.Unlock();
   } else {
-    // Force writable file to be continue writable.
-    logs_.back().writer->file()->reset_seen_error();
+    // Force writable file to be continue writable, for each stream of the
+    // current WAL.
+    for (auto it = logs_.rbegin();
+         it != logs_.rend() && it->number >= logfile_number_; ++it) {
+      it->writer->file()->reset_seen_error();
+    }
   }
 }
 
@@ -1217,6 +1247,19 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
   log_context->need_log_dir_sync =
       log_context->need_log_dir_sync && !log_dir_synced_;
   log_context->log_file_number_size = std::addressof(alive_log_files_.back());
+  const size_t num_streams =
+      static_cast<size_t>(immutable_db_options_.num_wal_streams);
+  if (num_streams > 1) {
+    // The streams of the current WAL are the last logs
+    assert(logs_.size() >= num_streams);
+    assert(alive_log_files_.size() >= num_streams);
+    for (size_t i = 0; i < num_streams; ++i) {
+      log_context->streams.emplace_back(
+          logs_[logs_.size() - num_streams + i].writer,
+          std::addressof(
+              alive_log_files_[alive_log_files_.size() - num_streams + i]));
+    }
+  }
 
   return status;
 }
@@ -1266,13 +1309,184 @@ Status DBImpl::MergeBatch(const WriteThread::WriteGroup& write_group,
   return Status::OK();
 }
 
+namespace {
+// Batches smaller than this are left to the group leader, which compresses
+// them together with their neighbours into one frame for a better ratio.
+constexpr size_t kMinCompressedWALFrameSize = 4096;
+
+// Builds in `*record` the compressed WAL record of `merged_batch` out of the
+// frames precompressed by the writers of `write_group`. Runs of batches
+// without a frame are compressed here, one frame per run. The frame of the
+// first batch is never reused, so that the merged header is compressed along
+// with that batch rather than as a tiny frame of its own.
+// Returns false if there is no frame to reuse or on error, in which case the
+// record should be compressed as a whole by log::Writer::AddRecord().
+bool AssembleCompressedWALRecord(const WriteThread::WriteGroup& write_group,
+                                 const WriteBatch& merged_batch,
+                                 CompressionType compression_type,
+                                 std::string* record) {
+  bool has_frame = false;
+  bool first = true;
+  for (auto* writer : write_group) {
+    if (writer->CallbackFailed()) {
+      continue;
+    }
+    if (!writer->batch->GetWalTerminationPoint().is_cleared()) {
+      // Only a prefix of the batch goes to the WAL
+      return false;
+    }
+    has_frame = has_frame || (!first && !writer->compressed_wal_frame.empty());
+    first = false;
+  }
+  if (!has_frame) {
+    return false;
+  }
+
+  const Slice contents = WriteBatchInternal::Contents(&merged_batch);
+  // Start of the merged contents not compressed yet
+  size_t pending = 0;
+  size_t offset = WriteBatchInternal::kHeader;
+  for (auto* writer : write_group) {
+    if (writer->CallbackFailed()) {
+      continue;
+    }
+    const size_t size =
+        WriteBatchInternal::ByteSize(writer->batch) - WriteBatchInternal::kHeader;
+    if (offset > WriteBatchInternal::kHeader &&
+        !writer->compressed_wal_frame.empty()) {
+      if (offset > pending &&
+          !log::Writer::CompressRecordFrame(
+               compression_type,
+               Slice(contents.data() + pending, offset - pending), record)
+               .ok()) {
+        return false;
+      }
+      record->append(writer->compressed_wal_frame);
+      pending = offset + size;
+    }
+    offset += size;
+  }
+  if (offset != contents.size()) {
+    assert(false);
+    return false;
+  }
+  if (offset > pending &&
+      !log::Writer::CompressRecordFrame(
+           compression_type, Slice(contents.data() + pending, offset - pending),
+           record)
+           .ok()) {
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+bool DBImpl::CheckInplaceUpdateConflicts(WriteThread::WriteGroup& write_group) {
+  ColumnFamilySet* column_family_set = versions_->GetColumnFamilySet();
+  if (column_family_set->NumberOfInplaceUpdateColumnFamilies() == 0) {
+    return true;
+  }
+  // Writers to memtables, indexed by the keys of their batches
+  autovector<WriteThread::Writer*> writers;
+  auto& keys = inplace_update_keys_;
+  keys.clear();
+  for (auto* writer : write_group) {
+    if (!writer->ShouldWriteToMemtable()) {
+      continue;
+    }
+    if (!WriteBatchInternal::CollectInplaceUpdateKeys(
+            writer->batch, column_family_set, writers.size(), &keys)) {
+      return false;
+    }
+    writers.push_back(writer);
+  }
+  // Group the writes of each key, in sequence order
+  std::sort(keys.begin(), keys.end(),
+            [](const WriteBatchInternal::InplaceUpdateKey& a,
+               const WriteBatchInternal::InplaceUpdateKey& b) {
+              if (a.column_family_id != b.column_family_id) {
+                return a.column_family_id < b.column_family_id;
+              }
+              const int cmp = a.key.compare(b.key);
+              return cmp != 0 ? cmp < 0 : a.batch < b.batch;
+            });
+  size_t num_insert_by_leader = 0;
+  for (size_t begin = 0, end = 0; begin < keys.size(); begin = end) {
+    end = begin + 1;
+    while (end < keys.size() &&
+           keys[end].column_family_id == keys[begin].column_family_id &&
+           keys[end].key == keys[begin].key) {
+      ++end;
+    }
+    if (keys[begin].batch == keys[end - 1].batch) {
+      // Only written by one batch
+      continue;
+    }
+    for (size_t i = begin; i < end; ++i) {
+      WriteThread::Writer* writer = writers[keys[i].batch];
+      if (!writer->insert_by_leader) {
+        writer->insert_by_leader = true;
+        ++num_insert_by_leader;
+      }
+    }
+  }
+  keys.clear();
+  if (num_insert_by_leader == writers.size()) {
+    // Nothing left to insert concurrently
+    for (auto* writer : writers) {
+      writer->insert_by_leader = false;
+    }
+    return false;
+  }
+  return true;
+}
+
+void DBImpl::InsertByLeader(WriteThread::WriteGroup& write_group,
+                            const WriteOptions& write_options) {
+  ColumnFamilyMemTablesImpl column_family_memtables(
+      versions_->GetColumnFamilySet());
+  for (auto* writer : write_group) {
+    if (writer->insert_by_leader && writer->ShouldWriteToMemtable()) {
+      writer->status = WriteBatchInternal::InsertInto(
+          writer, writer->sequence, &column_family_memtables, &flush_scheduler_,
+          &trim_history_scheduler_,
+          write_options.ignore_missing_column_families, 0 /*log_number*/, this,
+          true /*concurrent_memtable_writes*/, seq_per_batch_,
+          writer->batch_cnt, batch_per_txn_,
+          write_options.memtable_insert_hint_per_batch);
+    }
+  }
+}
+
+void DBImpl::MaybeCompressWALFrame(WriteThread::Writer* w) {
+  const CompressionType compression_type =
+      immutable_db_options_.wal_compression;
+  if (compression_type == kNoCompression || two_write_queues_ ||
+      immutable_db_options_.num_wal_streams > 1 || w->disable_wal ||
+      !write_thread_.HasQueuedWriters() ||
+      WriteBatchInternal::ByteSize(w->batch) <
+          WriteBatchInternal::kHeader + kMinCompressedWALFrameSize ||
+      !w->batch->GetWalTerminationPoint().is_cleared()) {
+    return;
+  }
+  Slice contents = WriteBatchInternal::Contents(w->batch);
+  contents.remove_prefix(WriteBatchInternal::kHeader);
+  IOStatus io_s = log::Writer::CompressRecordFrame(compression_type, contents,
+                                                   &w->compressed_wal_frame);
+  if (!io_s.ok()) {
+    // Let the leader compress it along with the rest of the group
+    w->compressed_wal_frame.clear();
+  }
+}
+
 // When two_write_queues_ is disabled, this function is called from the only
 // write thread. Otherwise this must be called holding log_write_mutex_.
 IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
                             log::Writer* log_writer, uint64_t* log_used,
                             uint64_t* log_size,
                             Env::IOPriority rate_limiter_priority,
-                            LogFileNumberSize& log_file_number_size) {
+                            LogFileNumberSize& log_file_number_size,
+                            const std::string* compressed_log_entry) {
   assert(log_size != nullptr);
 
   Slice log_entry = WriteBatchInternal::Contents(&merged_batch);
@@ -1293,7 +1507,11 @@ IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
   if (UNLIKELY(needs_locking)) {
     log_write_mutex_.Lock();
   }
-  IOStatus io_s = log_writer->AddRecord(log_entry, rate_limiter_priority);
+  IOStatus io_s =
+      compressed_log_entry != nullptr
+          ? log_writer->AddCompressedRecord(*compressed_log_entry,
+                                            rate_limiter_priority)
+          : log_writer->AddRecord(log_entry, rate_limiter_priority);
 
   if (UNLIKELY(needs_locking)) {
     log_write_mutex_.Unlock();
@@ -1335,74 +1553,213 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
 
   WriteBatchInternal::SetSequence(merged_batch, sequence);
 
+  std::string compressed_log_entry;
+  const bool precompressed =
+      log_writer->GetCompressionType() != kNoCompression &&
+      AssembleCompressedWALRecord(write_group, *merged_batch,
+                                  log_writer->GetCompressionType(),
+                                  &compressed_log_entry);
+
   uint64_t log_size;
   io_s = WriteToWAL(*merged_batch, log_writer, log_used, &log_size,
                     write_group.leader->rate_limiter_priority,
-                    log_file_number_size);
+                    log_file_number_size,
+                    precompressed ? &compressed_log_entry : nullptr);
   if (to_be_cached_state) {
     cached_recoverable_state_ = *to_be_cached_state;
     cached_recoverable_state_empty_ = false;
   }
 
   if (io_s.ok() && need_log_sync) {
-    StopWatch sw(immutable_db_options_.clock, stats_, WAL_FILE_SYNC_MICROS);
-    // It's safe to access logs_ with unlocked mutex_ here because:
-    //  - we've set getting_synced=true for all logs,
-    //    so other threads won't pop from logs_ while we're here,
-    //  - only writer thread can push to logs_, and we're in
-    //    writer thread, so no one will push to logs_,
-    //  - as long as other threads don't modify it, it's safe to read
-    //    from std::deque from multiple threads concurrently.
-    //
-    // Sync operation should work with locked log_write_mutex_, because:
-    //   when DBOptions.manual_wal_flush_ is set,
-    //   FlushWAL function will be invoked by another thread.
-    //   if without locked log_write_mutex_, the log file may get data
-    //   corruption
-
-    const bool needs_locking = manual_wal_flush_ && !two_write_queues_;
-    if (UNLIKELY(needs_locking)) {
-      log_write_mutex_.Lock();
+    io_s = SyncWALsOfWriteGroup(need_log_dir_sync);
+  }
+
+  if (merged_batch == &tmp_batch_) {
+    tmp_batch_.Clear();
+  }
+  if (io_s.ok()) {
+    auto stats = default_cf_internal_stats_;
+    if (need_log_sync) {
+      stats->AddDBStats(InternalStats::kIntStatsWalFileSynced, 1);
+      RecordTick(stats_, WAL_FILE_SYNCED);
     }
+    stats->AddDBStats(InternalStats::kIntStatsWalFileBytes, log_size);
+    RecordTick(stats_, WAL_FILE_BYTES, log_size);
+    stats->AddDBStats(InternalStats::kIntStatsWriteWithWal, write_with_wal);
+    RecordTick(stats_, WRITE_WITH_WAL, write_with_wal);
+  }
+  return io_s;
+}
 
-    for (auto& log : logs_) {
-      io_s = log.writer->file()->Sync(immutable_db_options_.use_fsync);
+IOStatus DBImpl::WriteToWALStreams(const WriteThread::WriteGroup& write_group,
+                                   const LogContext& log_context,
+                                   uint64_t* log_used,
+                                   SequenceNumber sequence) {
+  IOStatus io_s;
+  assert(!two_write_queues_);
+  assert(!seq_per_batch_);
+  assert(!write_group.leader->disable_wal);
+  const auto& streams = log_context.streams;
+  assert(streams.size() > 1);
+  const Env::IOPriority rate_limiter_priority =
+      write_group.leader->rate_limiter_priority;
+  size_t write_with_wal = 0;
+  uint64_t total_log_size = 0;
+
+  // Batches of consecutive writers to the same stream, merged in tmp_batch_
+  // unless there is only one
+  WriteBatch* run_batch = nullptr;
+  size_t run_stream = 0;
+  SequenceNumber run_sequence = sequence;
+  auto write_run = [&]() {
+    if (run_batch == nullptr) {
+      return;
+    }
+    if (io_s.ok()) {
+      WriteBatchInternal::SetSequence(run_batch, run_sequence);
+      uint64_t log_size = 0;
+      io_s = WriteToWAL(*run_batch, streams[run_stream].first, log_used,
+                        &log_size, rate_limiter_priority,
+                        *streams[run_stream].second);
+      total_log_size += log_size;
+    }
+    if (run_batch == &tmp_batch_) {
+      tmp_batch_.Clear();
+    }
+    run_batch = nullptr;
+  };
+
+  for (auto* writer : write_group) {
+    if (writer->CallbackFailed()) {
+      continue;
+    }
+    writer->log_used = logfile_number_;
+    ++write_with_wal;
+    const uint64_t wal_streams = writer->wal_streams;
+    assert(wal_streams >> streams.size() == 0);
+    // A batch to no column family goes to the first stream
+    const size_t stream =
+        wal_streams == 0 ? 0 : CountTrailingZeroBits(wal_streams);
+    if (write_with_wal == 1 && sequence != wal_streams_next_sequence_) {
+      // Sequence numbers were consumed without being logged, e.g. by writes
+      // with disableWAL or by file ingestion
+      io_s = streams[stream].first->AddWalStreamGapRecord(
+          wal_streams_next_sequence_);
       if (!io_s.ok()) {
         break;
       }
     }
-
-    if (UNLIKELY(needs_locking)) {
-      log_write_mutex_.Unlock();
+    const bool multi_stream = (wal_streams & (wal_streams - 1)) != 0;
+    if (run_batch != nullptr && (stream != run_stream || multi_stream)) {
+      write_run();
     }
-
-    if (io_s.ok() && need_log_dir_sync) {
-      // We only sync WAL directory the first time WAL syncing is
-      // requested, so that in case users never turn on WAL sync,
-      // we can avoid the disk I/O in the write code path.
-      io_s = directories_.GetWalDir()->FsyncWithDirOptions(
-          IOOptions(), nullptr,
-          DirFsyncOptions(DirFsyncOptions::FsyncReason::kNewFileSynced));
+    if (run_batch == nullptr) {
+      run_stream = stream;
+      run_sequence = sequence;
+      if (writer->batch->GetWalTerminationPoint().is_cleared()) {
+        run_batch = writer->batch;
+      } else {
+        io_s = status_to_io_status(
+            WriteBatchInternal::Append(&tmp_batch_, writer->batch, true));
+        run_batch = &tmp_batch_;
+      }
+    } else {
+      if (run_batch != &tmp_batch_) {
+        assert(tmp_batch_.Count() == 0);
+        io_s = status_to_io_status(
+            WriteBatchInternal::Append(&tmp_batch_, run_batch, true));
+        run_batch = &tmp_batch_;
+      }
+      if (io_s.ok()) {
+        io_s = status_to_io_status(
+            WriteBatchInternal::Append(&tmp_batch_, writer->batch, true));
+      }
     }
+    if (multi_stream) {
+      write_run();
+      WriteBatch marker;
+      WriteBatchInternal::SetSequence(&marker, sequence);
+      for (size_t i = stream + 1; i < streams.size() && io_s.ok(); ++i) {
+        if ((wal_streams >> i) & 1) {
+          uint64_t log_size = 0;
+          io_s = WriteToWAL(marker, streams[i].first, log_used, &log_size,
+                            rate_limiter_priority, *streams[i].second);
+          total_log_size += log_size;
+        }
+      }
+    }
+    if (!io_s.ok()) {
+      break;
+    }
+    sequence += WriteBatchInternal::Count(writer->batch);
+  }
+  write_run();
+  if (io_s.ok()) {
+    wal_streams_next_sequence_ = sequence;
   }
 
-  if (merged_batch == &tmp_batch_) {
-    tmp_batch_.Clear();
+  if (io_s.ok() && log_context.need_log_sync) {
+    io_s = SyncWALsOfWriteGroup(log_context.need_log_dir_sync);
   }
+
   if (io_s.ok()) {
     auto stats = default_cf_internal_stats_;
-    if (need_log_sync) {
+    if (log_context.need_log_sync) {
       stats->AddDBStats(InternalStats::kIntStatsWalFileSynced, 1);
       RecordTick(stats_, WAL_FILE_SYNCED);
     }
-    stats->AddDBStats(InternalStats::kIntStatsWalFileBytes, log_size);
-    RecordTick(stats_, WAL_FILE_BYTES, log_size);
+    stats->AddDBStats(InternalStats::kIntStatsWalFileBytes, total_log_size);
+    RecordTick(stats_, WAL_FILE_BYTES, total_log_size);
     stats->AddDBStats(InternalStats::kIntStatsWriteWithWal, write_with_wal);
     RecordTick(stats_, WRITE_WITH_WAL, write_with_wal);
   }
   return io_s;
 }
 
+IOStatus DBImpl::SyncWALsOfWriteGroup(bool need_log_dir_sync) {
+  StopWatch sw(immutable_db_options_.clock, stats_, WAL_FILE_SYNC_MICROS);
+  // It's safe to access logs_ with unlocked mutex_ here because:
+  //  - we've set getting_synced=true for all logs,
+  //    so other threads won't pop from logs_ while we're here,
+  //  - only writer thread can push to logs_, and we're in
+  //    writer thread, so no one will push to logs_,
+  //  - as long as other threads don't modify it, it's safe to read
+  //    from std::deque from multiple threads concurrently.
+  //
+  // Sync operation should work with locked log_write_mutex_, because:
+  //   when DBOptions.manual_wal_flush_ is set,
+  //   FlushWAL function will be invoked by another thread.
+  //   if without locked log_write_mutex_, the log file may get data
+  //   corruption
+
+  const bool needs_locking = manual_wal_flush_ && !two_write_queues_;
+  if (UNLIKELY(needs_locking)) {
+    log_write_mutex_.Lock();
+  }
+
+  IOStatus io_s;
+  for (auto& log : logs_) {
+    io_s = log.writer->file()->Sync(immutable_db_options_.use_fsync);
+    if (!io_s.ok()) {
+      break;
+    }
+  }
+
+  if (UNLIKELY(needs_locking)) {
+    log_write_mutex_.Unlock();
+  }
+
+  if (io_s.ok() && need_log_dir_sync) {
+    // We only sync WAL directory the first time WAL syncing is
+    // requested, so that in case users never turn on WAL sync,
+    // we can avoid the disk I/O in the write code path.
+    io_s = directories_.GetWalDir()->FsyncWithDirOptions(
+        IOOptions(), nullptr,
+        DirFsyncOptions(DirFsyncOptions::FsyncReason::kNewFileSynced));
+  }
+  return io_s;
+}
+
 IOStatus DBImpl::ConcurrentWriteToWAL(
     const WriteThread::WriteGroup& write_group, uint64_t* log_used,
     SequenceNumber* last_sequence, size_t seq_inc) {
@@ -2010,7 +2367,8 @@ void DBImpl::NotifyOnMemTableSealed(ColumnFamilyData* /*cfd*/,
 // two_write_queues_ is true (This is to simplify the reasoning.)
 Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
   mutex_.AssertHeld();
-  log::Writer* new_log = nullptr;
+  // One log per WAL stream
+  autovector<log::Writer*> new_logs;
   MemTable* new_mem = nullptr;
   IOStatus io_s;
 
@@ -2037,7 +2395,9 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
     recycle_log_number = log_recycle_files_.front();
   }
   uint64_t new_log_number =
-      creating_new_log ? versions_->NewFileNumber() : logfile_number_;
+      creating_new_log ? versions_->FetchAddFileNumber(
+                             immutable_db_options_.num_wal_streams)
+                       : logfile_number_;
   const MutableCFOptions mutable_cf_options = *cfd->GetLatestMutableCFOptions();
 
   // Set memtable_info for memtable sealed callback
@@ -2054,12 +2414,13 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
   int num_imm_unflushed = cfd->imm()->NumNotFlushed();
   const auto preallocate_block_size =
       GetWalPreallocateBlockSize(mutable_cf_options.write_buffer_size);
+  const SequenceNumber wal_first_sequence = versions_->LastSequence() + 1;
   mutex_.Unlock();
   if (creating_new_log) {
     // TODO: Write buffer size passed in should be max of all CF's instead
     // of mutable_cf_options.write_buffer_size.
-    io_s = CreateWAL(new_log_number, recycle_log_number, preallocate_block_size,
-                     &new_log);
+    io_s = CreateWALs(new_log_number, recycle_log_number,
+                      preallocate_block_size, wal_first_sequence, &new_logs);
     if (s.ok()) {
       s = io_s;
     }
@@ -2088,10 +2449,13 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
   }
   if (s.ok() && creating_new_log) {
     InstrumentedMutexLock l(&log_write_mutex_);
-    assert(new_log != nullptr);
-    if (!logs_.empty()) {
-      // Alway flush the buffer of the last log before switching to a new one
-      log::Writer* cur_log_writer = logs_.back().writer;
+    assert(!new_logs.empty());
+    // Alway flush the buffer of the last log, or the logs of the streams of
+    // the current WAL, before switching to a new one
+    const size_t num_cur_logs = std::min(logs_.size(), new_logs.size());
+    for (size_t i = logs_.size() - num_cur_logs; i < logs_.size() && s.ok();
+         ++i) {
+      log::Writer* cur_log_writer = logs_[i].writer;
       if (error_handler_.IsRecoveryInProgress()) {
         // In recovery path, we force another try of writing WAL buffer.
         cur_log_writer->file()->reset_seen_error();
@@ -2110,10 +2474,14 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
     }
     if (s.ok()) {
       logfile_number_ = new_log_number;
+      wal_streams_next_sequence_ = wal_first_sequence;
       log_empty_ = true;
       log_dir_synced_ = false;
-      logs_.emplace_back(logfile_number_, new_log);
-      alive_log_files_.push_back(LogFileNumberSize(logfile_number_));
+      for (log::Writer* new_log : new_logs) {
+        logs_.emplace_back(new_log->get_log_number(), new_log);
+        alive_log_files_.push_back(
+            LogFileNumberSize(new_log->get_log_number()));
+      }
     }
   }
 
@@ -2121,7 +2489,9 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
     // how do we fail if we're not creating new log?
     assert(creating_new_log);
     delete new_mem;
-    delete new_log;
+    for (log::Writer* new_log : new_logs) {
+      delete new_log;
+    }
     context->superversion_context.new_superversion.reset();
     // We may have lost data from the WritableFileBuffer in-memory buffer for
     // the current log, so treat it as a fatal error and set bg_error
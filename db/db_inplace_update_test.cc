@@ -8,6 +8,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include "db/db_test_util.h"
 #include "port/stack_trace.h"
+#include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -253,6 +254,111 @@ TEST_F(DBTestInPlaceUpdate, InPlaceUpdateAndSnapshot) {
   } while (ChangeCompactOptions());
 }
 
+namespace {
+// Fixed-size counters: add the delta to the existing value in place.
+UpdateStatus AddToCounter(char* existing_value, uint32_t* existing_value_size,
+                          Slice delta_value, std::string* merged_value) {
+  uint64_t counter = DecodeFixed64(delta_value.data());
+  if (existing_value != nullptr) {
+    EXPECT_EQ(sizeof(uint64_t), *existing_value_size);
+    counter += DecodeFixed64(existing_value);
+    EncodeFixed64(existing_value, counter);
+    return UpdateStatus::UPDATED_INPLACE;
+  }
+  PutFixed64(merged_value, counter);
+  return UpdateStatus::UPDATED;
+}
+}  // namespace
+
+TEST_F(DBTestInPlaceUpdate, InPlaceUpdateCallbackConcurrentWriters) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.inplace_update_support = true;
+  options.allow_concurrent_memtable_write = true;
+  options.env = env_;
+  options.inplace_callback = AddToCounter;
+  Reopen(options);
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumIncrements = 1000;
+  std::string delta;
+  PutFixed64(&delta, 1);
+
+  // Half of the increments go to a key shared by all threads, the other half
+  // to a key owned by the writing thread.
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kNumIncrements; ++i) {
+        const std::string key = (i % 2 == 0) ? "shared" : Key(t);
+        ASSERT_OK(db_->Put(WriteOptions(), key, delta));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::string value;
+  ASSERT_OK(db_->Get(ReadOptions(), "shared", &value));
+  ASSERT_EQ(static_cast<uint64_t>(kNumThreads * kNumIncrements / 2),
+            DecodeFixed64(value.data()));
+  for (int t = 0; t < kNumThreads; ++t) {
+    ASSERT_OK(db_->Get(ReadOptions(), Key(t), &value));
+    ASSERT_EQ(static_cast<uint64_t>(kNumIncrements / 2),
+              DecodeFixed64(value.data()));
+  }
+}
+
+TEST_F(DBTestInPlaceUpdate, InPlaceUpdateCallbackConcurrentWritersSameKey) {
+  for (bool pipelined : {false, true}) {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.inplace_update_support = true;
+    options.allow_concurrent_memtable_write = true;
+    options.enable_pipelined_write = pipelined;
+    options.env = env_;
+    options.inplace_callback = AddToCounter;
+    DestroyAndReopen(options);
+
+    constexpr int kNumThreads = 8;
+    constexpr int kNumBatches = 1000;
+    std::string delta;
+    PutFixed64(&delta, 1);
+
+    // Every other batch increments the key all threads write, which must be
+    // updated in sequence order, along with the key owned by the writing
+    // thread. The others only increment the latter, and can be inserted
+    // concurrently with any batch.
+    std::vector<port::Thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back([&, t]() {
+        for (int i = 0; i < kNumBatches; ++i) {
+          WriteBatch batch;
+          if (i % 2 == 0) {
+            ASSERT_OK(batch.Put("hot", delta));
+          }
+          ASSERT_OK(batch.Put(Key(t), delta));
+          ASSERT_OK(db_->Write(WriteOptions(), &batch));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    std::string value;
+    ASSERT_OK(db_->Get(ReadOptions(), "hot", &value));
+    ASSERT_EQ(static_cast<uint64_t>(kNumThreads * kNumBatches / 2),
+              DecodeFixed64(value.data()));
+    for (int t = 0; t < kNumThreads; ++t) {
+      ASSERT_OK(db_->Get(ReadOptions(), Key(t), &value));
+      ASSERT_EQ(static_cast<uint64_t>(kNumBatches),
+                DecodeFixed64(value.data()));
+    }
+  }
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
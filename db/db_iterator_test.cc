@@ -17,6 +17,7 @@
 #include "rocksdb/iostats_context.h"
 #include "rocksdb/perf_context.h"
 #include "table/block_based/flush_block_policy.h"
+#include "util/coding.h"
 #include "util/random.h"
 #include "utilities/merge_operators/string_append/stringappend2.h"
 
@@ -2521,6 +2522,125 @@ TEST_P(DBIteratorTest, TableFilter) {
   }
 }
 
+namespace {
+// Summarizes each data block by the smallest and largest value in it.
+class MinMaxValueSummaryCollector : public DataBlockSummaryCollector {
+ public:
+  void Add(const Slice& /*key*/, const Slice& value,
+           EntryType /*type*/) override {
+    if (min_.empty() || value.compare(min_) < 0) {
+      min_ = value.ToString();
+    }
+    if (max_.empty() || value.compare(max_) > 0) {
+      max_ = value.ToString();
+    }
+  }
+
+  void FinishBlock(std::string* summary) override {
+    PutLengthPrefixedSlice(summary, min_);
+    PutLengthPrefixedSlice(summary, max_);
+    min_.clear();
+    max_.clear();
+  }
+
+  const char* Name() const override { return "MinMaxValueSummaryCollector"; }
+
+ private:
+  std::string min_;
+  std::string max_;
+};
+
+class MinMaxValueSummaryCollectorFactory
+    : public DataBlockSummaryCollectorFactory {
+ public:
+  DataBlockSummaryCollector* CreateDataBlockSummaryCollector(
+      TablePropertiesCollectorFactory::Context /*context*/) override {
+    return new MinMaxValueSummaryCollector();
+  }
+
+  const char* Name() const override {
+    return "MinMaxValueSummaryCollectorFactory";
+  }
+};
+}  // namespace
+
+TEST_P(DBIteratorTest, BlockSummaryFilter) {
+  for (auto index_type : {BlockBasedTableOptions::kBinarySearch,
+                          BlockBasedTableOptions::kBinarySearchWithFirstKey}) {
+    Options options = CurrentOptions();
+    BlockBasedTableOptions table_options;
+    table_options.index_type = index_type;
+    table_options.flush_block_policy_factory =
+        std::make_shared<FlushBlockEveryKeyPolicyFactory>();
+    table_options.data_block_summary_collector_factory =
+        std::make_shared<MinMaxValueSummaryCollectorFactory>();
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    for (int i = 0; i < 10; ++i) {
+      ASSERT_OK(Put("k" + std::to_string(i), "v" + std::to_string(i)));
+    }
+    ASSERT_OK(Flush());
+    Reopen(options);
+
+    // Only read the blocks whose values may fall in ["v5", "v7"].
+    ReadOptions opts;
+    opts.block_summary_filter = [](const Slice& block_summary) {
+      Slice input = block_summary;
+      Slice min_value;
+      Slice max_value;
+      EXPECT_TRUE(GetLengthPrefixedSlice(&input, &min_value));
+      EXPECT_TRUE(GetLengthPrefixedSlice(&input, &max_value));
+      return max_value.compare("v5") >= 0 && min_value.compare("v7") <= 0;
+    };
+
+    SetPerfLevel(kEnableCount);
+    get_perf_context()->Reset();
+    auto iter = NewIterator(opts);
+    iter->SeekToFirst();
+    ASSERT_EQ(IterStatus(iter), "k5->v5");
+    iter->Next();
+    ASSERT_EQ(IterStatus(iter), "k6->v6");
+    iter->Next();
+    ASSERT_EQ(IterStatus(iter), "k7->v7");
+    iter->Next();
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(3, get_perf_context()->block_read_count);
+
+    iter->SeekToLast();
+    ASSERT_EQ(IterStatus(iter), "k7->v7");
+    iter->Prev();
+    ASSERT_EQ(IterStatus(iter), "k6->v6");
+    iter->Prev();
+    ASSERT_EQ(IterStatus(iter), "k5->v5");
+    iter->Prev();
+    ASSERT_FALSE(iter->Valid());
+
+    iter->Seek("k1");
+    ASSERT_EQ(IterStatus(iter), "k5->v5");
+    iter->Seek("k8");
+    ASSERT_FALSE(iter->Valid());
+    iter->SeekForPrev("k9");
+    ASSERT_EQ(IterStatus(iter), "k7->v7");
+    iter->SeekForPrev("k4");
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+    delete iter;
+    SetPerfLevel(kDisable);
+
+    // Without the filter every key is visible.
+    iter = NewIterator(ReadOptions());
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++count;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(10, count);
+    delete iter;
+  }
+}
+
 TEST_P(DBIteratorTest, UpperBoundWithPrevReseek) {
   Options options = CurrentOptions();
   options.max_sequential_skip_in_iterations = 3;
@@ -2269,6 +2269,260 @@ TEST_F(DBWALTest, WalTermTest) {
   ASSERT_EQ("NOT_FOUND", Get(1, "foo2"));
 }
 
+TEST_F(DBWALTest, RecoverPrecompressedWALFrames) {
+  if (!StreamingCompressionTypeSupported(kZSTD)) {
+    ROCKSDB_GTEST_BYPASS("stream compression not present");
+    return;
+  }
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.wal_compression = kZSTD;
+  DestroyAndReopen(options);
+
+  // Large batches are compressed by their writers, small ones by the group
+  // leader. Concurrent writers mix both kinds in one WAL record.
+  constexpr int kNumThreads = 4;
+  constexpr int kNumBatches = 20;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      Random rnd(301 + t);
+      for (int i = 0; i < kNumBatches; ++i) {
+        WriteBatch batch;
+        const int num_keys = (i % 2 == 0) ? 1 : 50;
+        for (int k = 0; k < num_keys; ++k) {
+          ASSERT_OK(batch.Put(Key(t * 100000 + i * 100 + k),
+                              rnd.RandomString(200)));
+        }
+        ASSERT_OK(db_->Write(WriteOptions(), &batch));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  std::map<std::string, std::string> expected;
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      expected[iter->key().ToString()] = iter->value().ToString();
+    }
+    ASSERT_OK(iter->status());
+  }
+  ASSERT_EQ(static_cast<size_t>(kNumThreads * kNumBatches / 2 * 51),
+            expected.size());
+
+  Reopen(options);
+  for (const auto& kv : expected) {
+    ASSERT_EQ(kv.second, Get(kv.first));
+  }
+}
+
+TEST_F(DBWALTest, RecoverWalStreams) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.num_wal_streams = 3;
+  DestroyAndReopen(options);
+  // Column families 0 and 3 share the first stream
+  const std::vector<std::string> cfs = {"one", "two", "three"};
+  CreateAndReopenWithCF(cfs, options);
+
+  // Single and multi-stream batches from concurrent writers, with a WAL
+  // switch in between
+  constexpr int kNumThreads = 4;
+  constexpr int kNumBatches = 50;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kNumBatches; ++i) {
+        WriteBatch batch;
+        const std::string key = Key(t * 1000 + i);
+        ASSERT_OK(batch.Put(handles_[(t + i) % 4], key, "v" + key));
+        if (i % 3 == 0) {
+          ASSERT_OK(batch.Put(handles_[(t + i + 1) % 4], key, "w" + key));
+        }
+        ASSERT_OK(db_->Write(WriteOptions(), &batch));
+        if (t == 0 && i == kNumBatches / 2) {
+          ASSERT_OK(Flush(1));
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // The streams of the current WAL all have records
+  VectorLogPtr wal_files;
+  ASSERT_OK(dbfull()->GetSortedWalFiles(wal_files));
+  ASSERT_GE(wal_files.size(), 3);
+  for (size_t i = wal_files.size() - 2; i < wal_files.size(); ++i) {
+    ASSERT_EQ(wal_files[i - 1]->LogNumber() + 1, wal_files[i]->LogNumber());
+  }
+
+  auto verify = [&]() {
+    for (int t = 0; t < kNumThreads; ++t) {
+      for (int i = 0; i < kNumBatches; ++i) {
+        const std::string key = Key(t * 1000 + i);
+        for (int cf = 0; cf < 4; ++cf) {
+          std::string expected = "NOT_FOUND";
+          if (cf == (t + i) % 4) {
+            expected = "v" + key;
+          } else if (i % 3 == 0 && cf == (t + i + 1) % 4) {
+            expected = "w" + key;
+          }
+          ASSERT_EQ(expected, Get(cf, key));
+        }
+      }
+    }
+  };
+  verify();
+  const SequenceNumber last_sequence = db_->GetLatestSequenceNumber();
+
+  ReopenWithColumnFamilies({"default", "one", "two", "three"}, options);
+  verify();
+  ASSERT_EQ(last_sequence, db_->GetLatestSequenceNumber());
+
+  // Also readable with the WAL written as a single stream
+  options.num_wal_streams = 1;
+  ReopenWithColumnFamilies({"default", "one", "two", "three"}, options);
+  verify();
+  options.num_wal_streams = 2;
+  ReopenWithColumnFamilies({"default", "one", "two", "three"}, options);
+  verify();
+}
+
+TEST_F(DBWALTest, WalStreamsDetectLostMultiStreamBatch) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.num_wal_streams = 2;
+  DestroyAndReopen(options);
+  CreateAndReopenWithCF({"one"}, options);
+
+  ASSERT_OK(Put(0, "a", "va"));
+  // Written to the first stream, with a marker in the second one
+  WriteBatch batch;
+  ASSERT_OK(batch.Put(handles_[0], "b", "vb"));
+  ASSERT_OK(batch.Put(handles_[1], "b", "vb"));
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+  ASSERT_OK(Put(1, "c", "vc"));
+  Close();
+
+  // Lose the first stream of the current WAL
+  std::vector<std::string> files;
+  ASSERT_OK(env_->GetChildren(dbname_, &files));
+  uint64_t last_wal_number = 0;
+  for (const auto& file : files) {
+    uint64_t number = 0;
+    FileType type = kTableFile;
+    if (ParseFileName(file, &number, &type) && type == kWalFile) {
+      last_wal_number = std::max(last_wal_number, number);
+    }
+  }
+  ASSERT_GT(last_wal_number, 0);
+  ASSERT_OK(env_->DeleteFile(LogFileName(dbname_, last_wal_number - 1)));
+
+  options.wal_recovery_mode = WALRecoveryMode::kAbsoluteConsistency;
+  ASSERT_TRUE(TryReopenWithColumnFamilies({"default", "one"}, options)
+                  .IsCorruption());
+
+  // Replay stops at the marker of the lost batch
+  options.wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
+  ReopenWithColumnFamilies({"default", "one"}, options);
+  ASSERT_EQ("NOT_FOUND", Get(0, "a"));
+  ASSERT_EQ("NOT_FOUND", Get(1, "b"));
+  ASSERT_EQ("NOT_FOUND", Get(1, "c"));
+}
+
+TEST_F(DBWALTest, WalStreamsDetectLostTailOfStream) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.num_wal_streams = 2;
+  DestroyAndReopen(options);
+  CreateAndReopenWithCF({"one"}, options);
+
+  auto last_wal_number = [&]() {
+    std::vector<std::string> files;
+    EXPECT_OK(env_->GetChildren(dbname_, &files));
+    uint64_t result = 0;
+    for (const auto& file : files) {
+      uint64_t number = 0;
+      FileType type = kTableFile;
+      if (ParseFileName(file, &number, &type) && type == kWalFile) {
+        result = std::max(result, number);
+      }
+    }
+    return result;
+  };
+  // The second stream of the current WAL
+  const std::string second_stream = LogFileName(dbname_, last_wal_number());
+
+  ASSERT_OK(Put(0, "a", "va"));
+  uint64_t synced_size = 0;
+  ASSERT_OK(env_->GetFileSize(second_stream, &synced_size));
+  ASSERT_OK(Put(1, "b", "vb"));
+  ASSERT_OK(Put(0, "c", "vc"));
+  Close();
+
+  // Lose the tail of the second stream, as if not synced, but not the later
+  // batch of the first one
+  ASSERT_OK(test::TruncateFile(env_, second_stream, synced_size));
+
+  options.wal_recovery_mode = WALRecoveryMode::kAbsoluteConsistency;
+  ASSERT_TRUE(TryReopenWithColumnFamilies({"default", "one"}, options)
+                  .IsCorruption());
+
+  // Replay stops at the lost batch
+  options.wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
+  ReopenWithColumnFamilies({"default", "one"}, options);
+  ASSERT_EQ("va", Get(0, "a"));
+  ASSERT_EQ("NOT_FOUND", Get(1, "b"));
+  ASSERT_EQ("NOT_FOUND", Get(0, "c"));
+}
+
+TEST_F(DBWALTest, WalStreamsRecoverAfterUnloggedWrite) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.num_wal_streams = 2;
+  // Keep the unlogged write in the memtable
+  options.avoid_flush_during_shutdown = true;
+  DestroyAndReopen(options);
+  CreateAndReopenWithCF({"one"}, options);
+
+  ASSERT_OK(Put(0, "a", "va"));
+  // Consumes a sequence number without being logged
+  WriteOptions no_wal;
+  no_wal.disableWAL = true;
+  ASSERT_OK(db_->Put(no_wal, handles_[1], "b", "vb"));
+  ASSERT_OK(Put(1, "c", "vc"));
+  ASSERT_OK(Put(0, "d", "vd"));
+  Close();
+
+  options.wal_recovery_mode = WALRecoveryMode::kAbsoluteConsistency;
+  ReopenWithColumnFamilies({"default", "one"}, options);
+  ASSERT_EQ("va", Get(0, "a"));
+  ASSERT_EQ("NOT_FOUND", Get(1, "b"));
+  ASSERT_EQ("vc", Get(1, "c"));
+  ASSERT_EQ("vd", Get(0, "d"));
+}
+
+TEST_F(DBWALTest, WalStreamsIncompatibleOptions) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.num_wal_streams = 0;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+  options.num_wal_streams = 65;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+  options.num_wal_streams = 2;
+  options.enable_pipelined_write = true;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+  options.enable_pipelined_write = false;
+  options.manual_wal_flush = true;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+  options.manual_wal_flush = false;
+  ASSERT_OK(TryReopen(options));
+}
+
 #ifndef ROCKSDB_LITE
 TEST_F(DBWALTest, GetCompressedWalsAfterSync) {
   if (db_->GetOptions().wal_compression == kNoCompression) {
@@ -247,6 +247,8 @@ static const std::string cf_file_histogram = "cf-file-histogram";
 static const std::string dbstats = "dbstats";
 static const std::string levelstats = "levelstats";
 static const std::string block_cache_entry_stats = "block-cache-entry-stats";
+static const std::string metadata_block_cache_entry_stats =
+    "metadata-block-cache-entry-stats";
 static const std::string num_immutable_mem_table = "num-immutable-mem-table";
 static const std::string num_immutable_mem_table_flushed =
     "num-immutable-mem-table-flushed";
@@ -326,6 +328,8 @@ const std::string DB::Properties::kDBStats = rocksdb_prefix + dbstats;
 const std::string DB::Properties::kLevelStats = rocksdb_prefix + levelstats;
 const std::string DB::Properties::kBlockCacheEntryStats =
     rocksdb_prefix + block_cache_entry_stats;
+const std::string DB::Properties::kMetadataBlockCacheEntryStats =
+    rocksdb_prefix + metadata_block_cache_entry_stats;
 const std::string DB::Properties::kNumImmutableMemTable =
     rocksdb_prefix + num_immutable_mem_table;
 const std::string DB::Properties::kNumImmutableMemTableFlushed =
@@ -446,6 +450,9 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kBlockCacheEntryStats,
          {true, &InternalStats::HandleBlockCacheEntryStats, nullptr,
           &InternalStats::HandleBlockCacheEntryStatsMap, nullptr}},
+        {DB::Properties::kMetadataBlockCacheEntryStats,
+         {true, &InternalStats::HandleMetadataBlockCacheEntryStats, nullptr,
+          &InternalStats::HandleMetadataBlockCacheEntryStatsMap, nullptr}},
         {DB::Properties::kSSTables,
          {false, &InternalStats::HandleSsTables, nullptr, nullptr, nullptr}},
         {DB::Properties::kAggregatedTableProperties,
@@ -614,6 +621,12 @@ InternalStats::InternalStats(int num_levels, SystemClock* clock,
       assert(!cache_entry_stats_collector_);
     }
   }
+  Cache* metadata_block_cache = GetMetadataBlockCacheForStats();
+  if (metadata_block_cache && metadata_block_cache != block_cache) {
+    CacheEntryStatsCollector<CacheEntryRoleStats>::GetShared(
+        metadata_block_cache, clock_, &metadata_cache_entry_stats_collector_)
+        .PermitUncheckedError();
+  }
 }
 
 void InternalStats::TEST_GetCacheEntryRoleStats(CacheEntryRoleStats* stats,
@@ -630,7 +643,8 @@ void InternalStats::CollectCacheEntryStats(bool foreground) {
   // and ->GetStats does its own synchronization, which also suffices for
   // cache_entry_stats_.
 
-  if (!cache_entry_stats_collector_) {
+  if (!cache_entry_stats_collector_ &&
+      !metadata_cache_entry_stats_collector_) {
     return;  // nothing to do (e.g. no block cache)
   }
 
@@ -640,8 +654,14 @@ void InternalStats::CollectCacheEntryStats(bool foreground) {
   int min_interval_seconds = foreground ? 10 : 180;
   // 1/500 = max of 0.2% of one CPU thread
   int min_interval_factor = foreground ? 10 : 500;
-  cache_entry_stats_collector_->CollectStats(min_interval_seconds,
-                                             min_interval_factor);
+  if (cache_entry_stats_collector_) {
+    cache_entry_stats_collector_->CollectStats(min_interval_seconds,
+                                               min_interval_factor);
+  }
+  if (metadata_cache_entry_stats_collector_) {
+    metadata_cache_entry_stats_collector_->CollectStats(min_interval_seconds,
+                                                        min_interval_factor);
+  }
 }
 
 std::function<void(const Slice&, void*, size_t, Cache::DeleterFn)>
@@ -758,6 +778,30 @@ bool InternalStats::HandleBlockCacheEntryStatsMap(
   return true;
 }
 
+bool InternalStats::HandleMetadataBlockCacheEntryStats(std::string* value,
+                                                       Slice /*suffix*/) {
+  if (!metadata_cache_entry_stats_collector_) {
+    return false;
+  }
+  CollectCacheEntryStats(/*foreground*/ true);
+  CacheEntryRoleStats stats;
+  metadata_cache_entry_stats_collector_->GetStats(&stats);
+  *value = stats.ToString(clock_);
+  return true;
+}
+
+bool InternalStats::HandleMetadataBlockCacheEntryStatsMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/) {
+  if (!metadata_cache_entry_stats_collector_) {
+    return false;
+  }
+  CollectCacheEntryStats(/*foreground*/ true);
+  CacheEntryRoleStats stats;
+  metadata_cache_entry_stats_collector_->GetStats(&stats);
+  stats.ToMap(values, clock_);
+  return true;
+}
+
 bool InternalStats::HandleLiveSstFilesSizeAtTemperature(std::string* value,
                                                         Slice suffix) {
   uint64_t temperature;
@@ -1334,11 +1378,13 @@ bool InternalStats::HandleIsWriteStopped(uint64_t* value, DBImpl* db,
 bool InternalStats::HandleEstimateOldestKeyTime(uint64_t* value, DBImpl* /*db*/,
                                                 Version* /*version*/) {
   // TODO(yiwu): The property is currently available for fifo compaction
-  // with allow_compaction = false. This is because we don't propagate
-  // oldest_key_time on compaction.
+  // with allow_compaction = false and time_window_seconds = 0. This is
+  // because we don't propagate oldest_key_time on compaction.
   if (cfd_->ioptions()->compaction_style != kCompactionStyleFIFO ||
       cfd_->GetCurrentMutableCFOptions()
-          ->compaction_options_fifo.allow_compaction) {
+          ->compaction_options_fifo.allow_compaction ||
+      cfd_->GetCurrentMutableCFOptions()
+              ->compaction_options_fifo.time_window_seconds > 0) {
     return false;
   }
 
@@ -1367,6 +1413,13 @@ Cache* InternalStats::GetBlockCacheForStats() {
   return table_factory->GetOptions<Cache>(TableFactory::kBlockCacheOpts());
 }
 
+Cache* InternalStats::GetMetadataBlockCacheForStats() {
+  auto* table_factory = cfd_->ioptions()->table_factory.get();
+  assert(table_factory != nullptr);
+  return table_factory->GetOptions<Cache>(
+      TableFactory::kMetadataBlockCacheOpts());
+}
+
 bool InternalStats::HandleBlockCacheCapacity(uint64_t* value, DBImpl* /*db*/,
                                              Version* /*version*/) {
   Cache* block_cache = GetBlockCacheForStats();
@@ -1877,10 +1930,14 @@ void InternalStats::DumpCFStatsNoFileHistogram(std::string* value) {
   // Do not gather cache entry stats during CFStats because DB
   // mutex is held. Only dump last cached collection (rely on DB
   // periodic stats dump to update)
-  if (cache_entry_stats_collector_) {
+  for (const auto& collector : {cache_entry_stats_collector_,
+                                 metadata_cache_entry_stats_collector_}) {
+    if (!collector) {
+      continue;
+    }
     CacheEntryRoleStats stats;
     // thread safe
-    cache_entry_stats_collector_->GetStats(&stats);
+    collector->GetStats(&stats);
 
     constexpr uint64_t kDayInMicros = uint64_t{86400} * 1000000U;
 
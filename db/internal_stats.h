@@ -606,6 +606,7 @@ class InternalStats {
   void DumpCFFileHistogram(std::string* value);
 
   Cache* GetBlockCacheForStats();
+  Cache* GetMetadataBlockCacheForStats();
   Cache* GetBlobCacheForStats();
 
   // Per-DB stats
@@ -620,6 +621,9 @@ class InternalStats {
   // a full cache, which would force a re-scan on the next GetStats.
   std::shared_ptr<CacheEntryStatsCollector<CacheEntryRoleStats>>
       cache_entry_stats_collector_;
+  // Like cache_entry_stats_collector_, for the metadata block cache, if any.
+  std::shared_ptr<CacheEntryStatsCollector<CacheEntryRoleStats>>
+      metadata_cache_entry_stats_collector_;
   // Per-ColumnFamily/level compaction stats
   std::vector<CompactionStats> comp_stats_;
   std::vector<CompactionStats> comp_stats_by_pri_;
@@ -793,6 +797,9 @@ class InternalStats {
   bool HandleBlockCacheEntryStats(std::string* value, Slice suffix);
   bool HandleBlockCacheEntryStatsMap(std::map<std::string, std::string>* values,
                                      Slice suffix);
+  bool HandleMetadataBlockCacheEntryStats(std::string* value, Slice suffix);
+  bool HandleMetadataBlockCacheEntryStatsMap(
+      std::map<std::string, std::string>* values, Slice suffix);
   bool HandleLiveSstFilesSizeAtTemperature(std::string* value, Slice suffix);
   bool HandleNumBlobFiles(uint64_t* value, DBImpl* db, Version* version);
   bool HandleBlobStats(std::string* value, Slice suffix);
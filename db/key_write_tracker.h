@@ -0,0 +1,80 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/types.h"
+#include "util/hash.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// KeyWriteTracker records, for each of a fixed number of stripes that user
+// keys are hashed to, the largest sequence number written to a key of that
+// stripe. A reader that remembers a value it wrote to a key at sequence number
+// `seq` can then tell that no later write touched the key if
+// GetLatestWrite() for that key is still <= `seq`. Keys sharing a stripe
+// only cause false positives.
+//
+// All methods are thread-safe. Writes must be recorded before they become
+// visible to readers, i.e. before their sequence number is published.
+class KeyWriteTracker {
+ public:
+  explicit KeyWriteTracker(size_t num_stripes_log2 = 16)
+      : num_stripes_(size_t{1} << num_stripes_log2),
+        stripes_(new std::atomic<SequenceNumber>[num_stripes_]),
+        all_keys_(0) {
+    for (size_t i = 0; i < num_stripes_; ++i) {
+      stripes_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // Records a write at `seq` to `key` of column family `column_family_id`.
+  void RecordWrite(uint32_t column_family_id, const Slice& key,
+                   SequenceNumber seq) {
+    UpdateMax(&stripes_[StripeIndex(column_family_id, key)], seq);
+  }
+
+  // Records a change at `seq` that may affect any key, such as a range
+  // deletion, a file ingestion or the deletion of files.
+  void RecordWriteToAllKeys(SequenceNumber seq) { UpdateMax(&all_keys_, seq); }
+
+  // Returns an upper bound of the sequence number of the latest write to
+  // `key` of column family `column_family_id`. 0 if none was recorded.
+  SequenceNumber GetLatestWrite(uint32_t column_family_id,
+                                const Slice& key) const {
+    const SequenceNumber stripe =
+        stripes_[StripeIndex(column_family_id, key)].load(
+            std::memory_order_acquire);
+    const SequenceNumber all = all_keys_.load(std::memory_order_acquire);
+    return stripe > all ? stripe : all;
+  }
+
+ private:
+  size_t StripeIndex(uint32_t column_family_id, const Slice& key) const {
+    return static_cast<size_t>(
+               GetSliceNPHash64(key, /*seed=*/column_family_id)) &
+           (num_stripes_ - 1);
+  }
+
+  static void UpdateMax(std::atomic<SequenceNumber>* latest,
+                        SequenceNumber seq) {
+    SequenceNumber cur = latest->load(std::memory_order_relaxed);
+    while (cur < seq && !latest->compare_exchange_weak(
+                            cur, seq, std::memory_order_acq_rel,
+                            std::memory_order_relaxed)) {
+    }
+  }
+
+  const size_t num_stripes_;
+  std::unique_ptr<std::atomic<SequenceNumber>[]> stripes_;
+  std::atomic<SequenceNumber> all_keys_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -35,8 +35,13 @@ enum RecordType {
 
   // Compression Type
   kSetCompressionType = 9,
+
+  // Stream of a WAL written as several streams (DBOptions::num_wal_streams)
+  kWalStreamType = 10,
+  // Sequence numbers skipped before the next record of a WAL stream
+  kWalStreamGapType = 11,
 };
-static const int kMaxRecordType = kSetCompressionType;
+static const int kMaxRecordType = kWalStreamGapType;
 
 static const unsigned int kBlockSize = 32768;
 
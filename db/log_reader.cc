@@ -17,6 +17,7 @@
 #include "test_util/sync_point.h"
 #include "util/coding.h"
 #include "util/crc32c.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace log {
@@ -43,6 +44,11 @@ Reader::Reader(std::shared_ptr<Logger> info_log,
       first_record_read_(false),
       compression_type_(kNoCompression),
       compression_type_record_read_(false),
+      wal_stream_(0),
+      num_wal_streams_(1),
+      wal_stream_first_sequence_(0),
+      has_wal_stream_gap_(false),
+      wal_stream_gap_next_sequence_(0),
       uncompress_(nullptr),
       hash_state_(nullptr),
       uncompress_hash_state_(nullptr){};
@@ -282,6 +288,24 @@ bool Reader::ReadRecord(Slice* record, std::string* scratch,
         break;
       }
 
+      case kWalStreamType:
+        prospective_record_offset = physical_record_offset;
+        scratch->clear();
+        last_record_offset_ = prospective_record_offset;
+        ReadWalStreamRecord(fragment);
+        break;
+
+      case kWalStreamGapType:
+        if (in_fragmented_record) {
+          ReportCorruption(scratch->size(), "partial record without end(3)");
+          in_fragmented_record = false;
+        }
+        prospective_record_offset = physical_record_offset;
+        scratch->clear();
+        last_record_offset_ = prospective_record_offset;
+        ReadWalStreamGapRecord(fragment);
+        break;
+
       default: {
         char buf[40];
         snprintf(buf, sizeof(buf), "unknown record type %u", record_type);
@@ -504,7 +528,8 @@ unsigned int Reader::ReadPhysicalRecord(Slice* result, size_t* drop_size,
 
     buffer_.remove_prefix(header_size + length);
 
-    if (!uncompress_ || type == kSetCompressionType) {
+    if (!uncompress_ || type == kSetCompressionType ||
+        type == kWalStreamType || type == kWalStreamGapType) {
       *result = Slice(header + header_size, length);
       return type;
     } else {
@@ -570,6 +595,45 @@ void Reader::InitCompression(const CompressionTypeRecord& compression_record) {
   assert(uncompressed_buffer_);
 }
 
+void Reader::ReadWalStreamRecord(const Slice& fragment) {
+  if (first_record_read_) {
+    ReportCorruption(fragment.size(), "WalStream not the first record");
+    return;
+  }
+  Slice input = fragment;
+  uint32_t stream = 0;
+  uint32_t num_streams = 0;
+  uint64_t first_sequence = 0;
+  if (!GetVarint32(&input, &stream) || !GetVarint32(&input, &num_streams) ||
+      !GetVarint64(&input, &first_sequence) || stream >= num_streams) {
+    ReportCorruption(fragment.size(), "could not decode WalStream record");
+    return;
+  }
+  wal_stream_ = stream;
+  num_wal_streams_ = num_streams;
+  wal_stream_first_sequence_ = first_sequence;
+}
+
+void Reader::ReadWalStreamGapRecord(const Slice& fragment) {
+  Slice input = fragment;
+  uint64_t next_sequence = 0;
+  if (num_wal_streams_ < 2 || !GetVarint64(&input, &next_sequence)) {
+    ReportCorruption(fragment.size(), "could not decode WalStreamGap record");
+    return;
+  }
+  has_wal_stream_gap_ = true;
+  wal_stream_gap_next_sequence_ = next_sequence;
+}
+
+bool Reader::ConsumeWalStreamGap(uint64_t* next_sequence) {
+  if (!has_wal_stream_gap_) {
+    return false;
+  }
+  has_wal_stream_gap_ = false;
+  *next_sequence = wal_stream_gap_next_sequence_;
+  return true;
+}
+
 bool FragmentBufferedReader::ReadRecord(Slice* record, std::string* scratch,
                                         WALRecoveryMode /*unused*/,
                                         uint64_t* /* checksum */) {
@@ -686,6 +750,25 @@ bool FragmentBufferedReader::ReadRecord(Slice* record, std::string* scratch,
         break;
       }
 
+      case kWalStreamType:
+        fragments_.clear();
+        prospective_record_offset = physical_record_offset;
+        last_record_offset_ = prospective_record_offset;
+        in_fragmented_record_ = false;
+        ReadWalStreamRecord(fragment);
+        break;
+
+      case kWalStreamGapType:
+        if (in_fragmented_record_) {
+          ReportCorruption(fragments_.size(), "partial record without end(3)");
+        }
+        fragments_.clear();
+        prospective_record_offset = physical_record_offset;
+        last_record_offset_ = prospective_record_offset;
+        in_fragmented_record_ = false;
+        ReadWalStreamGapRecord(fragment);
+        break;
+
       default: {
         char buf[40];
         snprintf(buf, sizeof(buf), "unknown record type %u",
@@ -825,7 +908,8 @@ bool FragmentBufferedReader::TryReadFragment(
 
   buffer_.remove_prefix(header_size + length);
 
-  if (!uncompress_ || type == kSetCompressionType) {
+  if (!uncompress_ || type == kSetCompressionType ||
+      type == kWalStreamType || type == kWalStreamGapType) {
     *fragment = Slice(header + header_size, length);
     *fragment_type_or_err = type;
     return true;
@@ -854,5 +938,138 @@ bool FragmentBufferedReader::TryReadFragment(
   }
 }
 
+ReadaheadReader::ReadaheadReader(
+    std::shared_ptr<Logger> info_log,
+    std::unique_ptr<SequentialFileReader>&& _file, Reporter* reporter,
+    bool checksum, uint64_t log_num, size_t max_readahead_bytes)
+    : Reader(info_log, std::move(_file), &queueing_reporter_, checksum,
+             log_num),
+      queueing_reporter_(this),
+      caller_reporter_(reporter),
+      max_readahead_bytes_(max_readahead_bytes),
+      cv_(&mu_) {}
+
+ReadaheadReader::~ReadaheadReader() {
+  if (thread_.joinable()) {
+    {
+      MutexLock l(&mu_);
+      stop_ = true;
+      cv_.SignalAll();
+    }
+    thread_.join();
+  }
+}
+
+void ReadaheadReader::QueueingReporter::Corruption(size_t bytes,
+                                                   const Status& status) {
+  if (!reader_->reading_ahead_) {
+    if (reader_->caller_reporter_ != nullptr) {
+      reader_->caller_reporter_->Corruption(bytes, status);
+    }
+    return;
+  }
+  MutexLock l(&reader_->mu_);
+  reader_->entries_.emplace_back();
+  reader_->entries_.back().dropped_bytes = bytes;
+  reader_->entries_.back().status = status;
+  reader_->cv_.SignalAll();
+}
+
+bool ReadaheadReader::ReadRecord(Slice* record, std::string* scratch,
+                                 WALRecoveryMode wal_recovery_mode,
+                                 uint64_t* record_checksum) {
+  if (!reading_ahead_) {
+    if (!Reader::ReadRecord(record, scratch, wal_recovery_mode,
+                            record_checksum)) {
+      return false;
+    }
+    if (compression_type_ != kNoCompression) {
+      // A decompressed record lives in the reader, which the read-ahead
+      // thread is about to reuse
+      if (record->data() != scratch->data()) {
+        scratch->assign(record->data(), record->size());
+        *record = Slice(*scratch);
+      }
+      // The read-ahead thread reads the gap records that follow
+      has_returned_wal_stream_gap_ =
+          Reader::ConsumeWalStreamGap(&returned_wal_stream_gap_next_sequence_);
+      reading_ahead_ = true;
+      thread_ = port::Thread(&ReadaheadReader::ReadAhead, this,
+                             wal_recovery_mode, record_checksum != nullptr);
+    }
+    return true;
+  }
+
+  MutexLock l(&mu_);
+  for (;;) {
+    while (entries_.empty() && !done_) {
+      cv_.Wait();
+    }
+    if (entries_.empty()) {
+      return false;
+    }
+    Entry entry = std::move(entries_.front());
+    entries_.pop_front();
+    queued_bytes_ -= entry.record.size();
+    cv_.SignalAll();
+    if (!entry.status.ok()) {
+      if (caller_reporter_ != nullptr) {
+        caller_reporter_->Corruption(entry.dropped_bytes, entry.status);
+      }
+      continue;
+    }
+    *scratch = std::move(entry.record);
+    *record = Slice(*scratch);
+    if (record_checksum != nullptr) {
+      *record_checksum = entry.checksum;
+    }
+    has_returned_wal_stream_gap_ = entry.has_wal_stream_gap;
+    returned_wal_stream_gap_next_sequence_ = entry.wal_stream_gap_next_sequence;
+    return true;
+  }
+}
+
+bool ReadaheadReader::ConsumeWalStreamGap(uint64_t* next_sequence) {
+  if (!reading_ahead_) {
+    return Reader::ConsumeWalStreamGap(next_sequence);
+  }
+  if (!has_returned_wal_stream_gap_) {
+    return false;
+  }
+  has_returned_wal_stream_gap_ = false;
+  *next_sequence = returned_wal_stream_gap_next_sequence_;
+  return true;
+}
+
+void ReadaheadReader::ReadAhead(WALRecoveryMode wal_recovery_mode,
+                                bool with_checksum) {
+  std::string scratch;
+  Slice record;
+  uint64_t checksum = 0;
+  for (;;) {
+    const bool read = Reader::ReadRecord(&record, &scratch, wal_recovery_mode,
+                                         with_checksum ? &checksum : nullptr);
+    MutexLock l(&mu_);
+    if (!read) {
+      done_ = true;
+      cv_.SignalAll();
+      return;
+    }
+    entries_.emplace_back();
+    entries_.back().record.assign(record.data(), record.size());
+    entries_.back().checksum = checksum;
+    entries_.back().has_wal_stream_gap = Reader::ConsumeWalStreamGap(
+        &entries_.back().wal_stream_gap_next_sequence);
+    queued_bytes_ += record.size();
+    cv_.SignalAll();
+    while (!stop_ && queued_bytes_ >= max_readahead_bytes_) {
+      cv_.Wait();
+    }
+    if (stop_) {
+      return;
+    }
+  }
+}
+
 }  // namespace log
 }  // namespace ROCKSDB_NAMESPACE
@@ -10,10 +10,12 @@
 #pragma once
 #include <stdint.h>
 
+#include <deque>
 #include <memory>
 
 #include "db/log_format.h"
 #include "file/sequence_file_reader.h"
+#include "port/port.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
@@ -113,6 +115,21 @@ class Reader {
     return !first_record_read_ && compression_type_record_read_;
   }
 
+  // Stream of a WAL written as several streams that this log holds, and the
+  // number of streams, as recorded by the stream record at its start. 0 and 1
+  // for a WAL written as a single stream, or before the first record is read.
+  uint32_t GetWalStream() const { return wal_stream_; }
+  uint32_t GetNumWalStreams() const { return num_wal_streams_; }
+  // Sequence number of the first batch of the WAL written as several streams,
+  // unless that batch follows a gap record.
+  uint64_t GetWalStreamFirstSequence() const {
+    return wal_stream_first_sequence_;
+  }
+  // If a gap record of a WAL stream preceded the last record returned by
+  // ReadRecord(), clears it and returns true with the sequence number that
+  // would have followed the batches before the gap in `*next_sequence`.
+  virtual bool ConsumeWalStreamGap(uint64_t* next_sequence);
+
  protected:
   std::shared_ptr<Logger> info_log_;
   const std::unique_ptr<SequentialFileReader> file_;
@@ -146,6 +163,13 @@ class Reader {
   CompressionType compression_type_;
   // Track whether the compression type record has been read or not.
   bool compression_type_record_read_;
+  // Stream of the WAL held by this log and number of streams
+  uint32_t wal_stream_;
+  uint32_t num_wal_streams_;
+  uint64_t wal_stream_first_sequence_;
+  // Gap record read since the last call to ConsumeWalStreamGap()
+  bool has_wal_stream_gap_;
+  uint64_t wal_stream_gap_next_sequence_;
   StreamingUncompress* uncompress_;
   // Reusable uncompressed output buffer
   std::unique_ptr<char[]> uncompressed_buffer_;
@@ -192,6 +216,12 @@ class Reader {
   void ReportDrop(size_t bytes, const Status& reason);
 
   void InitCompression(const CompressionTypeRecord& compression_record);
+
+  // Decodes the stream record `fragment` into wal_stream_ and
+  // num_wal_streams_, reporting it as corrupted if not the first record.
+  void ReadWalStreamRecord(const Slice& fragment);
+  // Decodes the gap record `fragment` of a WAL stream
+  void ReadWalStreamGapRecord(const Slice& fragment);
 };
 
 class FragmentBufferedReader : public Reader {
@@ -223,5 +253,73 @@ class FragmentBufferedReader : public Reader {
   void operator=(const FragmentBufferedReader&);
 };
 
+// A Reader that, for a compressed log, reads and decompresses the records
+// following the first one on a separate thread, up to `max_readahead_bytes`
+// ahead of the caller, so that decompression overlaps with the caller's
+// processing of the records. Corruptions are reported to `reporter` on the
+// calling thread, in the same order as with a plain Reader. Uncompressed logs
+// are read on the calling thread.
+//
+// Only ReadRecord() may be called once the read-ahead has started, and the
+// wal_recovery_mode and the presence of record_checksum must not change
+// across calls.
+class ReadaheadReader : public Reader {
+ public:
+  ReadaheadReader(std::shared_ptr<Logger> info_log,
+                  std::unique_ptr<SequentialFileReader>&& _file,
+                  Reporter* reporter, bool checksum, uint64_t log_num,
+                  size_t max_readahead_bytes = kDefaultMaxReadaheadBytes);
+  ~ReadaheadReader() override;
+  bool ReadRecord(Slice* record, std::string* scratch,
+                  WALRecoveryMode wal_recovery_mode =
+                      WALRecoveryMode::kTolerateCorruptedTailRecords,
+                  uint64_t* record_checksum = nullptr) override;
+  bool ConsumeWalStreamGap(uint64_t* next_sequence) override;
+
+  static constexpr size_t kDefaultMaxReadaheadBytes = 4 << 20;
+
+ private:
+  // Queues the corruptions found while reading ahead, and forwards the
+  // others to the caller's reporter.
+  class QueueingReporter : public Reporter {
+   public:
+    explicit QueueingReporter(ReadaheadReader* reader) : reader_(reader) {}
+    void Corruption(size_t bytes, const Status& status) override;
+
+   private:
+    ReadaheadReader* const reader_;
+  };
+
+  // A record, or a corruption if `status` is not OK
+  struct Entry {
+    std::string record;
+    uint64_t checksum = 0;
+    size_t dropped_bytes = 0;
+    Status status;
+    bool has_wal_stream_gap = false;
+    uint64_t wal_stream_gap_next_sequence = 0;
+  };
+
+  void ReadAhead(WALRecoveryMode wal_recovery_mode, bool with_checksum);
+
+  QueueingReporter queueing_reporter_;
+  Reporter* const caller_reporter_;
+  const size_t max_readahead_bytes_;
+
+  port::Mutex mu_;
+  port::CondVar cv_;
+  // Protected by mu_ once the read-ahead thread has started
+  std::deque<Entry> entries_;
+  size_t queued_bytes_ = 0;
+  bool done_ = false;
+  bool stop_ = false;
+  bool reading_ahead_ = false;
+  port::Thread thread_;
+  // Gap record before the last record returned, once the read-ahead thread
+  // has started
+  bool has_returned_wal_stream_gap_ = false;
+  uint64_t returned_wal_stream_gap_next_sequence_ = 0;
+};
+
 }  // namespace log
 }  // namespace ROCKSDB_NAMESPACE
@@ -181,6 +181,19 @@ class LogTest
 
   Slice* get_reader_contents() { return &reader_contents_; }
 
+  // Reads the log from its start with a ReadaheadReader
+  void UseReadaheadReader(size_t max_readahead_bytes) {
+    source_ = new StringSource(reader_contents_, true);
+    std::unique_ptr<FSSequentialFile> source_holder(source_);
+    std::unique_ptr<SequentialFileReader> file_reader(
+        new SequentialFileReader(std::move(source_holder), "" /* file name */));
+    reader_.reset(new ReadaheadReader(nullptr, std::move(file_reader),
+                                      &report_, true /* checksum */,
+                                      123 /* log_number */,
+                                      max_readahead_bytes));
+    allow_retry_read_ = false;
+  }
+
   void Write(const std::string& msg) {
     ASSERT_OK(writer_->AddRecord(Slice(msg)));
   }
@@ -985,6 +998,86 @@ TEST_P(CompressionLogTest, Fragmentation) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(CompressionLogTest, ConcatenatedFrames) {
+  CompressionType compression_type = std::get<2>(GetParam());
+  if (compression_type == kNoCompression ||
+      !StreamingCompressionTypeSupported(compression_type)) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  ASSERT_OK(SetupTestEnv());
+  ASSERT_EQ(compression_type, writer_->GetCompressionType());
+  Random rnd(301);
+  const std::vector<std::string> parts = {
+      "header",
+      rnd.RandomBinaryString(3 * kBlockSize / 2),  // Spans into block 2
+      "",
+      "tail",
+  };
+  // Each part compressed independently, written as a single record
+  std::string compressed;
+  std::string expected;
+  for (const std::string& part : parts) {
+    ASSERT_OK(Writer::CompressRecordFrame(compression_type, part, &compressed));
+    expected += part;
+  }
+  ASSERT_OK(writer_->AddCompressedRecord(compressed));
+  Write("next");
+
+  ASSERT_EQ(expected, Read());
+  ASSERT_EQ("next", Read());
+  ASSERT_EQ("EOF", Read());
+}
+
+TEST_P(CompressionLogTest, Readahead) {
+  CompressionType compression_type = std::get<2>(GetParam());
+  if (!StreamingCompressionTypeSupported(compression_type)) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  ASSERT_OK(SetupTestEnv());
+  Random rnd(301);
+  std::vector<std::string> records;
+  for (int i = 0; i < 200; i++) {
+    records.push_back(
+        rnd.RandomBinaryString(i % 7 == 0 ? 2 * kBlockSize : i % 100));
+    Write(records.back());
+  }
+  // Small enough for the read-ahead to wait for the reads
+  UseReadaheadReader(kBlockSize);
+  for (const std::string& record : records) {
+    ASSERT_EQ(record, Read());
+  }
+  ASSERT_EQ("EOF", Read());
+  ASSERT_EQ("EOF", Read());
+  ASSERT_EQ(0U, DroppedBytes());
+}
+
+TEST_P(CompressionLogTest, ReadaheadReportsCorruptionInOrder) {
+  CompressionType compression_type = std::get<2>(GetParam());
+  if (!StreamingCompressionTypeSupported(compression_type)) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  ASSERT_OK(SetupTestEnv());
+  Write("first");
+  const size_t corrupted_offset = WrittenBytes() + kRecyclableHeaderSize + 10;
+  Random rnd(301);
+  Write(rnd.RandomBinaryString(kBlockSize / 2));
+  Write("last");
+  IncrementByte(static_cast<int>(corrupted_offset), 1);
+
+  UseReadaheadReader(ReadaheadReader::kDefaultMaxReadaheadBytes);
+  const WALRecoveryMode mode = WALRecoveryMode::kSkipAnyCorruptedRecords;
+  ASSERT_EQ("first", Read(mode));
+  // Reported when the reader gets past the corrupted record, even if it has
+  // already been read ahead
+  ASSERT_EQ(0U, DroppedBytes());
+  while (Read(mode) != "EOF") {
+  }
+  ASSERT_GT(DroppedBytes(), 0U);
+}
+
 INSTANTIATE_TEST_CASE_P(
     Compression, CompressionLogTest,
     ::testing::Combine(::testing::Values(0, 1), ::testing::Bool(),
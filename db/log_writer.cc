@@ -63,6 +63,52 @@ IOStatus Writer::Close() {
 
 IOStatus Writer::AddRecord(const Slice& slice,
                            Env::IOPriority rate_limiter_priority) {
+  return AddRecordInternal(slice, compress_ != nullptr, rate_limiter_priority);
+}
+
+IOStatus Writer::AddCompressedRecord(const Slice& compressed,
+                                     Env::IOPriority rate_limiter_priority) {
+  assert(compress_ != nullptr);
+  return AddRecordInternal(compressed, false /* compress */,
+                           rate_limiter_priority);
+}
+
+IOStatus Writer::CompressRecordFrame(CompressionType compression_type,
+                                     const Slice& data, std::string* frame) {
+  // Same output chunk size as the log writer uses for a single fragment
+  constexpr size_t kMaxOutputLen = kBlockSize - kHeaderSize;
+  // Streaming compressors are not thread-safe and costly to create, so each
+  // thread keeps its own.
+  static thread_local std::unique_ptr<StreamingCompress> tls_compress;
+  static thread_local CompressionType tls_compression_type = kNoCompression;
+  if (tls_compress == nullptr || tls_compression_type != compression_type) {
+    CompressionOptions opts;
+    constexpr uint32_t compression_format_version = 2;
+    tls_compress.reset(StreamingCompress::Create(
+        compression_type, opts, compression_format_version, kMaxOutputLen));
+    if (tls_compress == nullptr) {
+      return IOStatus::NotSupported("Unsupported WAL compression type");
+    }
+    tls_compression_type = compression_type;
+  }
+  tls_compress->Reset();
+  int remaining = 0;
+  do {
+    const size_t old_size = frame->size();
+    frame->resize(old_size + kMaxOutputLen);
+    size_t output_pos = 0;
+    remaining = tls_compress->Compress(data.data(), data.size(),
+                                       &(*frame)[old_size], &output_pos);
+    frame->resize(old_size + output_pos);
+    if (remaining < 0) {
+      return IOStatus::IOError("Unexpected WAL compression error");
+    }
+  } while (remaining > 0);
+  return IOStatus::OK();
+}
+
+IOStatus Writer::AddRecordInternal(const Slice& slice, bool compress,
+                                   Env::IOPriority rate_limiter_priority) {
   const char* ptr = slice.data();
   size_t left = slice.size();
 
@@ -77,7 +123,7 @@ IOStatus Writer::AddRecord(const Slice& slice,
   bool begin = true;
   int compress_remaining = 0;
   bool compress_start = false;
-  if (compress_) {
+  if (compress) {
     compress_->Reset();
     compress_start = true;
   }
@@ -109,7 +155,7 @@ IOStatus Writer::AddRecord(const Slice& slice,
     // Compress() is called at least once (compress_start=true) and after the
     // previous generated compressed chunk is written out as one or more
     // physical records (left=0).
-    if (compress_ && (compress_start || left == 0)) {
+    if (compress && (compress_start || left == 0)) {
       compress_remaining = compress_->Compress(slice.data(), slice.size(),
                                                compressed_buffer_.get(), &left);
 
@@ -194,6 +240,45 @@ IOStatus Writer::AddCompressionTypeRecord() {
   return s;
 }
 
+IOStatus Writer::AddWalStreamRecord(uint32_t stream, uint32_t num_streams,
+                                    uint64_t first_sequence) {
+  assert(stream < num_streams);
+  std::string encode;
+  PutVarint32Varint32(&encode, stream, num_streams);
+  PutVarint64(&encode, first_sequence);
+  IOStatus s = EmitPhysicalRecord(kWalStreamType, encode.data(), encode.size());
+  if (s.ok() && !manual_flush_) {
+    s = dest_->Flush();
+  }
+  return s;
+}
+
+IOStatus Writer::AddWalStreamGapRecord(uint64_t next_sequence) {
+  std::string encode;
+  PutVarint64(&encode, next_sequence);
+  // Not fragmented: switch to a new block if it does not fit. A trailer of
+  // kHeaderSize bytes or more reads as a zero length record, which is skipped
+  // with the rest of the block.
+  const int64_t leftover = kBlockSize - block_offset_;
+  assert(leftover >= 0);
+  if (leftover < static_cast<int64_t>(kHeaderSize + encode.size())) {
+    if (leftover > 0) {
+      static const char kZeroes[kHeaderSize + kMaxVarint64Length] = {};
+      IOStatus s = dest_->Append(Slice(kZeroes, static_cast<size_t>(leftover)));
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    block_offset_ = 0;
+  }
+  IOStatus s =
+      EmitPhysicalRecord(kWalStreamGapType, encode.data(), encode.size());
+  if (s.ok() && !manual_flush_) {
+    s = dest_->Flush();
+  }
+  return s;
+}
+
 bool Writer::TEST_BufferIsEmpty() { return dest_->TEST_BufferIsEmpty(); }
 
 IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n,
@@ -209,7 +294,8 @@ IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n,
   buf[6] = static_cast<char>(t);
 
   uint32_t crc = type_crc_[t];
-  if (t < kRecyclableFullType || t == kSetCompressionType) {
+  if (t < kRecyclableFullType || t == kSetCompressionType ||
+      t == kWalStreamType || t == kWalStreamGapType) {
     // Legacy record format
     assert(block_offset_ + kHeaderSize + n <= kBlockSize);
     header_size = kHeaderSize;
@@ -10,6 +10,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 
 #include "db/log_format.h"
 #include "rocksdb/compression_type.h"
@@ -85,7 +86,38 @@ class Writer {
 
   IOStatus AddRecord(const Slice& slice,
                      Env::IOPriority rate_limiter_priority = Env::IO_TOTAL);
+  // Like AddRecord(), but `compressed` is the record already compressed as
+  // one or more frames produced by CompressRecordFrame().
+  // REQUIRES: compression is enabled, i.e. GetCompressionType() is not
+  // kNoCompression.
+  IOStatus AddCompressedRecord(
+      const Slice& compressed,
+      Env::IOPriority rate_limiter_priority = Env::IO_TOTAL);
   IOStatus AddCompressionTypeRecord();
+  // Records that this log is stream `stream` of a WAL written as
+  // `num_streams` streams, whose first batch has sequence number
+  // `first_sequence` or follows a gap record. Must follow the compression type
+  // record, if any, and precede all other records.
+  IOStatus AddWalStreamRecord(uint32_t stream, uint32_t num_streams,
+                              uint64_t first_sequence);
+  // Records that the next batch of this WAL stream does not follow the last
+  // batch written to the streams of the WAL, whose sequence numbers end before
+  // `next_sequence`, as some were consumed without being logged.
+  IOStatus AddWalStreamGapRecord(uint64_t next_sequence);
+
+  // Compresses `data` into a self-contained frame of a `compression_type`
+  // compressed log stream and appends it to `*frame`. The concatenation of
+  // such frames decompresses to the concatenation of their inputs, so parts
+  // of a record can be compressed independently, and concurrently, before
+  // being written with AddCompressedRecord(). Thread-safe.
+  static IOStatus CompressRecordFrame(CompressionType compression_type,
+                                      const Slice& data, std::string* frame);
+
+  // Compression in effect for records added to this log. kNoCompression until
+  // the compression type record has been written.
+  CompressionType GetCompressionType() const {
+    return compress_ != nullptr ? compression_type_ : kNoCompression;
+  }
 
   WritableFileWriter* file() { return dest_.get(); }
   const WritableFileWriter* file() const { return dest_.get(); }
@@ -113,6 +145,11 @@ class Writer {
       RecordType type, const char* ptr, size_t length,
       Env::IOPriority rate_limiter_priority = Env::IO_TOTAL);
 
+  // Fragments `slice` into physical records, compressing it first if
+  // `compress` is true.
+  IOStatus AddRecordInternal(const Slice& slice, bool compress,
+                             Env::IOPriority rate_limiter_priority);
+
   // If true, it does not flush after each write. Instead it relies on the upper
   // layer to manually does the flush by calling ::WriteBuffer()
   bool manual_flush_;
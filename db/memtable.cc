@@ -1247,7 +1247,9 @@ void MemTable::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
 
 Status MemTable::Update(SequenceNumber seq, ValueType value_type,
                         const Slice& key, const Slice& value,
-                        const ProtectionInfoKVOS64* kv_prot_info) {
+                        const ProtectionInfoKVOS64* kv_prot_info,
+                        bool allow_concurrent,
+                        MemTablePostProcessInfo* post_process_info) {
   LookupKey lkey(key, seq);
   Slice mem_key = lkey.memtable_key();
 
@@ -1305,12 +1307,15 @@ Status MemTable::Update(SequenceNumber seq, ValueType value_type,
   }
 
   // The latest value is not value_type or key doesn't exist
-  return Add(seq, value_type, key, value, kv_prot_info);
+  return Add(seq, value_type, key, value, kv_prot_info, allow_concurrent,
+             post_process_info);
 }
 
 Status MemTable::UpdateCallback(SequenceNumber seq, const Slice& key,
                                 const Slice& delta,
-                                const ProtectionInfoKVOS64* kv_prot_info) {
+                                const ProtectionInfoKVOS64* kv_prot_info,
+                                bool allow_concurrent,
+                                MemTablePostProcessInfo* post_process_info) {
   LookupKey lkey(key, seq);
   Slice memkey = lkey.memtable_key();
 
@@ -1380,10 +1385,12 @@ Status MemTable::UpdateCallback(SequenceNumber seq, const Slice& key,
             ProtectionInfoKVOS64 updated_kv_prot_info(*kv_prot_info);
             updated_kv_prot_info.UpdateV(delta, str_value);
             s = Add(seq, kTypeValue, key, Slice(str_value),
-                    &updated_kv_prot_info);
+                    &updated_kv_prot_info, allow_concurrent,
+                    post_process_info);
           } else {
             s = Add(seq, kTypeValue, key, Slice(str_value),
-                    nullptr /* kv_prot_info */);
+                    nullptr /* kv_prot_info */, allow_concurrent,
+                    post_process_info);
           }
           RecordTick(moptions_.statistics, NUMBER_KEYS_WRITTEN);
           UpdateFlushState();
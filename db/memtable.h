@@ -294,10 +294,13 @@ class MemTable {
   // in the memtable and `MemTableRepFactory::CanHandleDuplicatedKey()` is true.
   // The next attempt should try a larger value for `seq`.
   //
-  // REQUIRES: external synchronization to prevent simultaneous
-  // operations on the same MemTable.
+  // REQUIRES: if allow_concurrent = false, external synchronization to prevent
+  // simultaneous operations on the same MemTable. Otherwise, external
+  // synchronization to prevent simultaneous operations on the same key.
   Status Update(SequenceNumber seq, ValueType value_type, const Slice& key,
-                const Slice& value, const ProtectionInfoKVOS64* kv_prot_info);
+                const Slice& value, const ProtectionInfoKVOS64* kv_prot_info,
+                bool allow_concurrent = false,
+                MemTablePostProcessInfo* post_process_info = nullptr);
 
   // If `key` exists in current memtable with type `kTypeValue` and the existing
   // value is at least as large as the new value, updates it in-place. Otherwise
@@ -311,11 +314,14 @@ class MemTable {
   // in the memtable and `MemTableRepFactory::CanHandleDuplicatedKey()` is true.
   // The next attempt should try a larger value for `seq`.
   //
-  // REQUIRES: external synchronization to prevent simultaneous
-  // operations on the same MemTable.
+  // REQUIRES: if allow_concurrent = false, external synchronization to prevent
+  // simultaneous operations on the same MemTable. Otherwise, external
+  // synchronization to prevent simultaneous operations on the same key.
   Status UpdateCallback(SequenceNumber seq, const Slice& key,
                         const Slice& delta,
-                        const ProtectionInfoKVOS64* kv_prot_info);
+                        const ProtectionInfoKVOS64* kv_prot_info,
+                        bool allow_concurrent = false,
+                        MemTablePostProcessInfo* post_process_info = nullptr);
 
   // Returns the number of successive merge entries starting from the newest
   // entry for the key up to the last non-merge entry or last entry for the
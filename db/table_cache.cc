@@ -644,6 +644,51 @@ Status TableCache::ApproximateKeyAnchors(
   return s;
 }
 
+Status TableCache::GetDataBlocks(
+    const ReadOptions& ro, const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta,
+    std::vector<TableReader::DataBlock>* blocks) {
+  Status s;
+  TableReader* t = file_meta.fd.table_reader;
+  Cache::Handle* handle = nullptr;
+  if (t == nullptr) {
+    s = FindTable(ro, file_options_, internal_comparator, file_meta, &handle);
+    if (s.ok()) {
+      t = GetTableReaderFromHandle(handle);
+    }
+  }
+  if (s.ok() && t != nullptr) {
+    s = t->GetDataBlocks(ro, blocks);
+  }
+  if (handle != nullptr) {
+    ReleaseHandle(handle);
+  }
+  return s;
+}
+
+Status TableCache::ReadRawDataBlock(
+    const ReadOptions& ro, const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta, const BlockHandle& handle,
+    TableReader::RawDataBlock* block) {
+  Status s;
+  TableReader* t = file_meta.fd.table_reader;
+  Cache::Handle* table_handle = nullptr;
+  if (t == nullptr) {
+    s = FindTable(ro, file_options_, internal_comparator, file_meta,
+                  &table_handle);
+    if (s.ok()) {
+      t = GetTableReaderFromHandle(table_handle);
+    }
+  }
+  if (s.ok() && t != nullptr) {
+    s = t->ReadRawDataBlock(ro, handle, block);
+  }
+  if (table_handle != nullptr) {
+    ReleaseHandle(table_handle);
+  }
+  return s;
+}
+
 size_t TableCache::GetMemoryUsageByTableReader(
     const FileOptions& file_options,
     const InternalKeyComparator& internal_comparator,
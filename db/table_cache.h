@@ -190,6 +190,20 @@ class TableCache {
                                const FileMetaData& file_meta,
                                std::vector<TableReader::Anchor>& anchors);
 
+  // Returns the data blocks of the file, see TableReader::GetDataBlocks().
+  Status GetDataBlocks(const ReadOptions& ro,
+                       const InternalKeyComparator& internal_comparator,
+                       const FileMetaData& file_meta,
+                       std::vector<TableReader::DataBlock>* blocks);
+
+  // Reads a data block of the file as stored, see
+  // TableReader::ReadRawDataBlock().
+  Status ReadRawDataBlock(const ReadOptions& ro,
+                          const InternalKeyComparator& internal_comparator,
+                          const FileMetaData& file_meta,
+                          const BlockHandle& handle,
+                          TableReader::RawDataBlock* block);
+
   // Return total memory usage of the table reader of the file.
   // 0 if table reader of the file is not loaded.
   size_t GetMemoryUsageByTableReader(
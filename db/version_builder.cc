@@ -251,6 +251,9 @@ class VersionBuilder::Rep {
   std::unordered_map<uint64_t, int> table_file_levels_;
   // Current compact cursors that should be changed after the last compaction
   std::unordered_map<int, InternalKey> updated_compact_cursors_;
+  // The same for the other cursors of each level, keyed by (level, index)
+  std::map<std::pair<int, uint32_t>, InternalKey>
+      updated_indexed_compact_cursors_;
   NewestFirstBySeqNo level_zero_cmp_;
   BySmallestKey level_nonzero_cmp_;
 
@@ -811,7 +814,7 @@ class VersionBuilder::Rep {
     return Status::OK();
   }
 
-  Status ApplyCompactCursors(int level,
+  Status ApplyCompactCursors(int level, uint32_t index,
                              const InternalKey& smallest_uncompacted_key) {
     if (level < 0) {
       std::ostringstream oss;
@@ -822,7 +825,12 @@ class VersionBuilder::Rep {
     }
     if (level < num_levels_) {
       // Omit levels (>= num_levels_) when re-open with shrinking num_levels_
-      updated_compact_cursors_[level] = smallest_uncompacted_key;
+      if (index == 0) {
+        updated_compact_cursors_[level] = smallest_uncompacted_key;
+      } else {
+        updated_indexed_compact_cursors_[std::make_pair(level, index)] =
+            smallest_uncompacted_key;
+      }
     }
     return Status::OK();
   }
@@ -883,7 +891,15 @@ class VersionBuilder::Rep {
     for (const auto& cursor : edit->GetCompactCursors()) {
       const int level = cursor.first;
       const InternalKey smallest_uncompacted_key = cursor.second;
-      const Status s = ApplyCompactCursors(level, smallest_uncompacted_key);
+      const Status s =
+          ApplyCompactCursors(level, /*index=*/0, smallest_uncompacted_key);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    for (const auto& cursor : edit->GetIndexedCompactCursors()) {
+      const Status s =
+          ApplyCompactCursors(cursor.level, cursor.index, cursor.cursor);
       if (!s.ok()) {
         return s;
       }
@@ -1175,6 +1191,10 @@ class VersionBuilder::Rep {
          iter != updated_compact_cursors_.end(); iter++) {
       vstorage->AddCursorForOneLevel(iter->first, iter->second);
     }
+    for (const auto& cursor : updated_indexed_compact_cursors_) {
+      vstorage->AddCursorForOneLevel(cursor.first.first, cursor.first.second,
+                                     cursor.second);
+    }
   }
 
   // Save the current state in *vstorage.
@@ -80,6 +80,7 @@ void VersionEdit::Clear() {
   has_min_log_number_to_keep_ = false;
   has_last_sequence_ = false;
   compact_cursors_.clear();
+  indexed_compact_cursors_.clear();
   deleted_files_.clear();
   new_files_.clear();
   blob_file_additions_.clear();
@@ -171,6 +172,8 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
     //   tag kPathId: 1 byte as path_id
     //   tag kNeedCompaction:
     //        now only can take one char value 1 indicating need-compaction
+    //   tag kTimeWindowCompacted:
+    //        only takes one char value 1 indicating time-window-compacted
     //
     PutVarint32(dst, NewFileCustomTag::kOldestAncesterTime);
     std::string varint_oldest_ancester_time;
@@ -207,6 +210,11 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
       char p = static_cast<char>(1);
       PutLengthPrefixedSlice(dst, Slice(&p, 1));
     }
+    if (f.time_window_compacted) {
+      PutVarint32(dst, NewFileCustomTag::kTimeWindowCompacted);
+      char p = static_cast<char>(1);
+      PutLengthPrefixedSlice(dst, Slice(&p, 1));
+    }
     if (has_min_log_number_to_keep_ && !min_log_num_written) {
       PutVarint32(dst, NewFileCustomTag::kMinLogNumberToKeepHack);
       std::string varint_log_number;
@@ -281,6 +289,17 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
     PutVarint32(dst, kFullHistoryTsLow);
     PutLengthPrefixedSlice(dst, full_history_ts_low_);
   }
+
+  for (const auto& indexed_cursor : indexed_compact_cursors_) {
+    if (indexed_cursor.cursor.Valid()) {
+      PutVarint32(dst, kIndexedCompactCursor);
+      std::string encoded;
+      PutVarint32Varint32(&encoded, indexed_cursor.level,
+                          indexed_cursor.index);
+      PutLengthPrefixedSlice(&encoded, indexed_cursor.cursor.Encode());
+      PutLengthPrefixedSlice(dst, encoded);
+    }
+  }
   return true;
 }
 
@@ -366,6 +385,12 @@ const char* VersionEdit::DecodeNewFile4From(Slice* input) {
           }
           f.marked_for_compaction = (field[0] == 1);
           break;
+        case kTimeWindowCompacted:
+          if (field.size() != 1) {
+            return "time_window_compacted field wrong size";
+          }
+          f.time_window_compacted = (field[0] == 1);
+          break;
         case kMinLogNumberToKeepHack:
           // This is a hack to encode kMinLogNumberToKeep in a
           // forward-compatible fashion.
@@ -713,6 +738,18 @@ Status VersionEdit::DecodeFrom(const Slice& src) {
         }
         break;
 
+      case kIndexedCompactCursor: {
+        uint32_t index = 0;
+        if (GetLengthPrefixedSlice(&input, &str) &&
+            GetLevel(&str, &level, &msg) && GetVarint32(&str, &index) &&
+            index > 0 && GetInternalKey(&str, &key)) {
+          indexed_compact_cursors_.emplace_back(level, index, key);
+        } else if (!msg) {
+          msg = "indexed compaction cursor";
+        }
+        break;
+      }
+
       default:
         if (tag & kTagSafeIgnoreMask) {
           // Tag from future which can be safely ignored.
@@ -785,6 +822,14 @@ std::string VersionEdit::DebugString(bool hex_key) const {
     r.append(" ");
     r.append(level_and_compact_cursor.second.DebugString(hex_key));
   }
+  for (const auto& indexed_cursor : indexed_compact_cursors_) {
+    r.append("\n  CompactCursor: ");
+    AppendNumberTo(&r, indexed_cursor.level);
+    r.append(" ");
+    AppendNumberTo(&r, indexed_cursor.index);
+    r.append(" ");
+    r.append(indexed_cursor.cursor.DebugString(hex_key));
+  }
   for (const auto& deleted_file : deleted_files_) {
     r.append("\n  DeleteFile: ");
     AppendNumberTo(&r, deleted_file.first);
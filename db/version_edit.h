@@ -70,6 +70,7 @@ enum Tag : uint32_t {
   kFullHistoryTsLow,
   kWalAddition2,
   kWalDeletion2,
+  kIndexedCompactCursor,
 };
 
 enum NewFileCustomTag : uint32_t {
@@ -88,6 +89,7 @@ enum NewFileCustomTag : uint32_t {
   kMinTimestamp = 10,
   kMaxTimestamp = 11,
   kUniqueId = 12,
+  kTimeWindowCompacted = 13,
 
   // If this bit for the custom tag is set, opening DB should fail if
   // we don't know this field.
@@ -153,15 +155,19 @@ struct FileDescriptor {
 };
 
 struct FileSampledStats {
-  FileSampledStats() : num_reads_sampled(0) {}
+  FileSampledStats() : num_reads_sampled(0), num_scans_sampled(0) {}
   FileSampledStats(const FileSampledStats& other) { *this = other; }
   FileSampledStats& operator=(const FileSampledStats& other) {
     num_reads_sampled = other.num_reads_sampled.load();
+    num_scans_sampled = other.num_scans_sampled.load();
     return *this;
   }
 
   // number of user reads to this file.
   mutable std::atomic<uint64_t> num_reads_sampled;
+  // number of user reads to this file by iterators, included in
+  // num_reads_sampled.
+  mutable std::atomic<uint64_t> num_scans_sampled;
 };
 
 struct FileMetaData {
@@ -195,6 +201,9 @@ struct FileMetaData {
 
   bool marked_for_compaction = false;  // True if client asked us nicely to
                                        // compact this file.
+  // True if the file is the output of a FIFO time-window compaction, so the
+  // files of its time window need not be compacted again.
+  bool time_window_compacted = false;
   Temperature temperature = Temperature::kUnknown;
 
   // Used only in BlobDB. The file number of the oldest blob file this SST file
@@ -470,6 +479,46 @@ class VersionEdit {
     }
   }
 
+  // Retrieve the round-robin compact cursors other than the first one of
+  // their level (see round_robin_cursors_per_level). The first cursors are
+  // the ones in GetCompactCursors(), and are written the way older releases
+  // can read them.
+  struct IndexedCompactCursor {
+    IndexedCompactCursor(int _level, uint32_t _index,
+                         const InternalKey& _cursor)
+        : level(_level), index(_index), cursor(_cursor) {}
+    int level;
+    // Always greater than 0
+    uint32_t index;
+    InternalKey cursor;
+  };
+  using IndexedCompactCursors = std::vector<IndexedCompactCursor>;
+  const IndexedCompactCursors& GetIndexedCompactCursors() const {
+    return indexed_compact_cursors_;
+  }
+  // Adds cursor `index` of `level`
+  void AddCompactCursor(int level, uint32_t index,
+                        const InternalKey& cursor) {
+    if (index == 0) {
+      AddCompactCursor(level, cursor);
+    } else {
+      indexed_compact_cursors_.emplace_back(level, index, cursor);
+    }
+  }
+  // `cursors_by_level[level][i]` is cursor i + 1 of `level`
+  void SetIndexedCompactCursors(
+      const std::vector<std::vector<InternalKey>>& cursors_by_level) {
+    indexed_compact_cursors_.clear();
+    for (int i = 0; i < (int)cursors_by_level.size(); i++) {
+      for (size_t j = 0; j < cursors_by_level[i].size(); j++) {
+        if (cursors_by_level[i][j].Valid()) {
+          indexed_compact_cursors_.emplace_back(
+              i, static_cast<uint32_t>(j + 1), cursors_by_level[i][j]);
+        }
+      }
+    }
+  }
+
   // Add a new blob file.
   void AddBlobFile(uint64_t blob_file_number, uint64_t total_blob_count,
                    uint64_t total_blob_bytes, std::string checksum_method,
@@ -644,6 +693,7 @@ class VersionEdit {
 
   // Compaction cursors for round-robin compaction policy
   CompactCursors compact_cursors_;
+  IndexedCompactCursors indexed_compact_cursors_;
 
   DeletedFiles deleted_files_;
   NewFiles new_files_;
@@ -114,6 +114,30 @@ TEST_F(VersionEditTest, EncodeDecodeNewFile4) {
   ASSERT_EQ(1001, new_files[3].second.oldest_blob_file_number);
 }
 
+TEST_F(VersionEditTest, EncodeDecodeTimeWindowCompacted) {
+  VersionEdit edit;
+  FileMetaData f(300, 0, 100, InternalKey("foo", 500, kTypeValue),
+                 InternalKey("zoo", 600, kTypeValue), 500, 600, false,
+                 Temperature::kUnknown, kInvalidBlobFileNumber, 666, 888,
+                 kUnknownFileChecksum, kUnknownFileChecksumFuncName,
+                 kNullUniqueId64x2);
+  f.time_window_compacted = true;
+  edit.AddFile(0, f);
+  f.fd = FileDescriptor(301, 0, 100, 500, 600);
+  f.time_window_compacted = false;
+  edit.AddFile(0, f);
+  TestEncodeDecode(edit);
+
+  std::string encoded;
+  edit.EncodeTo(&encoded);
+  VersionEdit parsed;
+  Status s = parsed.DecodeFrom(encoded);
+  ASSERT_TRUE(s.ok()) << s.ToString();
+  auto& new_files = parsed.GetNewFiles();
+  ASSERT_TRUE(new_files[0].second.time_window_compacted);
+  ASSERT_FALSE(new_files[1].second.time_window_compacted);
+}
+
 TEST_F(VersionEditTest, ForwardCompatibleNewFile4) {
   static const uint64_t kBig = 1ull << 50;
   VersionEdit edit;
@@ -1100,7 +1100,7 @@ class LevelIterator final : public InternalIterator {
     assert(file_index_ < flevel_->num_files);
     auto file_meta = flevel_->files[file_index_];
     if (should_sample_) {
-      sample_file_read_inc(file_meta.file_metadata);
+      sample_file_scan_inc(file_meta.file_metadata);
     }
 
     const InternalKey* smallest_compaction_key = nullptr;
@@ -1948,7 +1948,7 @@ void Version::AddIteratorsForLevel(const ReadOptions& read_options,
       // If users execute one range query per iterator, there may be some
       // discrepancy here.
       for (FileMetaData* meta : storage_info_.LevelFiles(0)) {
-        sample_file_read_inc(meta);
+        sample_file_scan_inc(meta);
       }
     }
   } else if (storage_info_.LevelFilesBrief(level).num_files > 0) {
@@ -2049,6 +2049,7 @@ VersionStorageInfo::VersionStorageInfo(
       compaction_level_(num_levels_),
       l0_delay_trigger_count_(0),
       compact_cursor_(num_levels_),
+      extra_compact_cursors_(num_levels_),
       accumulated_file_size_(0),
       accumulated_raw_key_size_(0),
       accumulated_raw_value_size_(0),
@@ -2073,6 +2074,8 @@ VersionStorageInfo::VersionStorageInfo(
     oldest_snapshot_seqnum_ = ref_vstorage->oldest_snapshot_seqnum_;
     compact_cursor_ = ref_vstorage->compact_cursor_;
     compact_cursor_.resize(num_levels_);
+    extra_compact_cursors_ = ref_vstorage->extra_compact_cursors_;
+    extra_compact_cursors_.resize(num_levels_);
   }
 }
 
@@ -3127,11 +3130,21 @@ uint32_t GetExpiredTtlFilesCount(const ImmutableOptions& ioptions,
   auto status = ioptions.clock->GetCurrentTime(&_current_time);
   if (status.ok()) {
     const uint64_t current_time = static_cast<uint64_t>(_current_time);
+    const uint64_t time_window_seconds =
+        mutable_cf_options.compaction_options_fifo.time_window_seconds;
     for (FileMetaData* f : files) {
       if (!f->being_compacted) {
         uint64_t oldest_ancester_time = f->TryGetOldestAncesterTime();
+        uint64_t expiration_time = oldest_ancester_time;
+        if (time_window_seconds > 0) {
+          // FIFO time windows expire as a whole, once the end of the window
+          // is older than ttl. See FIFOCompactionPicker::PickTTLCompaction.
+          expiration_time =
+              (oldest_ancester_time / time_window_seconds + 1) *
+              time_window_seconds;
+        }
         if (oldest_ancester_time != 0 &&
-            oldest_ancester_time < (current_time - mutable_cf_options.ttl)) {
+            expiration_time < (current_time - mutable_cf_options.ttl)) {
           ttl_expired_files_count++;
         }
       }
@@ -3197,7 +3210,9 @@ void VersionStorageInfo::ComputeCompactionScore(
         score = static_cast<double>(total_size) /
                 mutable_cf_options.compaction_options_fifo.max_table_files_size;
         if (mutable_cf_options.compaction_options_fifo.allow_compaction ||
-            mutable_cf_options.compaction_options_fifo.age_for_warm > 0) {
+            mutable_cf_options.compaction_options_fifo.age_for_warm > 0 ||
+            mutable_cf_options.compaction_options_fifo.time_window_seconds >
+                0) {
           // Warm tier move can happen at any time. It's too expensive to
           // check very file's timestamp now. For now, just trigger it
           // slightly more frequently than FIFO compaction so that this
@@ -3824,6 +3839,21 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
   }
 }
 
+InternalKey VersionStorageInfo::GetNextCompactCursor(
+    int level, const std::vector<FileMetaData*>& files) const {
+  const std::vector<FileMetaData*>& level_files = files_[level];
+  assert(!files.empty());
+  assert(!level_files.empty());
+  // Input files are sorted like the files of the level, so the last of them
+  // is the one with the largest keys.
+  auto it = std::find(level_files.begin(), level_files.end(), files.back());
+  assert(it != level_files.end());
+  if (it == level_files.end() || ++it == level_files.end()) {
+    return level_files.front()->smallest;
+  }
+  return (*it)->smallest;
+}
+
 void VersionStorageInfo::GenerateLevel0NonOverlapping() {
   assert(!finalized_);
   level0_non_overlapping_ = true;
@@ -6060,6 +6090,7 @@ Status VersionSet::WriteCurrentStateToManifest(
       }
 
       edit.SetCompactCursors(vstorage->GetCompactCursors());
+      edit.SetIndexedCompactCursors(vstorage->GetExtraCompactCursors());
 
       const auto& blob_files = vstorage->GetBlobFiles();
       for (const auto& meta : blob_files) {
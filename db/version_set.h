@@ -139,6 +139,7 @@ class VersionStorageInfo {
   // Resize/Initialize the space for compact_cursor_
   void ResizeCompactCursors(int level) {
     compact_cursor_.resize(level, InternalKey());
+    extra_compact_cursors_.resize(level);
   }
 
   const std::vector<InternalKey>& GetCompactCursors() const {
@@ -151,6 +152,42 @@ class VersionStorageInfo {
     compact_cursor_[level] = smallest_uncompacted_key;
   }
 
+  // Cursor `index` of `level`, when round_robin_cursors_per_level allows more
+  // than one cursor per level. `[level][i]` holds cursor i + 1.
+  const std::vector<std::vector<InternalKey>>& GetExtraCompactCursors() const {
+    return extra_compact_cursors_;
+  }
+
+  // Returns an invalid key if the cursor has never been set
+  InternalKey GetCompactCursor(int level, uint32_t index) const {
+    if (index == 0) {
+      return compact_cursor_[level];
+    }
+    const auto& extra = extra_compact_cursors_[level];
+    return index <= extra.size() ? extra[index - 1] : InternalKey();
+  }
+
+  // REQUIRES: ResizeCompactCursors has been called
+  void AddCursorForOneLevel(int level, uint32_t index,
+                            const InternalKey& smallest_uncompacted_key) {
+    if (index == 0) {
+      AddCursorForOneLevel(level, smallest_uncompacted_key);
+      return;
+    }
+    auto& extra = extra_compact_cursors_[level];
+    if (extra.size() < index) {
+      extra.resize(index);
+    }
+    extra[index - 1] = smallest_uncompacted_key;
+  }
+
+  // REQUIRES: lock is held
+  // Returns the cursor that follows a compaction of `files` of `level`, which
+  // is the smallest key of the file right after the last of them in key
+  // order, wrapping around to the first file of the level.
+  InternalKey GetNextCompactCursor(
+      int level, const std::vector<FileMetaData*>& files) const;
+
   // REQUIRES: lock is held
   // Update the compact cursor and advance the file index using increment
   // so that it can point to the next cursor (increment means the number of
@@ -697,6 +734,8 @@ class VersionStorageInfo {
 
   // Compact cursors for round-robin compactions in each level
   std::vector<InternalKey> compact_cursor_;
+  // The other cursors of each level if there are multiple of them
+  std::vector<std::vector<InternalKey>> extra_compact_cursors_;
 
   // the following are the sampled temporary stats.
   // the current accumulated size of sampled files.
@@ -722,6 +722,153 @@ void WriteBatchInternal::SetAsLatestPersistentState(WriteBatch* b) {
   b->is_latest_persistent_state_ = true;
 }
 
+namespace {
+// Collects the keys a write batch writes to column families with
+// inplace_update_support, failing with `Status::Busy` on a range deletion of
+// such a column family.
+class InplaceUpdateKeyCollector : public WriteBatch::Handler {
+ public:
+  InplaceUpdateKeyCollector(
+      ColumnFamilySet* column_family_set, size_t batch,
+      std::vector<WriteBatchInternal::InplaceUpdateKey>* keys)
+      : column_family_set_(column_family_set), batch_(batch), keys_(keys) {}
+
+  Status PutCF(uint32_t column_family_id, const Slice& key,
+               const Slice& /*value*/) override {
+    return Record(column_family_id, key);
+  }
+
+  Status PutEntityCF(uint32_t column_family_id, const Slice& key,
+                     const Slice& /*entity*/) override {
+    return Record(column_family_id, key);
+  }
+
+  Status DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return Record(column_family_id, key);
+  }
+
+  Status SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return Record(column_family_id, key);
+  }
+
+  Status DeleteRangeCF(uint32_t column_family_id, const Slice& /*begin_key*/,
+                       const Slice& /*end_key*/) override {
+    // A range may cover keys written by any other batch.
+    return IsInplaceUpdateColumnFamily(column_family_id) ? Status::Busy()
+                                                          : Status::OK();
+  }
+
+  Status MergeCF(uint32_t column_family_id, const Slice& key,
+                 const Slice& /*value*/) override {
+    return Record(column_family_id, key);
+  }
+
+  Status PutBlobIndexCF(uint32_t column_family_id, const Slice& key,
+                        const Slice& /*value*/) override {
+    return Record(column_family_id, key);
+  }
+
+ private:
+  bool IsInplaceUpdateColumnFamily(uint32_t column_family_id) {
+    if (column_family_id != last_column_family_id_) {
+      ColumnFamilyData* cfd =
+          column_family_set_->GetColumnFamily(column_family_id);
+      last_column_family_id_ = column_family_id;
+      last_inplace_update_support_ =
+          cfd != nullptr && cfd->ioptions()->inplace_update_support;
+    }
+    return last_inplace_update_support_;
+  }
+
+  Status Record(uint32_t column_family_id, const Slice& key) {
+    if (IsInplaceUpdateColumnFamily(column_family_id)) {
+      keys_->push_back({column_family_id, key, batch_});
+    }
+    return Status::OK();
+  }
+
+  ColumnFamilySet* const column_family_set_;
+  const size_t batch_;
+  std::vector<WriteBatchInternal::InplaceUpdateKey>* const keys_;
+  uint32_t last_column_family_id_ = std::numeric_limits<uint32_t>::max();
+  bool last_inplace_update_support_ = false;
+};
+}  // namespace
+
+bool WriteBatchInternal::CollectInplaceUpdateKeys(
+    const WriteBatch* b, ColumnFamilySet* column_family_set, size_t batch,
+    std::vector<InplaceUpdateKey>* keys) {
+  InplaceUpdateKeyCollector collector(column_family_set, batch, keys);
+  return b->Iterate(&collector).ok();
+}
+
+namespace {
+// Collects the WAL streams of the column families a batch writes to.
+class WalStreamCollector : public WriteBatch::Handler {
+ public:
+  explicit WalStreamCollector(uint32_t num_streams)
+      : num_streams_(num_streams) {}
+
+  Status PutCF(uint32_t column_family_id, const Slice& /*key*/,
+               const Slice& /*value*/) override {
+    return Record(column_family_id);
+  }
+
+  Status PutEntityCF(uint32_t column_family_id, const Slice& /*key*/,
+                     const Slice& /*entity*/) override {
+    return Record(column_family_id);
+  }
+
+  Status DeleteCF(uint32_t column_family_id, const Slice& /*key*/) override {
+    return Record(column_family_id);
+  }
+
+  Status SingleDeleteCF(uint32_t column_family_id,
+                        const Slice& /*key*/) override {
+    return Record(column_family_id);
+  }
+
+  Status DeleteRangeCF(uint32_t column_family_id, const Slice& /*begin_key*/,
+                       const Slice& /*end_key*/) override {
+    return Record(column_family_id);
+  }
+
+  Status MergeCF(uint32_t column_family_id, const Slice& /*key*/,
+                 const Slice& /*value*/) override {
+    return Record(column_family_id);
+  }
+
+  Status PutBlobIndexCF(uint32_t column_family_id, const Slice& /*key*/,
+                        const Slice& /*value*/) override {
+    return Record(column_family_id);
+  }
+
+  Status MarkNoop(bool /*empty_batch*/) override { return Status::OK(); }
+
+  uint64_t streams() const { return streams_; }
+
+ private:
+  Status Record(uint32_t column_family_id) {
+    streams_ |= uint64_t{1} << (column_family_id % num_streams_);
+    return Status::OK();
+  }
+
+  const uint32_t num_streams_;
+  uint64_t streams_ = 0;
+};
+}  // namespace
+
+uint64_t WriteBatchInternal::GetWalStreams(const WriteBatch* b,
+                                           uint32_t num_streams) {
+  assert(num_streams > 0 && num_streams <= 64);
+  WalStreamCollector collector(num_streams);
+  if (!b->Iterate(&collector).ok()) {
+    // Left for the write path to fail, in the first stream
+    return 0;
+  }
+  return collector.streams();
+}
+
 uint32_t WriteBatchInternal::Count(const WriteBatch* b) {
   return DecodeFixed32(b->rep_.data() + 8);
 }
@@ -1888,6 +2035,24 @@ class MemTableInserter : public WriteBatch::Handler {
     }
   }
 
+  // Makes the write at `sequence_` visible to read-your-writes sessions of
+  // `db_`, if there are any.
+  void RecordKeyWrite(uint32_t column_family_id, const Slice& key) {
+    KeyWriteTracker* tracker =
+        db_ != nullptr ? db_->key_write_tracker() : nullptr;
+    if (tracker != nullptr) {
+      tracker->RecordWrite(column_family_id, key, sequence_);
+    }
+  }
+
+  void RecordWriteToAllKeys() {
+    KeyWriteTracker* tracker =
+        db_ != nullptr ? db_->key_write_tracker() : nullptr;
+    if (tracker != nullptr) {
+      tracker->RecordWriteToAllKeys(sequence_);
+    }
+  }
+
   void set_log_number_ref(uint64_t log) { log_number_ref_ = log; }
   void set_prot_info(const WriteBatch::ProtectionInfo* prot_info) {
     prot_info_ = prot_info;
@@ -1989,12 +2154,16 @@ class MemTableInserter : public WriteBatch::Handler {
                    hint_per_batch_ ? &GetHintMap()[mem] : nullptr);
     } else if (moptions->inplace_callback == nullptr ||
                value_type != kTypeValue) {
-      assert(!concurrent_memtable_writes_);
-      ret_status = mem->Update(sequence_, value_type, key, value, kv_prot_info);
+      // With concurrent memtable writes, the write group leader guarantees no
+      // other writer touches this key (see DBImpl::WriteImpl).
+      ret_status = mem->Update(sequence_, value_type, key, value, kv_prot_info,
+                               concurrent_memtable_writes_,
+                               get_post_process_info(mem));
     } else {
-      assert(!concurrent_memtable_writes_);
       assert(value_type == kTypeValue);
-      ret_status = mem->UpdateCallback(sequence_, key, value, kv_prot_info);
+      ret_status = mem->UpdateCallback(sequence_, key, value, kv_prot_info,
+                                       concurrent_memtable_writes_,
+                                       get_post_process_info(mem));
       if (ret_status.IsNotFound()) {
         // key not found in memtable. Do sst get, update, add
         SnapshotImpl read_from_snapshot;
@@ -2041,13 +2210,15 @@ class MemTableInserter : public WriteBatch::Handler {
               updated_kv_prot_info.UpdateV(value,
                                            Slice(prev_buffer, prev_size));
               // prev_value is updated in-place with final value.
-              ret_status = mem->Add(sequence_, value_type, key,
-                                    Slice(prev_buffer, prev_size),
-                                    &updated_kv_prot_info);
+              ret_status = mem->Add(
+                  sequence_, value_type, key, Slice(prev_buffer, prev_size),
+                  &updated_kv_prot_info, concurrent_memtable_writes_,
+                  get_post_process_info(mem));
             } else {
-              ret_status = mem->Add(sequence_, value_type, key,
-                                    Slice(prev_buffer, prev_size),
-                                    nullptr /* kv_prot_info */);
+              ret_status = mem->Add(
+                  sequence_, value_type, key, Slice(prev_buffer, prev_size),
+                  nullptr /* kv_prot_info */, concurrent_memtable_writes_,
+                  get_post_process_info(mem));
             }
             if (ret_status.ok()) {
               RecordTick(moptions->statistics, NUMBER_KEYS_WRITTEN);
@@ -2058,12 +2229,16 @@ class MemTableInserter : public WriteBatch::Handler {
               updated_kv_prot_info.UpdateV(value, merged_value);
               // merged_value contains the final value.
               ret_status = mem->Add(sequence_, value_type, key,
-                                    Slice(merged_value), &updated_kv_prot_info);
+                                    Slice(merged_value), &updated_kv_prot_info,
+                                    concurrent_memtable_writes_,
+                                    get_post_process_info(mem));
             } else {
               // merged_value contains the final value.
               ret_status =
                   mem->Add(sequence_, value_type, key, Slice(merged_value),
-                           nullptr /* kv_prot_info */);
+                           nullptr /* kv_prot_info */,
+                           concurrent_memtable_writes_,
+                           get_post_process_info(mem));
             }
             if (ret_status.ok()) {
               RecordTick(moptions->statistics, NUMBER_KEYS_WRITTEN);
@@ -2077,6 +2252,7 @@ class MemTableInserter : public WriteBatch::Handler {
       const bool kBatchBoundary = true;
       MaybeAdvanceSeq(kBatchBoundary);
     } else if (ret_status.ok()) {
+      RecordKeyWrite(column_family_id, key);
       MaybeAdvanceSeq();
       CheckMemtableFull();
     }
@@ -2141,7 +2317,7 @@ class MemTableInserter : public WriteBatch::Handler {
     return s;
   }
 
-  Status DeleteImpl(uint32_t /*column_family_id*/, const Slice& key,
+  Status DeleteImpl(uint32_t column_family_id, const Slice& key,
                     const Slice& value, ValueType delete_type,
                     const ProtectionInfoKVOS64* kv_prot_info) {
     Status ret_status;
@@ -2155,6 +2331,11 @@ class MemTableInserter : public WriteBatch::Handler {
       const bool kBatchBoundary = true;
       MaybeAdvanceSeq(kBatchBoundary);
     } else if (ret_status.ok()) {
+      if (delete_type == kTypeRangeDeletion) {
+        RecordWriteToAllKeys();
+      } else {
+        RecordKeyWrite(column_family_id, key);
+      }
       MaybeAdvanceSeq();
       CheckMemtableFull();
     }
@@ -2508,6 +2689,7 @@ class MemTableInserter : public WriteBatch::Handler {
       const bool kBatchBoundary = true;
       MaybeAdvanceSeq(kBatchBoundary);
     } else if (ret_status.ok()) {
+      RecordKeyWrite(column_family_id, key);
       MaybeAdvanceSeq();
       CheckMemtableFull();
     }
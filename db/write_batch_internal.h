@@ -27,6 +27,7 @@ namespace ROCKSDB_NAMESPACE {
 class MemTable;
 class FlushScheduler;
 class ColumnFamilyData;
+class ColumnFamilySet;
 
 class ColumnFamilyMemTables {
  public:
@@ -229,6 +230,29 @@ class WriteBatchInternal {
   static void SetAsLatestPersistentState(WriteBatch* b);
   static bool IsLatestPersistentState(const WriteBatch* b);
 
+  // A key written by a batch of a write group to a column family with
+  // inplace_update_support
+  struct InplaceUpdateKey {
+    uint32_t column_family_id;
+    Slice key;  // points into the batch
+    size_t batch;  // index of the batch in the write group
+  };
+
+  // Appends the keys `b` writes to column families with
+  // inplace_update_support to `*keys`, tagged with `batch`. Returns false if
+  // the keys of `b` cannot be told, as `b` deletes a range of such a column
+  // family or cannot be iterated. REQUIRES: DB mutex held or called from a
+  // write thread.
+  static bool CollectInplaceUpdateKeys(const WriteBatch* b,
+                                       ColumnFamilySet* column_family_set,
+                                       size_t batch,
+                                       std::vector<InplaceUpdateKey>* keys);
+
+  // Returns the WAL streams `b` writes to out of `num_streams`, one bit per
+  // stream, the column family with ID `id` being logged to stream
+  // `id % num_streams`. 0 if `b` writes to no column family.
+  static uint64_t GetWalStreams(const WriteBatch* b, uint32_t num_streams);
+
   static std::tuple<Status, uint32_t, size_t> GetColumnFamilyIdAndTimestampSize(
       WriteBatch* b, ColumnFamilyHandle* column_family);
 
@@ -11,6 +11,7 @@
 #include <condition_variable>
 #include <cstdint>
 #include <mutex>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -126,6 +127,9 @@ class WriteThread {
     PostMemTableCallback* post_memtable_callback;
     uint64_t log_used;  // log number that this batch was inserted into
     uint64_t log_ref;   // log number that memtable insert should reference
+    // WAL streams the batch writes to, one bit per stream, when
+    // DBOptions::num_wal_streams > 1
+    uint64_t wal_streams;
     WriteCallback* callback;
     bool made_waitable;          // records lazy construction of mutex and cv
     std::atomic<uint8_t> state;  // write under StateMutex() or pre-link
@@ -133,6 +137,12 @@ class WriteThread {
     SequenceNumber sequence;  // the sequence number to use for the first key
     Status status;
     Status callback_status;  // status returned by callback->Callback()
+    // batch contents past the header, compressed as a WAL frame by the
+    // writing thread. Empty if the leader should compress them.
+    std::string compressed_wal_frame;
+    // in a parallel memtable write group, the batch is inserted into
+    // memtables by the leader before the parallel writers are launched
+    bool insert_by_leader;
 
     std::aligned_storage<sizeof(std::mutex)>::type state_mutex_bytes;
     std::aligned_storage<sizeof(std::condition_variable)>::type state_cv_bytes;
@@ -152,11 +162,13 @@ class WriteThread {
           post_memtable_callback(nullptr),
           log_used(0),
           log_ref(0),
+          wal_streams(0),
           callback(nullptr),
           made_waitable(false),
           state(STATE_INIT),
           write_group(nullptr),
           sequence(kMaxSequenceNumber),
+          insert_by_leader(false),
           link_older(nullptr),
           link_newer(nullptr) {}
 
@@ -177,11 +189,13 @@ class WriteThread {
           post_memtable_callback(_post_memtable_callback),
           log_used(0),
           log_ref(_log_ref),
+          wal_streams(0),
           callback(_callback),
           made_waitable(false),
           state(STATE_INIT),
           write_group(nullptr),
           sequence(kMaxSequenceNumber),
+          insert_by_leader(false),
           link_older(nullptr),
           link_newer(nullptr) {}
 
@@ -355,6 +369,13 @@ class WriteThread {
     return last_sequence_;
   }
 
+  // Whether the write queue has writers, i.e. whether a writer joining now
+  // would most likely not lead its write group. Only a hint, as the queue may
+  // drain or fill up right after the check.
+  bool HasQueuedWriters() const {
+    return newest_writer_.load(std::memory_order_relaxed) != nullptr;
+  }
+
   // Insert a dummy writer at the tail of the write queue to indicate a write
   // stall, and fail any writers in the queue with no_slowdown set to true
   void BeginWriteStall();
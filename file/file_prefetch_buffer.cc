@@ -78,6 +78,45 @@ void FilePrefetchBuffer::CalculateOffsetAndLen(size_t alignment,
         static_cast<size_t>(roundup_len), copy_data_to_new_buffer,
         chunk_offset_in_buffer, static_cast<size_t>(chunk_len));
   }
+  ChargeBufferMemory();
+}
+
+bool FilePrefetchBuffer::ReserveBufferMemory(size_t total_bytes, bool force) {
+  assert(cache_res_mgr_ != nullptr);
+  if (total_bytes <= reserved_bytes_) {
+    return true;
+  }
+  std::unique_ptr<CacheReservationManager::CacheReservationHandle> handle;
+  Status s = cache_res_mgr_->MakeCacheReservation(total_bytes - reserved_bytes_,
+                                                  &handle);
+  if (!s.ok() && !force) {
+    // Destroying the handle releases whatever could be reserved
+    return false;
+  }
+  cache_res_handles_.push_back(std::move(handle));
+  reserved_bytes_ = total_bytes;
+  return true;
+}
+
+bool FilePrefetchBuffer::FitReadaheadToReservation(size_t n) {
+  if (cache_res_mgr_ == nullptr) {
+    return true;
+  }
+  size_t other_bytes = 0;
+  for (uint32_t i = 0; i < bufs_.size(); i++) {
+    if (i != curr_) {
+      other_bytes += bufs_[i].buffer_.Capacity();
+    }
+  }
+  while (readahead_size_ > 0) {
+    size_t curr_bytes =
+        std::max(bufs_[curr_].buffer_.Capacity(), n + readahead_size_);
+    if (ReserveBufferMemory(other_bytes + curr_bytes, /*force=*/false)) {
+      return true;
+    }
+    readahead_size_ /= 2;
+  }
+  return false;
 }
 
 Status FilePrefetchBuffer::Read(const IOOptions& opts,
@@ -310,6 +349,7 @@ Status FilePrefetchBuffer::PrefetchAsyncInternal(
     bufs_[2].buffer_.Clear();
     bufs_[2].buffer_.Alignment(alignment);
     bufs_[2].buffer_.AllocateNewBuffer(length);
+    ChargeBufferMemory();
     bufs_[2].offset_ = offset;
     copy_to_third_buffer = true;
 
@@ -416,6 +456,10 @@ bool FilePrefetchBuffer::TryReadFromCache(const IOOptions& opts,
       assert(reader != nullptr);
       assert(max_readahead_size_ >= readahead_size_);
       if (for_compaction) {
+        if (!FitReadaheadToReservation(n)) {
+          readahead_size_ = initial_auto_readahead_size_;
+          return false;
+        }
         s = Prefetch(opts, reader, offset, std::max(n, readahead_size_),
                      rate_limiter_priority);
       } else {
@@ -426,6 +470,12 @@ bool FilePrefetchBuffer::TryReadFromCache(const IOOptions& opts,
             return false;
           }
         }
+        if (!FitReadaheadToReservation(n)) {
+          // The block cache is full, so read without readahead this time
+          readahead_size_ = initial_auto_readahead_size_;
+          UpdateReadPattern(offset, n, false /*decrease_readaheadsize*/);
+          return false;
+        }
         s = Prefetch(opts, reader, offset, n + readahead_size_,
                      rate_limiter_priority);
       }
@@ -493,6 +543,12 @@ bool FilePrefetchBuffer::TryReadFromCacheAsync(
           return false;
         }
       }
+      if (!FitReadaheadToReservation(n)) {
+        // The block cache is full, so read without readahead this time
+        readahead_size_ = initial_auto_readahead_size_;
+        UpdateReadPattern(offset, n, false /*decrease_readaheadsize*/);
+        return false;
+      }
 
       // Prefetch n + readahead_size_/2 synchronously as remaining
       // readahead_size_/2 will be prefetched asynchronously.
@@ -12,7 +12,9 @@
 #include <atomic>
 #include <sstream>
 #include <string>
+#include <vector>
 
+#include "cache/cache_reservation_manager.h"
 #include "file/readahead_file_info.h"
 #include "monitoring/statistics.h"
 #include "port/port.h"
@@ -56,6 +58,9 @@ class FilePrefetchBuffer {
   // async_io : When async_io is enabled, if it's implicit_auto_readahead, it
   //   prefetches data asynchronously in second buffer while curr_ is being
   //   consumed.
+  // cache_res_mgr : if not null, the memory of the buffers is charged to the
+  //   block cache through it, and the readahead size is halved as long as
+  //   the buffers needed for it do not fit in the block cache.
   //
   // Automatic readhead is enabled for a file if readahead_size
   // and max_readahead_size are passed in.
@@ -67,7 +72,9 @@ class FilePrefetchBuffer {
                      uint64_t num_file_reads = 0,
                      uint64_t num_file_reads_for_auto_readahead = 0,
                      FileSystem* fs = nullptr, SystemClock* clock = nullptr,
-                     Statistics* stats = nullptr)
+                     Statistics* stats = nullptr,
+                     std::shared_ptr<CacheReservationManager> cache_res_mgr =
+                         nullptr)
       : curr_(0),
         readahead_size_(readahead_size),
         initial_auto_readahead_size_(readahead_size),
@@ -86,7 +93,8 @@ class FilePrefetchBuffer {
         async_request_submitted_(false),
         fs_(fs),
         clock_(clock),
-        stats_(stats) {
+        stats_(stats),
+        cache_res_mgr_(std::move(cache_res_mgr)) {
     assert((num_file_reads_ >= num_file_reads_for_auto_readahead_ + 1) ||
            (num_file_reads_ == 0));
     // If async_io_ is enabled, data is asynchronously filled in second buffer
@@ -281,6 +289,26 @@ class FilePrefetchBuffer {
   // Copy the data from src to third buffer.
   void CopyDataToBuffer(uint32_t src, uint64_t& offset, size_t& length);
 
+  // Charges at least `total_bytes` of buffers to the block cache. Unless
+  // `force`, returns false without charging anything if they do not fit.
+  bool ReserveBufferMemory(size_t total_bytes, bool force);
+
+  // Called after allocating buffers to charge their memory.
+  void ChargeBufferMemory() {
+    if (cache_res_mgr_ != nullptr) {
+      size_t total_bytes = 0;
+      for (const auto& buf : bufs_) {
+        total_bytes += buf.buffer_.Capacity();
+      }
+      ReserveBufferMemory(total_bytes, /*force=*/true);
+    }
+  }
+
+  // Called before prefetching `n` bytes and readahead_size_ more. Halves
+  // readahead_size_ until the buffers needed fit in the block cache. Returns
+  // false if even a readahead of one byte does not.
+  bool FitReadaheadToReservation(size_t n);
+
   bool IsBlockSequential(const size_t& offset) {
     return (prev_len_ == 0 || (prev_offset_ + prev_len_ == offset));
   }
@@ -358,5 +386,12 @@ class FilePrefetchBuffer {
   FileSystem* fs_;
   SystemClock* clock_;
   Statistics* stats_;
+
+  std::shared_ptr<CacheReservationManager> cache_res_mgr_;
+  // The buffers are charged incrementally, one handle per increase, and the
+  // charge is only released when this object is destroyed.
+  std::vector<std::unique_ptr<CacheReservationManager::CacheReservationHandle>>
+      cache_res_handles_;
+  size_t reserved_bytes_ = 0;
 };
 }  // namespace ROCKSDB_NAMESPACE
@@ -3,6 +3,7 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 
+#include "cache/cache_reservation_manager.h"
 #include "db/db_test_util.h"
 #include "test_util/sync_point.h"
 #ifdef GFLAGS
@@ -1347,6 +1348,99 @@ TEST_P(PrefetchTest1, DecreaseReadAheadIfInCache) {
   Close();
 }
 
+TEST_P(PrefetchTest1, ChargeReadBuffersToBlockCache) {
+  const int kNumKeys = 1000;
+  std::shared_ptr<MockFS> fs =
+      std::make_shared<MockFS>(env_->GetFileSystem(), false);
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.compression = kNoCompression;
+  options.env = env.get();
+  if (GetParam()) {
+    options.use_direct_reads = true;
+    options.use_direct_io_for_flush_and_compaction = true;
+  }
+  const size_t kDummyEntrySize = CacheReservationManagerImpl<
+      CacheEntryRole::kReadBuffer>::GetDummyEntrySize();
+  LRUCacheOptions co;
+  co.capacity = 2 * kDummyEntrySize;
+  co.num_shard_bits = 0;
+  co.strict_capacity_limit = true;
+  co.metadata_charge_policy = kDontChargeCacheMetadata;
+  std::shared_ptr<Cache> cache = NewLRUCache(co);
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = cache;
+  table_options.cache_usage_options.options_overrides.insert(
+      {CacheEntryRole::kReadBuffer,
+       {/*.charged = */ CacheEntryRoleOptions::Decision::kEnabled}});
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  Status s = TryReopen(options);
+  if (GetParam() && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  Random rnd(309);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), rnd.RandomString(1000)));
+  }
+  ASSERT_OK(Flush());
+
+  auto get_num_read_buffer_entries = [&]() {
+    const Cache::DeleterFn deleter = CacheReservationManagerImpl<
+        CacheEntryRole::kReadBuffer>::TEST_GetNoopDeleterForRole();
+    size_t count = 0;
+    cache->ApplyToAllEntries(
+        [&](const Slice& /*key*/, void* /*value*/, size_t /*charge*/,
+            Cache::DeleterFn entry_deleter) {
+          if (entry_deleter == deleter) {
+            count++;
+          }
+        },
+        {});
+    return count;
+  };
+
+  // The readahead buffer does not fit in the block cache, so the readahead
+  // size is shrunk until it does, and the scan still succeeds.
+  ReadOptions ro;
+  ro.readahead_size = 4 * kDummyEntrySize;
+  ro.fill_cache = false;
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+    int num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      num_keys++;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, num_keys);
+    const size_t num_entries = get_num_read_buffer_entries();
+    ASSERT_GE(num_entries, 1);
+    ASSERT_LE(num_entries, 2);
+  }
+  // The charge goes away with the iterator
+  ASSERT_EQ(0, get_num_read_buffer_entries());
+
+  // Without any room left, reads go to the file without readahead
+  cache->SetCapacity(0);
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+    int num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      num_keys++;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, num_keys);
+    ASSERT_EQ(0, get_num_read_buffer_entries());
+  }
+  Close();
+}
+
 TEST_P(PrefetchTest1, SeekParallelizationTest) {
   const int kNumKeys = 2000;
   // Set options
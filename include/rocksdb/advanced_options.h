@@ -80,6 +80,20 @@ struct CompactionOptionsFIFO {
   // will soon move the file to warm temperature.
   uint64_t age_for_warm = 0;
 
+  // EXPERIMENTAL
+  // When not 0, files are grouped into time windows of this many seconds by
+  // the age of their oldest data, like time-window compaction in other
+  // systems. Files of different windows are never compacted together. Once
+  // the current window has level0_file_num_compaction_trigger files that were
+  // not compacted yet, those are compacted, and once a window has ended, its
+  // remaining files that were not compacted yet are. Each compaction reads at
+  // most `max_compaction_bytes` and writes files of `target_file_size_base`.
+  // With `ttl`, data is dropped one whole window at a time, once the end of
+  // the window is older than `ttl`.
+  // This takes precedence over `allow_compaction`.
+  // Default: 0 (disabled)
+  uint64_t time_window_seconds = 0;
+
   CompactionOptionsFIFO() : max_table_files_size(1 * 1024 * 1024 * 1024) {}
   CompactionOptionsFIFO(uint64_t _max_table_files_size, bool _allow_compaction)
       : max_table_files_size(_max_table_files_size),
@@ -341,6 +355,12 @@ struct AdvancedColumnFamilyOptions {
   //   * new sizeof(new_value) <= sizeof(existing_value)
   //   * existing_value for that key is a put i.e. kTypeValue
   // If inplace_callback function is set, check doc for inplace_callback.
+  // Compatible with allow_concurrent_memtable_write: batches of a write group
+  // are inserted into memtables concurrently, except those writing a key of
+  // such a column family that another batch of the group writes too, which
+  // the group leader inserts serially first. Writes to a few hot keys hence
+  // gain little from concurrent memtable writes. Not compatible with
+  // unordered_write.
   // Default: false.
   bool inplace_update_support = false;
 
@@ -864,6 +884,59 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   uint64_t periodic_compaction_seconds = 0xfffffffffffffffe;
 
+  // EXPERIMENTAL
+  // If true, a leveled compaction that is not a trivial move as a whole still
+  // moves those of its start level input files whose key range overlaps no
+  // other input file to the output level as-is, and only rewrites the rest.
+  // Output files are cut around the moved files. This reduces the write
+  // amplification of workloads whose writes mostly go to new key ranges.
+  //
+  // Only applies to automatic compactions picked because of the L0 file count
+  // or a level's size, and only to files that could also be trivially moved
+  // (same path and compression as the output, allowed by the SST
+  // partitioner). Files moved this way are not passed through the
+  // compaction filter.
+  //
+  // Default: false
+  //
+  // Dynamically changeable through SetOptions() API
+  bool level_compaction_move_non_overlapping_files = false;
+
+  // EXPERIMENTAL
+  // If true, compactions copy the data blocks of their input files that they
+  // would not change to the output files as stored, instead of decoding,
+  // re-encoding and recompressing their entries. Index and filter entries
+  // are rebuilt from the keys of the copied blocks. A data block is copied
+  // if no other input file has keys within its key range and it only
+  // contains values (no deletions or merge operands) of distinct user keys
+  // whose sequence numbers would not be zeroed out. This saves compaction CPU
+  // for workloads whose writes mostly go to new key ranges.
+  //
+  // Blocks are only copied between block-based tables without compression
+  // dictionaries, and only if their compression type is the output
+  // compression type. Not used for compactions with a compaction filter, with
+  // range deletions or blob files among the inputs, with BlobDB output, with
+  // user-defined timestamps, or with per-key placement.
+  //
+  // Default: false
+  //
+  // Dynamically changeable through SetOptions() API
+  bool compaction_copy_clean_data_blocks = false;
+
+  // EXPERIMENTAL
+  // With compaction_pri = kRoundRobin in leveled compaction, the number of
+  // round-robin cursors of each level other than L0. The files of a level
+  // are divided into this many consecutive slices by key order, each with its
+  // own cursor that cycles through the slice, so that up to this many
+  // compactions of a level can run at the same time without conflicting. All
+  // cursors are persisted in the MANIFEST; releases that do not know about
+  // this option only read the first cursor of each level.
+  //
+  // Default: 1
+  //
+  // Dynamically changeable through SetOptions() API
+  uint32_t round_robin_cursors_per_level = 1;
+
   // If this option is set then 1 in N blocks are compressed
   // using a fast (lz4) and slow (zstd) compression algorithm.
   // The compressibility is reported as stats and the stored
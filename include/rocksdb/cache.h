@@ -24,6 +24,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -48,6 +49,52 @@ enum CacheMetadataChargePolicy {
 const CacheMetadataChargePolicy kDefaultCacheMetadataChargePolicy =
     kFullChargeCacheMetadata;
 
+// Classifications of block cache entries.
+//
+// Developer notes: Adding a new enum to this class requires corresponding
+// updates to `kCacheEntryRoleToCamelString` and
+// `kCacheEntryRoleToHyphenString`. Do not add to this enum after `kMisc` since
+// `kNumCacheEntryRoles` assumes `kMisc` comes last.
+enum class CacheEntryRole {
+  // Block-based table data block
+  kDataBlock,
+  // Block-based table filter block (full or partitioned)
+  kFilterBlock,
+  // Block-based table metadata block for partitioned filter
+  kFilterMetaBlock,
+  // OBSOLETE / DEPRECATED: old/removed block-based filter
+  kDeprecatedFilterBlock,
+  // Block-based table index block
+  kIndexBlock,
+  // Other kinds of block-based table block
+  kOtherBlock,
+  // WriteBufferManager's charge to account for its memtable usage
+  kWriteBuffer,
+  // Compression dictionary building buffer's charge to account for
+  // its memory usage
+  kCompressionDictionaryBuildingBuffer,
+  // Filter's charge to account for
+  // (new) bloom and ribbon filter construction's memory usage
+  kFilterConstruction,
+  // BlockBasedTableReader's charge to account for its memory usage
+  kBlockBasedTableReader,
+  // FileMetadata's charge to account for its memory usage
+  kFileMetadata,
+  // Blob value (when using the same cache as block cache and blob cache)
+  kBlobValue,
+  // Blob cache's charge to account for its memory usage (when using a
+  // separate block cache and blob cache)
+  kBlobCache,
+  // Readahead buffers of iterators and compactions reading block-based table
+  // files
+  kReadBuffer,
+  // Default bucket, for miscellaneous cache entries. Do not use for
+  // entries that could potentially add up to large usage.
+  kMisc,
+};
+constexpr uint32_t kNumCacheEntryRoles =
+    static_cast<uint32_t>(CacheEntryRole::kMisc) + 1;
+
 struct LRUCacheOptions {
   // Capacity of the cache.
   size_t capacity = 0;
@@ -104,6 +151,32 @@ struct LRUCacheOptions {
   // A SecondaryCache instance to use a the non-volatile tier.
   std::shared_ptr<SecondaryCache> secondary_cache;
 
+  // EXPERIMENTAL
+  // If true, the cache keeps a compact sketch of how often each key was
+  // looked up recently, and a new entry that can only be inserted by evicting
+  // another one is only admitted if it was looked up more often than the
+  // entry it would evict (TinyLFU admission). An entry that is not admitted
+  // is not inserted into the cache, but a handle requested by the caller
+  // stays valid until it is released. This keeps occasional large scans from
+  // flushing a frequently used working set out of the cache. High priority
+  // entries are always admitted.
+  bool use_tiny_lfu_admission = false;
+
+  // EXPERIMENTAL
+  // If true, releasing a handle doesn't take the shard mutex, unless it was
+  // the last reference to an entry erased from the cache. Lookups still take
+  // the shard mutex, to probe the hash table, so this does not make lookups
+  // of a hot shard scale with the number of threads; it only saves them from
+  // moving the entry in the LRU list, as they just mark it as recently used.
+  // The LRU order, including the high and low priority pools, is caught up
+  // with when the entries reach the end of the LRU list, where eviction moves
+  // the recently used and the referenced ones to the head of the list
+  // instead of evicting them. An insertion may have to walk past many entries
+  // if most of the cache is pinned. A released entry is only evicted by a
+  // later insertion when the cache is over capacity. Ignored with a secondary
+  // cache.
+  bool use_lazy_lru_updates = false;
+
   LRUCacheOptions() {}
   LRUCacheOptions(size_t _capacity, int _num_shard_bits,
                   bool _strict_capacity_limit, double _high_pri_pool_ratio,
@@ -141,6 +214,26 @@ extern std::shared_ptr<Cache> NewLRUCache(
 
 extern std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts);
 
+// EXPERIMENTAL
+// Returns a view of `cache`, which must have been created by NewLRUCache(),
+// for one of several tenants sharing it, e.g. one per column family or per
+// DB, to be used as their block cache. Each tenant is guaranteed a share of
+// the capacity proportional to `weight`, and may borrow the capacity unused
+// by the others. The entries of tenants using more than their share are
+// evicted before the entries of the tenants within their share, which keeps
+// a scan of one tenant from evicting the hot blocks of another.
+//
+// GetUsage() and ApplyToAllEntries() of the view only cover the entries of
+// the tenant, so that the block cache entry stats of a column family (see
+// DB::Properties::kBlockCacheEntryStats) are per tenant. The other calls,
+// including GetCapacity() and SetCapacity(), apply to the shared cache.
+// Entries inserted directly into `cache` are not subject to quotas.
+//
+// Returns nullptr if `cache` was not created by NewLRUCache(), if `weight` is
+// not positive, or if `cache` already had 65534 tenants.
+extern std::shared_ptr<Cache> NewLRUCacheTenant(
+    const std::shared_ptr<Cache>& cache, double weight = 1.0);
+
 // EXPERIMENTAL
 // Options structure for configuring a SecondaryCache instance based on
 // LRUCache. The LRUCacheOptions.secondary_cache is not used and
@@ -156,6 +249,18 @@ struct CompressedSecondaryCacheOptions : LRUCacheOptions {
   // header in varint32 format.
   uint32_t compress_format_version = 2;
 
+  // Blocks whose compressed size is more than this ratio of their
+  // uncompressed size are stored uncompressed, because compressing them saves
+  // too little memory to pay for decompressing them on every lookup.
+  double max_compressed_size_ratio = 0.875;
+
+  // Overrides compression_type for the blocks of some roles, e.g. to use
+  // kZSTD for data blocks. Filter blocks, which hardly compress, are stored
+  // uncompressed by default. The role of a block is inferred from the deleter
+  // of its primary cache entry; unknown ones use compression_type.
+  std::map<CacheEntryRole, CompressionType> compression_type_overrides = {
+      {CacheEntryRole::kFilterBlock, CompressionType::kNoCompression}};
+
   CompressedSecondaryCacheOptions() {}
   CompressedSecondaryCacheOptions(
       size_t _capacity, int _num_shard_bits, bool _strict_capacity_limit,
@@ -388,6 +493,11 @@ class Cache {
   // capacity is less than the old capacity and the existing usage is
   // greater than new capacity, the implementation will do its best job to
   // purge the released entries from the cache in order to lower the usage
+  //
+  // The built-in caches evict in small steps, without blocking lookups and
+  // inserts for the whole shrink, and GetCapacity() returns the new capacity
+  // as soon as the shrink starts. So another thread may follow the progress
+  // of a shrink by comparing GetUsage() with GetCapacity().
   virtual void SetCapacity(size_t capacity) = 0;
 
   // Set whether to return error on insertion when cache reaches its full
@@ -540,6 +650,22 @@ class Cache {
     return Lookup(key, stats);
   }
 
+  // Looks up a batch of keys, setting handles[i] to what
+  // Lookup(keys[i], helper, create_cb, priority, wait, stats) would have
+  // returned. Implementations may amortize hashing, memory latency and
+  // locking over the whole batch, so this is preferred over looking up the
+  // keys one at a time when they are all known upfront. Every non-null
+  // handle must be released by the caller.
+  virtual void LookupMany(const Slice* keys, size_t num_keys, Handle** handles,
+                          const CacheItemHelper* helper = nullptr,
+                          const CreateCallback& create_cb = nullptr,
+                          Priority priority = Priority::LOW, bool wait = true,
+                          Statistics* stats = nullptr) {
+    for (size_t i = 0; i < num_keys; i++) {
+      handles[i] = Lookup(keys[i], helper, create_cb, priority, wait, stats);
+    }
+  }
+
   // Release a mapping returned by a previous Lookup(). The "useful"
   // parameter specifies whether the data was actually used or not,
   // which may be used by the cache implementation to decide whether
@@ -570,49 +696,6 @@ class Cache {
   std::shared_ptr<MemoryAllocator> memory_allocator_;
 };
 
-// Classifications of block cache entries.
-//
-// Developer notes: Adding a new enum to this class requires corresponding
-// updates to `kCacheEntryRoleToCamelString` and
-// `kCacheEntryRoleToHyphenString`. Do not add to this enum after `kMisc` since
-// `kNumCacheEntryRoles` assumes `kMisc` comes last.
-enum class CacheEntryRole {
-  // Block-based table data block
-  kDataBlock,
-  // Block-based table filter block (full or partitioned)
-  kFilterBlock,
-  // Block-based table metadata block for partitioned filter
-  kFilterMetaBlock,
-  // OBSOLETE / DEPRECATED: old/removed block-based filter
-  kDeprecatedFilterBlock,
-  // Block-based table index block
-  kIndexBlock,
-  // Other kinds of block-based table block
-  kOtherBlock,
-  // WriteBufferManager's charge to account for its memtable usage
-  kWriteBuffer,
-  // Compression dictionary building buffer's charge to account for
-  // its memory usage
-  kCompressionDictionaryBuildingBuffer,
-  // Filter's charge to account for
-  // (new) bloom and ribbon filter construction's memory usage
-  kFilterConstruction,
-  // BlockBasedTableReader's charge to account for its memory usage
-  kBlockBasedTableReader,
-  // FileMetadata's charge to account for its memory usage
-  kFileMetadata,
-  // Blob value (when using the same cache as block cache and blob cache)
-  kBlobValue,
-  // Blob cache's charge to account for its memory usage (when using a
-  // separate block cache and blob cache)
-  kBlobCache,
-  // Default bucket, for miscellaneous cache entries. Do not use for
-  // entries that could potentially add up to large usage.
-  kMisc,
-};
-constexpr uint32_t kNumCacheEntryRoles =
-    static_cast<uint32_t>(CacheEntryRole::kMisc) + 1;
-
 // Obtain a hyphen-separated, lowercase name of a `CacheEntryRole`.
 const std::string& GetCacheEntryRoleName(CacheEntryRole);
 
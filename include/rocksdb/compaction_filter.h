@@ -49,6 +49,35 @@ class CompactionFilter : public Customizable {
 
   enum class BlobDecision { kKeep, kChangeValue, kCorruption, kIOError };
 
+  // EXPERIMENTAL
+  // Where a compaction writing blob files stores a value, see
+  // DecideBlobPlacement().
+  enum class BlobPlacement {
+    // Decide by size, using `min_blob_size`
+    kDefault,
+    // Store the value in the table file
+    kInline,
+    // Store the value in a blob file, whatever its size
+    kBlobFile,
+  };
+
+  // EXPERIMENTAL
+  // Sampled read statistics of the compaction input files whose key range
+  // contains a key, as a signal of how hot the key's neighbourhood is. The
+  // counts are approximate (see SstFileMetaData::num_reads_sampled) and start
+  // from zero for every file written.
+  struct ValueAccessStats {
+    // Reads of the files by point lookups and iterators
+    uint64_t num_reads_sampled = 0;
+    // The part of `num_reads_sampled` made by iterators
+    uint64_t num_scans_sampled = 0;
+    // Number of input files whose key range contains the key
+    uint64_t num_files = 0;
+    // Total size of those files in bytes, to tell the read density of
+    // the key range
+    uint64_t total_file_size = 0;
+  };
+
   // Context information for a table file creation.
   struct Context {
     // Whether this table file is created as part of a compaction including all
@@ -186,6 +215,74 @@ class CompactionFilter : public Customizable {
     return Decision::kKeep;
   }
 
+  // EXPERIMENTAL
+  // Limits of the batches passed to FilterBatch(). A batch ends once the
+  // entries read ahead for it reach `max_entries` or their keys and values
+  // add up to `max_bytes`.
+  struct BatchOptions {
+    size_t max_entries = 128;
+    size_t max_bytes = 256 << 10;
+  };
+
+  // EXPERIMENTAL
+  // Returning true makes compactions decide about plain values
+  // (ValueType::kValue) in batches through FilterBatch() instead of calling
+  // FilterV2() once per key, which saves the per-call overhead of filters
+  // implemented in another language. `*options` may be modified to change
+  // the size of the batches.
+  //
+  // Batching is not used with user-defined timestamps, with
+  // WritePrepared/WriteUnprepared transactions, or for blob indexes, merge
+  // operands and wide-column entities, which keep using FilterV2().
+  virtual bool SupportsFilterBatch(BatchOptions* /*options*/) const {
+    return false;
+  }
+
+  // EXPERIMENTAL
+  // Decides about a batch of plain values at once. Only called if
+  // SupportsFilterBatch() returns true. `keys` and `existing_values` hold the
+  // entries in key order; the same entries would otherwise have been passed
+  // to FilterV2() with ValueType::kValue, so snapshot semantics are the
+  // same. `decisions` and `new_values` come sized like `keys`, and
+  // (*decisions)[i] / (*new_values)[i] are to be set like the return value
+  // and `*new_value` of FilterV2() for entry i.
+  //
+  // Only kKeep, kRemove, kChangeValue and kPurge are supported; any other
+  // decision fails the compaction with Status::NotSupported. Batches are
+  // decided ahead of the compaction, so when FilterV2() returns
+  // kRemoveAndSkipUntil for a merge operand or blob index, decisions already
+  // made about the skipped entries are discarded.
+  //
+  // The default implementation calls FilterV2() for every entry.
+  virtual void FilterBatch(int level, const std::vector<Slice>& keys,
+                           const std::vector<Slice>& existing_values,
+                           std::vector<Decision>* decisions,
+                           std::vector<std::string>* new_values) const;
+
+  // EXPERIMENTAL
+  // With integrated BlobDB, compactions that write blob files call this for
+  // every plain value (ValueType::kValue) and blob reference
+  // (ValueType::kBlobIndex) they output, before `min_blob_size` is applied.
+  // `value_size` is the size of the value, or of the blob for a blob
+  // reference, and `stats` holds the read statistics of the input files
+  // around `key`.
+  //
+  // Returning kInline keeps a plain value in the table file, and reads the
+  // blob of a blob reference back into the table file, which helps scans of
+  // hot values. Returning kBlobFile moves a plain value into a blob file even
+  // if it is smaller than `min_blob_size`; blob references stay where they
+  // are. kDefault keeps the size-based behavior.
+  //
+  // Called for all versions of a key, including those only visible to
+  // snapshots, and also when Filter()/FilterV2() is not. Not called by
+  // compactions that do not write blob files (see `enable_blob_files` and
+  // `blob_file_starting_level`), which leave blob references in place.
+  virtual BlobPlacement DecideBlobPlacement(
+      int /*level*/, const Slice& /*key*/, ValueType /*value_type*/,
+      uint64_t /*value_size*/, const ValueAccessStats& /*stats*/) const {
+    return BlobPlacement::kDefault;
+  }
+
   // Internal (BlobDB) use only. Do not override in application code.
   virtual BlobDecision PrepareBlobOutput(const Slice& /* key */,
                                          const Slice& /* existing_value */,
@@ -46,6 +46,8 @@ struct CompactionJobStats {
 
   // the total size of table files in the compaction input
   uint64_t total_input_bytes;
+  // the total size of table files in the compaction input at the output level
+  uint64_t total_input_bytes_at_output_level;
   // the total size of blobs read from blob files
   uint64_t total_blob_bytes_read;
   // the total size of table files in the compaction output
@@ -103,6 +105,23 @@ struct CompactionJobStats {
   // number of single-deletes which meet something other than a put
   uint64_t num_single_del_mismatch;
 
+  // the number of subcompactions the compaction ran as, including the ones
+  // split off running subcompactions.
+  uint64_t num_subcompactions;
+  // the number of subcompactions that were split off the unprocessed part of
+  // a running subcompaction's key-range. See
+  // DBOptions::enable_subcompaction_work_stealing.
+  uint64_t num_split_subcompactions;
+  // the elapsed time of the fastest and the slowest subcompaction in
+  // microseconds. A large gap means the key-range split was skewed.
+  uint64_t min_subcompaction_micros;
+  uint64_t max_subcompaction_micros;
+
+  // The write amplification of the compaction: the bytes of table and blob
+  // files written per byte of table files read from the levels other than
+  // the output level. 0 if nothing was read from those levels.
+  double WriteAmplification() const;
+
   // TODO: Add output_to_penultimate_level output information
 };
 }  // namespace ROCKSDB_NAMESPACE
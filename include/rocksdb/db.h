@@ -901,6 +901,11 @@ class DB {
     //      available in the map form.
     static const std::string kBlockCacheEntryStats;
 
+    //  "rocksdb.metadata-block-cache-entry-stats" - like
+    //      "rocksdb.block-cache-entry-stats", for
+    //      `BlockBasedTableOptions::metadata_block_cache`.
+    static const std::string kMetadataBlockCacheEntryStats;
+
     //  "rocksdb.num-immutable-mem-table" - returns number of immutable
     //      memtables that have not yet been flushed.
     static const std::string kNumImmutableMemTable;
@@ -729,6 +729,62 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   uint32_t max_subcompactions = 1;
 
+  // EXPERIMENTAL
+  // If true, a compaction job that is split into subcompactions no longer
+  // sticks to the key-range split it picked up front. When a subcompaction
+  // thread runs out of work while others are still running, one of the
+  // running subcompactions hands the unprocessed second half of its
+  // remaining key-range over to the idle thread. This reduces the time a job
+  // spends waiting for a single subcompaction whose range holds more data
+  // than estimated. Not applied to compactions reading blob files, writing
+  // to the penultimate level, using user-defined timestamps, or run by a
+  // CompactionService.
+  //
+  // Default: false
+  bool enable_subcompaction_work_stealing = false;
+
+  // EXPERIMENTAL
+  // If true, background compactions are no longer handed to the column
+  // families that need compaction in the order they asked for it. Each
+  // column family estimates how long it will take until its number of L0
+  // files (sorted runs in universal compaction) reaches
+  // level0_slowdown_writes_trigger, from the rate at which new L0 files
+  // arrived recently, and the column family that would stall first is
+  // compacted first.
+  //
+  // Default: false
+  bool compaction_scheduling_by_stall_deadline = false;
+
+  // EXPERIMENTAL
+  // Only used with compaction_scheduling_by_stall_deadline. If not 0, when
+  // all compaction threads are busy and a column family waiting for one is
+  // estimated to stall writes within this many microseconds, a running
+  // automatic compaction that does not read L0 and writes to the bottommost
+  // level is canceled to free its thread. The most recently started of those
+  // is canceled first, since it loses the least work, and its column family
+  // is queued for compaction again. Compactions forwarded to the BOTTOM
+  // priority pool are never canceled.
+  //
+  // Default: 0
+  uint64_t bottommost_compaction_preemption_micros = 0;
+
+  // EXPERIMENTAL
+  // If not empty, the path of a local file used to keep the block cache warm
+  // across restarts. On Close(), the index, filter and data blocks of this
+  // DB's live table files that are in the block cache are written to this
+  // file, index and filter blocks first. On DB::Open(), the blocks are read
+  // back from it and inserted directly into the block caches of the column
+  // families, using up to max_file_opening_threads threads. Blocks of files
+  // that are no longer live, identified by their unique id, are skipped, and
+  // so are blocks that would not fit in the free capacity of the cache.
+  // Failing to write or read the file is logged and otherwise ignored.
+  //
+  // Only table files with a unique id recorded in the manifest take part,
+  // and only block-based tables with a block cache.
+  //
+  // Default: ""
+  std::string block_cache_dump_file = "";
+
   // DEPRECATED: RocksDB automatically decides this based on the
   // value of max_background_jobs. For backwards compatibility we will set
   // `max_background_jobs = max_background_compactions + max_background_flushes`
@@ -1095,8 +1151,9 @@ struct DBOptions {
 
   // If true, allow multi-writers to update mem tables in parallel.
   // Only some memtable_factory-s support concurrent writes; currently it
-  // is implemented only for SkipListFactory.  Concurrent memtable writes
-  // are not compatible with inplace_update_support or filter_deletes.
+  // is implemented only for SkipListFactory.  Write groups containing merges
+  // are applied serially, as are the batches of a group writing the same key
+  // of a column family with inplace_update_support.
   // It is strongly recommended to set enable_write_thread_adaptive_yield
   // if you are going to use this feature.
   //
@@ -1236,6 +1293,33 @@ struct DBOptions {
   // versions regardless of the wal_compression settings.
   CompressionType wal_compression = kNoCompression;
 
+  // EXPERIMENTAL
+  // Number of streams the WAL is split into, from 1 to 64. With more than one
+  // stream, each WAL is a set of files with consecutive numbers, one per
+  // stream, and the writes to the column family with ID `id` go to stream
+  // `id % num_wal_streams`, so that the WAL of unrelated column families can
+  // be spread over several files. A write batch touching several
+  // streams is written whole to the first of them, with a small record in
+  // each of the others, so that recovery can tell if it was lost. Recovery
+  // merges the streams back in sequence number order, and treats a sequence
+  // number missing from all the streams, e.g. with the unsynced tail of one
+  // of them, as a corruption of the WAL at that point (sequence numbers
+  // consumed without a WAL write, e.g. with disableWAL, are recorded).
+  //
+  // The streams still share one write queue: the leader of each write group
+  // writes (and syncs) all the streams the group touches, so writers to
+  // different streams are serialized as with a single WAL. This spreads the
+  // WAL over several files but does not reduce write path contention.
+  //
+  // Not supported with two_write_queues, unordered_write,
+  // enable_pipelined_write, manual_wal_flush, recycle_log_file_num or
+  // allow_2pc (hence TransactionDB). GetUpdatesSince() is not supported and
+  // secondary instances do not merge the streams. WALs written with more than
+  // one stream cannot be read by versions without this option.
+  //
+  // Default: 1
+  int num_wal_streams = 1;
+
   // If true, RocksDB supports flushing multiple column families and committing
   // their results atomically to MANIFEST. Note that it is not
   // necessary to set atomic_flush to true if WAL is always enabled since WAL
@@ -1613,6 +1697,18 @@ struct ReadOptions {
   // Default: empty (every table will be scanned)
   std::function<bool(const TableProperties&)> table_filter;
 
+  // EXPERIMENTAL
+  // A callback to determine whether relevant keys for this scan may exist in a
+  // data block, based on the summary recorded for that block by
+  // `BlockBasedTableOptions::data_block_summary_collector_factory`. If the
+  // callback returns false, the block is skipped without being read. Blocks
+  // without a summary are always read. As with `table_filter`, skipping a
+  // block hides all of its entries, including deletions, so the predicate
+  // should be conservative for blocks that may shadow older data. This option
+  // only affects Iterators and has no impact on point lookups.
+  // Default: empty (every data block will be scanned)
+  std::function<bool(const Slice& block_summary)> block_summary_filter;
+
   // Timestamp of operation. Read should return the latest data visible to the
   // specified timestamp. All timestamps of the same database must be of the
   // same length and format. The user is responsible for providing a customized
@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rocksdb/customizable.h"
 #include "rocksdb/rocksdb_namespace.h"
@@ -15,6 +16,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class Comparator;
 class Slice;
 
 enum PartitionerResult : char {
@@ -75,6 +77,13 @@ class SstPartitioner {
     Slice smallest_user_key;
     // Largest key for compaction
     Slice largest_user_key;
+    // User comparator of the column family
+    const Comparator* user_comparator = nullptr;
+    // Largest user keys of the files in the level after the output level
+    // that overlap the compaction, in ascending order. Cutting an output
+    // file right after one of them keeps the file from overlapping the files
+    // on both sides of that boundary when it is compacted further down.
+    std::vector<Slice> next_level_file_boundaries;
   };
 };
 
@@ -139,4 +148,65 @@ class SstPartitionerFixedPrefixFactory : public SstPartitionerFactory {
 extern std::shared_ptr<SstPartitionerFactory>
 NewSstPartitionerFixedPrefixFactory(size_t prefix_len);
 
+/*
+ * EXPERIMENTAL
+ * Next level aligned partitioner. Once the current output file reaches
+ * min_file_size, it splits the output SST files right after the largest key
+ * of a file in the level after the output level, so that the output files
+ * straddle as few of those files as possible and compacting them further
+ * rewrites less data. It also splits at max_file_size regardless, if not 0.
+ * Compactions still cut output files at the target file size, so
+ * min_file_size should be below it. Like the fixed prefix partitioner, it
+ * does not allow trivial moves of files that it would split.
+ */
+class SstPartitionerNextLevelAligned : public SstPartitioner {
+ public:
+  SstPartitionerNextLevelAligned(uint64_t min_file_size, uint64_t max_file_size,
+                                 const SstPartitioner::Context& context);
+
+  ~SstPartitionerNextLevelAligned() override {}
+
+  const char* Name() const override { return "SstPartitionerNextLevelAligned"; }
+
+  PartitionerResult ShouldPartition(const PartitionerRequest& request) override;
+
+  bool CanDoTrivialMove(const Slice& smallest_user_key,
+                        const Slice& largest_user_key) override;
+
+ private:
+  uint64_t min_file_size_;
+  uint64_t max_file_size_;
+  const Comparator* ucmp_;
+  std::vector<Slice> boundaries_;
+  // Index of the first boundary not below the previous key
+  size_t next_boundary_ = 0;
+};
+
+/*
+ * Factory for next level aligned partitioner.
+ */
+class SstPartitionerNextLevelAlignedFactory : public SstPartitionerFactory {
+ public:
+  SstPartitionerNextLevelAlignedFactory(uint64_t min_file_size,
+                                        uint64_t max_file_size);
+
+  ~SstPartitionerNextLevelAlignedFactory() override {}
+
+  static const char* kClassName() {
+    return "SstPartitionerNextLevelAlignedFactory";
+  }
+  const char* Name() const override { return kClassName(); }
+
+  std::unique_ptr<SstPartitioner> CreatePartitioner(
+      const SstPartitioner::Context& context) const override;
+
+ private:
+  uint64_t min_file_size_;
+  uint64_t max_file_size_;
+};
+
+extern std::shared_ptr<SstPartitionerFactory>
+NewSstPartitionerNextLevelAlignedFactory(uint64_t min_file_size,
+                                         uint64_t max_file_size = 0);
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -32,6 +32,7 @@ namespace ROCKSDB_NAMESPACE {
 
 // -- Block-based Table
 class Cache;
+class DataBlockSummaryCollectorFactory;
 class FilterPolicy;
 class FlushBlockPolicyFactory;
 class PersistentCache;
@@ -132,6 +133,18 @@ struct BlockBasedTableOptions {
   // `FlushBlockBySizePolicy`).
   std::shared_ptr<FlushBlockPolicyFactory> flush_block_policy_factory;
 
+  // EXPERIMENTAL
+  // If non-nullptr, a DataBlockSummaryCollector is created for each table and
+  // the summary it produces for each data block is stored in that block's
+  // index entry. See `ReadOptions::block_summary_filter` for how iterators use
+  // the summaries to skip data blocks.
+  //
+  // Only supported with index_type kBinarySearch and kBinarySearchWithFirstKey.
+  //
+  // Default: nullptr
+  std::shared_ptr<DataBlockSummaryCollectorFactory>
+      data_block_summary_collector_factory;
+
   // TODO(kailiu) Temporarily disable this feature by making the default value
   // to be false.
   //
@@ -262,6 +275,20 @@ struct BlockBasedTableOptions {
   // If NULL, rocksdb will automatically create and use an 8MB internal cache.
   std::shared_ptr<Cache> block_cache = nullptr;
 
+  // EXPERIMENTAL
+  // If non-NULL, index, filter and compression dictionary blocks that would
+  // be stored in `block_cache` are stored in this cache instead, so that data
+  // blocks can't evict them, and the two caches can have different sizes and
+  // eviction policies (e.g. a HyperClockCache for data blocks and an
+  // LRUCache for metadata). Only data blocks, and memory charged to the
+  // block cache for other purposes, are stored in `block_cache`. See
+  // `cache_index_and_filter_blocks` for which metadata blocks are stored in
+  // a cache. The entries of both caches are reported, by role, in the
+  // "rocksdb.block-cache-entry-stats" and
+  // "rocksdb.metadata-block-cache-entry-stats" DB properties.
+  // Ignored if `no_block_cache` is true.
+  std::shared_ptr<Cache> metadata_block_cache = nullptr;
+
   // If non-NULL use the specified cache for pages read from device
   // IF NULL, no page cache is used
   std::shared_ptr<PersistentCache> persistent_cache = nullptr;
@@ -383,7 +410,21 @@ struct BlockBasedTableOptions {
   // (iii) Compatible existing behavior:
   // Same as kDisabled.
   //
-  // (e) Other CacheEntryRole
+  // (e) CacheEntryRole::kReadBuffer
+  // (i) If kEnabled:
+  // Charge memory usage of the readahead buffers of iterators and compactions
+  // (see `ReadOptions::readahead_size`, `max_auto_readahead_size` and
+  // `compaction_readahead_size`).
+  // If a larger buffer exceeds the avaible space left in the block cache
+  // (i.e, causing a cache full under `LRUCacheOptions::strict_capacity_limit`
+  // = true), the readahead size is halved until the buffer fits, and reads
+  // go to the file without readahead if none fits.
+  // (ii) If kDisabled:
+  // Does not charge the memory usage mentioned above.
+  // (iii) Compatible existing behavior:
+  // Same as kDisabled.
+  //
+  // (f) Other CacheEntryRole
   // Not supported.
   // `Status::kNotSupported` will be returned if
   // `CacheEntryRoleOptions::charged` is set to {`kEnabled`, `kDisabled`}.
@@ -671,6 +712,9 @@ struct BlockBasedTablePropertyNames {
   static const std::string kWholeKeyFiltering;
   // value is "1" for true and "0" for false.
   static const std::string kPrefixFiltering;
+  // value is the name of the DataBlockSummaryCollectorFactory whose
+  // summaries are stored in the index entries. Absent if there are none.
+  static const std::string kDataBlockSummaryCollector;
 };
 
 // Create default block based table factory.
@@ -844,6 +888,9 @@ class TableFactory : public Customizable {
   virtual ~TableFactory() override {}
 
   static const char* kBlockCacheOpts() { return "BlockCache"; };
+  static const char* kMetadataBlockCacheOpts() {
+    return "MetadataBlockCache";
+  };
   static const char* kBlockBasedTableName() { return "BlockBasedTable"; };
   static const char* kPlainTableName() { return "PlainTable"; }
   static const char* kCuckooTableName() { return "CuckooTable"; };
@@ -171,6 +171,52 @@ class TablePropertiesCollectorFactory : public Customizable {
   virtual std::string ToString() const { return Name(); }
 };
 
+// EXPERIMENTAL
+// `DataBlockSummaryCollector` is the per-data-block counterpart of
+// `TablePropertiesCollector`. It observes the entries of each data block of a
+// block-based table and produces a small opaque summary (for example, the
+// min/max of a timestamp embedded in the value), which is stored in the
+// index entry of that block. Iterators can consult these summaries through
+// `ReadOptions::block_summary_filter` to skip data blocks without reading
+// them.
+//
+// One collector is created per table and called sequentially, so the
+// methods don't need to be thread-safe.
+//
+// Exceptions MUST NOT propagate out of overridden functions into RocksDB,
+// because RocksDB is not exception-safe.
+class DataBlockSummaryCollector {
+ public:
+  virtual ~DataBlockSummaryCollector() {}
+
+  // Called for every point entry added to the current data block.
+  // @params key    the user key of the entry
+  // @params value  the value of the entry (empty for deletions)
+  // @params type   the type of the entry
+  virtual void Add(const Slice& key, const Slice& value, EntryType type) = 0;
+
+  // Called when the current data block is cut. The collector sets `*summary`
+  // to the summary of the entries added since the previous call, and starts
+  // collecting for the next block. An empty summary means "unknown": such a
+  // block is never skipped.
+  virtual void FinishBlock(std::string* summary) = 0;
+
+  // The name of the collector, recorded in the table properties.
+  virtual const char* Name() const = 0;
+};
+
+// Constructs a DataBlockSummaryCollector for each new table.
+class DataBlockSummaryCollectorFactory {
+ public:
+  virtual ~DataBlockSummaryCollectorFactory() {}
+
+  // has to be thread-safe
+  virtual DataBlockSummaryCollector* CreateDataBlockSummaryCollector(
+      TablePropertiesCollectorFactory::Context context) = 0;
+
+  virtual const char* Name() const = 0;
+};
+
 // TableProperties contains a bunch of read-only properties of its associated
 // table.
 struct TableProperties {
@@ -77,7 +77,9 @@ class CompactionOptionsUniversal {
   // EXPERIMENTAL
   // If true, try to limit compaction size under max_compaction_bytes.
   // This might cause higher write amplification, but can prevent some
-  // problem caused by large compactions.
+  // problem caused by large compactions. Periodic compactions only rewrite
+  // the files marked for periodic compaction in the last sorted run, up to
+  // max_compaction_bytes at a time, if no other sorted run holds such files.
   // Default: false
   bool incremental;
 
@@ -0,0 +1,93 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#ifndef ROCKSDB_LITE
+
+#include <memory>
+#include <string>
+
+#include "rocksdb/db.h"
+#include "rocksdb/options.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class WriteBatch;
+
+struct ReadYourWritesSessionOptions {
+  // Maximum number of keys whose latest written value is remembered by the
+  // session. Rounded up to a power of two. Must be positive.
+  size_t max_cached_keys = 1024;
+};
+
+// EXPERIMENTAL
+//
+// A ReadYourWritesSession remembers the values it recently wrote to the DB so
+// that a later Get() of one of those keys can be answered without a
+// memtable or SST lookup, as long as no other write may have changed the key
+// since. This serves the common "write a key, then read it back" pattern of
+// request handlers at a fraction of the cost of DB::Get().
+//
+// Writes from other sessions or directly through the DB are tracked at the
+// granularity of a fixed number of key stripes; range deletions, file
+// ingestion and DeleteFilesInRange() invalidate all remembered values. Reads
+// served from the session return the same result as a DB::Get() without a
+// snapshot issued at the same time.
+//
+// Get() falls back to DB::Get() for reads with an explicit snapshot or
+// timestamp, reads from column families with user-defined timestamps, and
+// reads with `read_tier == kPersistedTier`. Merge operands and wide-column
+// entities written through the session are not remembered. Values that are
+// later dropped or changed by a compaction filter or by FIFO compaction are
+// not detected, so sessions should not be used with either.
+//
+// A session is not thread-safe; use one session per thread or request. The
+// DB must be a read-write DB opened with DB::Open() and must outlive the
+// session. Sessions are not supported with `unordered_write` or when the DB
+// is used by WritePrepared/WriteUnprepared transactions.
+class ReadYourWritesSession {
+ public:
+  static Status Open(DB* db, const ReadYourWritesSessionOptions& options,
+                     std::unique_ptr<ReadYourWritesSession>* session);
+
+  virtual ~ReadYourWritesSession() {}
+
+  virtual Status Put(const WriteOptions& options,
+                     ColumnFamilyHandle* column_family, const Slice& key,
+                     const Slice& value) = 0;
+  virtual Status Put(const WriteOptions& options, const Slice& key,
+                     const Slice& value) {
+    return Put(options, GetDB()->DefaultColumnFamily(), key, value);
+  }
+
+  virtual Status Delete(const WriteOptions& options,
+                        ColumnFamilyHandle* column_family,
+                        const Slice& key) = 0;
+  virtual Status Delete(const WriteOptions& options, const Slice& key) {
+    return Delete(options, GetDB()->DefaultColumnFamily(), key);
+  }
+
+  // Applies `updates` to the DB like DB::Write() and remembers the values of
+  // the keys it puts or deletes.
+  virtual Status Write(const WriteOptions& options, WriteBatch* updates) = 0;
+
+  virtual Status Get(const ReadOptions& options,
+                     ColumnFamilyHandle* column_family, const Slice& key,
+                     std::string* value) = 0;
+  virtual Status Get(const ReadOptions& options, const Slice& key,
+                     std::string* value) {
+    return Get(options, GetDB()->DefaultColumnFamily(), key, value);
+  }
+
+  // Number of Get() calls answered by the session without reading the DB.
+  virtual uint64_t GetNumCacheHits() const = 0;
+
+  virtual DB* GetDB() const = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // ROCKSDB_LITE
@@ -184,6 +184,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"ttl",
          {0, OptionType::kUInt64T, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kNone}},
+        {"time_window_seconds",
+         {offsetof(struct CompactionOptionsFIFO, time_window_seconds),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"allow_compaction",
          {offsetof(struct CompactionOptionsFIFO, allow_compaction),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -410,6 +414,19 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, periodic_compaction_seconds),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"level_compaction_move_non_overlapping_files",
+         {offsetof(struct MutableCFOptions,
+                   level_compaction_move_non_overlapping_files),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"compaction_copy_clean_data_blocks",
+         {offsetof(struct MutableCFOptions, compaction_copy_clean_data_blocks),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"round_robin_cursors_per_level",
+         {offsetof(struct MutableCFOptions, round_robin_cursors_per_level),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"bottommost_temperature",
          {0, OptionType::kTemperature, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kMutable}},
@@ -1034,6 +1051,12 @@ void MutableCFOptions::Dump(Logger* log) const {
                  ttl);
   ROCKS_LOG_INFO(log, "              periodic_compaction_seconds: %" PRIu64,
                  periodic_compaction_seconds);
+  ROCKS_LOG_INFO(log, "level_compaction_move_non_overlapping_files: %d",
+                 level_compaction_move_non_overlapping_files);
+  ROCKS_LOG_INFO(log, "        compaction_copy_clean_data_blocks: %d",
+                 compaction_copy_clean_data_blocks);
+  ROCKS_LOG_INFO(log, "            round_robin_cursors_per_level: %" PRIu32,
+                 round_robin_cursors_per_level);
   std::string result;
   char buf[10];
   for (const auto m : max_bytes_for_level_multiplier_additional) {
@@ -1088,6 +1111,9 @@ void MutableCFOptions::Dump(Logger* log) const {
                  compaction_options_fifo.max_table_files_size);
   ROCKS_LOG_INFO(log, "compaction_options_fifo.allow_compaction : %d",
                  compaction_options_fifo.allow_compaction);
+  ROCKS_LOG_INFO(log,
+                 "compaction_options_fifo.time_window_seconds : %" PRIu64,
+                 compaction_options_fifo.time_window_seconds);
 
   // Blob file related options
   ROCKS_LOG_INFO(log, "                        enable_blob_files: %s",
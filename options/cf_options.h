@@ -132,6 +132,11 @@ struct MutableCFOptions {
         max_bytes_for_level_multiplier(options.max_bytes_for_level_multiplier),
         ttl(options.ttl),
         periodic_compaction_seconds(options.periodic_compaction_seconds),
+        level_compaction_move_non_overlapping_files(
+            options.level_compaction_move_non_overlapping_files),
+        compaction_copy_clean_data_blocks(
+            options.compaction_copy_clean_data_blocks),
+        round_robin_cursors_per_level(options.round_robin_cursors_per_level),
         max_bytes_for_level_multiplier_additional(
             options.max_bytes_for_level_multiplier_additional),
         compaction_options_fifo(options.compaction_options_fifo),
@@ -194,6 +199,9 @@ struct MutableCFOptions {
         max_bytes_for_level_multiplier(0),
         ttl(0),
         periodic_compaction_seconds(0),
+        level_compaction_move_non_overlapping_files(false),
+        compaction_copy_clean_data_blocks(false),
+        round_robin_cursors_per_level(1),
         compaction_options_fifo(),
         enable_blob_files(false),
         min_blob_size(0),
@@ -275,6 +283,9 @@ struct MutableCFOptions {
   double max_bytes_for_level_multiplier;
   uint64_t ttl;
   uint64_t periodic_compaction_seconds;
+  bool level_compaction_move_non_overlapping_files;
+  bool compaction_copy_clean_data_blocks;
+  uint32_t round_robin_cursors_per_level;
   std::vector<int> max_bytes_for_level_multiplier_additional;
   CompactionOptionsFIFO compaction_options_fifo;
   CompactionOptionsUniversal compaction_options_universal;
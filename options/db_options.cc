@@ -387,6 +387,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, wal_compression),
           OptionType::kCompressionType, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"num_wal_streams",
+         {offsetof(struct ImmutableDBOptions, num_wal_streams),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"seq_per_batch",
          {0, OptionType::kBoolean, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kNone}},
@@ -558,6 +562,25 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, enforce_single_del_contracts),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"enable_subcompaction_work_stealing",
+         {offsetof(struct ImmutableDBOptions,
+                   enable_subcompaction_work_stealing),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"compaction_scheduling_by_stall_deadline",
+         {offsetof(struct ImmutableDBOptions,
+                   compaction_scheduling_by_stall_deadline),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"bottommost_compaction_preemption_micros",
+         {offsetof(struct ImmutableDBOptions,
+                   bottommost_compaction_preemption_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"block_cache_dump_file",
+         {offsetof(struct ImmutableDBOptions, block_cache_dump_file),
+          OptionType::kString, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 const std::string OptionsHelper::kDBOptionsName = "DBOptions";
@@ -744,6 +767,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       two_write_queues(options.two_write_queues),
       manual_wal_flush(options.manual_wal_flush),
       wal_compression(options.wal_compression),
+      num_wal_streams(options.num_wal_streams),
       atomic_flush(options.atomic_flush),
       avoid_unnecessary_blocking_io(options.avoid_unnecessary_blocking_io),
       persist_stats_to_disk(options.persist_stats_to_disk),
@@ -758,7 +782,14 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       checksum_handoff_file_types(options.checksum_handoff_file_types),
       lowest_used_cache_tier(options.lowest_used_cache_tier),
       compaction_service(options.compaction_service),
-      enforce_single_del_contracts(options.enforce_single_del_contracts) {
+      enforce_single_del_contracts(options.enforce_single_del_contracts),
+      enable_subcompaction_work_stealing(
+          options.enable_subcompaction_work_stealing),
+      compaction_scheduling_by_stall_deadline(
+          options.compaction_scheduling_by_stall_deadline),
+      bottommost_compaction_preemption_micros(
+          options.bottommost_compaction_preemption_micros),
+      block_cache_dump_file(options.block_cache_dump_file) {
   fs = env->GetFileSystem();
   clock = env->GetSystemClock().get();
   logger = info_log.get();
@@ -903,6 +934,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    manual_wal_flush);
   ROCKS_LOG_HEADER(log, "            Options.wal_compression: %d",
                    wal_compression);
+  ROCKS_LOG_HEADER(log, "            Options.num_wal_streams: %d",
+                   num_wal_streams);
   ROCKS_LOG_HEADER(log, "            Options.atomic_flush: %d", atomic_flush);
   ROCKS_LOG_HEADER(log,
                    "            Options.avoid_unnecessary_blocking_io: %d",
@@ -930,6 +963,17 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    db_host_id.c_str());
   ROCKS_LOG_HEADER(log, "            Options.enforce_single_del_contracts: %s",
                    enforce_single_del_contracts ? "true" : "false");
+  ROCKS_LOG_HEADER(log,
+                   "      Options.enable_subcompaction_work_stealing: %s",
+                   enable_subcompaction_work_stealing ? "true" : "false");
+  ROCKS_LOG_HEADER(log,
+                   " Options.compaction_scheduling_by_stall_deadline: %s",
+                   compaction_scheduling_by_stall_deadline ? "true" : "false");
+  ROCKS_LOG_HEADER(log,
+                   " Options.bottommost_compaction_preemption_micros: %" PRIu64,
+                   bottommost_compaction_preemption_micros);
+  ROCKS_LOG_HEADER(log, "           Options.block_cache_dump_file: %s",
+                   block_cache_dump_file.c_str());
 }
 
 bool ImmutableDBOptions::IsWalDirSameAsDBPath() const {
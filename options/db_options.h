@@ -86,6 +86,7 @@ struct ImmutableDBOptions {
   bool two_write_queues;
   bool manual_wal_flush;
   CompressionType wal_compression;
+  int num_wal_streams;
   bool atomic_flush;
   bool avoid_unnecessary_blocking_io;
   bool persist_stats_to_disk;
@@ -106,6 +107,10 @@ struct ImmutableDBOptions {
   Logger* logger;
   std::shared_ptr<CompactionService> compaction_service;
   bool enforce_single_del_contracts;
+  bool enable_subcompaction_work_stealing;
+  bool compaction_scheduling_by_stall_deadline;
+  uint64_t bottommost_compaction_preemption_micros;
+  std::string block_cache_dump_file;
 
   bool IsWalDirSameAsDBPath() const;
   bool IsWalDirSameAsDBPath(const std::string& path) const;
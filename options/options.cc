@@ -91,6 +91,11 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       report_bg_io_stats(options.report_bg_io_stats),
       ttl(options.ttl),
       periodic_compaction_seconds(options.periodic_compaction_seconds),
+      level_compaction_move_non_overlapping_files(
+          options.level_compaction_move_non_overlapping_files),
+      compaction_copy_clean_data_blocks(
+          options.compaction_copy_clean_data_blocks),
+      round_robin_cursors_per_level(options.round_robin_cursors_per_level),
       sample_for_compression(options.sample_for_compression),
       preclude_last_level_data_seconds(
           options.preclude_last_level_data_seconds),
@@ -355,6 +360,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "Options.compaction_options_fifo.allow_compaction: %d",
                      compaction_options_fifo.allow_compaction);
+    ROCKS_LOG_HEADER(
+        log, "Options.compaction_options_fifo.time_window_seconds: %" PRIu64,
+        compaction_options_fifo.time_window_seconds);
     std::ostringstream collector_info;
     for (const auto& collector_factory : table_properties_collector_factories) {
       collector_info << collector_factory->ToString() << ';';
@@ -401,6 +409,15 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "         Options.periodic_compaction_seconds: %" PRIu64,
                      periodic_compaction_seconds);
+    ROCKS_LOG_HEADER(log,
+                     "Options.level_compaction_move_non_overlapping_files: %d",
+                     level_compaction_move_non_overlapping_files);
+    ROCKS_LOG_HEADER(log,
+                     "  Options.compaction_copy_clean_data_blocks: %d",
+                     compaction_copy_clean_data_blocks);
+    ROCKS_LOG_HEADER(log,
+                     "      Options.round_robin_cursors_per_level: %" PRIu32,
+                     round_robin_cursors_per_level);
     ROCKS_LOG_HEADER(log, " Options.preclude_last_level_data_seconds: %" PRIu64,
                      preclude_last_level_data_seconds);
     ROCKS_LOG_HEADER(log, "                      Options.enable_blob_files: %s",
@@ -168,6 +168,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.two_write_queues = immutable_db_options.two_write_queues;
   options.manual_wal_flush = immutable_db_options.manual_wal_flush;
   options.wal_compression = immutable_db_options.wal_compression;
+  options.num_wal_streams = immutable_db_options.num_wal_streams;
   options.atomic_flush = immutable_db_options.atomic_flush;
   options.avoid_unnecessary_blocking_io =
       immutable_db_options.avoid_unnecessary_blocking_io;
@@ -186,6 +187,13 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.lowest_used_cache_tier = immutable_db_options.lowest_used_cache_tier;
   options.enforce_single_del_contracts =
       immutable_db_options.enforce_single_del_contracts;
+  options.enable_subcompaction_work_stealing =
+      immutable_db_options.enable_subcompaction_work_stealing;
+  options.compaction_scheduling_by_stall_deadline =
+      immutable_db_options.compaction_scheduling_by_stall_deadline;
+  options.bottommost_compaction_preemption_micros =
+      immutable_db_options.bottommost_compaction_preemption_micros;
+  options.block_cache_dump_file = immutable_db_options.block_cache_dump_file;
   return options;
 }
 
@@ -236,6 +244,12 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
       moptions.max_bytes_for_level_multiplier;
   cf_opts->ttl = moptions.ttl;
   cf_opts->periodic_compaction_seconds = moptions.periodic_compaction_seconds;
+  cf_opts->level_compaction_move_non_overlapping_files =
+      moptions.level_compaction_move_non_overlapping_files;
+  cf_opts->compaction_copy_clean_data_blocks =
+      moptions.compaction_copy_clean_data_blocks;
+  cf_opts->round_robin_cursors_per_level =
+      moptions.round_robin_cursors_per_level;
 
   cf_opts->max_bytes_for_level_multiplier_additional.clear();
   for (auto value : moptions.max_bytes_for_level_multiplier_additional) {
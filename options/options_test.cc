@@ -2087,6 +2087,22 @@ TEST_F(OptionsTest, SstPartitionerTest) {
   ASSERT_OK(RocksDBOptionsParser::VerifyCFOptions(cfg_opts, cf_opts, new_opt));
   ASSERT_TRUE(cf_opts.sst_partitioner_factory->AreEquivalent(
       cfg_opts, new_opt.sst_partitioner_factory.get(), &mismatch));
+
+  ASSERT_OK(GetColumnFamilyOptionsFromString(
+      cfg_opts, ColumnFamilyOptions(),
+      std::string("sst_partitioner_factory={id=") +
+          SstPartitionerNextLevelAlignedFactory::kClassName() +
+          "; min_file_size=1024; max_file_size=4096;}",
+      &cf_opts));
+  ASSERT_NE(cf_opts.sst_partitioner_factory, nullptr);
+  ASSERT_STREQ(cf_opts.sst_partitioner_factory->Name(),
+               SstPartitionerNextLevelAlignedFactory::kClassName());
+  ASSERT_EQ(1024U,
+            *cf_opts.sst_partitioner_factory->GetOptions<uint64_t>(
+                "MinFileSize"));
+  ASSERT_EQ(4096U,
+            *cf_opts.sst_partitioner_factory->GetOptions<uint64_t>(
+                "MaxFileSize"));
 }
 
 TEST_F(OptionsTest, FileChecksumGenFactoryTest) {
@@ -64,7 +64,9 @@ InternalIteratorBase<IndexValue>* BinarySearchIndexReader::NewIterator(
   auto it = index_block.GetValue()->NewIndexIterator(
       internal_comparator()->user_comparator(),
       rep->get_global_seqno(BlockType::kIndex), iter, kNullStats, true,
-      index_has_first_key(), index_key_includes_seq(), index_value_is_full());
+      index_has_first_key(), index_key_includes_seq(), index_value_is_full(),
+      /* block_contents_pinned */ false, /* prefix_index */ nullptr,
+      index_has_block_summary());
 
   assert(it != nullptr);
   index_block.TransferTo(it);
@@ -224,13 +224,18 @@ class Block {
   // first_internal_key. It affects data serialization format, so the same value
   // have_first_key must be used when writing and reading index.
   // It is determined by IndexType property of the table.
+  //
+  // `have_block_summary` likewise controls whether IndexValue will contain
+  // block_summary. It is determined by the kDataBlockSummaryCollector
+  // property of the table.
   IndexBlockIter* NewIndexIterator(const Comparator* raw_ucmp,
                                    SequenceNumber global_seqno,
                                    IndexBlockIter* iter, Statistics* stats,
                                    bool total_order_seek, bool have_first_key,
                                    bool key_includes_seq, bool value_is_full,
                                    bool block_contents_pinned = false,
-                                   BlockPrefixIndex* prefix_index = nullptr);
+                                   BlockPrefixIndex* prefix_index = nullptr,
+                                   bool have_block_summary = false);
 
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
@@ -627,14 +632,16 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   void Initialize(const Comparator* raw_ucmp, const char* data,
                   uint32_t restarts, uint32_t num_restarts,
                   SequenceNumber global_seqno, BlockPrefixIndex* prefix_index,
-                  bool have_first_key, bool key_includes_seq,
-                  bool value_is_full, bool block_contents_pinned) {
+                  bool have_first_key, bool have_block_summary,
+                  bool key_includes_seq, bool value_is_full,
+                  bool block_contents_pinned) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts,
                    kDisableGlobalSequenceNumber, block_contents_pinned);
     raw_key_.SetIsUserKey(!key_includes_seq);
     prefix_index_ = prefix_index;
     value_delta_encoded_ = !value_is_full;
     have_first_key_ = have_first_key;
+    have_block_summary_ = have_block_summary;
     if (have_first_key_ && global_seqno != kDisableGlobalSequenceNumber) {
       global_seqno_state_.reset(new GlobalSeqnoState(global_seqno));
     } else {
@@ -655,7 +662,7 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
       IndexValue entry;
       Slice v = value_;
       Status decode_s __attribute__((__unused__)) =
-          entry.DecodeFrom(&v, have_first_key_, nullptr);
+          entry.DecodeFrom(&v, have_first_key_, nullptr, have_block_summary_);
       assert(decode_s.ok());
       return entry;
     }
@@ -696,7 +703,8 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
 
  private:
   bool value_delta_encoded_;
-  bool have_first_key_;  // value includes first_internal_key
+  bool have_first_key_;      // value includes first_internal_key
+  bool have_block_summary_;  // value includes block_summary
   BlockPrefixIndex* prefix_index_;
   // Whether the value is delta encoded. In that case the value is assumed to be
   // BlockHandle. The first value in each restart interval is the full encoded
@@ -45,6 +45,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/partitioned_filter_block.h"
+#include "table/block_based/reader_common.h"
 #include "table/format.h"
 #include "table/meta_blocks.h"
 #include "table/table_builder.h"
@@ -109,6 +110,21 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
   return compressed_size < raw_size - (raw_size / 8u);
 }
 
+void UpdatePropertiesForEntry(const Slice& key, const Slice& value,
+                              ValueType value_type, TableProperties* props) {
+  props->num_entries++;
+  props->raw_key_size += key.size();
+  props->raw_value_size += value.size();
+  if (value_type == kTypeDeletion || value_type == kTypeSingleDeletion) {
+    props->num_deletions++;
+  } else if (value_type == kTypeRangeDeletion) {
+    props->num_deletions++;
+    props->num_range_deletions++;
+  } else if (value_type == kTypeMerge) {
+    props->num_merge_operands++;
+  }
+}
+
 }  // namespace
 
 // format_version is the block format as defined in include/rocksdb/table.h
@@ -204,10 +220,11 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
  public:
   explicit BlockBasedTablePropertiesCollector(
       BlockBasedTableOptions::IndexType index_type, bool whole_key_filtering,
-      bool prefix_filtering)
+      bool prefix_filtering, const char* data_block_summary_collector)
       : index_type_(index_type),
         whole_key_filtering_(whole_key_filtering),
-        prefix_filtering_(prefix_filtering) {}
+        prefix_filtering_(prefix_filtering),
+        data_block_summary_collector_(data_block_summary_collector) {}
 
   Status InternalAdd(const Slice& /*key*/, const Slice& /*value*/,
                      uint64_t /*file_size*/) override {
@@ -232,6 +249,11 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
                         whole_key_filtering_ ? kPropTrue : kPropFalse});
     properties->insert({BlockBasedTablePropertyNames::kPrefixFiltering,
                         prefix_filtering_ ? kPropTrue : kPropFalse});
+    if (data_block_summary_collector_ != nullptr) {
+      properties->insert(
+          {BlockBasedTablePropertyNames::kDataBlockSummaryCollector,
+           data_block_summary_collector_});
+    }
     return Status::OK();
   }
 
@@ -249,6 +271,8 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
   BlockBasedTableOptions::IndexType index_type_;
   bool whole_key_filtering_;
   bool prefix_filtering_;
+  // nullptr if the index doesn't store data block summaries
+  const char* data_block_summary_collector_;
 };
 
 struct BlockBasedTableBuilder::Rep {
@@ -264,6 +288,9 @@ struct BlockBasedTableBuilder::Rep {
   // compression dictionary is enabled so we can finalize the dictionary before
   // compressing any data blocks.
   std::vector<std::string> data_block_buffers;
+  // Summaries of the blocks in `data_block_buffers`, if
+  // `data_block_summary_collector` is set.
+  std::vector<std::string> data_block_summaries;
   BlockBuilder range_del_block;
 
   InternalKeySliceTransform internal_prefix_transform;
@@ -324,12 +351,18 @@ struct BlockBasedTableBuilder::Rep {
   const TableFileCreationReason reason;
 
   BlockHandle pending_handle;  // Handle to add to index block
+  // Set if the last data block was added by AddRawDataBlock() and its index
+  // entry still has to be added.
+  bool raw_data_block_pending = false;
 
   std::string compressed_output;
   std::unique_ptr<FlushBlockPolicy> flush_block_policy;
 
   std::vector<std::unique_ptr<IntTblPropCollector>> table_properties_collectors;
 
+  // Set if the index stores data block summaries.
+  std::unique_ptr<DataBlockSummaryCollector> data_block_summary_collector;
+
   std::unique_ptr<ParallelCompressionRep> pc_rep;
 
   uint64_t get_offset() { return offset.load(std::memory_order_relaxed); }
@@ -522,10 +555,27 @@ struct BlockBasedTableBuilder::Rep {
           factory->CreateIntTblPropCollector(tbo.column_family_id,
                                              tbo.level_at_creation));
     }
+    const char* data_block_summary_collector_name = nullptr;
+    if (table_options.data_block_summary_collector_factory != nullptr &&
+        (table_options.index_type == BlockBasedTableOptions::kBinarySearch ||
+         table_options.index_type ==
+             BlockBasedTableOptions::kBinarySearchWithFirstKey)) {
+      // The index builder stores a (possibly empty) summary in every entry,
+      // so the property must be recorded even if no collector is created.
+      TablePropertiesCollectorFactory::Context context;
+      context.column_family_id = tbo.column_family_id;
+      context.level_at_creation = tbo.level_at_creation;
+      data_block_summary_collector.reset(
+          table_options.data_block_summary_collector_factory
+              ->CreateDataBlockSummaryCollector(context));
+      data_block_summary_collector_name =
+          table_options.data_block_summary_collector_factory->Name();
+    }
     table_properties_collectors.emplace_back(
         new BlockBasedTablePropertiesCollector(
             table_options.index_type, table_options.whole_key_filtering,
-            moptions.prefix_extractor != nullptr));
+            moptions.prefix_extractor != nullptr,
+            data_block_summary_collector_name));
     const Comparator* ucmp = tbo.internal_comparator.user_comparator();
     assert(ucmp);
     if (ucmp->timestamp_size() > 0) {
@@ -613,6 +663,7 @@ struct BlockBasedTableBuilder::ParallelCompressionRep {
     std::unique_ptr<std::string> first_key_in_next_block;
     std::unique_ptr<Keys> keys;
     std::unique_ptr<BlockRepSlot> slot;
+    std::string block_summary;
     Status status;
   };
   // Use a vector of BlockRep as a buffer for a determined number
@@ -922,7 +973,13 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
 #endif  // !NDEBUG
 
     auto should_flush = r->flush_block_policy->Update(key, value);
-    if (should_flush) {
+    if (r->raw_data_block_pending) {
+      // The last data block was added as is, so only its index entry is
+      // missing.
+      assert(r->data_block.empty());
+      r->raw_data_block_pending = false;
+      r->index_builder->AddIndexEntry(&r->last_key, &key, r->pending_handle);
+    } else if (should_flush) {
       assert(!r->data_block.empty());
       r->first_key_in_next_block = &key;
       Flush();
@@ -981,6 +1038,10 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
 
     r->data_block.AddWithLastKey(key, value, r->last_key);
     r->last_key.assign(key.data(), key.size());
+    if (r->data_block_summary_collector != nullptr) {
+      r->data_block_summary_collector->Add(ExtractUserKey(key), value,
+                                           GetEntryType(value_type));
+    }
     if (r->state == Rep::State::kBuffered) {
       // Buffered keys will be replayed from data_block_buffers during
       // `Finish()` once compression dictionary has been finalized.
@@ -1004,17 +1065,101 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
     assert(false);
   }
 
-  r->props.num_entries++;
-  r->props.raw_key_size += key.size();
-  r->props.raw_value_size += value.size();
-  if (value_type == kTypeDeletion || value_type == kTypeSingleDeletion) {
-    r->props.num_deletions++;
-  } else if (value_type == kTypeRangeDeletion) {
-    r->props.num_deletions++;
-    r->props.num_range_deletions++;
-  } else if (value_type == kTypeMerge) {
-    r->props.num_merge_operands++;
+  UpdatePropertiesForEntry(key, value, value_type, &r->props);
+}
+
+Status BlockBasedTableBuilder::AddRawDataBlock(const Slice& contents,
+                                               CompressionType type,
+                                               uint32_t format_version,
+                                               const Slice& uncompressed) {
+  Rep* r = rep_;
+  assert(r->state != Rep::State::kClosed);
+  if (!ok()) {
+    return status();
+  }
+  if (r->state != Rep::State::kUnbuffered ||
+      r->IsParallelCompressionEnabled()) {
+    return Status::NotSupported(
+        "Raw data blocks cannot be added with compression dictionary or "
+        "parallel compression");
+  }
+  if (type != r->compression_type ||
+      (type != kNoCompression &&
+       GetCompressFormatForVersion(format_version) !=
+           GetCompressFormatForVersion(r->table_options.format_version))) {
+    return Status::NotSupported(
+        "Compression of the data block does not match the table");
+  }
+
+  Block block{BlockContents(uncompressed)};
+  std::unique_ptr<DataBlockIter> iter(block.NewDataIterator(
+      r->internal_comparator.user_comparator(), kDisableGlobalSequenceNumber));
+  iter->SeekToFirst();
+  if (!iter->Valid()) {
+    return iter->status().ok() ? Status::InvalidArgument("Empty data block")
+                               : iter->status();
+  }
+  const std::string first_key = iter->key().ToString();
+  const Slice first_key_slice(first_key);
+  assert(r->props.num_entries <= r->props.num_range_deletions ||
+         r->internal_comparator.Compare(first_key_slice, r->last_key) > 0);
+
+  // The index entry of the previous data block can use the first key of this
+  // one.
+  if (!r->data_block.empty()) {
+    r->first_key_in_next_block = &first_key_slice;
+    Flush();
+    if (!ok()) {
+      return status();
+    }
+    r->index_builder->AddIndexEntry(&r->last_key, &first_key_slice,
+                                    r->pending_handle);
+  } else if (r->raw_data_block_pending) {
+    r->index_builder->AddIndexEntry(&r->last_key, &first_key_slice,
+                                    r->pending_handle);
+  }
+  r->raw_data_block_pending = false;
+
+  // Everything but the data block itself is rebuilt from its entries.
+  const size_t ts_sz =
+      r->internal_comparator.user_comparator()->timestamp_size();
+  for (; iter->Valid(); iter->Next()) {
+    const Slice key = iter->key();
+    const Slice value = iter->value();
+    ValueType value_type = ExtractValueType(key);
+    if (r->filter_builder != nullptr) {
+      r->filter_builder->Add(ExtractUserKeyAndStripTimestamp(key, ts_sz));
+    }
+    if (r->data_block_summary_collector != nullptr) {
+      r->data_block_summary_collector->Add(ExtractUserKey(key), value,
+                                           GetEntryType(value_type));
+    }
+    r->index_builder->OnKeyAdded(key);
+    NotifyCollectTableCollectorsOnAdd(key, value, r->get_offset(),
+                                      r->table_properties_collectors,
+                                      r->ioptions.logger);
+    UpdatePropertiesForEntry(key, value, value_type, &r->props);
+    r->last_key.assign(key.data(), key.size());
   }
+  r->SetStatus(iter->status());
+  if (!ok()) {
+    return status();
+  }
+  if (r->data_block_summary_collector != nullptr) {
+    std::string block_summary;
+    r->data_block_summary_collector->FinishBlock(&block_summary);
+    r->index_builder->OnDataBlockSummary(block_summary);
+  }
+
+  WriteRawBlock(contents, type, &r->pending_handle, BlockType::kData,
+                &uncompressed);
+  if (!ok()) {
+    return status();
+  }
+  r->props.data_size = r->get_offset();
+  ++r->props.num_data_blocks;
+  r->raw_data_block_pending = true;
+  return Status::OK();
 }
 
 void BlockBasedTableBuilder::Flush() {
@@ -1022,16 +1167,28 @@ void BlockBasedTableBuilder::Flush() {
   assert(rep_->state != Rep::State::kClosed);
   if (!ok()) return;
   if (r->data_block.empty()) return;
+  std::string block_summary;
+  if (r->data_block_summary_collector != nullptr) {
+    r->data_block_summary_collector->FinishBlock(&block_summary);
+  }
   if (r->IsParallelCompressionEnabled() &&
       r->state == Rep::State::kUnbuffered) {
     r->data_block.Finish();
     ParallelCompressionRep::BlockRep* block_rep = r->pc_rep->PrepareBlock(
         r->compression_type, r->first_key_in_next_block, &(r->data_block));
     assert(block_rep != nullptr);
+    block_rep->block_summary = std::move(block_summary);
     r->pc_rep->file_size_estimator.EmitBlock(block_rep->data->size(),
                                              r->get_offset());
     r->pc_rep->EmitBlock(block_rep);
   } else {
+    if (r->data_block_summary_collector == nullptr) {
+      // Nothing to do
+    } else if (r->state == Rep::State::kBuffered) {
+      r->data_block_summaries.emplace_back(std::move(block_summary));
+    } else {
+      r->index_builder->OnDataBlockSummary(block_summary);
+    }
     WriteBlock(&r->data_block, &r->pending_handle, BlockType::kData);
   }
 }
@@ -1364,6 +1521,9 @@ void BlockBasedTableBuilder::BGWorkWriteRawBlock() {
     r->props.data_size = r->get_offset();
     ++r->props.num_data_blocks;
 
+    if (r->data_block_summary_collector != nullptr) {
+      r->index_builder->OnDataBlockSummary(block_rep->block_summary);
+    }
     if (block_rep->first_key_in_next_block == nullptr) {
       r->index_builder->AddIndexEntry(&(block_rep->keys->Back()), nullptr,
                                       r->pending_handle);
@@ -1489,7 +1649,8 @@ Status BlockBasedTableBuilder::InsertBlockInCache(const Slice& block_contents,
                                                   const BlockHandle* handle,
                                                   BlockType block_type) {
   // Uncompressed regular block cache
-  Cache* block_cache = rep_->table_options.block_cache.get();
+  Cache* block_cache =
+      GetBlockCacheForBlockType(rep_->table_options, block_type);
   Status s;
   if (block_cache != nullptr) {
     size_t size = block_contents.size();
@@ -1921,10 +2082,16 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
           r->compression_type, first_key_in_next_block_ptr, &data_block, &keys);
 
       assert(block_rep != nullptr);
+      if (r->data_block_summary_collector != nullptr) {
+        block_rep->block_summary = std::move(r->data_block_summaries[i]);
+      }
       r->pc_rep->file_size_estimator.EmitBlock(block_rep->data->size(),
                                                r->get_offset());
       r->pc_rep->EmitBlock(block_rep);
     } else {
+      if (r->data_block_summary_collector != nullptr) {
+        r->index_builder->OnDataBlockSummary(r->data_block_summaries[i]);
+      }
       for (; iter->Valid(); iter->Next()) {
         Slice key = iter->key();
         if (r->filter_builder != nullptr) {
@@ -1950,6 +2117,7 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
     std::swap(iter, next_block_iter);
   }
   r->data_block_buffers.clear();
+  r->data_block_summaries.clear();
   r->data_begin_offset = 0;
   // Release all reserved cache for data block buffers
   if (r->compression_dict_buffer_cache_res_mgr != nullptr) {
@@ -1978,7 +2146,7 @@ Status BlockBasedTableBuilder::Finish() {
   } else {
     // To make sure properties block is able to keep the accurate size of index
     // block, we will finish writing all index entries first.
-    if (ok() && !empty_data_block) {
+    if (ok() && (!empty_data_block || r->raw_data_block_pending)) {
       r->index_builder->AddIndexEntry(
           &r->last_key, nullptr /* no next data block */, r->pending_handle);
     }
@@ -57,6 +57,12 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called
   void Add(const Slice& key, const Slice& value) override;
 
+  // Add a data block of another table as is. Not supported with compression
+  // dictionaries or parallel compression.
+  Status AddRawDataBlock(const Slice& contents, CompressionType type,
+                         uint32_t format_version,
+                         const Slice& uncompressed) override;
+
   // Return non-ok iff some error has been detected.
   Status status() const override;
 
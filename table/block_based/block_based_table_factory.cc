@@ -233,6 +233,7 @@ static std::unordered_map<std::string, OptionTypeInfo>
 #ifndef ROCKSDB_LITE
         /* currently not supported
           std::shared_ptr<Cache> block_cache = nullptr;
+          std::shared_ptr<Cache> metadata_block_cache = nullptr;
           std::shared_ptr<Cache> block_cache_compressed = nullptr;
           CacheUsageOptions cache_usage_options;
          */
@@ -393,6 +394,16 @@ static std::unordered_map<std::string, OptionTypeInfo>
             auto* cache = static_cast<std::shared_ptr<Cache>*>(addr);
             return Cache::CreateFromString(opts, value, cache);
           }}},
+        {"metadata_block_cache",
+         {offsetof(struct BlockBasedTableOptions, metadata_block_cache),
+          OptionType::kUnknown, OptionVerificationType::kNormal,
+          (OptionTypeFlags::kCompareNever | OptionTypeFlags::kDontSerialize),
+          // Parses the input value as a Cache
+          [](const ConfigOptions& opts, const std::string&,
+             const std::string& value, void* addr) {
+            auto* cache = static_cast<std::shared_ptr<Cache>*>(addr);
+            return Cache::CreateFromString(opts, value, cache);
+          }}},
         {"block_cache_compressed",
          {offsetof(struct BlockBasedTableOptions, block_cache_compressed),
           OptionType::kUnknown, OptionVerificationType::kNormal,
@@ -444,6 +455,18 @@ BlockBasedTableFactory::BlockBasedTableFactory(
             CacheEntryRole::kBlockBasedTableReader>>(
             table_options_.block_cache)));
   }
+
+  const auto read_buffer_charged =
+      table_options_.cache_usage_options.options_overrides
+          .at(CacheEntryRole::kReadBuffer)
+          .charged;
+  if (table_options_.block_cache &&
+      read_buffer_charged == CacheEntryRoleOptions::Decision::kEnabled) {
+    read_buffer_cache_res_mgr_.reset(new ConcurrentCacheReservationManager(
+        std::make_shared<
+            CacheReservationManagerImpl<CacheEntryRole::kReadBuffer>>(
+            table_options_.block_cache)));
+  }
 }
 
 void BlockBasedTableFactory::InitializeOptions() {
@@ -453,6 +476,7 @@ void BlockBasedTableFactory::InitializeOptions() {
   }
   if (table_options_.no_block_cache) {
     table_options_.block_cache.reset();
+    table_options_.metadata_block_cache.reset();
   } else if (table_options_.block_cache == nullptr) {
     LRUCacheOptions co;
     co.capacity = 8 << 20;
@@ -521,6 +545,11 @@ Status CheckCacheOptionCompatibility(const BlockBasedTableOptions& bbto) {
         "block_cache same as block_cache_compressed not currently supported, "
         "and would be bad for performance anyway");
   }
+  if (bbto.metadata_block_cache &&
+      bbto.metadata_block_cache == bbto.block_cache_compressed) {
+    return Status::InvalidArgument(
+        "metadata_block_cache same as block_cache_compressed not supported");
+  }
 
   // More complex test of shared key space, in case the instances are wrappers
   // for some shared underlying cache.
@@ -629,7 +658,7 @@ Status BlockBasedTableFactory::NewTableReader(
       table_reader_options.block_cache_tracer,
       table_reader_options.max_file_size_for_l0_meta_pin,
       table_reader_options.cur_db_session_id, table_reader_options.cur_file_num,
-      table_reader_options.unique_id);
+      table_reader_options.unique_id, read_buffer_cache_res_mgr_);
 }
 
 TableBuilder* BlockBasedTableFactory::NewTableBuilder(
@@ -685,6 +714,14 @@ Status BlockBasedTableFactory::ValidateOptions(
         "data_block_hash_table_util_ratio should be greater than 0 when "
         "data_block_index_type is set to kDataBlockBinaryAndHash");
   }
+  if (table_options_.data_block_summary_collector_factory != nullptr &&
+      table_options_.index_type != BlockBasedTableOptions::kBinarySearch &&
+      table_options_.index_type !=
+          BlockBasedTableOptions::kBinarySearchWithFirstKey) {
+    return Status::InvalidArgument(
+        "data_block_summary_collector_factory is only supported with "
+        "kBinarySearch and kBinarySearchWithFirstKey index types");
+  }
   if (db_opts.unordered_write && cf_opts.max_successive_merges > 0) {
     // TODO(myabandeh): support it
     return Status::InvalidArgument(
@@ -702,7 +739,7 @@ Status BlockBasedTableFactory::ValidateOptions(
         CacheEntryRole::kCompressionDictionaryBuildingBuffer,
         CacheEntryRole::kFilterConstruction,
         CacheEntryRole::kBlockBasedTableReader, CacheEntryRole::kFileMetadata,
-        CacheEntryRole::kBlobCache};
+        CacheEntryRole::kBlobCache, CacheEntryRole::kReadBuffer};
     if (options.charged != CacheEntryRoleOptions::Decision::kFallback &&
         kMemoryChargingSupported.count(role) == 0) {
       return Status::NotSupported(
@@ -778,6 +815,14 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
            table_options_.flush_block_policy_factory->Name(),
            static_cast<void*>(table_options_.flush_block_policy_factory.get()));
   ret.append(buffer);
+  if (table_options_.data_block_summary_collector_factory != nullptr) {
+    snprintf(buffer, kBufferSize,
+             "  data_block_summary_collector_factory: %s (%p)\n",
+             table_options_.data_block_summary_collector_factory->Name(),
+             static_cast<void*>(
+                 table_options_.data_block_summary_collector_factory.get()));
+    ret.append(buffer);
+  }
   snprintf(buffer, kBufferSize, "  cache_index_and_filter_blocks: %d\n",
            table_options_.cache_index_and_filter_blocks);
   ret.append(buffer);
@@ -822,6 +867,20 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
     ret.append("  block_cache_options:\n");
     ret.append(table_options_.block_cache->GetPrintableOptions());
   }
+  snprintf(buffer, kBufferSize, "  metadata_block_cache: %p\n",
+           static_cast<void*>(table_options_.metadata_block_cache.get()));
+  ret.append(buffer);
+  if (table_options_.metadata_block_cache) {
+    const char* metadata_block_cache_name =
+        table_options_.metadata_block_cache->Name();
+    if (metadata_block_cache_name != nullptr) {
+      snprintf(buffer, kBufferSize, "  metadata_block_cache_name: %s\n",
+               metadata_block_cache_name);
+      ret.append(buffer);
+    }
+    ret.append("  metadata_block_cache_options:\n");
+    ret.append(table_options_.metadata_block_cache->GetPrintableOptions());
+  }
   snprintf(buffer, kBufferSize, "  block_cache_compressed: %p\n",
            static_cast<void*>(table_options_.block_cache_compressed.get()));
   ret.append(buffer);
@@ -914,6 +973,8 @@ const void* BlockBasedTableFactory::GetOptionsPtr(
     } else {
       return table_options_.block_cache.get();
     }
+  } else if (name == kMetadataBlockCacheOpts()) {
+    return table_options_.metadata_block_cache.get();
   } else {
     return TableFactory::GetOptionsPtr(name);
   }
@@ -1048,6 +1109,8 @@ const std::string BlockBasedTablePropertyNames::kWholeKeyFiltering =
     "rocksdb.block.based.table.whole.key.filtering";
 const std::string BlockBasedTablePropertyNames::kPrefixFiltering =
     "rocksdb.block.based.table.prefix.filtering";
+const std::string BlockBasedTablePropertyNames::kDataBlockSummaryCollector =
+    "rocksdb.block.based.table.data.block.summary.collector";
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
@@ -60,6 +60,7 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target,
     } else {
       index_iter_->SeekToFirst();
     }
+    SkipFilteredBlocks(IterDirection::kForward);
 
     if (!index_iter_->Valid()) {
       ResetDataIter();
@@ -172,6 +173,12 @@ void BlockBasedTableIterator::SeekForPrev(const Slice& target) {
     }
   }
 
+  SkipFilteredBlocks(IterDirection::kBackward);
+  if (!index_iter_->Valid()) {
+    ResetDataIter();
+    return;
+  }
+
   InitDataBlock();
 
   block_iter_.SeekForPrev(target);
@@ -187,6 +194,7 @@ void BlockBasedTableIterator::SeekToLast() {
   is_at_first_key_from_index_ = false;
   SavePrevIndexValue();
   index_iter_->SeekToLast();
+  SkipFilteredBlocks(IterDirection::kBackward);
   if (!index_iter_->Valid()) {
     ResetDataIter();
     return;
@@ -223,6 +231,7 @@ void BlockBasedTableIterator::Prev() {
     is_at_first_key_from_index_ = false;
 
     index_iter_->Prev();
+    SkipFilteredBlocks(IterDirection::kBackward);
     if (!index_iter_->Valid()) {
       return;
     }
@@ -396,6 +405,7 @@ void BlockBasedTableIterator::FindBlockForward() {
       return;
     }
 
+    SkipFilteredBlocks(IterDirection::kForward);
     if (!index_iter_->Valid()) {
       return;
     }
@@ -421,6 +431,7 @@ void BlockBasedTableIterator::FindKeyBackward() {
 
     ResetDataIter();
     index_iter_->Prev();
+    SkipFilteredBlocks(IterDirection::kBackward);
 
     if (index_iter_->Valid()) {
       InitDataBlock();
@@ -434,6 +445,24 @@ void BlockBasedTableIterator::FindKeyBackward() {
   // code simplicity.
 }
 
+void BlockBasedTableIterator::SkipFilteredBlocks(IterDirection direction) {
+  if (!read_options_.block_summary_filter) {
+    return;
+  }
+  while (index_iter_->Valid()) {
+    IndexValue v = index_iter_->value();
+    if (v.block_summary.empty() ||
+        read_options_.block_summary_filter(v.block_summary)) {
+      return;
+    }
+    if (direction == IterDirection::kForward) {
+      index_iter_->Next();
+    } else {
+      index_iter_->Prev();
+    }
+  }
+}
+
 void BlockBasedTableIterator::CheckOutOfBound() {
   if (read_options_.iterate_upper_bound != nullptr &&
       block_upper_bound_check_ != BlockUpperBound::kUpperBoundBeyondCurBlock &&
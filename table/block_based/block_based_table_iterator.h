@@ -252,6 +252,10 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   void FindKeyBackward();
   void CheckOutOfBound();
 
+  // Moves index_iter_ in `direction` past the data blocks that
+  // ReadOptions::block_summary_filter rules out.
+  void SkipFilteredBlocks(IterDirection direction);
+
   // Check if data block is fully within iterate_upper_bound.
   //
   // Note MyRocks may update iterate bounds between seek. To workaround it,
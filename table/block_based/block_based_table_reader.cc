@@ -58,6 +58,7 @@
 #include "table/block_based/hash_index_reader.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_based/partitioned_index_reader.h"
+#include "table/block_based/reader_common.h"
 #include "table/block_fetcher.h"
 #include "table/format.h"
 #include "table/get_context.h"
@@ -408,6 +409,43 @@ Cache::Handle* BlockBasedTable::GetEntryFromCache(
   return cache_handle;
 }
 
+void BlockBasedTable::MultiGetDataBlocksFromCache(
+    Cache* block_cache, const Slice* keys, size_t num_keys,
+    GetContext* const* get_contexts,
+    CachableEntry<Block>* const* blocks) const {
+  assert(num_keys <= MultiGetContext::MAX_BATCH_SIZE);
+  Statistics* statistics = rep_->ioptions.statistics.get();
+  const Cache::CacheItemHelper* cache_helper = nullptr;
+  Cache::CreateCallback create_cb;
+  if (rep_->ioptions.lowest_used_cache_tier ==
+      CacheTier::kNonVolatileBlockTier) {
+    cache_helper = BlocklikeTraits<Block>::GetCacheItemHelper(BlockType::kData);
+    create_cb = GetCreateCallback<Block>(
+        rep_->table_options.read_amp_bytes_per_bit, statistics,
+        rep_->blocks_definitely_zstd_compressed, rep_->filter_policy);
+  }
+  std::array<Cache::Handle*, MultiGetContext::MAX_BATCH_SIZE> cache_handles;
+  block_cache->LookupMany(keys, num_keys, cache_handles.data(), cache_helper,
+                          create_cb, Cache::Priority::LOW, /*wait=*/false,
+                          statistics);
+  for (size_t i = 0; i < num_keys; ++i) {
+    Cache::Handle* cache_handle = cache_handles[i];
+    // Same as GetEntryFromCache(), pending lookups update the metrics once
+    // they complete
+    if (cache_handle == nullptr) {
+      UpdateCacheMissMetrics(BlockType::kData, get_contexts[i]);
+      continue;
+    }
+    if (block_cache->Value(cache_handle)) {
+      UpdateCacheHitMetrics(BlockType::kData, get_contexts[i],
+                            block_cache->GetUsage(cache_handle));
+    }
+    blocks[i]->SetCachedValue(
+        reinterpret_cast<Block*>(block_cache->Value(cache_handle)),
+        block_cache, cache_handle);
+  }
+}
+
 template <typename TBlocklike>
 Status BlockBasedTable::InsertEntryToCache(
     const CacheTier& cache_tier, Cache* block_cache, const Slice& key,
@@ -589,7 +627,8 @@ Status BlockBasedTable::Open(
     TailPrefetchStats* tail_prefetch_stats,
     BlockCacheTracer* const block_cache_tracer,
     size_t max_file_size_for_l0_meta_pin, const std::string& cur_db_session_id,
-    uint64_t cur_file_num, UniqueId64x2 expected_unique_id) {
+    uint64_t cur_file_num, UniqueId64x2 expected_unique_id,
+    std::shared_ptr<CacheReservationManager> read_buffer_cache_res_mgr) {
   table_reader->reset();
 
   Status s;
@@ -653,6 +692,7 @@ Status BlockBasedTable::Open(
                                       internal_comparator, skip_filters,
                                       file_size, level, immortal_table);
   rep->file = std::move(file);
+  rep->read_buffer_cache_res_mgr = std::move(read_buffer_cache_res_mgr);
   rep->footer = footer;
 
   // For fully portable/stable cache keys, we need to read the properties
@@ -938,6 +978,12 @@ Status BlockBasedTable::ReadPropertiesBlock(
 
     rep_->index_has_first_key =
         rep_->index_type == BlockBasedTableOptions::kBinarySearchWithFirstKey;
+    rep_->index_has_block_summary =
+        (rep_->index_type == BlockBasedTableOptions::kBinarySearch ||
+         rep_->index_type ==
+             BlockBasedTableOptions::kBinarySearchWithFirstKey) &&
+        props.count(BlockBasedTablePropertyNames::kDataBlockSummaryCollector) >
+            0;
 
     s = GetGlobalSequenceNumber(*(rep_->table_properties), largest_seqno,
                                 &(rep_->global_seqno));
@@ -1567,7 +1613,8 @@ IndexBlockIter* BlockBasedTable::InitBlockIterator<IndexBlockIter>(
       rep->get_global_seqno(block_type), input_iter, rep->ioptions.stats,
       /* total_order_seek */ true, rep->index_has_first_key,
       rep->index_key_includes_seq, rep->index_value_is_full,
-      block_contents_pinned);
+      block_contents_pinned, /* prefix_index */ nullptr,
+      rep->index_has_block_summary);
 }
 
 // If contents is nullptr, this function looks up the block caches for the
@@ -1585,7 +1632,8 @@ Status BlockBasedTable::MaybeReadBlockAndLoadToCache(
     BlockContents* contents, bool async_read) const {
   assert(block_entry != nullptr);
   const bool no_io = (ro.read_tier == kBlockCacheTier);
-  Cache* block_cache = rep_->table_options.block_cache.get();
+  Cache* block_cache =
+      GetBlockCacheForBlockType(rep_->table_options, block_type);
   Cache* block_cache_compressed =
       rep_->table_options.block_cache_compressed.get();
 
@@ -2147,6 +2195,85 @@ Status BlockBasedTable::ApproximateKeyAnchors(const ReadOptions& read_options,
   return Status::OK();
 }
 
+Status BlockBasedTable::GetDataBlocks(const ReadOptions& read_options,
+                                      std::vector<DataBlock>* blocks) {
+  // The keys of a data block only make sense in another table if they do not
+  // depend on the global sequence number of this one, and the compressed
+  // contents if they do not depend on its compression dictionary.
+  if (rep_->global_seqno != kDisableGlobalSequenceNumber ||
+      !rep_->compression_dict_handle.IsNull()) {
+    return Status::NotSupported(
+        "Data blocks depend on the global sequence number or compression "
+        "dictionary of the table");
+  }
+  IndexBlockIter iiter_on_stack;
+  auto iiter = NewIndexIterator(
+      read_options, /*disable_prefix_seek=*/false, &iiter_on_stack,
+      /*get_context=*/nullptr, /*lookup_context=*/nullptr);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr.reset(iiter);
+  }
+  for (iiter->SeekToFirst(); iiter->Valid(); iiter->Next()) {
+    blocks->emplace_back(iiter->user_key(), iiter->value().handle);
+  }
+  return iiter->status();
+}
+
+namespace {
+void DeleteRawDataBlock(void* arg1, void* /*arg2*/) {
+  delete static_cast<Block*>(arg1);
+}
+}  // namespace
+
+Status BlockBasedTable::ReadRawDataBlock(const ReadOptions& read_options,
+                                         const BlockHandle& handle,
+                                         RawDataBlock* block) {
+  BlockFetcher block_fetcher(
+      rep_->file.get(), /*prefetch_buffer=*/nullptr, rep_->footer,
+      read_options, handle, &block->contents, rep_->ioptions,
+      /*do_uncompress=*/false, /*maybe_compressed=*/true, BlockType::kData,
+      UncompressionDict::GetEmptyDict(), rep_->persistent_cache_options,
+      GetMemoryAllocator(rep_->table_options),
+      GetMemoryAllocatorForCompressedBlock(rep_->table_options),
+      /*for_compaction=*/true);
+  Status s = block_fetcher.ReadBlockContents();
+  if (!s.ok()) {
+    return s;
+  }
+  if (!block->contents.own_bytes()) {
+    // The block may outlive the table reader, e.g. for mmap reads.
+    const size_t size = block->contents.data.size();
+    CacheAllocationPtr buf =
+        AllocateBlock(size, GetMemoryAllocator(rep_->table_options));
+    memcpy(buf.get(), block->contents.data.data(), size);
+    block->contents = BlockContents(std::move(buf), size);
+  }
+  block->compression_type = block_fetcher.get_compression_type();
+  block->format_version = rep_->footer.format_version();
+  if (block->compression_type == kNoCompression) {
+    block->uncompressed = BlockContents(block->contents.data);
+  } else {
+    UncompressionContext context(block->compression_type);
+    UncompressionInfo info(context, UncompressionDict::GetEmptyDict(),
+                           block->compression_type);
+    s = UncompressBlockContents(info, block->contents.data.data(),
+                                block->contents.data.size(),
+                                &block->uncompressed,
+                                rep_->footer.format_version(), rep_->ioptions,
+                                GetMemoryAllocator(rep_->table_options));
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  Block* data_block = new Block(BlockContents(block->uncompressed.data));
+  block->iter.reset(data_block->NewDataIterator(
+      rep_->internal_comparator.user_comparator(),
+      kDisableGlobalSequenceNumber));
+  block->iter->RegisterCleanup(&DeleteRawDataBlock, data_block, nullptr);
+  return Status::OK();
+}
+
 Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
                             GetContext* get_context,
                             const SliceTransform* prefix_extractor,
@@ -2974,8 +3101,9 @@ Status BlockBasedTable::DumpIndexBlock(std::ostream& out_stream) {
     }
 
     out_stream << "  HEX    " << user_key.ToString(true) << ": "
-               << blockhandles_iter->value().ToString(true,
-                                                      rep_->index_has_first_key)
+               << blockhandles_iter->value().ToString(
+                      true, rep_->index_has_first_key,
+                      rep_->index_has_block_summary)
                << "\n";
 
     std::string str_key = user_key.ToString();
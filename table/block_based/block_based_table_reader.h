@@ -91,6 +91,8 @@ class BlockBasedTable : public TableReader {
   //    are set.
   // @param force_direct_prefetch if true, always prefetching to RocksDB
   //    buffer, rather than calling RandomAccessFile::Prefetch().
+  // @param read_buffer_cache_res_mgr if not null, the readahead buffers of
+  //    iterators over this table are charged to the block cache through it.
   static Status Open(
       const ReadOptions& ro, const ImmutableOptions& ioptions,
       const EnvOptions& env_options,
@@ -109,7 +111,9 @@ class BlockBasedTable : public TableReader {
       BlockCacheTracer* const block_cache_tracer = nullptr,
       size_t max_file_size_for_l0_meta_pin = 0,
       const std::string& cur_db_session_id = "", uint64_t cur_file_num = 0,
-      UniqueId64x2 expected_unique_id = {});
+      UniqueId64x2 expected_unique_id = {},
+      std::shared_ptr<CacheReservationManager> read_buffer_cache_res_mgr =
+          nullptr);
 
   bool PrefixRangeMayMatch(const Slice& internal_key,
                            const ReadOptions& read_options,
@@ -173,6 +177,13 @@ class BlockBasedTable : public TableReader {
   Status ApproximateKeyAnchors(const ReadOptions& read_options,
                                std::vector<Anchor>& anchors) override;
 
+  Status GetDataBlocks(const ReadOptions& read_options,
+                       std::vector<DataBlock>* blocks) override;
+
+  Status ReadRawDataBlock(const ReadOptions& read_options,
+                          const BlockHandle& handle,
+                          RawDataBlock* block) override;
+
   bool TEST_BlockInCache(const BlockHandle& handle) const;
 
   // Returns true if the block for the specified key is in cache.
@@ -323,6 +334,15 @@ class BlockBasedTable : public TableReader {
                                    const Cache::CreateCallback& create_cb,
                                    Cache::Priority priority) const;
 
+  // Looks up the data blocks with the given cache keys in the block cache
+  // with a single Cache::LookupMany() call, and sets *blocks[i] to the entry
+  // for keys[i] when it is found. As with GetEntryFromCache(), the entry may
+  // still be pending if the cache has a secondary tier.
+  void MultiGetDataBlocksFromCache(Cache* block_cache, const Slice* keys,
+                                   size_t num_keys,
+                                   GetContext* const* get_contexts,
+                                   CachableEntry<Block>* const* blocks) const;
+
   template <typename TBlocklike>
   Status InsertEntryToCache(const CacheTier& cache_tier, Cache* block_cache,
                             const Slice& key,
@@ -625,6 +645,7 @@ struct BlockBasedTable::Rep {
 
   // These describe how index is encoded.
   bool index_has_first_key = false;
+  bool index_has_block_summary = false;
   bool index_key_includes_seq = true;
   bool index_value_is_full = true;
 
@@ -633,6 +654,9 @@ struct BlockBasedTable::Rep {
   std::unique_ptr<CacheReservationManager::CacheReservationHandle>
       table_reader_cache_res_handle = nullptr;
 
+  // Charges the readahead buffers of iterators to the block cache, if set
+  std::shared_ptr<CacheReservationManager> read_buffer_cache_res_mgr;
+
   SequenceNumber get_global_seqno(BlockType block_type) const {
     return (block_type == BlockType::kFilterPartitionIndex ||
             block_type == BlockType::kCompressionDictionary)
@@ -667,7 +691,7 @@ struct BlockBasedTable::Rep {
         !ioptions.allow_mmap_reads /* enable */, false /* track_min_offset */,
         implicit_auto_readahead, num_file_reads,
         num_file_reads_for_auto_readahead, ioptions.fs.get(), ioptions.clock,
-        ioptions.stats));
+        ioptions.stats, read_buffer_cache_res_mgr));
   }
 
   void CreateFilePrefetchBufferIfNotExists(
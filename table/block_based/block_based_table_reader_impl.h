@@ -88,7 +88,8 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(
 
   if (!block.IsCached()) {
     if (!ro.fill_cache) {
-      Cache* const block_cache = rep_->table_options.block_cache.get();
+      Cache* const block_cache =
+          GetBlockCacheForBlockType(rep_->table_options, block_type);
       if (block_cache) {
         // insert a dummy record to block cache to track the memory usage
         Cache::Handle* cache_handle = nullptr;
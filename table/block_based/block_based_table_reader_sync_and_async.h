@@ -375,6 +375,20 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::MultiGet)
       ReadOptions ro = read_options;
       ro.read_tier = kBlockCacheTier;
 
+      // When nothing but the block cache has to be consulted, the data blocks
+      // are looked up all at once after the index lookups, so that the cache
+      // can amortize hashing, memory latency and locking over the batch.
+      Cache* block_cache = rep_->table_options.block_cache.get();
+      const bool batch_cache_lookups =
+          block_cache != nullptr &&
+          rep_->table_options.block_cache_compressed == nullptr &&
+          !(block_cache_tracer_ && block_cache_tracer_->is_tracing_enabled());
+      std::array<CacheKey, MultiGetContext::MAX_BATCH_SIZE> cache_keys;
+      std::array<size_t, MultiGetContext::MAX_BATCH_SIZE> cache_key_idx;
+      std::array<GetContext*, MultiGetContext::MAX_BATCH_SIZE>
+          cache_get_contexts;
+      size_t num_cache_lookups = 0;
+
       for (auto miter = data_block_range.begin();
            miter != data_block_range.end(); ++miter) {
         const Slice& key = miter->ikey;
@@ -434,6 +448,15 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::MultiGet)
         // initialize block to the contents of the data block.
         prev_offset = v.handle.offset();
         BlockHandle handle = v.handle;
+        if (batch_cache_lookups) {
+          cache_keys[num_cache_lookups] =
+              GetCacheKey(rep_->base_cache_key, handle);
+          cache_key_idx[num_cache_lookups] = block_handles.size();
+          cache_get_contexts[num_cache_lookups] = miter->get_context;
+          ++num_cache_lookups;
+          block_handles.emplace_back(handle);
+          continue;
+        }
         BlockCacheLookupContext lookup_data_block_context(
             TableReaderCaller::kUserMultiGet);
         const UncompressionDict& dict = uncompression_dict.GetValue()
@@ -473,8 +496,33 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::MultiGet)
         }
       }
 
+      if (num_cache_lookups > 0) {
+        std::array<Slice, MultiGetContext::MAX_BATCH_SIZE> keys;
+        std::array<CachableEntry<Block>*, MultiGetContext::MAX_BATCH_SIZE>
+            blocks;
+        for (size_t i = 0; i < num_cache_lookups; ++i) {
+          keys[i] = cache_keys[i].AsSlice();
+          blocks[i] = &results[cache_key_idx[i]];
+        }
+        MultiGetDataBlocksFromCache(block_cache, keys.data(),
+                                    num_cache_lookups,
+                                    cache_get_contexts.data(), blocks.data());
+        for (size_t i = 0; i < num_cache_lookups; ++i) {
+          const size_t idx = cache_key_idx[i];
+          if (results[idx].IsEmpty()) {
+            total_len += BlockSizeWithTrailer(block_handles[idx]);
+          } else if (results[idx].GetValue() != nullptr) {
+            results[idx].UpdateCachedValue();
+            block_handles[idx] = BlockHandle::NullBlockHandle();
+          } else {
+            // The secondary cache lookup is still in progress
+            wait_for_cache_results = true;
+            cache_handles.emplace_back(results[idx].GetCacheHandle());
+          }
+        }
+      }
+
       if (wait_for_cache_results) {
-        Cache* block_cache = rep_->table_options.block_cache.get();
         block_cache->WaitAll(cache_handles);
         for (size_t i = 0; i < block_handles.size(); ++i) {
           // If this block was a success or failure or not needed because
@@ -36,7 +36,8 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
       result = new ShortenedIndexBuilder(
           comparator, table_opt.index_block_restart_interval,
           table_opt.format_version, use_value_delta_encoding,
-          table_opt.index_shortening, /* include_first_key */ false);
+          table_opt.index_shortening, /* include_first_key */ false,
+          table_opt.data_block_summary_collector_factory != nullptr);
       break;
     }
     case BlockBasedTableOptions::kHashSearch: {
@@ -58,7 +59,8 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
       result = new ShortenedIndexBuilder(
           comparator, table_opt.index_block_restart_interval,
           table_opt.format_version, use_value_delta_encoding,
-          table_opt.index_shortening, /* include_first_key */ true);
+          table_opt.index_shortening, /* include_first_key */ true,
+          table_opt.data_block_summary_collector_factory != nullptr);
       break;
     }
     default: {
@@ -73,6 +73,11 @@ class IndexBuilder {
   // override OnKeyAdded() if they need to collect additional information.
   virtual void OnKeyAdded(const Slice& /*key*/) {}
 
+  // Called with the summary of a data block, produced by the
+  // DataBlockSummaryCollector, before the AddIndexEntry() call for that
+  // block. The subclasses that can store block summaries override it.
+  virtual void OnDataBlockSummary(const Slice& /*summary*/) {}
+
   // Inform the index builder that all entries has been written. Block builder
   // may therefore perform any operation required for block finalization.
   //
@@ -125,7 +130,7 @@ class ShortenedIndexBuilder : public IndexBuilder {
       const int index_block_restart_interval, const uint32_t format_version,
       const bool use_value_delta_encoding,
       BlockBasedTableOptions::IndexShorteningMode shortening_mode,
-      bool include_first_key)
+      bool include_first_key, bool include_block_summary = false)
       : IndexBuilder(comparator),
         index_block_builder_(index_block_restart_interval,
                              true /*use_delta_encoding*/,
@@ -135,6 +140,7 @@ class ShortenedIndexBuilder : public IndexBuilder {
                                          use_value_delta_encoding),
         use_value_delta_encoding_(use_value_delta_encoding),
         include_first_key_(include_first_key),
+        include_block_summary_(include_block_summary),
         shortening_mode_(shortening_mode) {
     // Making the default true will disable the feature for old versions
     seperator_is_key_plus_seq_ = (format_version <= 2);
@@ -146,6 +152,12 @@ class ShortenedIndexBuilder : public IndexBuilder {
     }
   }
 
+  virtual void OnDataBlockSummary(const Slice& summary) override {
+    if (include_block_summary_) {
+      current_block_summary_.assign(summary.data(), summary.size());
+    }
+  }
+
   virtual void AddIndexEntry(std::string* last_key_in_current_block,
                              const Slice* first_key_in_next_block,
                              const BlockHandle& block_handle) override {
@@ -172,13 +184,15 @@ class ShortenedIndexBuilder : public IndexBuilder {
     auto sep = Slice(*last_key_in_current_block);
 
     assert(!include_first_key_ || !current_block_first_internal_key_.empty());
-    IndexValue entry(block_handle, current_block_first_internal_key_);
+    IndexValue entry(block_handle, current_block_first_internal_key_,
+                     current_block_summary_);
     std::string encoded_entry;
     std::string delta_encoded_entry;
-    entry.EncodeTo(&encoded_entry, include_first_key_, nullptr);
+    entry.EncodeTo(&encoded_entry, include_first_key_, nullptr,
+                   include_block_summary_);
     if (use_value_delta_encoding_ && !last_encoded_handle_.IsNull()) {
       entry.EncodeTo(&delta_encoded_entry, include_first_key_,
-                     &last_encoded_handle_);
+                     &last_encoded_handle_, include_block_summary_);
     } else {
       // If it's the first block, or delta encoding is disabled,
       // BlockBuilder::Add() below won't use delta-encoded slice.
@@ -192,6 +206,7 @@ class ShortenedIndexBuilder : public IndexBuilder {
     }
 
     current_block_first_internal_key_.clear();
+    current_block_summary_.clear();
   }
 
   using IndexBuilder::Finish;
@@ -231,9 +246,11 @@ class ShortenedIndexBuilder : public IndexBuilder {
   const bool use_value_delta_encoding_;
   bool seperator_is_key_plus_seq_;
   const bool include_first_key_;
+  const bool include_block_summary_;
   BlockBasedTableOptions::IndexShorteningMode shortening_mode_;
   BlockHandle last_encoded_handle_ = BlockHandle::NullBlockHandle();
   std::string current_block_first_internal_key_;
+  std::string current_block_summary_;
 };
 
 // HashIndexBuilder contains a binary-searchable primary index and the
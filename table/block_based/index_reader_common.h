@@ -48,6 +48,12 @@ class BlockBasedTable::IndexReaderCommon : public BlockBasedTable::IndexReader {
     return table_->get_rep()->index_has_first_key;
   }
 
+  bool index_has_block_summary() const {
+    assert(table_ != nullptr);
+    assert(table_->get_rep() != nullptr);
+    return table_->get_rep()->index_has_block_summary;
+  }
+
   bool index_key_includes_seq() const {
     assert(table_ != nullptr);
     assert(table_->get_rep() != nullptr);
@@ -10,6 +10,7 @@
 
 #include "rocksdb/cache.h"
 #include "rocksdb/table.h"
+#include "table/block_based/block_type.h"
 
 namespace ROCKSDB_NAMESPACE {
 // Release the cached entry and decrement its ref count.
@@ -22,6 +23,25 @@ inline MemoryAllocator* GetMemoryAllocator(
              : nullptr;
 }
 
+// Returns the cache for the uncompressed blocks of the given type, which is
+// the metadata block cache, if any, for index, filter and compression
+// dictionary blocks, or the block cache.
+inline Cache* GetBlockCacheForBlockType(
+    const BlockBasedTableOptions& table_options, BlockType block_type) {
+  if (table_options.metadata_block_cache != nullptr) {
+    switch (block_type) {
+      case BlockType::kFilter:
+      case BlockType::kFilterPartitionIndex:
+      case BlockType::kCompressionDictionary:
+      case BlockType::kIndex:
+        return table_options.metadata_block_cache.get();
+      default:
+        break;
+    }
+  }
+  return table_options.block_cache.get();
+}
+
 inline MemoryAllocator* GetMemoryAllocatorForCompressedBlock(
     const BlockBasedTableOptions& table_options) {
   return table_options.block_cache_compressed.get()
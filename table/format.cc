@@ -106,7 +106,8 @@ std::string BlockHandle::ToString(bool hex) const {
 const BlockHandle BlockHandle::kNullBlockHandle(0, 0);
 
 void IndexValue::EncodeTo(std::string* dst, bool have_first_key,
-                          const BlockHandle* previous_handle) const {
+                          const BlockHandle* previous_handle,
+                          bool have_block_summary) const {
   if (previous_handle) {
     // WART: this is specific to Block-based table
     assert(handle.offset() == previous_handle->offset() +
@@ -121,10 +122,14 @@ void IndexValue::EncodeTo(std::string* dst, bool have_first_key,
   if (have_first_key) {
     PutLengthPrefixedSlice(dst, first_internal_key);
   }
+  if (have_block_summary) {
+    PutLengthPrefixedSlice(dst, block_summary);
+  }
 }
 
 Status IndexValue::DecodeFrom(Slice* input, bool have_first_key,
-                              const BlockHandle* previous_handle) {
+                              const BlockHandle* previous_handle,
+                              bool have_block_summary) {
   if (previous_handle) {
     int64_t delta;
     if (!GetVarsignedint64(input, &delta)) {
@@ -147,12 +152,19 @@ Status IndexValue::DecodeFrom(Slice* input, bool have_first_key,
     return Status::Corruption("bad first key in block info");
   }
 
+  if (!have_block_summary) {
+    block_summary = Slice();
+  } else if (!GetLengthPrefixedSlice(input, &block_summary)) {
+    return Status::Corruption("bad block summary in block info");
+  }
+
   return Status::OK();
 }
 
-std::string IndexValue::ToString(bool hex, bool have_first_key) const {
+std::string IndexValue::ToString(bool hex, bool have_first_key,
+                                 bool have_block_summary) const {
   std::string s;
-  EncodeTo(&s, have_first_key, nullptr);
+  EncodeTo(&s, have_first_key, nullptr, have_block_summary);
   if (hex) {
     return Slice(s).ToString(true);
   } else {
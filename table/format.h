@@ -88,27 +88,40 @@ class BlockHandle {
 // where: y is some key between the last key of block n (inclusive) and the
 // first key of block n+1 (exclusive); h is BlockHandle pointing to block n;
 // x, if present, is the first key of block n (unshortened).
-// This struct represents the "h, [x]" part.
+// The entry may additionally carry s, the summary of block n produced by a
+// DataBlockSummaryCollector: y -> h, [x], [s].
+// This struct represents the "h, [x], [s]" part.
 struct IndexValue {
   BlockHandle handle;
   // Empty means unknown.
   Slice first_internal_key;
+  // Empty means unknown.
+  Slice block_summary;
 
   IndexValue() = default;
   IndexValue(BlockHandle _handle, Slice _first_internal_key)
       : handle(_handle), first_internal_key(_first_internal_key) {}
+  IndexValue(BlockHandle _handle, Slice _first_internal_key,
+             Slice _block_summary)
+      : handle(_handle),
+        first_internal_key(_first_internal_key),
+        block_summary(_block_summary) {}
 
   // have_first_key indicates whether the `first_internal_key` is used.
+  // have_block_summary indicates whether the `block_summary` is used.
   // If previous_handle is not null, delta encoding is used;
   // in this case, the two handles must point to consecutive blocks:
   // handle.offset() ==
   //     previous_handle->offset() + previous_handle->size() + kBlockTrailerSize
   void EncodeTo(std::string* dst, bool have_first_key,
-                const BlockHandle* previous_handle) const;
+                const BlockHandle* previous_handle,
+                bool have_block_summary = false) const;
   Status DecodeFrom(Slice* input, bool have_first_key,
-                    const BlockHandle* previous_handle);
+                    const BlockHandle* previous_handle,
+                    bool have_block_summary = false);
 
-  std::string ToString(bool hex, bool have_first_key) const;
+  std::string ToString(bool hex, bool have_first_key,
+                       bool have_block_summary = false) const;
 };
 
 inline uint32_t GetCompressFormatForVersion(uint32_t format_version) {
@@ -163,6 +163,22 @@ class TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called
   virtual void Add(const Slice& key, const Slice& value) = 0;
 
+  // EXPERIMENTAL
+  // Add a data block read from another table with
+  // TableReader::ReadRawDataBlock() without decoding and recompressing its
+  // entries. `contents` is the block as stored, compressed with `type` in the
+  // format of table format_version `format_version`, and `uncompressed` the
+  // uncompressed block. Returns NotSupported, without adding anything, if the
+  // block cannot be used by this table as is.
+  // REQUIRES: the keys of the block are after any previously added key.
+  // REQUIRES: Finish(), Abandon() have not been called
+  virtual Status AddRawDataBlock(const Slice& /*contents*/,
+                                 CompressionType /*type*/,
+                                 uint32_t /*format_version*/,
+                                 const Slice& /*uncompressed*/) {
+    return Status::NotSupported("AddRawDataBlock() not supported.");
+  }
+
   // Return non-ok iff some error has been detected.
   virtual Status status() const = 0;
 
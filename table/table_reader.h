@@ -15,6 +15,7 @@
 #include "folly/experimental/coro/Task.h"
 #endif
 #include "rocksdb/slice_transform.h"
+#include "table/format.h"
 #include "table/get_context.h"
 #include "table/internal_iterator.h"
 #include "table/multiget_context.h"
@@ -100,6 +101,49 @@ class TableReader {
     return Status::NotSupported("ApproximateKeyAnchors() not supported.");
   }
 
+  // EXPERIMENTAL
+  // A data block of the table. Its keys have user keys no larger than
+  // `user_key_bound`, and the keys of the next data block have user keys no
+  // smaller than it.
+  struct DataBlock {
+    DataBlock(const Slice& _user_key_bound, const BlockHandle& _handle)
+        : user_key_bound(_user_key_bound.ToString()), handle(_handle) {}
+    std::string user_key_bound;
+    BlockHandle handle;
+  };
+
+  // EXPERIMENTAL
+  // Returns the data blocks of the table in key order, for copying them to
+  // another table as stored with ReadRawDataBlock() and
+  // TableBuilder::AddRawDataBlock().
+  virtual Status GetDataBlocks(const ReadOptions& /*read_options*/,
+                               std::vector<DataBlock>* /*blocks*/) {
+    return Status::NotSupported("GetDataBlocks() not supported.");
+  }
+
+  // EXPERIMENTAL
+  // A data block as stored in the table file.
+  struct RawDataBlock {
+    // The block as stored, compressed with `compression_type` in the format
+    // of table format_version `format_version`
+    BlockContents contents;
+    CompressionType compression_type = kNoCompression;
+    uint32_t format_version = 0;
+    // The uncompressed block
+    BlockContents uncompressed;
+    // Iterates over the entries of the block
+    std::unique_ptr<InternalIterator> iter;
+  };
+
+  // EXPERIMENTAL
+  // Reads a data block returned by GetDataBlocks() without uncompressing it
+  // into the block cache.
+  virtual Status ReadRawDataBlock(const ReadOptions& /*read_options*/,
+                                  const BlockHandle& /*handle*/,
+                                  RawDataBlock* /*block*/) {
+    return Status::NotSupported("ReadRawDataBlock() not supported.");
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
@@ -294,6 +294,8 @@ void RandomInitDBOptions(DBOptions* db_opt, Random* rnd) {
   db_opt->avoid_flush_during_recovery = rnd->Uniform(2);
   db_opt->avoid_flush_during_shutdown = rnd->Uniform(2);
   db_opt->enforce_single_del_contracts = rnd->Uniform(2);
+  db_opt->enable_subcompaction_work_stealing = rnd->Uniform(2);
+  db_opt->compaction_scheduling_by_stall_deadline = rnd->Uniform(2);
 
   // int options
   db_opt->max_background_compactions = rnd->Uniform(100);
@@ -326,6 +328,8 @@ void RandomInitDBOptions(DBOptions* db_opt, Random* rnd) {
   db_opt->max_manifest_file_size = uint_max + rnd->Uniform(100000);
   db_opt->max_total_wal_size = uint_max + rnd->Uniform(100000);
   db_opt->wal_bytes_per_sync = uint_max + rnd->Uniform(100000);
+  db_opt->bottommost_compaction_preemption_micros =
+      uint_max + rnd->Uniform(100000);
 
   // unsigned int options
   db_opt->stats_dump_period_sec = rnd->Uniform(100000);
@@ -337,6 +341,8 @@ void RandomInitCFOptions(ColumnFamilyOptions* cf_opt, DBOptions& db_options,
 
   // boolean options
   cf_opt->report_bg_io_stats = rnd->Uniform(2);
+  cf_opt->level_compaction_move_non_overlapping_files = rnd->Uniform(2);
+  cf_opt->compaction_copy_clean_data_blocks = rnd->Uniform(2);
   cf_opt->disable_auto_compactions = rnd->Uniform(2);
   cf_opt->inplace_update_support = rnd->Uniform(2);
   cf_opt->level_compaction_dynamic_level_bytes = rnd->Uniform(2);
@@ -383,6 +389,7 @@ void RandomInitCFOptions(ColumnFamilyOptions* cf_opt, DBOptions& db_options,
   // uint32_t options
   cf_opt->bloom_locality = rnd->Uniform(10000);
   cf_opt->max_bytes_for_level_base = rnd->Uniform(10000);
+  cf_opt->round_robin_cursors_per_level = rnd->Uniform(10000);
 
   // uint64_t options
   static const uint64_t uint_max = static_cast<uint64_t>(UINT_MAX);
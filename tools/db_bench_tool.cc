@@ -610,6 +610,11 @@ DEFINE_uint32(
     "compress_format_version == 2 -- decompressed size is included"
     " in the block header in varint32 format.");
 
+DEFINE_double(compressed_secondary_cache_max_compressed_size_ratio, 0.875,
+              "Blocks whose compressed size is more than this ratio of their "
+              "uncompressed size are stored uncompressed in "
+              "CompressedSecondaryCache.");
+
 DEFINE_int64(simcache_size, -1,
              "Number of bytes to use as a simcache of "
              "uncompressed data. Nagative value disables simcache.");
@@ -1206,6 +1211,11 @@ DEFINE_bool(charge_blob_cache, false,
             "CacheEntryRoleOptions::charged of "
             "CacheEntryRole::kBlobCache");
 
+DEFINE_bool(charge_read_buffer, false,
+            "Setting for "
+            "CacheEntryRoleOptions::charged of "
+            "CacheEntryRole::kReadBuffer");
+
 DEFINE_uint64(backup_rate_limit, 0ull,
               "If non-zero, db_bench will rate limit reads and writes for DB "
               "backup. This "
@@ -3086,6 +3096,8 @@ class Benchmark {
             FLAGS_compressed_secondary_cache_compression_type_e;
         secondary_cache_opts.compress_format_version =
             FLAGS_compressed_secondary_cache_compress_format_version;
+        secondary_cache_opts.max_compressed_size_ratio =
+            FLAGS_compressed_secondary_cache_max_compressed_size_ratio;
         opts.secondary_cache =
             NewCompressedSecondaryCache(secondary_cache_opts);
       }
@@ -4356,6 +4368,11 @@ class Benchmark {
            {/*.charged = */ FLAGS_charge_blob_cache
                 ? CacheEntryRoleOptions::Decision::kEnabled
                 : CacheEntryRoleOptions::Decision::kDisabled}});
+      block_based_options.cache_usage_options.options_overrides.insert(
+          {CacheEntryRole::kReadBuffer,
+           {/*.charged = */ FLAGS_charge_read_buffer
+                ? CacheEntryRoleOptions::Decision::kEnabled
+                : CacheEntryRoleOptions::Decision::kDisabled}});
       block_based_options.block_cache_compressed = compressed_cache_;
       block_based_options.block_size = FLAGS_block_size;
       block_based_options.block_restart_interval = FLAGS_block_restart_interval;
@@ -26,6 +26,7 @@ void CompactionJobStats::Reset() {
   is_manual_compaction = false;
 
   total_input_bytes = 0;
+  total_input_bytes_at_output_level = 0;
   total_blob_bytes_read = 0;
   total_output_bytes = 0;
   total_output_bytes_blob = 0;
@@ -50,6 +51,11 @@ void CompactionJobStats::Reset() {
 
   num_single_del_fallthru = 0;
   num_single_del_mismatch = 0;
+
+  num_subcompactions = 0;
+  num_split_subcompactions = 0;
+  min_subcompaction_micros = 0;
+  max_subcompaction_micros = 0;
 }
 
 void CompactionJobStats::Add(const CompactionJobStats& stats) {
@@ -66,6 +72,7 @@ void CompactionJobStats::Add(const CompactionJobStats& stats) {
   num_output_files_blob += stats.num_output_files_blob;
 
   total_input_bytes += stats.total_input_bytes;
+  total_input_bytes_at_output_level += stats.total_input_bytes_at_output_level;
   total_blob_bytes_read += stats.total_blob_bytes_read;
   total_output_bytes += stats.total_output_bytes;
   total_output_bytes_blob += stats.total_output_bytes_blob;
@@ -87,6 +94,27 @@ void CompactionJobStats::Add(const CompactionJobStats& stats) {
 
   num_single_del_fallthru += stats.num_single_del_fallthru;
   num_single_del_mismatch += stats.num_single_del_mismatch;
+
+  if (stats.num_subcompactions > 0) {
+    if (num_subcompactions == 0 ||
+        stats.min_subcompaction_micros < min_subcompaction_micros) {
+      min_subcompaction_micros = stats.min_subcompaction_micros;
+    }
+    if (stats.max_subcompaction_micros > max_subcompaction_micros) {
+      max_subcompaction_micros = stats.max_subcompaction_micros;
+    }
+  }
+  num_subcompactions += stats.num_subcompactions;
+  num_split_subcompactions += stats.num_split_subcompactions;
+}
+
+double CompactionJobStats::WriteAmplification() const {
+  if (total_input_bytes <= total_input_bytes_at_output_level) {
+    return 0;
+  }
+  return static_cast<double>(total_output_bytes + total_output_bytes_blob) /
+         static_cast<double>(total_input_bytes -
+                             total_input_bytes_at_output_level);
 }
 
 #else
@@ -95,6 +123,8 @@ void CompactionJobStats::Reset() {}
 
 void CompactionJobStats::Add(const CompactionJobStats& /*stats*/) {}
 
+double CompactionJobStats::WriteAmplification() const { return 0; }
+
 #endif  // !ROCKSDB_LITE
 
 }  // namespace ROCKSDB_NAMESPACE
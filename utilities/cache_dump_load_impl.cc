@@ -9,14 +9,21 @@
 
 #include "utilities/cache_dump_load_impl.h"
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+
 #include "cache/cache_entry_roles.h"
 #include "file/writable_file_writer.h"
+#include "memory/memory_allocator.h"
 #include "port/lang.h"
+#include "port/port.h"
 #include "rocksdb/env.h"
 #include "rocksdb/file_system.h"
 #include "rocksdb/utilities/ldb_cmd.h"
 #include "table/format.h"
 #include "util/crc32c.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -60,6 +67,11 @@ IOStatus CacheDumperImpl::DumpCacheEntriesToWriter() {
   if (cache_ == nullptr) {
     return IOStatus::InvalidArgument("Cache is null");
   }
+  return DumpCachesToWriter({cache_.get()});
+}
+
+IOStatus CacheDumperImpl::DumpCachesToWriter(
+    const std::vector<Cache*>& caches) {
   if (writer_ == nullptr) {
     return IOStatus::InvalidArgument("CacheDumpWriter is null");
   }
@@ -80,8 +92,15 @@ IOStatus CacheDumperImpl::DumpCacheEntriesToWriter() {
   }
 
   // Then, we iterate the block cache and dump out the blocks that are not
-  // filtered out.
-  cache_->ApplyToAllEntries(DumpOneBlockCallBack(), {});
+  // filtered out. Index and filter blocks go first, so that a loader running
+  // out of cache capacity keeps the blocks that serve the most reads.
+  for (bool data_blocks : {false, true}) {
+    dumping_data_blocks_ = data_blocks;
+    for (Cache* cache : caches) {
+      assert(cache != nullptr);
+      cache->ApplyToAllEntries(DumpOneBlockCallBack(), {});
+    }
+  }
 
   // Finally, write the footer
   io_s = WriteFooter();
@@ -174,7 +193,8 @@ CacheDumperImpl::DumpOneBlockCallBack() {
 
     // Step 4: if the block should not be filter out, write the block to the
     // CacheDumpWriter
-    if (!filter_out && block_start != nullptr) {
+    if (!filter_out && block_start != nullptr &&
+        (type == CacheDumpUnitType::kData) == dumping_data_blocks_) {
       char* buffer = new char[block_len];
       memcpy(buffer, block_start, block_len);
       WriteCacheBlock(type, key, (void*)buffer, block_len)
@@ -272,6 +292,107 @@ IOStatus CacheDumperImpl::WriteFooter() {
                        footer_checksum);
 }
 
+namespace {
+template <typename TBlocklike>
+void CreateDumpedBlock(BlockContents&& contents, BlockType block_type,
+                       size_t read_amp_bytes_per_bit,
+                       const BlockBasedTableOptions& toptions, void** value,
+                       size_t* charge, const Cache::CacheItemHelper** helper) {
+  TBlocklike* block = BlocklikeTraits<TBlocklike>::Create(
+      std::move(contents), read_amp_bytes_per_bit, /*statistics=*/nullptr,
+      /*using_zstd=*/false, toptions.filter_policy.get());
+  *value = block;
+  *charge = block->ApproximateMemoryUsage();
+  *helper = BlocklikeTraits<TBlocklike>::GetCacheItemHelper(block_type);
+}
+
+// Creates the cache entry value of a dumped block from its contents, which
+// it takes over. Returns false if blocks of this type are not restored.
+bool CreateDumpedBlock(CacheDumpUnitType type, BlockContents&& contents,
+                       const BlockBasedTableOptions& toptions, void** value,
+                       size_t* charge, const Cache::CacheItemHelper** helper) {
+  switch (type) {
+    case CacheDumpUnitType::kFilter:
+      CreateDumpedBlock<ParsedFullFilterBlock>(
+          std::move(contents), BlockType::kFilter,
+          toptions.read_amp_bytes_per_bit, toptions, value, charge, helper);
+      return true;
+    case CacheDumpUnitType::kData:
+      CreateDumpedBlock<Block>(std::move(contents), BlockType::kData,
+                               toptions.read_amp_bytes_per_bit, toptions,
+                               value, charge, helper);
+      return true;
+    case CacheDumpUnitType::kIndex:
+      CreateDumpedBlock<Block>(std::move(contents), BlockType::kIndex,
+                               /*read_amp_bytes_per_bit=*/0, toptions, value,
+                               charge, helper);
+      return true;
+    case CacheDumpUnitType::kFilterMetaBlock:
+      CreateDumpedBlock<Block>(std::move(contents),
+                               BlockType::kFilterPartitionIndex,
+                               toptions.read_amp_bytes_per_bit, toptions,
+                               value, charge, helper);
+      return true;
+    default:
+      // Including the obsolete kDeprecatedFilterBlock
+      return false;
+  }
+}
+
+// Inserts one serialized dump unit into the primary cache its table file
+// maps to. Returns true if the block was inserted.
+bool RestoreDumpUnitToPrimaryCache(
+    const std::string& data,
+    const std::unordered_map<std::string, CacheDumpRestoreTarget>& targets) {
+  DumpUnit dump_unit;
+  if (!CacheDumperHelper::DecodeDumpUnit(data, &dump_unit).ok() ||
+      dump_unit.key.size() < OffsetableCacheKey::kCommonPrefixSize) {
+    return false;
+  }
+  auto target = targets.find(std::string(
+      dump_unit.key.data(), OffsetableCacheKey::kCommonPrefixSize));
+  if (target == targets.end()) {
+    // Not a block of a live table file
+    return false;
+  }
+  Cache* cache = target->second.cache;
+  const BlockBasedTableOptions& toptions = *target->second.table_options;
+  Cache::Handle* handle = cache->Lookup(dump_unit.key);
+  if (handle != nullptr) {
+    // Already read by the DB in the meantime
+    cache->Release(handle);
+    return false;
+  }
+
+  // The cache owns the block, so it is copied out of the dump unit
+  CacheAllocationPtr buf =
+      AllocateBlock(dump_unit.value_len, cache->memory_allocator());
+  memcpy(buf.get(), dump_unit.value, dump_unit.value_len);
+  void* value = nullptr;
+  size_t charge = 0;
+  const Cache::CacheItemHelper* helper = nullptr;
+  if (!CreateDumpedBlock(dump_unit.type,
+                         BlockContents(std::move(buf), dump_unit.value_len),
+                         toptions, &value, &charge, &helper)) {
+    return false;
+  }
+  if (cache->GetUsage() + charge > cache->GetCapacity()) {
+    // Do not evict anything to make room for restored blocks
+    (*helper->del_cb)(dump_unit.key, value);
+    return false;
+  }
+  const Cache::Priority priority =
+      toptions.cache_index_and_filter_blocks_with_high_priority &&
+              dump_unit.type != CacheDumpUnitType::kData
+          ? Cache::Priority::HIGH
+          : Cache::Priority::LOW;
+  // Without a handle, the cache cleans up the value if the insert fails
+  return cache->Insert(dump_unit.key, value, helper, charge,
+                       /*handle=*/nullptr, priority)
+      .ok();
+}
+}  // namespace
+
 // This is the main function to restore the cache entries to secondary cache.
 // First, we check if all the arguments are valid. Then, we read the block
 // sequentially from the reader and insert them to the secondary cache.
@@ -312,74 +433,108 @@ IOStatus CacheDumpedLoaderImpl::RestoreCacheEntriesToSecondaryCache() {
     // create the raw_block_content based on the information in the dump_unit
     BlockContents raw_block_contents(
         Slice((char*)dump_unit.value, dump_unit.value_len));
-    Cache::CacheItemHelper* helper = nullptr;
-    Statistics* statistics = nullptr;
+    // according to the block type, create the corresponding block and insert
+    // it. The secondary cache keeps its own copy of the block.
+    void* value = nullptr;
+    size_t charge = 0;
+    const Cache::CacheItemHelper* helper = nullptr;
     Status s = Status::OK();
-    // according to the block type, get the helper callback function and create
-    // the corresponding block
-    switch (dump_unit.type) {
-      case CacheDumpUnitType::kFilter: {
-        helper = BlocklikeTraits<ParsedFullFilterBlock>::GetCacheItemHelper(
-            BlockType::kFilter);
-        std::unique_ptr<ParsedFullFilterBlock> block_holder;
-        block_holder.reset(BlocklikeTraits<ParsedFullFilterBlock>::Create(
-            std::move(raw_block_contents), toptions_.read_amp_bytes_per_bit,
-            statistics, false, toptions_.filter_policy.get()));
-        if (helper != nullptr) {
-          s = secondary_cache_->Insert(dump_unit.key,
-                                       (void*)(block_holder.get()), helper);
+    if (CreateDumpedBlock(dump_unit.type, std::move(raw_block_contents),
+                          toptions_, &value, &charge, &helper)) {
+      s = secondary_cache_->Insert(dump_unit.key, value, helper);
+      (*helper->del_cb)(dump_unit.key, value);
+    }
+    if (!s.ok()) {
+      io_s = status_to_io_status(std::move(s));
+    }
+  }
+  if (dump_unit.type == CacheDumpUnitType::kFooter) {
+    return IOStatus::OK();
+  } else {
+    return io_s;
+  }
+}
+
+// Restore the cache entries directly into primary caches. The dump is read
+// sequentially by this thread, while the blocks are decoded, parsed and
+// inserted by a pool of worker threads fed through a bounded queue.
+IOStatus CacheDumpedLoaderImpl::RestoreCacheEntriesToPrimaryCache(
+    const std::unordered_map<std::string, CacheDumpRestoreTarget>& targets,
+    int num_threads, size_t* num_restored) {
+  assert(num_restored != nullptr);
+  *num_restored = 0;
+  if (reader_ == nullptr) {
+    return IOStatus::InvalidArgument("CacheDumpReader is null");
+  }
+  IOStatus io_s;
+  DumpUnit dump_unit;
+  std::string data;
+  io_s = ReadHeader(&data, &dump_unit);
+  if (!io_s.ok()) {
+    return io_s;
+  }
+
+  std::atomic<size_t> restored{0};
+  port::Mutex mutex;
+  port::CondVar cv(&mutex);
+  std::deque<std::string> pending;
+  bool done = false;
+  const size_t max_pending =
+      16 * static_cast<size_t>(std::max(num_threads, 1));
+  auto restore_func = [&]() {
+    std::string unit_data;
+    while (true) {
+      {
+        MutexLock l(&mutex);
+        while (pending.empty() && !done) {
+          cv.Wait();
         }
-        break;
-      }
-      case CacheDumpUnitType::kData: {
-        helper = BlocklikeTraits<Block>::GetCacheItemHelper(BlockType::kData);
-        std::unique_ptr<Block> block_holder;
-        block_holder.reset(BlocklikeTraits<Block>::Create(
-            std::move(raw_block_contents), toptions_.read_amp_bytes_per_bit,
-            statistics, false, toptions_.filter_policy.get()));
-        if (helper != nullptr) {
-          s = secondary_cache_->Insert(dump_unit.key,
-                                       (void*)(block_holder.get()), helper);
+        if (pending.empty()) {
+          return;
         }
-        break;
+        unit_data = std::move(pending.front());
+        pending.pop_front();
+        cv.SignalAll();
       }
-      case CacheDumpUnitType::kIndex: {
-        helper = BlocklikeTraits<Block>::GetCacheItemHelper(BlockType::kIndex);
-        std::unique_ptr<Block> block_holder;
-        block_holder.reset(BlocklikeTraits<Block>::Create(
-            std::move(raw_block_contents), 0, statistics, false,
-            toptions_.filter_policy.get()));
-        if (helper != nullptr) {
-          s = secondary_cache_->Insert(dump_unit.key,
-                                       (void*)(block_holder.get()), helper);
-        }
-        break;
+      if (RestoreDumpUnitToPrimaryCache(unit_data, targets)) {
+        restored.fetch_add(1, std::memory_order_relaxed);
       }
-      case CacheDumpUnitType::kFilterMetaBlock: {
-        helper = BlocklikeTraits<Block>::GetCacheItemHelper(
-            BlockType::kFilterPartitionIndex);
-        std::unique_ptr<Block> block_holder;
-        block_holder.reset(BlocklikeTraits<Block>::Create(
-            std::move(raw_block_contents), toptions_.read_amp_bytes_per_bit,
-            statistics, false, toptions_.filter_policy.get()));
-        if (helper != nullptr) {
-          s = secondary_cache_->Insert(dump_unit.key,
-                                       (void*)(block_holder.get()), helper);
-        }
-        break;
+    }
+  };
+  std::vector<port::Thread> threads;
+  for (int i = 1; i < num_threads; i++) {
+    threads.emplace_back(restore_func);
+  }
+
+  while (io_s.ok() && dump_unit.type != CacheDumpUnitType::kFooter) {
+    dump_unit.reset();
+    data.clear();
+    io_s = ReadCacheBlock(&data, &dump_unit);
+    if (!io_s.ok() || dump_unit.type == CacheDumpUnitType::kFooter) {
+      break;
+    }
+    if (threads.empty()) {
+      if (RestoreDumpUnitToPrimaryCache(data, targets)) {
+        restored.fetch_add(1, std::memory_order_relaxed);
       }
-      case CacheDumpUnitType::kFooter:
-        break;
-      case CacheDumpUnitType::kDeprecatedFilterBlock:
-        // Obsolete
-        break;
-      default:
-        continue;
+      continue;
     }
-    if (!s.ok()) {
-      io_s = status_to_io_status(std::move(s));
+    MutexLock l(&mutex);
+    while (pending.size() >= max_pending) {
+      cv.Wait();
     }
+    pending.push_back(std::move(data));
+    cv.SignalAll();
+  }
+  {
+    MutexLock l(&mutex);
+    done = true;
+    cv.SignalAll();
+  }
+  for (auto& t : threads) {
+    t.join();
   }
+  *num_restored = restored.load(std::memory_order_relaxed);
   if (dump_unit.type == CacheDumpUnitType::kFooter) {
     return IOStatus::OK();
   } else {
@@ -6,6 +6,7 @@
 #pragma once
 #ifndef ROCKSDB_LITE
 
+#include <set>
 #include <unordered_map>
 
 #include "file/random_access_file_reader.h"
@@ -102,6 +103,16 @@ class CacheDumperImpl : public CacheDumper {
   Status SetDumpFilter(std::vector<DB*> db_list) override;
   IOStatus DumpCacheEntriesToWriter() override;
 
+  // Only dump the blocks whose cache key starts with one of the given cache
+  // key common prefixes (see OffsetableCacheKey::CommonPrefixSlice()).
+  void SetPrefixFilter(std::set<std::string>&& prefixes) {
+    prefix_filter_ = std::move(prefixes);
+  }
+
+  // Dumps the entries of all the given caches into a single dump, instead of
+  // the entries of the cache this dumper was created with.
+  IOStatus DumpCachesToWriter(const std::vector<Cache*>& caches);
+
  private:
   IOStatus WriteRawBlock(uint64_t timestamp, CacheDumpUnitType type,
                          const Slice& key, void* value, size_t len,
@@ -122,6 +133,9 @@ class CacheDumperImpl : public CacheDumper {
   UnorderedMap<Cache::DeleterFn, CacheEntryRole> role_map_;
   SystemClock* clock_;
   uint32_t sequence_num_;
+  // Index and filter blocks are dumped in a first pass over the cache and
+  // data blocks in a second one.
+  bool dumping_data_blocks_;
   // The cache key prefix filter. Currently, we use db_session_id as the prefix,
   // so using std::set to store the prefixes as filter is enough. Further
   // improvement can be applied like BloomFilter or others to speedup the
@@ -129,6 +143,13 @@ class CacheDumperImpl : public CacheDumper {
   std::set<std::string> prefix_filter_;
 };
 
+// Where the blocks of one table file go when a dump is restored into primary
+// block caches.
+struct CacheDumpRestoreTarget {
+  Cache* cache;
+  const BlockBasedTableOptions* table_options;
+};
+
 // The default implementation of CacheDumpedLoader
 class CacheDumpedLoaderImpl : public CacheDumpedLoader {
  public:
@@ -143,6 +164,16 @@ class CacheDumpedLoaderImpl : public CacheDumpedLoader {
   ~CacheDumpedLoaderImpl() {}
   IOStatus RestoreCacheEntriesToSecondaryCache() override;
 
+  // Restores the dumped blocks directly into primary block caches, instead of
+  // the secondary cache this loader was created with. `targets` maps the
+  // cache key common prefix of a table file to where its blocks go, and the
+  // blocks of other files are skipped. So are the blocks that are already
+  // cached or would not fit in the free capacity of their cache. Blocks are
+  // parsed and inserted by `num_threads` threads while the dump is read.
+  IOStatus RestoreCacheEntriesToPrimaryCache(
+      const std::unordered_map<std::string, CacheDumpRestoreTarget>& targets,
+      int num_threads, size_t* num_restored);
+
  private:
   IOStatus ReadDumpUnitMeta(std::string* data, DumpUnitMeta* unit_meta);
   IOStatus ReadDumpUnit(size_t len, std::string* data, DumpUnit* unit);
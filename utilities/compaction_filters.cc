@@ -7,6 +7,7 @@
 
 #include "rocksdb/compaction_filter.h"
 #include "rocksdb/options.h"
+#include "rocksdb/slice.h"
 #include "rocksdb/utilities/customizable_util.h"
 #include "rocksdb/utilities/options_type.h"
 #include "utilities/compaction_filters/layered_compaction_filter_base.h"
@@ -44,6 +45,21 @@ Status CompactionFilter::CreateFromString(const ConfigOptions& config_options,
   return status;
 }
 
+void CompactionFilter::FilterBatch(int level, const std::vector<Slice>& keys,
+                                   const std::vector<Slice>& existing_values,
+                                   std::vector<Decision>* decisions,
+                                   std::vector<std::string>* new_values) const {
+  assert(existing_values.size() == keys.size());
+  assert(decisions->size() == keys.size());
+  assert(new_values->size() == keys.size());
+  std::string skip_until;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    (*decisions)[i] = FilterV2(level, keys[i], ValueType::kValue,
+                               existing_values[i], &(*new_values)[i],
+                               &skip_until);
+  }
+}
+
 Status CompactionFilterFactory::CreateFromString(
     const ConfigOptions& config_options, const std::string& value,
     std::shared_ptr<CompactionFilterFactory>* result) {
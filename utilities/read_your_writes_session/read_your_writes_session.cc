@@ -0,0 +1,288 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+
+#include "rocksdb/utilities/read_your_writes_session.h"
+
+#include <string>
+#include <vector>
+
+#include "db/db_impl/db_impl.h"
+#include "db/key_write_tracker.h"
+#include "db/write_batch_internal.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/write_batch.h"
+#include "util/cast_util.h"
+#include "util/hash.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class ReadYourWritesSessionImpl : public ReadYourWritesSession {
+ public:
+  ReadYourWritesSessionImpl(DB* db, DBImpl* db_impl, KeyWriteTracker* tracker,
+                            size_t max_cached_keys)
+      : db_(db), db_impl_(db_impl), tracker_(tracker), num_cache_hits_(0) {
+    size_t num_slots = 1;
+    while (num_slots < max_cached_keys) {
+      num_slots <<= 1;
+    }
+    slots_.resize(num_slots);
+  }
+
+  using ReadYourWritesSession::Delete;
+  using ReadYourWritesSession::Get;
+  using ReadYourWritesSession::Put;
+
+  Status Put(const WriteOptions& options, ColumnFamilyHandle* column_family,
+             const Slice& key, const Slice& value) override {
+    WriteBatch batch;
+    Status s = batch.Put(column_family, key, value);
+    if (!s.ok()) {
+      return s;
+    }
+    return Write(options, &batch);
+  }
+
+  Status Delete(const WriteOptions& options, ColumnFamilyHandle* column_family,
+                const Slice& key) override {
+    WriteBatch batch;
+    Status s = batch.Delete(column_family, key);
+    if (!s.ok()) {
+      return s;
+    }
+    return Write(options, &batch);
+  }
+
+  Status Write(const WriteOptions& options, WriteBatch* updates) override {
+    if (updates == nullptr) {
+      return Status::InvalidArgument("Batch is nullptr!");
+    }
+    uint64_t seq_used = kMaxSequenceNumber;
+    Status s = db_impl_->WriteImpl(options, updates, /*callback=*/nullptr,
+                                   /*log_used=*/nullptr, /*log_ref=*/0,
+                                   /*disable_memtable=*/false, &seq_used);
+    if (!s.ok() || WriteBatchInternal::Count(updates) == 0) {
+      // Anything a failed write managed to insert has been recorded by the
+      // tracker, which invalidates the affected cached values.
+      return s;
+    }
+    assert(seq_used != kMaxSequenceNumber);
+    // Every key of the batch is remembered as written at the last sequence
+    // number of the batch. Nobody else can write in between, so this only
+    // makes the validity check more conservative.
+    CacheUpdater updater(this,
+                         seq_used + WriteBatchInternal::Count(updates) - 1);
+    // The write has already succeeded, so a failure to remember its keys
+    // must not be reported to the caller. Drop everything instead.
+    if (!updates->Iterate(&updater).ok()) {
+      Clear();
+    }
+    return s;
+  }
+
+  Status Get(const ReadOptions& options, ColumnFamilyHandle* column_family,
+             const Slice& key, std::string* value) override {
+    if (column_family == nullptr) {
+      column_family = db_->DefaultColumnFamily();
+    }
+    if (options.snapshot == nullptr && options.timestamp == nullptr &&
+        options.read_tier != kPersistedTier &&
+        column_family->GetComparator()->timestamp_size() == 0) {
+      const uint32_t cf_id = column_family->GetID();
+      Slot* slot = Find(cf_id, key);
+      if (slot != nullptr) {
+        if (tracker_->GetLatestWrite(cf_id, key) <= slot->seq) {
+          ++num_cache_hits_;
+          if (slot->deleted) {
+            return Status::NotFound();
+          }
+          value->assign(slot->value);
+          return Status::OK();
+        }
+        // The key may have been written by someone else.
+        slot->in_use = false;
+      }
+    }
+    return db_->Get(options, column_family, key, value);
+  }
+
+  uint64_t GetNumCacheHits() const override { return num_cache_hits_; }
+
+  DB* GetDB() const override { return db_; }
+
+ private:
+  struct Slot {
+    bool in_use = false;
+    bool deleted = false;
+    uint32_t column_family_id = 0;
+    SequenceNumber seq = 0;
+    std::string key;
+    std::string value;
+  };
+
+  class CacheUpdater : public WriteBatch::Handler {
+   public:
+    CacheUpdater(ReadYourWritesSessionImpl* session, SequenceNumber seq)
+        : session_(session), seq_(seq) {}
+
+    Status PutCF(uint32_t column_family_id, const Slice& key,
+                 const Slice& value) override {
+      session_->Insert(column_family_id, key, value, /*deleted=*/false, seq_);
+      return Status::OK();
+    }
+
+    Status DeleteCF(uint32_t column_family_id, const Slice& key) override {
+      session_->Insert(column_family_id, key, Slice(), /*deleted=*/true, seq_);
+      return Status::OK();
+    }
+
+    Status SingleDeleteCF(uint32_t column_family_id,
+                          const Slice& key) override {
+      session_->Insert(column_family_id, key, Slice(), /*deleted=*/true, seq_);
+      return Status::OK();
+    }
+
+    Status DeleteRangeCF(uint32_t /*column_family_id*/,
+                         const Slice& /*begin_key*/,
+                         const Slice& /*end_key*/) override {
+      session_->Clear();
+      return Status::OK();
+    }
+
+    Status MergeCF(uint32_t column_family_id, const Slice& key,
+                   const Slice& /*value*/) override {
+      session_->Erase(column_family_id, key);
+      return Status::OK();
+    }
+
+    Status PutEntityCF(uint32_t column_family_id, const Slice& key,
+                       const Slice& /*entity*/) override {
+      session_->Erase(column_family_id, key);
+      return Status::OK();
+    }
+
+    Status PutBlobIndexCF(uint32_t column_family_id, const Slice& key,
+                          const Slice& /*value*/) override {
+      session_->Erase(column_family_id, key);
+      return Status::OK();
+    }
+
+    Status MarkBeginPrepare(bool /*unprepared*/) override {
+      return Status::OK();
+    }
+    Status MarkEndPrepare(const Slice& /*xid*/) override {
+      return Status::OK();
+    }
+    Status MarkNoop(bool /*empty_batch*/) override { return Status::OK(); }
+    Status MarkRollback(const Slice& /*xid*/) override { return Status::OK(); }
+    Status MarkCommit(const Slice& /*xid*/) override { return Status::OK(); }
+    Status MarkCommitWithTimestamp(const Slice& /*xid*/,
+                                   const Slice& /*commit_ts*/) override {
+      return Status::OK();
+    }
+
+   private:
+    ReadYourWritesSessionImpl* session_;
+    const SequenceNumber seq_;
+  };
+
+  // A key may live in any of kNumProbes consecutive slots starting at its
+  // home slot.
+  static constexpr size_t kNumProbes = 4;
+
+  size_t HomeSlot(uint32_t column_family_id, const Slice& key) const {
+    return static_cast<size_t>(
+               GetSliceNPHash64(key, /*seed=*/column_family_id)) &
+           (slots_.size() - 1);
+  }
+
+  Slot* Find(uint32_t column_family_id, const Slice& key) {
+    const size_t home = HomeSlot(column_family_id, key);
+    for (size_t i = 0; i < kNumProbes; ++i) {
+      Slot& slot = slots_[(home + i) & (slots_.size() - 1)];
+      if (slot.in_use && slot.column_family_id == column_family_id &&
+          key.compare(slot.key) == 0) {
+        return &slot;
+      }
+    }
+    return nullptr;
+  }
+
+  void Insert(uint32_t column_family_id, const Slice& key, const Slice& value,
+              bool deleted, SequenceNumber seq) {
+    Slot* target = Find(column_family_id, key);
+    if (target == nullptr) {
+      // Take a free slot, or else evict the least recently written key.
+      const size_t home = HomeSlot(column_family_id, key);
+      for (size_t i = 0; i < kNumProbes; ++i) {
+        Slot& slot = slots_[(home + i) & (slots_.size() - 1)];
+        if (!slot.in_use) {
+          target = &slot;
+          break;
+        }
+        if (target == nullptr || slot.seq < target->seq) {
+          target = &slot;
+        }
+      }
+      target->column_family_id = column_family_id;
+      target->key.assign(key.data(), key.size());
+    }
+    target->in_use = true;
+    target->deleted = deleted;
+    target->seq = seq;
+    target->value.assign(value.data(), value.size());
+  }
+
+  void Erase(uint32_t column_family_id, const Slice& key) {
+    Slot* slot = Find(column_family_id, key);
+    if (slot != nullptr) {
+      slot->in_use = false;
+    }
+  }
+
+  void Clear() {
+    for (auto& slot : slots_) {
+      slot.in_use = false;
+    }
+  }
+
+  DB* const db_;
+  DBImpl* const db_impl_;
+  KeyWriteTracker* const tracker_;
+  std::vector<Slot> slots_;
+  uint64_t num_cache_hits_;
+};
+
+Status ReadYourWritesSession::Open(
+    DB* db, const ReadYourWritesSessionOptions& options,
+    std::unique_ptr<ReadYourWritesSession>* session) {
+  if (db == nullptr || session == nullptr) {
+    return Status::InvalidArgument("db and session must not be nullptr");
+  }
+  if (options.max_cached_keys == 0) {
+    return Status::InvalidArgument("max_cached_keys must be positive");
+  }
+  if (db->GetRootDB() != db) {
+    return Status::NotSupported(
+        "ReadYourWritesSession requires a DB opened with DB::Open()");
+  }
+  if (db->GetDBOptions().unordered_write) {
+    return Status::NotSupported(
+        "ReadYourWritesSession is not supported with unordered_write");
+  }
+  DBImpl* db_impl = static_cast_with_check<DBImpl>(db);
+  if (db_impl->seq_per_batch()) {
+    return Status::NotSupported(
+        "ReadYourWritesSession requires one sequence number per key");
+  }
+  session->reset(new ReadYourWritesSessionImpl(
+      db, db_impl, db_impl->GetOrCreateKeyWriteTracker(),
+      options.max_cached_keys));
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // ROCKSDB_LITE
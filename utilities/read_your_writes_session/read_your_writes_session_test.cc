@@ -0,0 +1,176 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+
+#include "rocksdb/utilities/read_your_writes_session.h"
+
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+#include "rocksdb/utilities/stackable_db.h"
+#include "utilities/merge_operators.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class ReadYourWritesSessionTest : public DBTestBase {
+ public:
+  ReadYourWritesSessionTest()
+      : DBTestBase("read_your_writes_session_test", /*env_do_fsync=*/false) {}
+
+  std::unique_ptr<ReadYourWritesSession> OpenSession(
+      size_t max_cached_keys = 1024) {
+    ReadYourWritesSessionOptions session_options;
+    session_options.max_cached_keys = max_cached_keys;
+    std::unique_ptr<ReadYourWritesSession> session;
+    EXPECT_OK(ReadYourWritesSession::Open(db_, session_options, &session));
+    return session;
+  }
+};
+
+TEST_F(ReadYourWritesSessionTest, ReadOwnWrites) {
+  Options options = CurrentOptions();
+  CreateAndReopenWithCF({"pikachu"}, options);
+  auto session = OpenSession();
+
+  ASSERT_OK(session->Put(WriteOptions(), "k1", "v1"));
+  ASSERT_OK(session->Put(WriteOptions(), handles_[1], "k1", "v1_cf1"));
+  ASSERT_OK(session->Delete(WriteOptions(), "k2"));
+
+  std::string value;
+  ASSERT_OK(session->Get(ReadOptions(), "k1", &value));
+  ASSERT_EQ("v1", value);
+  ASSERT_OK(session->Get(ReadOptions(), handles_[1], "k1", &value));
+  ASSERT_EQ("v1_cf1", value);
+  ASSERT_TRUE(session->Get(ReadOptions(), "k2", &value).IsNotFound());
+  ASSERT_EQ(3U, session->GetNumCacheHits());
+
+  // Keys that were not written through the session are read from the DB.
+  ASSERT_OK(db_->Put(WriteOptions(), "k3", "v3"));
+  ASSERT_OK(session->Get(ReadOptions(), "k3", &value));
+  ASSERT_EQ("v3", value);
+  ASSERT_EQ(3U, session->GetNumCacheHits());
+
+  WriteBatch batch;
+  ASSERT_OK(batch.Put("k4", "v4"));
+  ASSERT_OK(batch.Put("k1", "v1_new"));
+  ASSERT_OK(session->Write(WriteOptions(), &batch));
+  ASSERT_OK(session->Get(ReadOptions(), "k4", &value));
+  ASSERT_EQ("v4", value);
+  ASSERT_OK(session->Get(ReadOptions(), "k1", &value));
+  ASSERT_EQ("v1_new", value);
+  ASSERT_EQ(5U, session->GetNumCacheHits());
+
+  // Snapshot reads always go to the DB.
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ReadOptions snapshot_read_options;
+  snapshot_read_options.snapshot = snapshot;
+  ASSERT_OK(session->Get(snapshot_read_options, "k1", &value));
+  ASSERT_EQ("v1_new", value);
+  ASSERT_EQ(5U, session->GetNumCacheHits());
+  db_->ReleaseSnapshot(snapshot);
+}
+
+TEST_F(ReadYourWritesSessionTest, OtherWritersInvalidate) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  Reopen(options);
+  auto session = OpenSession();
+  auto other_session = OpenSession();
+  std::string value;
+
+  ASSERT_OK(session->Put(WriteOptions(), "a", "session"));
+  ASSERT_OK(db_->Put(WriteOptions(), "a", "db"));
+  ASSERT_OK(session->Get(ReadOptions(), "a", &value));
+  ASSERT_EQ("db", value);
+
+  ASSERT_OK(session->Put(WriteOptions(), "b", "session"));
+  ASSERT_OK(other_session->Delete(WriteOptions(), "b"));
+  ASSERT_TRUE(session->Get(ReadOptions(), "b", &value).IsNotFound());
+  ASSERT_TRUE(other_session->Get(ReadOptions(), "b", &value).IsNotFound());
+  ASSERT_EQ(1U, other_session->GetNumCacheHits());
+
+  ASSERT_OK(session->Put(WriteOptions(), "c", "session"));
+  ASSERT_OK(db_->Merge(WriteOptions(), "c", "merge"));
+  // Merges by anyone are tracked as writes too.
+  ASSERT_OK(session->Get(ReadOptions(), "c", &value));
+  ASSERT_EQ("session,merge", value);
+
+  // Range deletions may cover any remembered key.
+  ASSERT_OK(session->Put(WriteOptions(), "d", "session"));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "d",
+                             "e"));
+  ASSERT_TRUE(session->Get(ReadOptions(), "d", &value).IsNotFound());
+
+  // So may deleting files.
+  ASSERT_OK(session->Put(WriteOptions(), "e", "session"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_OK(DeleteFilesInRange(db_, db_->DefaultColumnFamily(),
+                               /*begin=*/nullptr, /*end=*/nullptr));
+  ASSERT_TRUE(session->Get(ReadOptions(), "e", &value).IsNotFound());
+
+  ASSERT_EQ(0U, session->GetNumCacheHits());
+}
+
+TEST_F(ReadYourWritesSessionTest, Eviction) {
+  Reopen(CurrentOptions());
+  auto session = OpenSession(/*max_cached_keys=*/4);
+
+  const int kNumKeys = 100;
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(session->Put(WriteOptions(), Key(i), "v" + std::to_string(i)));
+  }
+  std::string value;
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(session->Get(ReadOptions(), Key(i), &value));
+    ASSERT_EQ("v" + std::to_string(i), value);
+  }
+  // All keys compete for the same four slots, which keep the latest writes.
+  ASSERT_EQ(4U, session->GetNumCacheHits());
+}
+
+TEST_F(ReadYourWritesSessionTest, Unsupported) {
+  Options options = CurrentOptions();
+  options.unordered_write = true;
+  Reopen(options);
+  ReadYourWritesSessionOptions session_options;
+  std::unique_ptr<ReadYourWritesSession> session;
+  ASSERT_TRUE(ReadYourWritesSession::Open(db_, session_options, &session)
+                  .IsNotSupported());
+
+  Reopen(CurrentOptions());
+  StackableDB* stackable_db = new StackableDB(db_);
+  ASSERT_TRUE(
+      ReadYourWritesSession::Open(stackable_db, session_options, &session)
+          .IsNotSupported());
+  ASSERT_OK(stackable_db->Close());
+  delete stackable_db;
+  db_ = nullptr;
+
+  Reopen(CurrentOptions());
+  session_options.max_cached_keys = 0;
+  ASSERT_TRUE(ReadYourWritesSession::Open(db_, session_options, &session)
+                  .IsInvalidArgument());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+#else
+#include <stdio.h>
+
+int main(int /*argc*/, char** /*argv*/) {
+  fprintf(stderr,
+          "SKIPPED as ReadYourWritesSession is not supported in ROCKSDB_LITE\n");
+  return 0;
+}
+
+#endif  // !ROCKSDB_LITE